@@ -0,0 +1,136 @@
+#
+#  LLAStaticPlugins.cmake
+#
+# Build the plug-ins listed in LLA_STATIC_PLUGINS (plug-in target names, for
+# example "desfirecards;iso7816readers;pcscreaders") into the
+# logicalaccess-static-plugins static library.
+#
+# The factory functions exported by the libraryentry.cpp of those plug-ins are
+# listed in a generated table, registered to the StaticPluginRegistry of
+# logicalaccess. The registration source is an interface source of the
+# library: it is compiled into each target linking logicalaccess-static-plugins,
+# so the linker cannot drop it. LibraryManager then resolves those factories
+# without scanning nor loading the plug-in folders.
+#
+# Plug-ins a static plug-in depends on should be listed too, otherwise the
+# shared version is linked. The shared plug-ins are still built.
+
+set(LLA_STATIC_PLUGINS_TEMPLATE ${CMAKE_CURRENT_LIST_DIR}/staticplugins.cpp.in)
+
+function(lla_add_static_plugins)
+    set(_sources)
+    set(_definitions)
+    set(_includes)
+    set(_libraries logicalaccess)
+    set(_declarations)
+    set(_entries)
+    set(_chip_infos)
+    set(_reader_infos)
+
+    foreach (_plugin ${LLA_STATIC_PLUGINS})
+        if (NOT TARGET ${_plugin})
+            message(FATAL_ERROR "Unknown plug-in ${_plugin} in LLA_STATIC_PLUGINS.")
+        endif ()
+
+        get_target_property(_dir ${_plugin} SOURCE_DIR)
+        get_target_property(_plugin_sources ${_plugin} SOURCES)
+        foreach (_source ${_plugin_sources})
+            if (NOT IS_ABSOLUTE ${_source})
+                set(_source ${_dir}/${_source})
+            endif ()
+            if (NOT _source MATCHES "\\.cpp$")
+                continue()
+            endif ()
+            list(APPEND _sources ${_source})
+
+            if (_source MATCHES "/libraryentry\\.cpp$")
+                # Every plug-in exports the same library entry points: they are
+                # renamed to link several plug-ins together.
+                set_source_files_properties(${_source} PROPERTIES COMPILE_DEFINITIONS
+                        "getLibraryName=${_plugin}_getLibraryName;getChipInfoAt=${_plugin}_getChipInfoAt;getReaderInfoAt=${_plugin}_getReaderInfoAt")
+
+                file(READ ${_source} _content)
+                if (_content MATCHES "getChipInfoAt")
+                    list(APPEND _declarations "bool ${_plugin}_getChipInfoAt(unsigned int, char *, size_t, void **)")
+                    list(APPEND _chip_infos "&${_plugin}_getChipInfoAt")
+                endif ()
+                if (_content MATCHES "getReaderInfoAt")
+                    list(APPEND _declarations "bool ${_plugin}_getReaderInfoAt(unsigned int, char *, size_t, void **)")
+                    list(APPEND _reader_infos "&${_plugin}_getReaderInfoAt")
+                endif ()
+
+                string(REGEX MATCHALL
+                        "void[ \t\r\n]+get[A-Za-z0-9_]+(Chip|Reader|Commands|Diversification)[ \t\r\n]*\\("
+                        _factories "${_content}")
+                foreach (_factory ${_factories})
+                    string(REGEX REPLACE "^void[ \t\r\n]+([A-Za-z0-9_]+)[ \t\r\n]*\\($" "\\1"
+                            _symbol "${_factory}")
+                    if (_symbol MATCHES "Chip$")
+                        list(APPEND _declarations "void ${_symbol}(std::shared_ptr<logicalaccess::Chip> *)")
+                        list(APPEND _entries "{\"${_symbol}\", &${_symbol}, nullptr, nullptr, nullptr}")
+                    elseif (_symbol MATCHES "Reader$")
+                        list(APPEND _declarations "void ${_symbol}(std::shared_ptr<logicalaccess::ReaderProvider> *)")
+                        list(APPEND _entries "{\"${_symbol}\", nullptr, &${_symbol}, nullptr, nullptr}")
+                    elseif (_symbol MATCHES "Commands$")
+                        list(APPEND _declarations "void ${_symbol}(std::shared_ptr<logicalaccess::Commands> *)")
+                        list(APPEND _entries "{\"${_symbol}\", nullptr, nullptr, &${_symbol}, nullptr}")
+                    else ()
+                        list(APPEND _declarations "void ${_symbol}(std::shared_ptr<logicalaccess::KeyDiversification> *)")
+                        list(APPEND _entries "{\"${_symbol}\", nullptr, nullptr, nullptr, &${_symbol}}")
+                    endif ()
+                endforeach ()
+            endif ()
+        endforeach ()
+
+        get_target_property(_plugin_definitions ${_plugin} COMPILE_DEFINITIONS)
+        if (_plugin_definitions)
+            list(APPEND _definitions ${_plugin_definitions})
+        endif ()
+        get_target_property(_plugin_includes ${_plugin} INCLUDE_DIRECTORIES)
+        if (_plugin_includes)
+            list(APPEND _includes ${_plugin_includes})
+        endif ()
+        get_target_property(_plugin_libraries ${_plugin} LINK_LIBRARIES)
+        if (_plugin_libraries)
+            list(APPEND _libraries ${_plugin_libraries})
+        endif ()
+    endforeach ()
+
+    list(REMOVE_DUPLICATES _libraries)
+    list(REMOVE_ITEM _libraries ${LLA_STATIC_PLUGINS})
+    if (_definitions)
+        list(REMOVE_DUPLICATES _definitions)
+    endif ()
+    if (_includes)
+        list(REMOVE_DUPLICATES _includes)
+    endif ()
+
+    # Sorted by symbol, like the registry index.
+    list(SORT _entries)
+    string(REPLACE ";" ",\n    " LLA_STATIC_PLUGINS_ENTRIES "${_entries}")
+    string(REPLACE ";" ";\n" LLA_STATIC_PLUGINS_DECLARATIONS "${_declarations}")
+    list(APPEND _chip_infos nullptr)
+    string(REPLACE ";" ", " LLA_STATIC_PLUGINS_CHIP_INFOS "${_chip_infos}")
+    list(APPEND _reader_infos nullptr)
+    string(REPLACE ";" ", " LLA_STATIC_PLUGINS_READER_INFOS "${_reader_infos}")
+
+    set(_registration ${CMAKE_CURRENT_BINARY_DIR}/staticplugins.cpp)
+    configure_file(${LLA_STATIC_PLUGINS_TEMPLATE} ${_registration} @ONLY)
+
+    add_library(logicalaccess-static-plugins STATIC ${_sources})
+    set_target_properties(logicalaccess-static-plugins PROPERTIES
+            POSITION_INDEPENDENT_CODE ON)
+    target_compile_definitions(logicalaccess-static-plugins PRIVATE ${_definitions})
+    target_include_directories(logicalaccess-static-plugins PRIVATE ${_includes})
+    target_link_libraries(logicalaccess-static-plugins PUBLIC ${_libraries})
+    target_sources(logicalaccess-static-plugins INTERFACE ${_registration})
+
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT _ipo_supported OUTPUT _ipo_output)
+    if (_ipo_supported)
+        set_target_properties(logicalaccess-static-plugins PROPERTIES
+                INTERPROCEDURAL_OPTIMIZATION ON)
+    endif ()
+
+    install(TARGETS logicalaccess-static-plugins ARCHIVE DESTINATION lib/${LIB_SUFFIX})
+endfunction()
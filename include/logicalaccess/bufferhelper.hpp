@@ -33,6 +33,51 @@ class LLA_CORE_API BufferHelper
 
     static std::string getStdString(const ByteVector &buffer);
 
+    /**
+     * \brief Encode bytes to upper case hex digits, without separator.
+     * \param in The bytes.
+     * \param len The number of bytes.
+     * \param out The output, of at least 2 * len characters. No null terminator
+     * is added.
+     * \return The number of characters written.
+     */
+    static size_t hexEncode(const uint8_t *in, size_t len, char *out);
+
+    /**
+     * \brief Decode hex digits, ignoring spaces. An odd last digit is decoded
+     * as a byte on its own.
+     * \param in The hex digits.
+     * \param len The number of characters.
+     * \param out The output, of at least (len + 1) / 2 bytes.
+     * \return The number of bytes written.
+     */
+    static size_t hexDecode(const char *in, size_t len, uint8_t *out);
+
+    /**
+     * \brief Get the size of the base 64 encoding of some bytes.
+     * \param len The number of bytes.
+     * \return The number of characters.
+     */
+    static size_t getBase64EncodedSize(size_t len);
+
+    /**
+     * \brief Encode bytes to base 64, with padding.
+     * \param in The bytes.
+     * \param len The number of bytes.
+     * \param out The output, of at least getBase64EncodedSize(len) characters.
+     * \return The number of characters written.
+     */
+    static size_t base64Encode(const uint8_t *in, size_t len, char *out);
+
+    /**
+     * \brief Decode base 64 characters. Decoding stops at the padding.
+     * \param in The base 64 characters.
+     * \param len The number of characters, a multiple of 4.
+     * \param out The output, of at least len / 4 * 3 bytes.
+     * \return The number of bytes written.
+     */
+    static size_t base64Decode(const char *in, size_t len, uint8_t *out);
+
     static void setUShort(ByteVector &buffer, const unsigned short &value);
 
     static unsigned short getUShort(const ByteVector &buffer, size_t &offset);
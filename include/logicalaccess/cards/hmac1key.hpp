@@ -47,6 +47,12 @@ class LLA_CORE_API HMAC1Key : public Key
      */
     explicit HMAC1Key(const ByteVector &data);
 
+    /**
+     * \brief Copy the key.
+     * \return The copy.
+     */
+    std::shared_ptr<Key> clone() const override;
+
     /**
      * \brief Get the key length.
      * \return The key length.
@@ -35,6 +35,16 @@ class LLA_CORE_API Location : public XmlSerializable
         throw std::runtime_error("not implemented");
     }
 
+    /**
+     * \brief Copy the location, so that incrementOffset() on the copy leaves
+     * this one unchanged.
+     * \return The copy.
+     */
+    virtual std::shared_ptr<Location> clone() const
+    {
+        throw std::runtime_error("not implemented");
+    }
+
     /**
      * \brief Equality operator
      * \param location Location to compare.
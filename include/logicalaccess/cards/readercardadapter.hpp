@@ -92,6 +92,13 @@ class LLA_CORE_API ReaderCardAdapter
     * \brief The result checker.
     */
     std::shared_ptr<ResultChecker> d_ResultChecker;
+
+  private:
+    /**
+     * \brief The command metrics, resolved again only when the reader or the card
+     * type changes.
+     */
+    std::shared_ptr<const LatencyMetrics> d_commandMetrics;
 };
 }
 
@@ -50,6 +50,12 @@ class LLA_CORE_API TripleDESKey : public Key
      */
     explicit TripleDESKey(const ByteVector &data);
 
+    /**
+     * \brief Copy the key.
+     * \return The copy.
+     */
+    std::shared_ptr<Key> clone() const override;
+
     /**
      * \brief Get the key length.
      * \return The key length.
@@ -1,10 +1,16 @@
 #ifndef LIBRARYMANAGER_HPP__
 #define LIBRARYMANAGER_HPP__
 
+#include <atomic>
+#include <ctime>
 #include <string>
 #include <list>
+#include <map>
+#include <memory>
 #include <unordered_map>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include <logicalaccess/dynlibrary/idynlibrary.hpp>
 
@@ -23,9 +29,44 @@ class LLA_CORE_API LibraryManager
     };
 
   private:
-    LibraryManager() = default;
+    /**
+     * Kinds of plug-in factory functions, resolved through the symbol cache.
+     */
+    enum SymbolKind
+    {
+        READER_PROVIDER_SYMBOL = 0,
+        CHIP_SYMBOL,
+        COMMANDS_SYMBOL,
+        DIVERSIFICATION_SYMBOL,
+        SYMBOL_KIND_COUNT
+    };
+
+    /**
+     * Resolved factory functions of a kind, by type name. A null function is
+     * cached too, for types no plug-in provides.
+     */
+    typedef std::unordered_map<std::string, void *> SymbolMap;
+
+    /**
+     * A plug-in known from the manifest, loaded or not.
+     */
+    struct PluginEntry
+    {
+        std::string path;
+        std::time_t lastWriteTime;
+        uintmax_t size;
+        std::vector<std::string> chips;
+        std::vector<std::string> readers;
+    };
+
+    /**
+     * Plug-ins by file name.
+     */
+    typedef std::map<std::string, PluginEntry> PluginManifest;
+
+    LibraryManager();
 
-    ~LibraryManager() = default;
+    ~LibraryManager();
 
     static bool hasEnding(std::string const &fullString, std::string ending);
 
@@ -93,14 +134,105 @@ class LLA_CORE_API LibraryManager
     void scanPlugins();
 
   protected:
+    /**
+     * Get the factory function of a type, `"get" + type + suffix`.
+     *
+     * Resolved functions are cached in immutable maps published atomically:
+     * a cached lookup is a hash map search, without the manager lock nor
+     * allocation. It is not lock-free though: libstdc++ and MSVC implement
+     * the shared_ptr atomic functions with a global pool of locks, held
+     * while copying the pointer. A miss resolves the function under the
+     * manager lock and publishes a new map. Plug-in scans invalidate the
+     * cache.
+     */
+    void *getCachedFctFromType(SymbolKind kind, const std::string &type);
+
+    /**
+     * Invalidate the symbol cache. Must be called with the manager lock.
+     */
+    void clearSymbolCache();
+
     std::vector<std::string> getAvailablePlugins(LibraryType libraryType);
     static void getAvailablePlugins(std::vector<std::string> &plugins,
                                     getobjectinfoat objectinfoptr);
 
+    /**
+     * List the plug-in files of the plug-in folders, by file name.
+     */
+    static std::map<std::string, std::string> listPluginFiles();
+
+    /**
+     * Read the manifest file. Returns false if it is missing, unreadable or
+     * doesn't describe exactly the plug-in files.
+     */
+    static bool readManifest(const std::string &filename,
+                             const std::map<std::string, std::string> &files,
+                             PluginManifest &manifest);
+
+    /**
+     * Write the manifest file.
+     */
+    static void writeManifest(const std::string &filename,
+                              const PluginManifest &manifest);
+
+    /**
+     * Load a plug-in file. Returns null if it is not a valid plug-in.
+     */
+    static IDynLibrary *openPlugin(const std::string &path);
+
+    /**
+     * Load the plug-in of the manifest providing a chip or reader type, if
+     * any. Must be called with the manager lock.
+     */
+    IDynLibrary *loadPluginFor(SymbolKind kind, const std::string &type);
+
+    /**
+     * Load every plug-in not loaded yet. Must be called with the manager lock.
+     */
+    void loadAllPlugins();
+
+    /**
+     * Background loading thread body.
+     */
+    void backgroundLoad();
+
+    /**
+     * Stop and join the background loading thread.
+     */
+    void stopBackgroundLoad();
+
   private:
     mutable std::recursive_mutex mutex_;
     std::map<std::string, IDynLibrary *> libLoaded;
     static const std::string enumType[3];
+
+    /**
+     * The published symbol maps, one per kind, accessed with atomic_load and
+     * atomic_store. Null until a first lookup. A replaced map is freed once
+     * the last reader holding it releases it, so maps are not retired
+     * forever like the StaticPluginRegistry tables: a new map is published
+     * on each miss, including the types no plug-in provides.
+     */
+    std::shared_ptr<const SymbolMap> symbolCache_[SYMBOL_KIND_COUNT];
+
+    /**
+     * Every known plug-in, from the last scan or the manifest file.
+     */
+    PluginManifest manifest_;
+
+    /**
+     * Plug-ins were scanned, or listed from a valid manifest file.
+     */
+    bool scanned_;
+
+    /**
+     * Every plug-in of the manifest is loaded.
+     */
+    bool allLoaded_;
+
+    std::thread backgroundThread_;
+
+    std::atomic<bool> stopBackground_;
 };
 }
 
@@ -0,0 +1,73 @@
+/**
+ * \file staticpluginregistry.hpp
+ * \brief Factory functions of plug-ins linked statically.
+ */
+
+#ifndef LOGICALACCESS_STATICPLUGINREGISTRY_HPP
+#define LOGICALACCESS_STATICPLUGINREGISTRY_HPP
+
+#include <logicalaccess/dynlibrary/idynlibrary.hpp>
+
+#include <string>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief A factory function of a plug-in linked statically. Only the field of
+ * the function kind is set.
+ */
+struct StaticPluginEntry
+{
+    const char *symbol;
+    getcard chip;
+    getprovider reader;
+    getcommands commands;
+    getdiversification diversification;
+};
+
+/**
+ * \brief Registry of the plug-ins linked statically, built with the
+ * LLA_STATIC_PLUGINS CMake option.
+ *
+ * The factory tables are generated at build time and registered during
+ * static initialization of the application. LibraryManager resolves factory
+ * functions here before looking for dynamic plug-ins, so that a
+ * configuration using only static plug-ins never scans the plug-in folders.
+ *
+ * Each registration publishes a new immutable table: lookups take no lock.
+ */
+class LLA_CORE_API StaticPluginRegistry
+{
+  public:
+    /**
+     * \brief Register the tables of a set of static plug-ins. Registering the
+     * same table again has no effect.
+     * \param entries The factory functions.
+     * \param count The number of factory functions.
+     * \param chipInfos The chip info functions, null terminated.
+     * \param readerInfos The reader info functions, null terminated.
+     */
+    static void registerPlugins(const StaticPluginEntry *entries, size_t count,
+                                const getobjectinfoat *chipInfos,
+                                const getobjectinfoat *readerInfos);
+
+    /**
+     * \brief Get a factory function by symbol name.
+     * \return The function, or null if no static plug-in exports it.
+     */
+    static void *getSymbol(const std::string &symbol);
+
+    /**
+     * \brief Get the chip types of the static plug-ins.
+     */
+    static std::vector<std::string> getChipTypes();
+
+    /**
+     * \brief Get the reader types of the static plug-ins.
+     */
+    static std::vector<std::string> getReaderTypes();
+};
+}
+
+#endif /* LOGICALACCESS_STATICPLUGINREGISTRY_HPP */
@@ -9,10 +9,66 @@
 
 #include <logicalaccess/cards/keystorage.hpp>
 #include <logicalaccess/cards/keydiversification.hpp>
+#include <logicalaccess/securememory.hpp>
 
 namespace logicalaccess
 {
 class KeyDiversification;
+
+/**
+ * \brief A read-only view of key data, without copying it to the heap. The view
+ * points into the key, or into its own secure memory when the key data have to be
+ * padded. It is invalidated when the key is modified or destroyed.
+ */
+class LLA_CORE_API KeyDataView
+{
+  public:
+    KeyDataView(const uint8_t *data, size_t size);
+
+    explicit KeyDataView(SecureByteVector &&padded);
+
+    KeyDataView(KeyDataView &&) = default;
+
+    KeyDataView(const KeyDataView &) = delete;
+
+    KeyDataView &operator=(const KeyDataView &) = delete;
+
+    const uint8_t *data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    uint8_t operator[](size_t index) const
+    {
+        return data_[index];
+    }
+
+    const uint8_t *begin() const
+    {
+        return data_;
+    }
+
+    const uint8_t *end() const
+    {
+        return data_ + size_;
+    }
+
+  private:
+    /**
+     * \brief The padded key data, when the view does not point into the key.
+     */
+    SecureByteVector padded_;
+
+    const uint8_t *data_;
+
+    size_t size_;
+};
+
 /**
  * \brief A Key base class. The key object is used to describe key chip information used
  * for authentication on secured memory area or for restricted operation.
@@ -38,7 +94,15 @@ class LLA_CORE_API Key : public XmlSerializable,
      * \return The key length.
      */
     virtual size_t getLength() const = 0;
-    
+
+    /**
+     * \brief Copy the key. The key storage and the key diversification are
+     * shared with the copy. The default implementation throws: key types
+     * diversified by an encoding pipeline must override it.
+     * \return The copy.
+     */
+    virtual std::shared_ptr<Key> clone() const;
+
     virtual unsigned char getEmptyByte() const
     {
         return 0x00;
@@ -49,7 +113,13 @@ class LLA_CORE_API Key : public XmlSerializable,
      * \return The key data.
      */
     virtual ByteVector getData() const;
-    
+
+    /**
+     * \brief Get the key data without copying them.
+     * \return A view of the key data, padded like getData().
+     */
+    KeyDataView getDataView() const;
+
     /**
      * \brief Set the key data.
      * \param buf The buffer.
@@ -192,9 +262,9 @@ class LLA_CORE_API Key : public XmlSerializable,
     bool d_storeCipheredData;
     
     /**
-     * \biref The key data.
+     * \brief The key data, in secure memory.
      */
-    ByteVector d_data;
+    SecureByteVector d_data;
 };
 
 /**
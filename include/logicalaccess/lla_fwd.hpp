@@ -51,6 +51,10 @@ class Format;
 
 class ResultChecker;
 
+class CompiledConfiguration;
+
+class LatencyMetrics;
+
 class Key;
 using KeyPtr = std::shared_ptr<Key>;
 
@@ -0,0 +1,273 @@
+/**
+ * \file metrics.hpp
+ * \brief Counters and latency histograms of reader and card operations.
+ */
+
+#ifndef LOGICALACCESS_METRICS_HPP
+#define LOGICALACCESS_METRICS_HPP
+
+#include <logicalaccess/lla_fwd.hpp>
+#include <logicalaccess/utils.hpp>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief Metric labels, by label name.
+ */
+typedef std::map<std::string, std::string> MetricLabels;
+
+/**
+ * \brief A monotonic counter.
+ */
+class LLA_CORE_API MetricCounter
+{
+  public:
+    MetricCounter();
+
+    void increment(uint64_t value = 1);
+
+    uint64_t getValue() const;
+
+    void reset();
+
+  private:
+    std::atomic<uint64_t> value_;
+};
+
+/**
+ * \brief A latency histogram, in microseconds, with fixed buckets.
+ */
+class LLA_CORE_API MetricHistogram
+{
+  public:
+    /**
+     * \brief Number of buckets, the last one without upper bound.
+     */
+    static const size_t BUCKET_COUNT = 19;
+
+    /**
+     * \brief Get the upper bound of each bucket but the last, in microseconds.
+     */
+    static const std::array<uint64_t, BUCKET_COUNT - 1> &getBounds();
+
+    MetricHistogram();
+
+    /**
+     * \brief Record a latency, in microseconds.
+     */
+    void observe(uint64_t micro);
+
+    uint64_t getCount() const;
+
+    /**
+     * \brief Get the sum of the recorded latencies, in microseconds.
+     */
+    uint64_t getSum() const;
+
+    /**
+     * \brief Get the number of latencies of each bucket (not cumulative).
+     */
+    std::array<uint64_t, BUCKET_COUNT> getBucketCounts() const;
+
+    /**
+     * \brief Estimate a quantile, in microseconds, by interpolating inside its
+     * bucket. Returns 0 without values.
+     * \param quantile The quantile, between 0 and 1.
+     */
+    double getQuantile(double quantile) const;
+
+    void reset();
+
+  private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+
+    std::atomic<uint64_t> sum_;
+};
+
+/**
+ * \brief The values of a metric, for the pull API.
+ */
+struct LLA_CORE_API MetricSnapshot
+{
+    std::string name;
+    MetricLabels labels;
+
+    /**
+     * \brief True for a histogram, false for a counter.
+     */
+    bool histogram;
+
+    /**
+     * \brief Counter value, or number of histogram values.
+     */
+    uint64_t count;
+
+    /**
+     * \brief Histogram values, in microseconds.
+     */
+    uint64_t sum;
+    std::array<uint64_t, MetricHistogram::BUCKET_COUNT> buckets;
+    double p50;
+    double p99;
+};
+
+/**
+ * \brief Registry of the metrics of the library.
+ *
+ * Metrics are identified by name and labels, and created on first use. They
+ * are never removed: references returned stay valid. The library records:
+ *  - lla_transport_command: DataTransport::sendCommand, by reader and transport.
+ *  - lla_card_command: ReaderCardAdapter::sendCommand, by reader and card.
+ *  - lla_authentication: card authentications, by reader and card.
+ *  - lla_wait_insertion: waitInsertion, by reader.
+ * Each has a "_seconds" histogram and a "_total" counter by result.
+ */
+class LLA_CORE_API MetricsRegistry
+{
+  public:
+    static MetricsRegistry &getInstance();
+
+    /**
+     * \brief Enable or disable the recording of the library metrics. Enabled
+     * by default.
+     */
+    void setEnabled(bool enabled);
+
+    bool isEnabled() const;
+
+    MetricCounter &getCounter(const std::string &name, const MetricLabels &labels);
+
+    MetricHistogram &getHistogram(const std::string &name, const MetricLabels &labels);
+
+    /**
+     * \brief Get the values of every metric.
+     */
+    std::vector<MetricSnapshot> collect() const;
+
+    /**
+     * \brief Format every metric in the Prometheus text exposition format.
+     * Histograms are exported in seconds.
+     */
+    std::string toPrometheus() const;
+
+    /**
+     * \brief Reset every metric to zero.
+     */
+    void reset();
+
+  private:
+    MetricsRegistry();
+
+    typedef std::pair<std::string, MetricLabels> MetricKey;
+
+    mutable std::mutex mutex_;
+
+    std::atomic<bool> enabled_;
+
+    std::map<MetricKey, std::unique_ptr<MetricCounter>> counters_;
+
+    std::map<MetricKey, std::unique_ptr<MetricHistogram>> histograms_;
+};
+
+/**
+ * \brief The "<name>_seconds" histogram and "<name>_total" counters of an
+ * operation for given labels, resolved once in the registry. Keeping it, per
+ * reader or adapter, records an operation without any registry lookup.
+ */
+class LLA_CORE_API LatencyMetrics
+{
+  public:
+    LatencyMetrics(const std::string &name, const MetricLabels &labels);
+
+    /**
+     * \brief Get a label value, empty if the label is not set.
+     */
+    const std::string &getLabel(const std::string &label) const;
+
+    /**
+     * \brief Record the latency, in microseconds, and the result of an operation.
+     */
+    void record(uint64_t micro, const std::string &result) const;
+
+  private:
+    std::string name_;
+
+    MetricLabels labels_;
+
+    MetricHistogram &histogram_;
+
+    MetricCounter &ok_;
+
+    MetricCounter &error_;
+};
+
+/**
+ * \brief Record the latency and the result of an operation on destruction,
+ * in the "<name>_seconds" histogram and the "<name>_total" counter.
+ *
+ * The result is "error" unless set, when an exception leaves the operation.
+ */
+class LLA_CORE_API LatencyRecorder
+{
+  public:
+    LatencyRecorder(const std::string &name, const MetricLabels &labels);
+
+    /**
+     * \brief Record in metrics already resolved.
+     * \param metrics The metrics, null to record nothing (metrics disabled).
+     */
+    explicit LatencyRecorder(std::shared_ptr<const LatencyMetrics> metrics);
+
+    ~LatencyRecorder();
+
+    LatencyRecorder(const LatencyRecorder &) = delete;
+    LatencyRecorder &operator=(const LatencyRecorder &) = delete;
+
+    void setResult(const std::string &result);
+
+    /**
+     * \brief Set the "ok" result.
+     */
+    void succeed();
+
+  private:
+    std::shared_ptr<const LatencyMetrics> metrics_;
+
+    std::string result_;
+
+    ElapsedTimeCounter counter_;
+};
+
+/**
+ * \brief Record a card authentication in the lla_authentication metrics,
+ * labelled with the reader and card of the commands. Authentications nested in
+ * another one, in the same thread, are part of it and not recorded.
+ */
+class LLA_CORE_API AuthenticationRecorder
+{
+  public:
+    explicit AuthenticationRecorder(const Commands &commands);
+
+    ~AuthenticationRecorder();
+
+    AuthenticationRecorder(const AuthenticationRecorder &) = delete;
+    AuthenticationRecorder &operator=(const AuthenticationRecorder &) = delete;
+
+    void setResult(const std::string &result);
+
+    void succeed();
+
+  private:
+    std::unique_ptr<LatencyRecorder> recorder_;
+};
+}
+
+#endif /* LOGICALACCESS_METRICS_HPP */
@@ -115,6 +115,12 @@ class LLA_CORE_API DataTransport : public XmlSerializable
      * \brief The last command.
      */
     ByteVector d_lastCommand;
+
+  private:
+    /**
+     * \brief The command metrics, resolved again only when the reader changes.
+     */
+    std::shared_ptr<const LatencyMetrics> d_commandMetrics;
 };
 }
 
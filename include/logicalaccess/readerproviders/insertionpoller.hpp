@@ -0,0 +1,241 @@
+/**
+ * \file insertionpoller.hpp
+ * \brief Card insertion/removal detection for readers without card events.
+ */
+
+#ifndef LOGICALACCESS_INSERTIONPOLLER_HPP
+#define LOGICALACCESS_INSERTIONPOLLER_HPP
+
+#include <logicalaccess/lla_fwd.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace logicalaccess
+{
+/**
+ * \brief Poll a reader for card presence with an adaptive interval.
+ *
+ * The reader unit provides a scan function returning the chip in the field,
+ * if any. The scan is repeated with the minimum interval right after a card
+ * removal, then the interval is doubled on each empty scan up to the maximum
+ * interval. Data received on the reader transport while the poller sleeps
+ * (unsolicited frames) wake it up for an immediate scan at the minimum
+ * interval. The answers to the scans are not unsolicited: they change neither
+ * the wait nor the backoff.
+ *
+ * waitInsertion() and waitRemoval() are blocking helpers for the ReaderUnit
+ * methods of the same name. start() instead polls from a background thread
+ * and reports card presence through callbacks; the blocking helpers must not
+ * be used while it runs.
+ */
+class LLA_CORE_API InsertionPoller : public std::enable_shared_from_this<InsertionPoller>
+{
+  public:
+    /**
+     * \brief Scan the field, returns the detected chip or null.
+     */
+    typedef std::function<std::shared_ptr<Chip>()> ScanFunction;
+
+    /**
+     * \brief Card presence callback.
+     */
+    typedef std::function<void(std::shared_ptr<Chip>)> ChipCallback;
+
+    /**
+     * \brief Wait without time limit.
+     */
+    static const unsigned int WAIT_FOREVER;
+
+    /**
+     * \brief Constructor.
+     * \param scan The scan function.
+     */
+    explicit InsertionPoller(ScanFunction scan);
+
+    /**
+     * \brief Destructor. Stop the background polling.
+     */
+    ~InsertionPoller();
+
+    InsertionPoller(const InsertionPoller &) = delete;
+    InsertionPoller &operator=(const InsertionPoller &) = delete;
+
+    /**
+     * \brief Set the scan used while waiting for a removal, for readers that
+     * only report new cards. Defaults to the insertion scan.
+     */
+    void setRemovalScan(ScanFunction scan);
+
+    /**
+     * \brief Set the insertion polling intervals, in milliseconds.
+     * \param minInterval Interval right after a removal or a wake-up.
+     * \param maxInterval Interval reached by backoff when idle.
+     */
+    void setIntervals(unsigned int minInterval, unsigned int maxInterval);
+
+    unsigned int getMinInterval() const;
+
+    unsigned int getMaxInterval() const;
+
+    /**
+     * \brief Set how long the minimum interval is kept after a removal, in
+     * milliseconds.
+     */
+    void setFastPollingDuration(unsigned int duration);
+
+    unsigned int getFastPollingDuration() const;
+
+    /**
+     * \brief Set the removal polling interval, in milliseconds.
+     */
+    void setRemovalInterval(unsigned int interval);
+
+    unsigned int getRemovalInterval() const;
+
+    /**
+     * \brief Wait for a card. The field is scanned at least once.
+     * \param maxwait The maximum wait time in milliseconds, or WAIT_FOREVER.
+     * \return The detected chip, or null on timeout.
+     */
+    std::shared_ptr<Chip> waitInsertion(unsigned int maxwait);
+
+    /**
+     * \brief Wait for a card removal. The card is removed when the scan
+     * returns no chip or another chip. The field is scanned at least once.
+     * \param identifier The identifier of the inserted card.
+     * \param maxwait The maximum wait time in milliseconds, or WAIT_FOREVER.
+     * \param replacement If not null, set to the other chip detected, if any.
+     * \return True if the card was removed, false on timeout.
+     */
+    bool waitRemoval(const ByteVector &identifier, unsigned int maxwait,
+                     std::shared_ptr<Chip> *replacement = nullptr);
+
+    /**
+     * \brief Interrupt the current wait for an immediate scan.
+     */
+    void wakeUp();
+
+    /**
+     * \brief Wake up on the unsolicited data received on a serial transport.
+     * Other transports are ignored.
+     * \param transport The reader data transport.
+     */
+    void listen(std::shared_ptr<DataTransport> transport);
+
+    /**
+     * \brief Start polling from a background thread.
+     * \param onInsertion Called with each inserted chip.
+     * \param onRemoval Called with each removed chip.
+     */
+    void start(ChipCallback onInsertion, ChipCallback onRemoval);
+
+    /**
+     * \brief Stop the background polling. Blocking waits in progress return.
+     * Reader units stop it in their destructor, as the scan functions call them.
+     * Called from a callback, the background thread ends once the callback
+     * returns.
+     */
+    void stop();
+
+    /**
+     * \brief Get if the background polling runs.
+     */
+    bool isStarted() const;
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * \brief Compute the deadline of a wait.
+     */
+    static Clock::time_point deadline(unsigned int maxwait);
+
+    /**
+     * \brief Sleep for an interval, until the deadline, a wake-up or stop().
+     * \param generation The stop generation when the wait started.
+     * \return False if the wait must end.
+     */
+    bool sleep(unsigned int interval, const Clock::time_point &until,
+               unsigned int generation);
+
+    /**
+     * \brief Wait for a card, until the deadline or stop().
+     */
+    std::shared_ptr<Chip> waitInsertion(const Clock::time_point &until,
+                                        unsigned int generation);
+
+    /**
+     * \brief Wait for a card removal, until the deadline or stop().
+     */
+    bool waitRemoval(const ByteVector &identifier, const Clock::time_point &until,
+                     unsigned int generation, std::shared_ptr<Chip> *replacement);
+
+    /**
+     * \brief Background polling thread body.
+     */
+    void run(ChipCallback onInsertion, ChipCallback onRemoval, unsigned int generation);
+
+    /**
+     * \brief Join a stopped background thread, or detach it from itself.
+     */
+    static void joinThread(std::thread &thread);
+
+    /**
+     * \brief Called with each data received on the transport.
+     */
+    void onData();
+
+    ScanFunction d_scan;
+
+    ScanFunction d_removalScan;
+
+    unsigned int d_minInterval;
+
+    unsigned int d_maxInterval;
+
+    unsigned int d_fastDuration;
+
+    unsigned int d_removalInterval;
+
+    /**
+     * \brief Current insertion interval, kept between waits for the backoff.
+     */
+    unsigned int d_interval;
+
+    /**
+     * \brief End of the fast polling period.
+     */
+    Clock::time_point d_fastUntil;
+
+    mutable std::mutex d_mutex;
+
+    std::condition_variable d_condition;
+
+    bool d_wakeUp;
+
+    /**
+     * \brief True while waiting between two insertion scans: data received
+     * then are unsolicited.
+     */
+    bool d_sleeping;
+
+    /**
+     * \brief Incremented by each stop(): the waits started before end.
+     */
+    unsigned int d_stopGeneration;
+
+    /**
+     * \brief The stop generation of the background thread.
+     */
+    unsigned int d_runGeneration;
+
+    std::thread d_thread;
+};
+}
+
+#endif /* LOGICALACCESS_INSERTIONPOLLER_HPP */
@@ -0,0 +1,104 @@
+/**
+ * \file readermonitor.hpp
+ * \brief Reader hot-plug monitoring.
+ */
+
+#ifndef LOGICALACCESS_READERMONITOR_HPP
+#define LOGICALACCESS_READERMONITOR_HPP
+
+#include <logicalaccess/readerproviders/readerprovider.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace logicalaccess
+{
+/**
+ * \brief Report the readers plugged and unplugged on a reader provider.
+ *
+ * A background thread waits for reader list changes with
+ * ReaderProvider::waitReaderListChange(), refreshes the provider reader list
+ * and compares it with the previous one, by reader name. The provider reader
+ * list is refreshed from the monitor thread: the reader list of the provider
+ * must not be used concurrently while the monitor runs.
+ */
+class LLA_CORE_API ReaderMonitor
+{
+  public:
+    /**
+     * \brief Reader event callback.
+     */
+    typedef std::function<void(std::shared_ptr<ReaderUnit>)> ReaderCallback;
+
+    /**
+     * \brief Constructor.
+     * \param provider The reader provider to monitor.
+     */
+    explicit ReaderMonitor(std::shared_ptr<ReaderProvider> provider);
+
+    /**
+     * \brief Destructor. Stop the monitoring.
+     */
+    ~ReaderMonitor();
+
+    ReaderMonitor(const ReaderMonitor &) = delete;
+    ReaderMonitor &operator=(const ReaderMonitor &) = delete;
+
+    /**
+     * \brief Start the monitoring. The readers already plugged are reported
+     * as added.
+     * \param onAdded Called with each plugged reader.
+     * \param onRemoved Called with each unplugged reader.
+     */
+    void start(ReaderCallback onAdded, ReaderCallback onRemoved);
+
+    /**
+     * \brief Stop the monitoring.
+     */
+    void stop();
+
+    /**
+     * \brief Get if the monitoring runs.
+     */
+    bool isStarted() const;
+
+    /**
+     * \brief Set the maximum time between two checks of the stop request, in
+     * milliseconds. Reader changes are reported as soon as the provider
+     * notifies them.
+     */
+    void setStopLatency(unsigned int latency);
+
+    unsigned int getStopLatency() const;
+
+  private:
+    /**
+     * \brief Monitoring thread body.
+     */
+    void run(ReaderCallback onAdded, ReaderCallback onRemoved);
+
+    /**
+     * \brief Refresh the provider reader list and report the differences.
+     */
+    void update(const ReaderCallback &onAdded, const ReaderCallback &onRemoved);
+
+    std::shared_ptr<ReaderProvider> d_provider;
+
+    /**
+     * \brief The readers last reported, by name.
+     */
+    std::map<std::string, std::shared_ptr<ReaderUnit>> d_readers;
+
+    unsigned int d_stopLatency;
+
+    mutable std::mutex d_mutex;
+
+    bool d_stopping;
+
+    std::thread d_thread;
+};
+}
+
+#endif /* LOGICALACCESS_READERMONITOR_HPP */
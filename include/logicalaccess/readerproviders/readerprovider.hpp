@@ -61,6 +61,18 @@ class LLA_CORE_API ReaderProvider
     virtual const ReaderList waitForReaders(std::vector<std::string> readers,
                                             double maxwait, bool all);
 
+    /**
+     * \brief Wait for a change of the system reader list (reader plugged or
+     * unplugged).
+     *
+     * Providers with hot-plug notifications return as soon as the change is
+     * notified. The default implementation cannot know about changes: it
+     * returns true after a polling period of up to one second.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the reader list may have changed, false on timeout.
+     */
+    virtual bool waitReaderListChange(unsigned int maxwait);
+
     /**
      * \brief Get the reader provider type.
      * \return The reader provider type.
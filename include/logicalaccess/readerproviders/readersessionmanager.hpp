@@ -0,0 +1,260 @@
+/**
+ * \file readersessionmanager.hpp
+ * \brief Drive many reader units in parallel from a bounded thread pool.
+ */
+
+#ifndef LOGICALACCESS_READERSESSIONMANAGER_HPP
+#define LOGICALACCESS_READERSESSIONMANAGER_HPP
+
+#include <logicalaccess/readerproviders/readerunit.hpp>
+#include <logicalaccess/utils.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief Operation statistics of a reader unit.
+ */
+struct LLA_CORE_API ReaderSessionStatistics
+{
+    /**
+     * \brief The reader unit.
+     */
+    std::shared_ptr<ReaderUnit> reader;
+
+    /**
+     * \brief The number of operations waiting to run.
+     */
+    size_t queueDepth;
+
+    /**
+     * \brief True if an operation is running.
+     */
+    bool busy;
+
+    /**
+     * \brief The number of operations which returned.
+     */
+    size_t completed;
+
+    /**
+     * \brief The number of operations which threw an exception.
+     */
+    size_t failed;
+
+    /**
+     * \brief The total time spent by the operations in the queue, in
+     * microseconds.
+     */
+    uint64_t totalWaitTime;
+
+    /**
+     * \brief The total run time of the operations, in microseconds.
+     */
+    uint64_t totalRunTime;
+
+    /**
+     * \brief The maximum latency (queue and run time) of an operation, in
+     * microseconds.
+     */
+    uint64_t maxLatency;
+};
+
+/**
+ * \brief Run operations on a set of reader units from a bounded thread pool.
+ *
+ * The operations of a reader unit run one at a time, in submission order,
+ * as reader units aren't thread-safe. Operations on different reader units
+ * run in parallel on the pool threads. Blocking operations, such as
+ * waitInsertion(), keep a thread busy until they return: use bounded waits
+ * when the pool is smaller than the number of reader units.
+ */
+class LLA_CORE_API ReaderSessionManager
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param threads The number of pool threads.
+     */
+    explicit ReaderSessionManager(unsigned int threads = 4);
+
+    /**
+     * \brief Destructor. Stop the manager.
+     */
+    ~ReaderSessionManager();
+
+    ReaderSessionManager(const ReaderSessionManager &) = delete;
+    ReaderSessionManager &operator=(const ReaderSessionManager &) = delete;
+
+    /**
+     * \brief Add a reader unit to the managed set.
+     * \param reader The reader unit.
+     */
+    void addReader(std::shared_ptr<ReaderUnit> reader);
+
+    /**
+     * \brief Remove a reader unit from the managed set. The running operation
+     * completes; the futures of the queued ones report a broken promise.
+     * \param reader The reader unit.
+     */
+    void removeReader(std::shared_ptr<ReaderUnit> reader);
+
+    /**
+     * \brief Get the managed reader units.
+     */
+    std::vector<std::shared_ptr<ReaderUnit>> getReaders() const;
+
+    /**
+     * \brief Queue an operation on a reader unit.
+     * \param reader The managed reader unit.
+     * \param operation The operation, called with the reader unit.
+     * \return The operation result. Exceptions thrown by the operation are
+     * rethrown by the future.
+     */
+    template <typename F>
+    std::future<typename std::result_of<F(std::shared_ptr<ReaderUnit>)>::type>
+    post(std::shared_ptr<ReaderUnit> reader, F operation)
+    {
+        typedef typename std::result_of<F(std::shared_ptr<ReaderUnit>)>::type Result;
+        auto promise = std::make_shared<std::promise<Result>>();
+        std::future<Result> ret = promise->get_future();
+        enqueue(reader, [promise, operation, reader](std::function<void()> &complete) {
+            try
+            {
+                complete = Call<Result>::run(promise, operation, reader);
+            }
+            catch (...)
+            {
+                std::exception_ptr error = std::current_exception();
+                complete = [promise, error]() { promise->set_exception(error); };
+                return false;
+            }
+            return true;
+        });
+        return ret;
+    }
+
+    /**
+     * \brief Queue a card insertion wait.
+     * \param reader The managed reader unit.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return The inserted chip, or null on timeout.
+     */
+    std::future<std::shared_ptr<Chip>> waitInsertion(std::shared_ptr<ReaderUnit> reader,
+                                                     unsigned int maxwait);
+
+    /**
+     * \brief Queue a card removal wait.
+     * \param reader The managed reader unit.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the card was removed, false on timeout.
+     */
+    std::future<bool> waitRemoval(std::shared_ptr<ReaderUnit> reader,
+                                  unsigned int maxwait);
+
+    /**
+     * \brief Get the statistics of all managed reader units.
+     */
+    std::vector<ReaderSessionStatistics> getStatistics() const;
+
+    /**
+     * \brief Stop the pool threads. Running operations complete, queued ones
+     * are dropped.
+     */
+    void stop();
+
+  private:
+    /**
+     * \brief Run an operation, returning the function setting its promise.
+     */
+    template <typename R>
+    struct Call
+    {
+        template <typename F>
+        static std::function<void()> run(std::shared_ptr<std::promise<R>> promise,
+                                         F &operation, std::shared_ptr<ReaderUnit> reader)
+        {
+            auto result = std::make_shared<R>(operation(reader));
+            return [promise, result]() { promise->set_value(std::move(*result)); };
+        }
+    };
+
+    /**
+     * \brief A queued operation. Returns false if it failed.
+     *
+     * The operation doesn't set its promise but the function it completes,
+     * called once the statistics are updated: a caller getting the result
+     * sees the statistics of the operation.
+     */
+    struct Task
+    {
+        std::function<bool(std::function<void()> &)> operation;
+
+        ElapsedTimeCounter queued;
+    };
+
+    /**
+     * \brief The operation queue and statistics of a reader unit.
+     */
+    struct Session
+    {
+        ReaderSessionStatistics statistics;
+
+        std::deque<Task> tasks;
+
+        /**
+         * \brief True if the session is in the ready list or running.
+         */
+        bool scheduled;
+    };
+
+    /**
+     * \brief Queue an operation on a reader unit.
+     */
+    void enqueue(std::shared_ptr<ReaderUnit> reader,
+                 std::function<bool(std::function<void()> &)> operation);
+
+    /**
+     * \brief Pool thread body.
+     */
+    void run();
+
+    std::map<ReaderUnit *, std::shared_ptr<Session>> d_sessions;
+
+    /**
+     * \brief Sessions with queued operations and no running one, in order.
+     */
+    std::deque<std::shared_ptr<Session>> d_ready;
+
+    mutable std::mutex d_mutex;
+
+    std::condition_variable d_condition;
+
+    bool d_stopping;
+
+    std::vector<std::thread> d_threads;
+};
+
+template <>
+struct ReaderSessionManager::Call<void>
+{
+    template <typename F>
+    static std::function<void()> run(std::shared_ptr<std::promise<void>> promise,
+                                     F &operation, std::shared_ptr<ReaderUnit> reader)
+    {
+        operation(reader);
+        return [promise]() { promise->set_value(); };
+    }
+};
+}
+
+#endif /* LOGICALACCESS_READERSESSIONMANAGER_HPP */
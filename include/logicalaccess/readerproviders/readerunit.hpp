@@ -17,6 +17,7 @@
 #include <logicalaccess/techno.hpp>
 #include <logicalaccess/cardprobe.hpp>
 #include <logicalaccess/services/reader_service.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
 #define PLUGINOBJECT_MAXLEN 64
 
 namespace logicalaccess
@@ -28,6 +29,7 @@ class DataTransport;
 class CardsFormatComposite;
 class ReaderFormatComposite;
 class ReaderProvider;
+class InsertionPoller;
 
 /**
  * \brief The card types.
@@ -150,12 +152,30 @@ class LLA_CORE_API ReaderUnit : public XmlSerializable,
      */
     virtual std::shared_ptr<Chip> getSingleChip() = 0;
 
+    /**
+     * \brief Get the chip detected by the last card insertion, without any
+     * communication with the reader.
+     * \return The inserted chip, or null.
+     */
+    std::shared_ptr<Chip> getInsertedChip() const
+    {
+        return d_insertedChip;
+    }
+
     /**
      * \brief Get chip available in the RFID rang.
      * \return The chip list.
      */
     virtual std::vector<std::shared_ptr<Chip>> getChipList() = 0;
 
+    /**
+     * \brief Get all the chips in the RFID range in one call, using the reader
+     * anticollision when supported.
+     * \return The chip list. Readers without multi-target support return the
+     * same list as getChipList().
+     */
+    virtual std::vector<std::shared_ptr<Chip>> inventory();
+
     /**
      * \brief Get the number from the reader format composite.
      * \param chip The chip object.
@@ -269,6 +289,25 @@ class LLA_CORE_API ReaderUnit : public XmlSerializable,
      */
     virtual void setDataTransport(std::shared_ptr<DataTransport> dataTransport);
 
+    /**
+     * \brief Get the insertion poller of readers without card events.
+     * \return The insertion poller, or null if the reader doesn't poll.
+     */
+    std::shared_ptr<InsertionPoller> getInsertionPoller() const;
+
+    /**
+     * \brief Set the log levels enabled while communicating with the reader
+     * and polling for cards. Other reader units are not affected.
+     * \param mask The enabled log levels.
+     */
+    void setLogMask(LogLevelMask mask);
+
+    /**
+     * \brief Get the log levels enabled for the reader unit.
+     * \return The enabled log levels.
+     */
+    LogLevelMask getLogMask() const;
+
     /**
      * \brief Get a string hexadecimal representation of the reader serial number
      * \return The reader serial number or an empty string on error.
@@ -404,6 +443,16 @@ class LLA_CORE_API ReaderUnit : public XmlSerializable,
      */
     std::shared_ptr<Chip> d_insertedChip;
 
+    /**
+     * \brief The insertion poller, set by readers polling for cards.
+     */
+    std::shared_ptr<InsertionPoller> d_insertionPoller;
+
+    /**
+     * \brief The log levels enabled for the reader unit.
+     */
+    LogLevelMask d_logMask;
+
     /**
      * \brief The inserted chip.
      */
@@ -0,0 +1,222 @@
+/**
+ * \file readerunitconfigstore.hpp
+ * \brief Process-wide cache of reader unit configuration files.
+ */
+
+#ifndef LOGICALACCESS_READERUNITCONFIGSTORE_HPP
+#define LOGICALACCESS_READERUNITCONFIGSTORE_HPP
+
+#include <logicalaccess/lla_core_api.hpp>
+#include <logicalaccess/lla_fwd.hpp>
+
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace logicalaccess
+{
+/**
+ * \brief Process-wide cache of a reader unit configuration file, like
+ * ReaderUnit.config.
+ *
+ * Reader units are created on the insertion path (e.g. PC/SC proxy reader
+ * units), so they read their configuration from this store instead of the
+ * file. The file is loaded on first use, then a background thread, shared by
+ * every store, checks it for changes: when it is created, modified or removed,
+ * the new configuration is published and the listeners notified. Getting the
+ * configuration does no filesystem I/O.
+ */
+class LLA_CORE_API ReaderUnitConfigStore
+{
+  public:
+    /**
+     * \brief A loaded configuration. It never changes once published.
+     */
+    struct Config
+    {
+        Config();
+
+        /**
+         * \brief The card type forced on reader units (config.cardType).
+         */
+        std::string cardType;
+    };
+
+    typedef std::function<void(std::shared_ptr<const Config>)> Listener;
+
+    /**
+     * \brief Default interval between two checks of the file, in milliseconds.
+     */
+    static const unsigned int DEFAULT_WATCH_INTERVAL = 2000;
+
+    /**
+     * \brief Get the store of a configuration file.
+     * \param name The file name, in the current directory.
+     */
+    static ReaderUnitConfigStore &
+    getInstance(const std::string &name = "ReaderUnit.config");
+
+    ~ReaderUnitConfigStore();
+
+    ReaderUnitConfigStore(const ReaderUnitConfigStore &) = delete;
+
+    ReaderUnitConfigStore &operator=(const ReaderUnitConfigStore &) = delete;
+
+    /**
+     * \brief Get the current configuration.
+     * \return The configuration, never null.
+     */
+    std::shared_ptr<const Config> getConfig() const;
+
+    /**
+     * \brief Set the configuration file, and load it.
+     * \param filename The file. When empty, the store file name in the current
+     * directory, resolved at each check.
+     */
+    void setFilename(const std::string &filename);
+
+    /**
+     * \brief Get the configuration file.
+     * \return The file.
+     */
+    std::string getFilename() const;
+
+    /**
+     * \brief Set the interval between two checks of the file.
+     * \param interval The interval in milliseconds, 0 to stop watching.
+     */
+    void setWatchInterval(unsigned int interval);
+
+    /**
+     * \brief Check the file now, and publish its configuration if it changed.
+     * \return True if a new configuration was published.
+     */
+    bool refresh();
+
+    /**
+     * \brief Add a listener, called from the watching thread with each new
+     * configuration. It is called without the store locked, so it may call
+     * refresh() or setFilename().
+     * \param listener The listener.
+     * \return The listener identifier, for removeListener().
+     */
+    size_t addListener(Listener listener);
+
+    /**
+     * \brief Remove a listener.
+     * \param id The listener identifier.
+     */
+    void removeListener(size_t id);
+
+  private:
+    /**
+     * \brief What the file looked like when it was last loaded.
+     */
+    struct FileState
+    {
+        FileState();
+
+        /**
+         * \brief Compare the content.
+         */
+        bool operator==(const FileState &other) const;
+
+        /**
+         * \brief Compare the status, without reading the file.
+         */
+        bool sameStatus(const FileState &other) const;
+
+        /**
+         * \brief Check if the file was modified within the modification time
+         * resolution, so that its status may not show a new modification.
+         */
+        bool isRecent() const;
+
+        std::string filename;
+
+        bool exists;
+
+        size_t size;
+
+        std::time_t lastWrite;
+
+        /**
+         * \brief Hash of the content, only set once the file is read.
+         */
+        size_t contentHash;
+    };
+
+    class Watcher;
+
+    explicit ReaderUnitConfigStore(const std::string &name);
+
+    std::string resolveFilename() const;
+
+    /**
+     * \brief Get the file status, without reading it.
+     */
+    static FileState getFileState(const std::string &filename);
+
+    /**
+     * \brief Read the file, and set the size and hash of its content.
+     * \return The file content, empty if it does not exist.
+     */
+    static std::string readFile(FileState &state);
+
+    static std::shared_ptr<const Config> load(const std::string &content);
+
+    /**
+     * \brief Load the file if it changed, or if forced.
+     */
+    bool update(bool force);
+
+    /**
+     * \brief Notify the listeners of a configuration, unless a newer one was
+     * published.
+     */
+    void notify(std::shared_ptr<const Config> config, unsigned int version);
+
+    mutable std::mutex d_mutex;
+
+    /**
+     * \brief Serializes the loads, so that listeners see them in order.
+     */
+    std::mutex d_loadMutex;
+
+    /**
+     * \brief Serializes the notifications. Recursive, for the listeners
+     * refreshing the store.
+     */
+    std::recursive_mutex d_notifyMutex;
+
+    std::shared_ptr<const Config> d_config;
+
+    /**
+     * \brief Incremented with each published configuration.
+     */
+    unsigned int d_configVersion;
+
+    FileState d_fileState;
+
+    /**
+     * \brief The file name, in the current directory.
+     */
+    const std::string d_name;
+
+    /**
+     * \brief The file, when set with setFilename().
+     */
+    std::string d_filename;
+
+    unsigned int d_watchInterval;
+
+    std::map<size_t, Listener> d_listeners;
+
+    size_t d_nextListenerId;
+};
+}
+
+#endif /* LOGICALACCESS_READERUNITCONFIGSTORE_HPP */
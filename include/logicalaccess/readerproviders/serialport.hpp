@@ -18,7 +18,9 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/circular_buffer.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <atomic>
 #include <condition_variable>
+#include <functional>
 
 #include <logicalaccess/readerproviders/readerunit.hpp>
 #include <logicalaccess/readerproviders/circularbufferparser.hpp>
@@ -203,6 +205,12 @@ class LLA_CORE_API SerialPort
      */
     void dataConsumed();
 
+    /**
+     * Set a function called from the reading thread each time data is
+     * received, solicited or not. An empty function removes the listener.
+     */
+    void setDataListener(std::function<void()> listener);
+
   private:
     void do_read(const boost::system::error_code &e, size_t bytes_transferred);
 
@@ -239,6 +247,14 @@ class LLA_CORE_API SerialPort
     std::condition_variable cond_var_;
     bool data_flag_;
     std::mutex cond_var_mutex_;
+
+    std::function<void()> data_listener_;
+
+    /**
+     * The log levels of the thread which wrote last, applied to the logs of
+     * the reader thread.
+     */
+    std::atomic<LogLevelMask> log_mask_;
 };
 }
 
@@ -64,9 +64,51 @@ class LLA_CORE_API SerialPortXml : public XmlSerializable
     static bool
     EnumerateUsingCreateFile(std::vector<std::shared_ptr<SerialPortXml>> &ports);
 
+    /**
+     * \brief Wait for a serial port to be plugged or unplugged. The list is
+     * only watched during the call: prefer a SerialPortListWatcher, which
+     * doesn't miss the changes between two calls.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the serial port list may have changed, false on timeout.
+     */
+    static bool WaitPortListChange(unsigned int maxwait);
+
   protected:
     std::shared_ptr<SerialPort> d_serialport;
 };
+
+/**
+ * \brief Watch the serial port list for plugged or unplugged serial ports. On
+ * Linux, the serial device nodes are watched with inotify from the
+ * construction, so that changes between two waits are reported by the next
+ * one. Other systems poll: wait() returns after at most one second and reports
+ * a possible change every time, so the callers enumerate the ports again.
+ */
+class LLA_CORE_API SerialPortListWatcher
+{
+  public:
+    SerialPortListWatcher();
+
+    ~SerialPortListWatcher();
+
+    SerialPortListWatcher(const SerialPortListWatcher &) = delete;
+    SerialPortListWatcher &operator=(const SerialPortListWatcher &) = delete;
+
+    /**
+     * \brief Wait for a change of the serial port list since the previous wait,
+     * or since the construction.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the serial port list may have changed, false on timeout.
+     * Always true when polling.
+     */
+    bool wait(unsigned int maxwait);
+
+  private:
+    /**
+     * \brief The inotify descriptor, -1 when polling.
+     */
+    int d_fd;
+};
 }
 
 #endif /* SERIALPORTXML_HPP */
\ No newline at end of file
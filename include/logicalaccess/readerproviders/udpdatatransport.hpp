@@ -9,6 +9,7 @@
 
 #include <logicalaccess/readerproviders/datatransport.hpp>
 #include <boost/asio.hpp>
+#include <boost/asio/deadline_timer.hpp>
 
 namespace logicalaccess
 {
@@ -111,8 +112,27 @@ class LLA_CORE_API UDPDataTransport : public DataTransport
 
     void send(const ByteVector &data) override;
 
+    /**
+     * \brief Receive the next datagram from the reader.
+     * \param timeout Time waiting for data, in milliseconds. 0 waits forever.
+     * \return The datagram, or an empty buffer on timeout.
+     *
+     * Datagrams that are not sent by the reader endpoint are dropped.
+     */
     ByteVector receive(long int timeout) override;
 
+    /**
+     * \brief Socket readable
+     * \param error Wait error
+     */
+    void read_complete(const boost::system::error_code &error);
+
+    /**
+     * \brief Read timeout
+     * \param error Read timeout or canceled
+     */
+    void time_out(const boost::system::error_code &error);
+
   protected:
     /**
      * \brief Client socket use to communicate with the reader.
@@ -124,6 +144,16 @@ class LLA_CORE_API UDPDataTransport : public DataTransport
      */
     boost::asio::io_service ios;
 
+    /**
+     * \brief Read deadline timer
+     */
+    boost::asio::deadline_timer d_timer;
+
+    /**
+     * \brief Read error
+     */
+    bool d_read_error;
+
     /**
      * \brief The ip address
      */
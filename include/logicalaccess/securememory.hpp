@@ -0,0 +1,91 @@
+/**
+ * \file securememory.hpp
+ * \brief Locked, zeroized on free, memory for key material.
+ */
+
+#ifndef LOGICALACCESS_SECUREMEMORY_HPP
+#define LOGICALACCESS_SECUREMEMORY_HPP
+
+#include <logicalaccess/lla_core_api.hpp>
+#include <logicalaccess/lla_fwd.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief Allocate zeroed memory in the OpenSSL secure heap, a single arena locked
+ * in RAM so that it is not swapped out. The arena is best effort: when it cannot
+ * be locked (locked memory limit of the process) or is full, the memory is only
+ * zeroized on free.
+ * \param size The size in bytes.
+ * \return The memory, never null.
+ */
+LLA_CORE_API void *secureAllocate(size_t size);
+
+/**
+ * \brief Zeroize and free memory allocated with secureAllocate().
+ * \param ptr The memory.
+ * \param size The size in bytes.
+ */
+LLA_CORE_API void secureFree(void *ptr, size_t size);
+
+/**
+ * \brief Zeroize memory, in a way the compiler does not optimize out.
+ * \param ptr The memory.
+ * \param size The size in bytes.
+ */
+LLA_CORE_API void secureZero(void *ptr, size_t size);
+
+/**
+ * \brief An allocator of secure memory, for containers of key material.
+ */
+template <typename T>
+class SecureAllocator
+{
+  public:
+    typedef T value_type;
+
+    SecureAllocator() = default;
+
+    template <typename U>
+    SecureAllocator(const SecureAllocator<U> &)
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+            throw std::bad_alloc();
+        return static_cast<T *>(secureAllocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n)
+    {
+        secureFree(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const SecureAllocator<U> &) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const SecureAllocator<U> &) const
+    {
+        return false;
+    }
+};
+
+/**
+ * \brief A byte vector in secure memory. Buffers released when it grows or is
+ * destroyed are zeroized.
+ */
+typedef std::vector<uint8_t, SecureAllocator<uint8_t>> SecureByteVector;
+}
+
+#endif /* LOGICALACCESS_SECUREMEMORY_HPP */
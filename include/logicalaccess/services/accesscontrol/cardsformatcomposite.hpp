@@ -57,6 +57,17 @@ class LLA_CORE_API CardsFormatComposite : public XmlSerializable
     std::shared_ptr<Format> createFormatFromXml(const std::string &xmlstring,
                                                 const std::string &rootNode) const;
 
+#ifndef SWIG
+    /**
+     * \brief Create a format instance from a compiled configuration.
+     * \param config The compiled configuration.
+     * \param rootNode The root node.
+     * \return The format instance.
+     */
+    std::shared_ptr<Format> createFormatFromCompiled(const CompiledConfiguration &config,
+                                                     const std::string &rootNode) const;
+#endif
+
     /**
      * \brief Add a format for a card type.
      * \param type The card type.
@@ -0,0 +1,329 @@
+/**
+ * \file encodingpipeline.hpp
+ * \brief Bulk encoding of credentials across several reader units.
+ */
+
+#ifndef LOGICALACCESS_ENCODINGPIPELINE_HPP
+#define LOGICALACCESS_ENCODINGPIPELINE_HPP
+
+#include <logicalaccess/services/accesscontrol/formats/format.hpp>
+#include <logicalaccess/cards/accessinfo.hpp>
+#include <logicalaccess/cards/location.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace logicalaccess
+{
+class Chip;
+class Key;
+class ReaderUnit;
+
+/**
+ * \brief A key to diversify before the card is presented.
+ */
+struct LLA_CORE_API EncodingKey
+{
+    /**
+     * \brief The key, with its key diversification. It is left unchanged: the
+     * diversified key is a copy, given to the job operations.
+     */
+    std::shared_ptr<Key> key;
+
+    /**
+     * \brief The application identifier used for diversification.
+     */
+    unsigned int aid;
+
+    /**
+     * \brief The key number used for diversification.
+     */
+    unsigned char keyno;
+};
+
+/**
+ * \brief A credential to encode.
+ */
+struct LLA_CORE_API EncodingJob
+{
+    /**
+     * \brief The format to write, with its values. Can be null if only the
+     * custom operations are required.
+     */
+    std::shared_ptr<Format> format;
+
+    /**
+     * \brief The location where to write the format.
+     */
+    std::shared_ptr<Location> location;
+
+    /**
+     * \brief The access infos used to write.
+     */
+    std::shared_ptr<AccessInfo> aiToUse;
+
+    /**
+     * \brief The access infos to write on the card, can be null.
+     */
+    std::shared_ptr<AccessInfo> aiToWrite;
+
+    /**
+     * \brief The identifier of the card to encode. Empty to encode the next
+     * presented card. Keys can only be diversified ahead of the card I/O when
+     * the identifier is known.
+     */
+    ByteVector identifier;
+
+    /**
+     * \brief The keys to diversify on the preparation threads.
+     */
+    std::vector<EncodingKey> keys;
+
+    /**
+     * \brief Additional card operations (storage writes, key changes...),
+     * called on the connected chip after the format is written, with the
+     * prepared keys in the order of keys: the diversified copies, or the keys
+     * themselves when they are not diversified.
+     */
+    std::function<void(std::shared_ptr<Chip>, const std::vector<std::shared_ptr<Key>> &)>
+        operations;
+};
+
+/**
+ * \brief Time spent in each stage of the encoding, in microseconds.
+ */
+struct LLA_CORE_API EncodingStageTimes
+{
+    /**
+     * \brief Format encoding and key diversification.
+     */
+    size_t prepare;
+
+    /**
+     * \brief Wait for the card, from the moment the reader unit was idle.
+     */
+    size_t insertion;
+
+    /**
+     * \brief Connection, format writing and custom operations.
+     */
+    size_t write;
+
+    /**
+     * \brief Wait for the card removal.
+     */
+    size_t removal;
+};
+
+/**
+ * \brief The outcome of an encoding job.
+ */
+struct LLA_CORE_API EncodingResult
+{
+    /**
+     * \brief True if the card was successfully encoded.
+     */
+    bool success;
+
+    /**
+     * \brief The error message on failure.
+     */
+    std::string error;
+
+    /**
+     * \brief The name of the reader unit that encoded the card.
+     */
+    std::string readerName;
+
+    /**
+     * \brief The identifier of the encoded card.
+     */
+    ByteVector chipIdentifier;
+
+    /**
+     * \brief Time spent in each stage.
+     */
+    EncodingStageTimes times;
+};
+
+/**
+ * \brief Cumulated metrics of an encoding pipeline.
+ */
+struct LLA_CORE_API EncodingPipelineMetrics
+{
+    /**
+     * \brief Number of cards successfully encoded.
+     */
+    size_t succeeded;
+
+    /**
+     * \brief Number of failed jobs.
+     */
+    size_t failed;
+
+    /**
+     * \brief Total time spent in each stage, for all jobs.
+     */
+    EncodingStageTimes total;
+};
+
+/**
+ * \brief Encode credentials in bulk on several reader units.
+ *
+ * Submitted jobs are first prepared by a pool of worker threads: the format
+ * is encoded and the keys are diversified while the reader units are still
+ * busy with the previous cards. Each reader unit is then driven by its own
+ * thread: it waits for a card, picks the prepared job matching the card (or
+ * the first job without identifier), writes it and waits for the card
+ * removal.
+ *
+ * A reader unit must not be used by the caller while the pipeline runs.
+ */
+class LLA_CORE_API EncodingPipeline
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param readers The connected reader units to encode with.
+     * \param prepareThreads Number of preparation threads.
+     */
+    explicit EncodingPipeline(const std::vector<std::shared_ptr<ReaderUnit>> &readers,
+                              unsigned int prepareThreads = 1);
+
+    /**
+     * \brief Destructor. Stop the pipeline.
+     */
+    ~EncodingPipeline();
+
+    EncodingPipeline(const EncodingPipeline &) = delete;
+    EncodingPipeline &operator=(const EncodingPipeline &) = delete;
+
+    /**
+     * \brief Set the polling period of the card insertion and removal, in
+     * milliseconds. Must be set before start().
+     */
+    void setPollingPeriod(unsigned int period);
+
+    /**
+     * \brief Get the polling period of the card insertion and removal.
+     */
+    unsigned int getPollingPeriod() const;
+
+    /**
+     * \brief Start the preparation and reader unit threads.
+     */
+    void start();
+
+    /**
+     * \brief Stop the pipeline. Jobs not yet encoded fail.
+     */
+    void stop();
+
+    /**
+     * \brief Submit a job.
+     * \param job The job to encode.
+     * \return The result of the job, available once the card is encoded.
+     */
+    std::future<EncodingResult> submit(const EncodingJob &job);
+
+    /**
+     * \brief Get the cumulated metrics of the encoded jobs.
+     */
+    EncodingPipelineMetrics getMetrics() const;
+
+  private:
+    /**
+     * \brief A submitted job and its state.
+     */
+    struct Task
+    {
+        EncodingJob job;
+
+        std::promise<EncodingResult> promise;
+
+        EncodingResult result;
+
+        /**
+         * \brief The prepared keys, in the order of the job keys.
+         */
+        std::vector<std::shared_ptr<Key>> keys;
+    };
+
+    /**
+     * \brief Preparation thread body.
+     */
+    void prepareLoop();
+
+    /**
+     * \brief Reader unit thread body.
+     */
+    void readerLoop(std::shared_ptr<ReaderUnit> reader);
+
+    /**
+     * \brief Encode the format and diversify the keys of a job.
+     */
+    static void prepare(Task &task);
+
+    /**
+     * \brief Take the prepared job for a card, waiting for one if none is
+     * ready yet.
+     * \return The job, or null if no job will be encoded on this card.
+     */
+    std::shared_ptr<Task> takeTask(const ByteVector &identifier);
+
+    /**
+     * \brief Write a job on the inserted card.
+     */
+    void encode(ReaderUnit &reader, Task &task);
+
+    /**
+     * \brief Publish the result of a job.
+     */
+    void complete(std::shared_ptr<Task> task);
+
+    /**
+     * \brief Fail the jobs still queued.
+     */
+    void failPending();
+
+    std::vector<std::shared_ptr<ReaderUnit>> d_readers;
+
+    unsigned int d_prepareThreads;
+
+    unsigned int d_pollingPeriod;
+
+    std::vector<std::thread> d_threads;
+
+    mutable std::mutex d_mutex;
+
+    std::condition_variable d_condition;
+
+    bool d_running;
+
+    /**
+     * \brief Submitted jobs, waiting for preparation.
+     */
+    std::deque<std::shared_ptr<Task>> d_pending;
+
+    /**
+     * \brief Prepared jobs, waiting for a card.
+     */
+    std::deque<std::shared_ptr<Task>> d_ready;
+
+    /**
+     * \brief Number of jobs being prepared.
+     */
+    size_t d_preparing;
+
+    EncodingPipelineMetrics d_metrics;
+};
+}
+
+#endif /* LOGICALACCESS_ENCODINGPIPELINE_HPP */
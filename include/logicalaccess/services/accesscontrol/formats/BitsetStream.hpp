@@ -1,4 +1,3 @@
-
 #ifndef LOGICALACCESS_BITSETSTREAM_HPP
 #define LOGICALACCESS_BITSETSTREAM_HPP
 
@@ -11,6 +10,14 @@
 
 namespace logicalaccess
 {
+/**
+ * A growable stream of bits, most significant bit first.
+ *
+ * Bits are stored in 64-bit words so that range operations (concat, writeAt,
+ * insert, extract) move up to 64 bits at a time instead of one byte at a time.
+ * The byte view returned by getData() is unchanged: bit 0 is the high weight
+ * bit of the first byte.
+ */
 class LLA_CORE_API BitsetStream
 {
   public:
@@ -34,8 +41,24 @@ class LLA_CORE_API BitsetStream
      */
     void append(unsigned char data, unsigned int readPosStart, unsigned int readLength);
 
+    /**
+     * Append between 0 and 64 bits of data.
+     * @param value Value whose low weight bits are appended, high weight first.
+     * @param length Number of bits to append.
+     */
+    void appendValue(unsigned long long value, unsigned int length);
+
     void concat(const BitsetStream &data);
 
+    /**
+     * Append a bit range of another stream.
+     * @param data Stream from where bits are read
+     * @param readPosStart Offset of the first bit to read
+     * @param readLength Number of bits to read.
+     */
+    void concat(const BitsetStream &data, unsigned int readPosStart,
+                unsigned int readLength);
+
     void concat(const ByteVector &data);
 
     void concat(const ByteVector &data, unsigned int readPosStart);
@@ -43,20 +66,64 @@ class LLA_CORE_API BitsetStream
     void concat(const ByteVector &data, unsigned int readPosStart,
                 unsigned int readLength);
 
+    /**
+     * Append a bit range of a raw byte buffer.
+     * @param data Buffer from where bits are read
+     * @param dataSize Size of the buffer, in bytes
+     * @param readPosStart Offset of the first bit to read
+     * @param readLength Number of bits to read.
+     */
+    void concat(const unsigned char *data, size_t dataSize, unsigned int readPosStart,
+                unsigned int readLength);
+
     void writeAt(unsigned int pos, unsigned char data, unsigned int readPosStart = 0,
                  unsigned int readLength = 8);
 
     void writeAt(unsigned int pos, ByteVector const &data, unsigned int readPosStart,
                  unsigned int readLength);
 
+    void writeAt(unsigned int pos, const unsigned char *data, size_t dataSize,
+                 unsigned int readPosStart, unsigned int readLength);
+
+    void writeAt(unsigned int pos, const BitsetStream &data, unsigned int readPosStart,
+                 unsigned int readLength);
+
     void insert(unsigned int pos, unsigned char data, unsigned int readPosStart = 0,
                 unsigned int readLength = 8);
 
     void insert(unsigned int pos, ByteVector const &data, unsigned int readPosStart,
                 unsigned int readLength);
 
+    void insert(unsigned int pos, const unsigned char *data, size_t dataSize,
+                unsigned int readPosStart, unsigned int readLength);
+
+    void insert(unsigned int pos, const BitsetStream &data, unsigned int readPosStart,
+                unsigned int readLength);
+
+    /**
+     * Copy a bit range into a new stream.
+     * @param pos Offset of the first bit to copy
+     * @param length Number of bits to copy.
+     */
+    BitsetStream extract(unsigned int pos, unsigned int length) const;
+
+    /**
+     * Read between 0 and 64 bits as an unsigned value, high weight bit first.
+     * @param pos Offset of the first bit to read
+     * @param length Number of bits to read.
+     */
+    unsigned long long extractValue(unsigned int pos, unsigned int length) const;
+
     ByteVector getData() const;
 
+    /**
+     * Copy the stream bytes into a caller provided buffer.
+     * @param data Destination buffer
+     * @param dataSize Size of the destination buffer, must be at least getByteSize()
+     * @return Number of bytes written.
+     */
+    size_t getData(unsigned char *data, size_t dataSize) const;
+
     unsigned int getByteSize() const;
 
     unsigned int getBitSize() const;
@@ -80,10 +147,20 @@ class LLA_CORE_API BitsetStream
     void clear();
 
   private:
-    ByteVector stream;
+    unsigned char getByte(size_t index) const;
+
+    uint64_t readBits(size_t pos, unsigned int length) const;
+
+    void orBits(size_t pos, uint64_t value, unsigned int length);
+
+    void writeBits(size_t pos, uint64_t value, unsigned int length);
+
+    void resize(size_t bitSize);
+
+    std::vector<uint64_t> stream;
 
     unsigned int _pos;
 };
 }
 
-#endif // LOGICALACCESS_BITSETSTREAM_HPP
\ No newline at end of file
+#endif // LOGICALACCESS_BITSETSTREAM_HPP
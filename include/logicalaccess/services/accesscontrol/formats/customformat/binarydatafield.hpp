@@ -34,6 +34,12 @@ class LLA_CORE_API BinaryFieldValue : public Key
     explicit BinaryFieldValue(const ByteVector &buf);
 
     virtual ~BinaryFieldValue() = default;
+    /**
+     * \brief Copy the field value.
+     * \return The copy.
+     */
+    std::shared_ptr<Key> clone() const override;
+
     /**
      * \brief Get the field length.
      * \return The field length.
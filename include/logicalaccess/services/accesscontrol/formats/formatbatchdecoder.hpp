@@ -0,0 +1,121 @@
+/**
+ * \file formatbatchdecoder.hpp
+ * \brief Batch decoding of raw credentials for a format.
+ */
+
+#ifndef LOGICALACCESS_FORMATBATCHDECODER_HPP
+#define LOGICALACCESS_FORMATBATCHDECODER_HPP
+
+#include <logicalaccess/services/accesscontrol/formats/format.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief Columnar result of a batch decode.
+ *
+ * Each column holds the value of one number field for every credential of
+ * the batch, in input order.
+ */
+struct LLA_CORE_API FormatBatchResult
+{
+    /**
+     * \brief Names of the decoded fields, one per column.
+     */
+    std::vector<std::string> fieldNames;
+
+    /**
+     * \brief Decoded values, columns[field][credential].
+     */
+    std::vector<std::vector<unsigned long long>> columns;
+
+    /**
+     * \brief One flag per credential: 1 if the credential decoded with valid
+     * parities and fixed fields, 0 otherwise.
+     */
+    ByteVector valid;
+
+    /**
+     * \brief Get the number of decoded credentials.
+     */
+    size_t size() const;
+
+    /**
+     * \brief Get the column of a field.
+     * \param field The field name.
+     * \return The field values, one per credential.
+     */
+    const std::vector<unsigned long long> &getColumn(const std::string &field) const;
+};
+
+/**
+ * \brief Decode many raw credentials of the same format at once.
+ *
+ * The format is duplicated once per worker thread, so decoding does not
+ * allocate formats or fields per credential and does not touch the format
+ * given at construction.
+ */
+class LLA_CORE_API FormatBatchDecoder
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param format The format of the credentials. Its skeleton (custom format
+     * fields, encodings...) is used for decoding.
+     */
+    explicit FormatBatchDecoder(std::shared_ptr<Format> format);
+
+    /**
+     * \brief Get the format used for decoding.
+     */
+    std::shared_ptr<Format> getFormat() const;
+
+    /**
+     * \brief Get the number fields that are decoded, in column order.
+     */
+    const std::vector<std::string> &getFieldNames() const;
+
+    /**
+     * \brief Decode a batch of credentials.
+     * \param data Credentials, stored contiguously, each on stride bytes.
+     * \param count Number of credentials.
+     * \param stride Size of one credential in bytes, at least
+     * (getDataLength() + 7) / 8.
+     * \param threads Number of worker threads, 0 to use the hardware concurrency.
+     * \return The decoded fields and validity flags.
+     */
+    FormatBatchResult decode(const unsigned char *data, size_t count, size_t stride,
+                             unsigned int threads = 1) const;
+
+    /**
+     * \brief Decode a batch of credentials.
+     * \param data Credentials, stored contiguously, each on stride bytes.
+     * \param stride Size of one credential in bytes.
+     * \param threads Number of worker threads, 0 to use the hardware concurrency.
+     * \return The decoded fields and validity flags.
+     */
+    FormatBatchResult decode(const ByteVector &data, size_t stride,
+                             unsigned int threads = 1) const;
+
+  private:
+    /**
+     * \brief Duplicate the decoding format.
+     */
+    std::shared_ptr<Format> cloneFormat() const;
+
+    /**
+     * \brief The format of the credentials.
+     */
+    std::shared_ptr<Format> d_format;
+
+    /**
+     * \brief The decoded number fields.
+     */
+    std::vector<std::string> d_fieldNames;
+};
+}
+
+#endif /* LOGICALACCESS_FORMATBATCHDECODER_HPP */
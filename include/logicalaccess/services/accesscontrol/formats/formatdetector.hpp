@@ -0,0 +1,145 @@
+/**
+ * \file formatdetector.hpp
+ * \brief Detection of the format of a raw credential.
+ */
+
+#ifndef LOGICALACCESS_FORMATDETECTOR_HPP
+#define LOGICALACCESS_FORMATDETECTOR_HPP
+
+#include <logicalaccess/services/accesscontrol/formats/format.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief A format matching a raw credential.
+ */
+struct LLA_CORE_API FormatCandidate
+{
+    /**
+     * \brief A new format instance, decoded from the credential.
+     */
+    std::shared_ptr<Format> format;
+
+    /**
+     * \brief Number of fixed bits of the format that matched the credential.
+     */
+    unsigned int fixedBits;
+
+    /**
+     * \brief True if the credential decoded without parity or fixed field error.
+     */
+    bool valid;
+};
+
+/**
+ * \brief An index of formats by bit length and fixed bits signature.
+ *
+ * For each format, the bits that never change whatever the field values are
+ * (fixed fields, constant padding...) are computed once at registration by
+ * encoding a set of sample values. A credential is then only decoded by the
+ * formats of the same length whose fixed bits match, and the candidates are
+ * ranked: valid decodings first, then the most specific signatures.
+ */
+class LLA_CORE_API FormatDetector
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param registerBuiltins Register the built-in Wiegand, DataClock, FASCN,
+     * HID Honeywell, Getronik and Barium Ferrite formats.
+     */
+    explicit FormatDetector(bool registerBuiltins = true);
+
+    /**
+     * \brief Register a format. The format skeleton (custom format fields,
+     * fixed values...) is used for detection.
+     * \param format The format to register.
+     */
+    void registerFormat(std::shared_ptr<Format> format);
+
+    /**
+     * \brief Register a format through its factory.
+     * \param factory Function creating a new format instance, ready to decode.
+     */
+    void registerFormatFactory(std::function<std::shared_ptr<Format>()> factory);
+
+    /**
+     * \brief Get the number of registered formats.
+     */
+    size_t size() const;
+
+    /**
+     * \brief Find the formats matching a credential.
+     * \param data The credential, high weight bit first.
+     * \param bitLength Length of the credential in bits.
+     * \return The matching formats, best candidate first.
+     */
+    std::vector<FormatCandidate> detect(const ByteVector &data,
+                                        unsigned int bitLength) const;
+
+    /**
+     * \brief Find the formats matching a credential.
+     * \param data The credential.
+     * \return The matching formats, best candidate first.
+     */
+    std::vector<FormatCandidate> detect(const BitsetStream &data) const;
+
+  private:
+    /**
+     * \brief Sets a sample value on a part of a format that is not exposed as
+     * a value field.
+     */
+    struct Sampler
+    {
+        std::function<void(Format &, unsigned long long)> setValue;
+
+        unsigned int length;
+    };
+
+    /**
+     * \brief Register a format through its factory, with additional samplers.
+     */
+    void registerFormatFactory(std::function<std::shared_ptr<Format>()> factory,
+                               const std::vector<Sampler> &samplers);
+
+    /**
+     * \brief A registered format and its fixed bits signature, stored by
+     * 64-bit chunks, high weight bit first.
+     */
+    struct Entry
+    {
+        std::function<std::shared_ptr<Format>()> factory;
+
+        std::vector<unsigned long long> mask;
+
+        std::vector<unsigned long long> value;
+
+        unsigned int fixedBits;
+
+        size_t order;
+    };
+
+    /**
+     * \brief Compute the fixed bits signature of a format.
+     */
+    static void computeSignature(std::shared_ptr<Format> format,
+                                 std::vector<Sampler> samplers, Entry &entry);
+
+    /**
+     * \brief The registered formats, by bit length.
+     */
+    std::map<unsigned int, std::vector<Entry>> d_index;
+
+    /**
+     * \brief Number of registered formats.
+     */
+    size_t d_count;
+};
+}
+
+#endif /* LOGICALACCESS_FORMATDETECTOR_HPP */
@@ -3,8 +3,21 @@
 #include <logicalaccess/lla_core_api.hpp>
 #include <logicalaccess/lla_fwd.hpp>
 
+#include <functional>
+#include <vector>
+
 namespace logicalaccess
 {
+/**
+ * An AES operation of a batch: the data, the IV and the key to use.
+ */
+struct LLA_CORE_API AESOperation
+{
+    ByteVector data;
+    ByteVector iv;
+    std::shared_ptr<Key> key;
+};
+
 /**
  * Stateless service to perform AES cryptography against Key.
  *
@@ -23,10 +36,40 @@ class LLA_CORE_API AESCryptoService
     ByteVector aes_decrypt(const ByteVector &data, const ByteVector &iv,
                            std::shared_ptr<Key> key);
 
+    /**
+     * Perform a batch of operations. Operations with keys stored in the same
+     * PKCS token are sent together to its backend.
+     */
+    std::vector<ByteVector> aes_encrypt(const std::vector<AESOperation> &operations);
+
+    std::vector<ByteVector> aes_decrypt(const std::vector<AESOperation> &operations);
+
+    /**
+     * Compute an AES CMAC (NIST SP 800-38B) of `data`.
+     *
+     * `iv` is the chaining value of the last block, `padding_size` the size
+     * the data are padded to (the block size if 0).
+     */
+    ByteVector aes_cmac(const ByteVector &data, std::shared_ptr<Key> key,
+                        const ByteVector &iv = {}, unsigned int padding_size = 0,
+                        bool forceK2Use = false);
+
+    std::vector<ByteVector> aes_cmac(const std::vector<AESOperation> &operations,
+                                     unsigned int padding_size = 0,
+                                     bool forceK2Use = false);
+
   private:
     // Adjust IV. If `iv` is empty vector, return an full zero iv.
     ByteVector adjust_iv(const ByteVector &iv);
 
+    // Run a batch: `in_memory_op` for each key in memory, `pkcs_op` once for the
+    // keys of each PKCS library.
+    std::vector<ByteVector> perform_batch(
+        const std::vector<AESOperation> &operations,
+        const std::function<ByteVector(const AESOperation &)> &in_memory_op,
+        const std::function<std::vector<ByteVector>(
+            IAESCryptoService &, const std::vector<AESOperation> &)> &pkcs_op);
+
     ByteVector perform_operation(const ByteVector &data, const ByteVector &iv,
                                  std::shared_ptr<Key> key, bool encrypt);
 
@@ -48,10 +91,32 @@ class LLA_CORE_API AESCryptoService
 class LLA_CORE_API IAESCryptoService
 {
   public:
+    virtual ~IAESCryptoService() = default;
+
     virtual ByteVector aes_encrypt(const ByteVector &data, const ByteVector &iv,
                                    std::shared_ptr<Key> key) = 0;
 
     virtual ByteVector aes_decrypt(const ByteVector &data, const ByteVector &iv,
                                    std::shared_ptr<Key> key) = 0;
+
+    /**
+     * Batch variants, to be overridden by backends that can amortize their
+     * round trips. By default, operations are performed one by one.
+     */
+    virtual std::vector<ByteVector>
+    aes_encrypt(const std::vector<AESOperation> &operations);
+
+    virtual std::vector<ByteVector>
+    aes_decrypt(const std::vector<AESOperation> &operations);
+
+    /**
+     * CMAC of each operation data, see AESCryptoService::aes_cmac().
+     *
+     * By default, computed with two batches of aes_encrypt(): one for the
+     * subkeys, one for the MACs.
+     */
+    virtual std::vector<ByteVector> aes_cmac(const std::vector<AESOperation> &operations,
+                                             unsigned int padding_size,
+                                             bool forceK2Use);
 };
 }
@@ -5,6 +5,7 @@
 #include <logicalaccess/services/accesscontrol/formats/format.hpp>
 #include <nlohmann/json_fwd.hpp>
 #include <logicalaccess/services/accesscontrol/formatinfos.hpp>
+#include <logicalaccess/services/json/json_writer.hpp>
 
 namespace logicalaccess {
 
@@ -44,14 +45,107 @@ class LLA_CORE_API JsonDumpCardService : public CardService {
     /**
      * Dump the content of the content of the card, according the configuration
      * provided at the configure() call.
+     *
+     * The document is indented, with sorted keys, as in the previous versions:
+     * it is streamed, then parsed and written again, which costs more than
+     * dump(std::ostream &).
      */
     std::string dump();
 
+    /**
+     * Dump the content of the card as compact JSON, written to the stream as
+     * each file is read and decoded, without building the whole document.
+     *
+     * If an error is thrown, the output is left incomplete.
+     */
+    void dump(std::ostream &out);
+
+    /**
+     * Dump the content of the card as a sequence of JSON events.
+     * \see dump(std::ostream &)
+     */
+    void dump(JsonWriter &writer);
+
     std::map<std::string, std::shared_ptr<Format>> formats_;
     std::map<std::string, std::shared_ptr<Key>> keys_;
     std::map<std::string, std::shared_ptr<FormatInfos>> format_infos_;
 
+  protected:
+    /**
+     * Get the file holding a location, so that all the formats configured in
+     * the same file are read with one authentication and one read.
+     *
+     * The default implementation returns false: each format is then read
+     * on its own through the AccessControlCardService.
+     *
+     * \param location The location of a format.
+     * \param file_location Set to the location of the start of the file.
+     * \param offset Set to the offset of the format in the file, in bytes.
+     * \return True if the location belongs to a file that can be read at once.
+     */
+    virtual bool get_file_location(const std::shared_ptr<Location> &location,
+                                   std::shared_ptr<Location> &file_location,
+                                   size_t &offset);
+
+    /**
+     * Get the size of a file, so that the records of repeated formats are read
+     * at once.
+     *
+     * \return The size in bytes, or 0 if unknown. The repeated formats of the
+     * file are then read record by record.
+     */
+    virtual size_t get_file_size(const std::shared_ptr<Location> &file_location,
+                                 const std::shared_ptr<AccessInfo> &ai);
+
+    /**
+     * Whether reading a length of 0 at a file location returns the whole file.
+     * The repeated formats of the file are then read without asking its size.
+     *
+     * The default implementation returns false.
+     */
+    virtual bool reads_to_end(const std::shared_ptr<Location> &file_location);
+
   private:
+    /**
+     * A format to decode from a planned read.
+     */
+    struct PlannedFormat
+    {
+        std::string name;
+        std::shared_ptr<FormatInfos> format_info;
+        size_t offset;
+    };
+
+    /**
+     * One read of a file, with the access info to use, and the formats it holds.
+     * Formats whose file is unknown have a read of their own, without location.
+     */
+    struct PlannedRead
+    {
+        std::shared_ptr<Location> location;
+        std::shared_ptr<AccessInfo> ai;
+        std::vector<PlannedFormat> formats;
+    };
+
+    /**
+     * Group the configured formats by file and access info.
+     */
+    std::vector<PlannedRead> plan_reads();
+
+    /**
+     * Read a file at once and decode its formats.
+     * \return False if the file could not be read at once.
+     */
+    bool read_file(const PlannedRead &read, JsonWriter &writer);
+
+    /**
+     * Read a format on its own, record by record if it is repeated.
+     */
+    void read_format(const std::string &name,
+                     const std::shared_ptr<FormatInfos> &format_info,
+                     JsonWriter &writer);
+
+
     void extract_formats(const nlohmann::json & json);
 
     /**
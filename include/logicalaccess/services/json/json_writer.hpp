@@ -0,0 +1,75 @@
+#pragma once
+
+#include <logicalaccess/lla_core_api.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * A streaming writer of compact JSON.
+ *
+ * Each event is written to the output stream at once, so a document can be
+ * produced without building it in memory first. The writer only inserts the
+ * separators: the caller is responsible for emitting a well-formed sequence
+ * of events. Strings are expected in UTF-8: invalid sequences are replaced by
+ * U+FFFD.
+ */
+class LLA_CORE_API JsonWriter
+{
+  public:
+    explicit JsonWriter(std::ostream &out);
+
+    void startObject();
+
+    void endObject();
+
+    void startArray();
+
+    void endArray();
+
+    /**
+     * Write the key of the next object member.
+     */
+    void key(const std::string &name);
+
+    void value(const std::string &str);
+
+    void value(const char *str);
+
+    void value(uint64_t number);
+
+    void value(bool boolean);
+
+    /**
+     * Get the output stream.
+     */
+    std::ostream &getStream() const
+    {
+        return d_out;
+    }
+
+  private:
+    /**
+     * Write the separator before a value, if any.
+     */
+    void separate();
+
+    void writeString(const std::string &str);
+
+    std::ostream &d_out;
+
+    /**
+     * For each open object or array, whether it is still empty.
+     */
+    std::vector<bool> d_empty;
+
+    /**
+     * Whether a key has just been written.
+     */
+    bool d_afterKey;
+};
+}
@@ -120,6 +120,29 @@ class LLA_CORE_API XmlSerializable
      */
     virtual void unSerializeFromFile(const std::string &filename);
 
+    /**
+     * \brief Serialize object to a compiled configuration file.
+     * \param filename The compiled file.
+     */
+    virtual void serializeToCompiledFile(const std::string &filename);
+
+#ifndef SWIG
+    /**
+     * \brief UnSerialize object from a compiled configuration. The sub tree of
+     * the object is rebuilt as a property tree for unSerialize().
+     * \param config The compiled configuration.
+     * \param rootNode The root node.
+     */
+    virtual void unSerialize(const CompiledConfiguration &config,
+                             const std::string &rootNode);
+#endif
+
+    /**
+     * \brief UnSerialize object from a compiled configuration file.
+     * \param filename The compiled file.
+     */
+    virtual void unSerializeFromCompiledFile(const std::string &filename);
+
     /**
      * \brief Get the default Xml Node name for this object.
      * \return The Xml node name.
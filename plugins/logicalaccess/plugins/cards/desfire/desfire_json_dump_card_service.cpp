@@ -5,10 +5,12 @@
 #include <logicalaccess/cards/samkeystorage.hpp>
 #include <nlohmann/json.hpp>
 #include <logicalaccess/myexception.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
 #include "desfire_json_dump_card_service.hpp"
 #include "desfirekey.hpp"
 #include "desfireaccessinfo.hpp"
 #include "desfirelocation.hpp"
+#include "desfirechip.hpp"
 
 namespace logicalaccess
 {
@@ -112,4 +114,52 @@ void DESFireJsonDumpCardService::configure_format_infos(const nlohmann::json &js
         }
     }
 }
-}
\ No newline at end of file
+
+bool DESFireJsonDumpCardService::get_file_location(
+    const std::shared_ptr<Location> &location, std::shared_ptr<Location> &file_location,
+    size_t &offset)
+{
+    auto dfLocation = std::dynamic_pointer_cast<DESFireLocation>(location);
+    if (!dfLocation)
+        return false;
+
+    // Cloned, so that DESFire EV1 locations keep their ISO and crypto settings.
+    auto fileLocation = std::dynamic_pointer_cast<DESFireLocation>(dfLocation->clone());
+    fileLocation->byte_ = 0;
+    file_location       = fileLocation;
+    offset              = dfLocation->byte_;
+    return true;
+}
+
+size_t
+DESFireJsonDumpCardService::get_file_size(const std::shared_ptr<Location> &file_location,
+                                          const std::shared_ptr<AccessInfo> & /*ai*/)
+{
+    auto dfLocation = std::dynamic_pointer_cast<DESFireLocation>(file_location);
+    auto dfChip     = std::dynamic_pointer_cast<DESFireChip>(getChip());
+    if (!dfLocation || !dfChip)
+        return 0;
+
+    // Only standard data files report their size, other files are read record
+    // by record. The file settings are kept in the metadata cache, so the read
+    // of a plain file, which needs them for its communication mode, reuses them.
+    try
+    {
+        dfChip->getDESFireCommands()->selectApplication(dfLocation);
+        return dfChip->getDESFireCommands()->getFileLength(dfLocation->file);
+    }
+    catch (const std::exception &e)
+    {
+        LOG(LogLevel::WARNINGS) << "Cannot get the size of DESFire file "
+                                << static_cast<int>(dfLocation->file) << ": " << e.what();
+        return 0;
+    }
+}
+
+bool DESFireJsonDumpCardService::reads_to_end(
+    const std::shared_ptr<Location> & /*file_location*/)
+{
+    auto dfChip = std::dynamic_pointer_cast<DESFireChip>(getChip());
+    return dfChip && dfChip->getDESFireCommands()->readsToEndOfFile();
+}
+}
@@ -12,6 +12,16 @@ class LLA_CARDS_DESFIRE_API DESFireJsonDumpCardService : public JsonDumpCardServ
     ~DESFireJsonDumpCardService();
     explicit DESFireJsonDumpCardService(const std::shared_ptr<Chip> &chip);
 
+  protected:
+    bool get_file_location(const std::shared_ptr<Location> &location,
+                           std::shared_ptr<Location> &file_location,
+                           size_t &offset) override;
+
+    size_t get_file_size(const std::shared_ptr<Location> &file_location,
+                         const std::shared_ptr<AccessInfo> &ai) override;
+
+    bool reads_to_end(const std::shared_ptr<Location> &file_location) override;
+
   private:
     std::shared_ptr<Key> create_key(const nlohmann::json &key_description) override;
 
@@ -21,6 +21,7 @@ DESFireChip::DESFireChip(std::string ct)
     , has_real_uid_(true)
 {
     d_crypto.reset(new DESFireCrypto());
+    d_metadataCache = std::make_shared<DESFireMetadataCache>();
 }
 
 DESFireChip::DESFireChip()
@@ -28,10 +29,17 @@ DESFireChip::DESFireChip()
     , has_real_uid_(true)
 {
     d_crypto.reset(new DESFireCrypto());
+    d_metadataCache = std::make_shared<DESFireMetadataCache>();
 }
 
 DESFireChip::~DESFireChip() {}
 
+std::shared_ptr<DESFireMetadataCache> DESFireChip::getMetadataCache() const
+{
+    d_metadataCache->bind(getChipIdentifier());
+    return d_metadataCache;
+}
+
 std::shared_ptr<LocationNode> DESFireChip::getRootLocationNode()
 {
     std::shared_ptr<LocationNode> rootNode;
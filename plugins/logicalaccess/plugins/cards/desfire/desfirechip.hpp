@@ -10,6 +10,7 @@
 #include <logicalaccess/cards/chip.hpp>
 #include <logicalaccess/plugins/cards/desfire/desfirecommands.hpp>
 #include <logicalaccess/plugins/cards/desfire/desfirecrypto.hpp>
+#include <logicalaccess/plugins/cards/desfire/desfiremetadatacache.hpp>
 
 #include <string>
 #include <vector>
@@ -129,12 +130,23 @@ class LLA_CARDS_DESFIRE_API DESFireChip : public Chip
         d_crypto = crypto;
     }
 
+    /**
+     * \brief Get the card metadata cache, bound to the current chip identifier.
+     * \return The metadata cache.
+     */
+    std::shared_ptr<DESFireMetadataCache> getMetadataCache() const;
+
   protected:
     /**
     * \brief Crypto instance for security manipulation.
     */
     std::shared_ptr<DESFireCrypto> d_crypto;
 
+    /**
+     * \brief Card metadata cache.
+     */
+    std::shared_ptr<DESFireMetadataCache> d_metadataCache;
+
     /**
      * Is random UUID enabled or not ?
      * This is detected when creating the chip object in PCSC Reader.
@@ -433,6 +433,15 @@ class LLA_CARDS_DESFIRE_API DESFireCommands : public Commands
     virtual ByteVector readData(unsigned char fileno, unsigned int offset,
                                 unsigned int length, EncryptionMode mode) = 0;
 
+    /**
+     * \brief Whether readData() with a length of 0 reads the whole file.
+     * \return True if supported, false otherwise.
+     */
+    virtual bool readsToEndOfFile() const
+    {
+        return false;
+    }
+
     /**
      * \brief Write data into a specific file.
      * \param fileno The file number
@@ -7,6 +7,7 @@
 #include <logicalaccess/plugins/cards/desfire/desfirecommands.hpp>
 #include <logicalaccess/plugins/cards/desfire/desfirecrypto.hpp>
 #include <logicalaccess/plugins/cards/desfire/desfireev1location.hpp>
+#include <logicalaccess/plugins/cards/desfire/nxpav2keydiversification.hpp>
 #include <logicalaccess/plugins/crypto/tomcrypt.h>
 #include <boost/crc.hpp>
 #include <ctime>
@@ -634,6 +635,73 @@ void DESFireCrypto::getKey(std::shared_ptr<DESFireKey> key, ByteVector diversify
         getKeyVersioned(key, keydiv);
 }
 
+void DESFireCrypto::getKeys(const std::vector<std::shared_ptr<DESFireKey>> &keys,
+                            const std::vector<ByteVector> &diversify,
+                            std::vector<ByteVector> &keydivs)
+{
+    keydivs.resize(keys.size());
+
+    std::vector<size_t> batched;
+    std::vector<AESOperation> operations;
+    bool forceK2Use = false;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        auto kdiv = std::dynamic_pointer_cast<NXPAV2KeyDiversification>(
+            keys[i]->getKeyDiversification());
+        if (kdiv && diversify[i].size() != 0 && keys[i]->getKeyType() == DF_KEY_AES &&
+            keys[i]->getKeyStorage()->getType() == KST_PKCS &&
+            (batched.empty() || kdiv->getForceK2Use() == forceK2Use))
+        {
+            forceK2Use = kdiv->getForceK2Use();
+            batched.push_back(i);
+            operations.push_back(
+                NXPAV2KeyDiversification::getAESOperation(keys[i], diversify[i]));
+        }
+        else
+        {
+            getKey(keys[i], diversify[i], keydivs[i]);
+        }
+    }
+
+    if (!operations.empty())
+    {
+        LOG(LogLevel::INFOS) << "Diversifying " << operations.size()
+                             << " PKCS keys in a batch.";
+        AESCryptoService aes_crypto;
+        std::vector<ByteVector> results = aes_crypto.aes_cmac(
+            operations, NXPAV2KeyDiversification::AES_PADDING_SIZE, forceK2Use);
+        for (size_t i = 0; i < batched.size(); ++i)
+        {
+            keydivs[batched[i]] = results[i];
+        }
+    }
+}
+
+void DESFireCrypto::getChangeKeys(uint8_t keysetno, uint8_t keyno,
+                                  const ByteVector &oldKeyDiversify,
+                                  std::shared_ptr<DESFireKey> newkey,
+                                  const ByteVector &newKeyDiversify,
+                                  ByteVector &oldkeydiv, ByteVector &newkeydiv)
+{
+    std::vector<std::shared_ptr<DESFireKey>> keys;
+    std::vector<ByteVector> diversify;
+    auto it =
+        d_keys.find(std::make_tuple(static_cast<size_t>(d_currentAid), keysetno, keyno));
+    if (it != d_keys.end())
+    {
+        keys.push_back(it->second);
+        diversify.push_back(oldKeyDiversify);
+    }
+    keys.push_back(newkey);
+    diversify.push_back(newKeyDiversify);
+
+    std::vector<ByteVector> keydivs;
+    getKeys(keys, diversify, keydivs);
+    if (keys.size() == 2)
+        oldkeydiv = keydivs.front();
+    newkeydiv = keydivs.back();
+}
+
 void DESFireCrypto::getKeyVersioned(std::shared_ptr<DESFireKey> key,
                                     ByteVector &keyversioned)
 {
@@ -676,8 +744,8 @@ ByteVector DESFireCrypto::changeKey_PICC(uint8_t keyno, ByteVector oldKeyDiversi
     newkeydiv.resize(16, 0x00);
     // Get keyno only, in case of master card key
     unsigned char keyno_only = static_cast<unsigned char>(keyno & 0x3F);
-    getKey(keysetno, keyno_only, oldKeyDiversify, oldkeydiv);
-    getKey(newkey, newKeyDiversify, newkeydiv);
+    getChangeKeys(keysetno, keyno_only, oldKeyDiversify, newkey, newKeyDiversify,
+                  oldkeydiv, newkeydiv);
 
     ByteVector encCryptogram;
 
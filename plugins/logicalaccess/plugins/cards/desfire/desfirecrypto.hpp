@@ -338,6 +338,33 @@ class LLA_CARDS_DESFIRE_API DESFireCrypto
     static void getKey(std::shared_ptr<DESFireKey> key, ByteVector diversify,
                        ByteVector &keydiv);
 
+    /**
+     * \brief Get several keys diversified. NXP AV2 diversifications of AES keys
+     * stored in a PKCS token are computed in a single batch.
+     * \param keys The DESFire keys information
+     * \param diversify The diversify buffer of each key
+     * \param keydivs The key data of each key, diversified if a diversify buffer is
+     * specified.
+     */
+    static void getKeys(const std::vector<std::shared_ptr<DESFireKey>> &keys,
+                        const std::vector<ByteVector> &diversify,
+                        std::vector<ByteVector> &keydivs);
+
+    /**
+     * \brief Get the current and the new key of a key change, diversified.
+     * \param keysetno The key set number
+     * \param keyno The key number
+     * \param oldKeyDiversify The diversify buffer of the current key
+     * \param newkey The new key
+     * \param newKeyDiversify The diversify buffer of the new key
+     * \param oldkeydiv The current key data, unchanged if the key is unknown
+     * \param newkeydiv The new key data
+     */
+    void getChangeKeys(uint8_t keysetno, uint8_t keyno, const ByteVector &oldKeyDiversify,
+                       std::shared_ptr<DESFireKey> newkey,
+                       const ByteVector &newKeyDiversify, ByteVector &oldkeydiv,
+                       ByteVector &newkeydiv);
+
     /**
      * \brief Get DES key versionned.
      * \param key The DESFire key information
@@ -54,6 +54,11 @@ std::string DESFireEV1Location::getDefaultXmlNodeName() const
     return "DESFireEV1Location";
 }
 
+std::shared_ptr<Location> DESFireEV1Location::clone() const
+{
+    return std::make_shared<DESFireEV1Location>(*this);
+}
+
 bool DESFireEV1Location::operator==(const Location &location) const
 {
     if (!Location::operator==(location))
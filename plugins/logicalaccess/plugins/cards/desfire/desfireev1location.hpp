@@ -54,6 +54,8 @@ class LLA_CARDS_DESFIRE_API DESFireEV1Location : public DESFireLocation
         return "DESFireEV1";
     }
 
+    std::shared_ptr<Location> clone() const override;
+
     /**
      * \brief Equality operator
      * \param location Location to compare.
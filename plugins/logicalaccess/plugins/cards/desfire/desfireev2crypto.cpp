@@ -294,8 +294,8 @@ ByteVector DESFireEV2Crypto::changeKey_PICC(unsigned char keyno,
     oldkeydiv.resize(16, 0x00);
     newkeydiv.resize(16, 0x00);
     // Get keyno only, in case of master card key
-    getKey(keysetno, keyno, oldKeyDiversify, oldkeydiv);
-    getKey(newkey, newKeyDiversify, newkeydiv);
+    getChangeKeys(keysetno, keyno, oldKeyDiversify, newkey, newKeyDiversify, oldkeydiv,
+                  newkeydiv);
 
     ByteVector encCryptogram;
     for (unsigned int i = 0; i < newkeydiv.size(); ++i)
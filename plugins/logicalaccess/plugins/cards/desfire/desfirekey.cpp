@@ -116,4 +116,9 @@ void DESFireKey::setKeyType(DESFireKeyType keyType)
     d_keyType = keyType;
     d_data.resize(getLength(), 0x00);
 }
+
+std::shared_ptr<Key> DESFireKey::clone() const
+{
+    return std::make_shared<DESFireKey>(*this);
+}
 }
\ No newline at end of file
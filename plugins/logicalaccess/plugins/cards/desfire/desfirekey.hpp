@@ -68,6 +68,12 @@ class LLA_CARDS_DESFIRE_API DESFireKey : public Key
      */
     explicit DESFireKey(const ByteVector &data);
 
+    /**
+     * \brief Copy the key.
+     * \return The copy.
+     */
+    std::shared_ptr<Key> clone() const override;
+
     /**
      * \brief Get the key length.
      * \return The key length.
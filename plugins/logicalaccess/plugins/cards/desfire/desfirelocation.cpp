@@ -83,4 +83,9 @@ void DESFireLocation::incrementOffset(int increment)
 {
     byte_ += increment;
 }
+
+std::shared_ptr<Location> DESFireLocation::clone() const
+{
+    return std::make_shared<DESFireLocation>(*this);
+}
 }
\ No newline at end of file
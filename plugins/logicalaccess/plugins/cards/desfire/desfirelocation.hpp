@@ -81,6 +81,8 @@ class LLA_CARDS_DESFIRE_API DESFireLocation : public Location
 
     void incrementOffset(int increment) override;
 
+    std::shared_ptr<Location> clone() const override;
+
     /**
      * \brief Equality operator
      * \param location Location to compare.
@@ -0,0 +1,303 @@
+/**
+ * \file desfiremetadatacache.cpp
+ * \brief DESFire card metadata cache.
+ */
+
+#include <logicalaccess/plugins/cards/desfire/desfiremetadatacache.hpp>
+#include <logicalaccess/plugins/cards/desfire/desfireev2commands.hpp>
+
+namespace logicalaccess
+{
+DESFireMetadataCache::Application::Application()
+    : hasFileIDs(false)
+    , hasKeySettings(false)
+    , keySettings()
+{
+}
+
+DESFireMetadataCache::DESFireMetadataCache()
+    : d_selectionValid(false)
+    , d_selectedAid(0)
+    , d_authenticatedKeyNo(0)
+    , d_hasApplicationIDs(false)
+{
+}
+
+void DESFireMetadataCache::bind(const ByteVector &identifier)
+{
+    if (identifier != d_identifier)
+    {
+        clear();
+        d_identifier = identifier;
+    }
+}
+
+void DESFireMetadataCache::clear()
+{
+    invalidateSelection();
+    d_hasApplicationIDs = false;
+    d_applicationIDs.clear();
+    d_applications.clear();
+}
+
+void DESFireMetadataCache::invalidate(unsigned char ins, const ByteVector &data)
+{
+    Application *application = nullptr;
+    switch (ins)
+    {
+    case DF_INS_SELECT_APPLICATION: invalidateSelection(); break;
+
+    // A new authentication ends the current one, even when it fails.
+    case DF_INS_AUTHENTICATE:
+    case DFEV1_INS_AUTHENTICATE_ISO:
+    case DFEV1_INS_AUTHENTICATE_AES:
+    case DFEV2_INS_AUTHENTICATE_EV2_FIRST: invalidateAuthentication(); break;
+
+    case DF_INS_CREATE_APPLICATION:
+    case DFEV2_INS_CREATE_DELEGATED_APPLICATION:
+    case DF_INS_DELETE_APPLICATION:
+        d_hasApplicationIDs = false;
+        if (data.size() >= 3)
+        {
+            unsigned int aid = DESFireLocation::convertAidToUInt(
+                ByteVector(data.begin(), data.begin() + 3));
+            d_applications.erase(aid);
+            // The PICC level is selected when the selected application is deleted.
+            if (ins == DF_INS_DELETE_APPLICATION && d_selectedAid == aid)
+                invalidateSelection();
+        }
+        else
+        {
+            d_applications.clear();
+        }
+        break;
+
+    case DF_INS_FORMAT_PICC:
+        clear();
+        break;
+
+    case DF_INS_CREATE_STD_DATA_FILE:
+    case DF_INS_CREATE_BACKUP_DATA_FILE:
+    case DF_INS_CREATE_VALUE_FILE:
+    case DF_INS_CREATE_LINEAR_RECORD_FILE:
+    case DF_INS_CREATE_CYCLIC_RECORD_FILE:
+    case DFEV2_INS_CREATE_TRANSACTION_MAC_FILE:
+    case DF_INS_DELETE_FILE:
+    case DF_INS_CHANGE_FILE_SETTINGS:
+        application = getSelectedApplication();
+        if (!application)
+        {
+            d_applications.clear();
+            break;
+        }
+        if (ins != DF_INS_CHANGE_FILE_SETTINGS)
+        {
+            application->hasFileIDs = false;
+            application->fileIDs.clear();
+        }
+        if (data.size() >= 1)
+            application->fileSettings.erase(data[0]);
+        else
+            application->fileSettings.clear();
+        break;
+
+    // The settings of record and value files hold the current number of
+    // records and the limited credit value.
+    case DF_INS_WRITE_RECORD:
+    case DF_INS_CLEAR_RECORD_FILE:
+    case DF_INS_CREDIT:
+    case DF_INS_DEBIT:
+    case DF_INS_LIMITED_CREDIT:
+    case DF_COMMIT_TRANSACTION:
+    case DF_INS_ABORT_TRANSACTION:
+        application = getSelectedApplication();
+        if (!application)
+            d_applications.clear();
+        else if (data.size() >= 1 && ins != DF_COMMIT_TRANSACTION &&
+                 ins != DF_INS_ABORT_TRANSACTION)
+            application->fileSettings.erase(data[0]);
+        else
+            application->fileSettings.clear();
+        break;
+
+    case DF_INS_CHANGE_KEY_SETTINGS:
+    case DF_INS_CHANGE_KEY:
+    case DFEV2_INS_CHANGEKEY_EV2:
+    case DFEV2_INS_INITIALIZEKEYSET:
+    case DFEV2_INS_ROLLKEYSET:
+    case DFEV2_INS_FINALIZEKEYSET:
+        application = getSelectedApplication();
+        if (application)
+            application->hasKeySettings = false;
+        else
+            d_applications.clear();
+
+        // Changing the authenticated key ends the authentication on the card:
+        // the next selection is sent, to reset the crypto too. Other keys are
+        // not told apart.
+        if (ins != DF_INS_CHANGE_KEY_SETTINGS)
+            invalidateSelection();
+        break;
+
+    default: break;
+    }
+}
+
+bool DESFireMetadataCache::isSelected(unsigned int aid) const
+{
+    return d_selectionValid && d_selectedAid == aid;
+}
+
+void DESFireMetadataCache::setSelected(unsigned int aid)
+{
+    invalidateAuthentication();
+    d_selectionValid = true;
+    d_selectedAid    = aid;
+}
+
+void DESFireMetadataCache::invalidateSelection()
+{
+    invalidateAuthentication();
+    d_selectionValid = false;
+}
+
+bool DESFireMetadataCache::isAuthenticated(unsigned char keyno,
+                                           std::shared_ptr<DESFireKey> key) const
+{
+    if (!d_selectionValid || !d_authenticatedKey || !key || d_authenticatedKeyNo != keyno)
+        return false;
+
+    if (!(*key == *d_authenticatedKey) ||
+        key->getKeyDiversification() != d_authenticatedKey->getKeyDiversification())
+        return false;
+
+    // Keys stored elsewhere than in memory have no data to compare: they must
+    // come from the same storage.
+    std::shared_ptr<KeyStorage> storage         = key->getKeyStorage();
+    std::shared_ptr<KeyStorage> previousStorage = d_authenticatedKey->getKeyStorage();
+    if (!storage || !previousStorage)
+        return false;
+    if (storage->getType() == KST_COMPUTER_MEMORY)
+        return previousStorage->getType() == KST_COMPUTER_MEMORY;
+    return storage == previousStorage;
+}
+
+void DESFireMetadataCache::setAuthenticated(unsigned char keyno,
+                                            std::shared_ptr<DESFireKey> key)
+{
+    if (!d_selectionValid || !key)
+        return;
+
+    d_authenticatedKey   = std::make_shared<DESFireKey>(*key);
+    d_authenticatedKeyNo = keyno;
+}
+
+void DESFireMetadataCache::invalidateAuthentication()
+{
+    d_authenticatedKey.reset();
+}
+
+bool DESFireMetadataCache::getApplicationIDs(std::vector<unsigned int> &aids) const
+{
+    if (!d_hasApplicationIDs)
+        return false;
+
+    aids = d_applicationIDs;
+    return true;
+}
+
+void DESFireMetadataCache::setApplicationIDs(const std::vector<unsigned int> &aids)
+{
+    d_hasApplicationIDs = true;
+    d_applicationIDs    = aids;
+}
+
+bool DESFireMetadataCache::getFileIDs(ByteVector &files) const
+{
+    const Application *application = getSelectedApplication();
+    if (!application || !application->hasFileIDs)
+        return false;
+
+    files = application->fileIDs;
+    return true;
+}
+
+void DESFireMetadataCache::setFileIDs(const ByteVector &files)
+{
+    Application *application = getSelectedApplication();
+    if (application)
+    {
+        application->hasFileIDs = true;
+        application->fileIDs    = files;
+    }
+}
+
+bool DESFireMetadataCache::getFileSettings(unsigned char fileno,
+                                           DESFireCommands::FileSetting &settings) const
+{
+    const Application *application = getSelectedApplication();
+    if (!application)
+        return false;
+
+    auto it = application->fileSettings.find(fileno);
+    if (it == application->fileSettings.end())
+        return false;
+
+    settings = it->second;
+    return true;
+}
+
+void DESFireMetadataCache::setFileSettings(unsigned char fileno,
+                                           const DESFireCommands::FileSetting &settings)
+{
+    Application *application = getSelectedApplication();
+    if (application)
+        application->fileSettings[fileno] = settings;
+}
+
+bool DESFireMetadataCache::getKeySettings(DESFireKeySettings &settings,
+                                          unsigned char &maxNbKeys,
+                                          DESFireKeyType &keyType) const
+{
+    const Application *application = getSelectedApplication();
+    if (!application || !application->hasKeySettings)
+        return false;
+
+    settings  = application->keySettings.settings;
+    maxNbKeys = application->keySettings.maxNbKeys;
+    keyType   = application->keySettings.keyType;
+    return true;
+}
+
+void DESFireMetadataCache::setKeySettings(DESFireKeySettings settings,
+                                          unsigned char maxNbKeys,
+                                          DESFireKeyType keyType)
+{
+    Application *application = getSelectedApplication();
+    if (application)
+    {
+        application->hasKeySettings        = true;
+        application->keySettings.settings  = settings;
+        application->keySettings.maxNbKeys = maxNbKeys;
+        application->keySettings.keyType   = keyType;
+    }
+}
+
+const DESFireMetadataCache::Application *
+DESFireMetadataCache::getSelectedApplication() const
+{
+    if (!d_selectionValid)
+        return nullptr;
+
+    auto it = d_applications.find(d_selectedAid);
+    return it != d_applications.end() ? &it->second : nullptr;
+}
+
+DESFireMetadataCache::Application *DESFireMetadataCache::getSelectedApplication()
+{
+    if (!d_selectionValid)
+        return nullptr;
+
+    return &d_applications[d_selectedAid];
+}
+}
@@ -0,0 +1,183 @@
+/**
+ * \file desfiremetadatacache.hpp
+ * \brief DESFire card metadata cache.
+ */
+
+#ifndef LOGICALACCESS_DESFIREMETADATACACHE_HPP
+#define LOGICALACCESS_DESFIREMETADATACACHE_HPP
+
+#include <logicalaccess/plugins/cards/desfire/desfirecommands.hpp>
+#include <logicalaccess/plugins/cards/desfire/desfirekey.hpp>
+
+#include <map>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief Cache of the metadata of a DESFire card: the application IDs, and for
+ * each application its file IDs, file settings and key settings.
+ *
+ * The commands fill it on the first query, and every command changing the
+ * metadata invalidates the part it changes, so that multi-step flows don't
+ * query the card again for unchanged metadata. It also tracks the selected
+ * application, so that redundant SELECT APPLICATION commands are skipped, and
+ * the key the selected application is authenticated with, so that redundant
+ * authentications are skipped.
+ *
+ * The cache belongs to a DESFireChip and is bound to its identifier: it is
+ * cleared when the identifier changes.
+ */
+class LLA_CARDS_DESFIRE_API DESFireMetadataCache
+{
+  public:
+    DESFireMetadataCache();
+
+    /**
+     * \brief Bind the cache to a card, clearing it if it was bound to another one.
+     * \param identifier The card identifier.
+     */
+    void bind(const ByteVector &identifier);
+
+    /**
+     * \brief Clear the whole cache.
+     */
+    void clear();
+
+    /**
+     * \brief Invalidate the metadata a command may change, before it is sent.
+     * \param ins The command instruction code.
+     * \param data The command data.
+     */
+    void invalidate(unsigned char ins, const ByteVector &data);
+
+    /**
+     * \brief Check if an application is known to be selected.
+     * \param aid The application ID.
+     * \return True if it is selected, and the selection is still valid.
+     */
+    bool isSelected(unsigned int aid) const;
+
+    /**
+     * \brief Set the selected application.
+     * \param aid The application ID.
+     */
+    void setSelected(unsigned int aid);
+
+    /**
+     * \brief Forget the selected application, after an error or a command the
+     * cache cannot follow. The next selection is sent to the card.
+     */
+    void invalidateSelection();
+
+    /**
+     * \brief Check if the selected application is known to be authenticated
+     * with a key.
+     * \param keyno The key number.
+     * \param key The key.
+     * \return True if it is authenticated with the same key, and the selection
+     * is still valid.
+     */
+    bool isAuthenticated(unsigned char keyno, std::shared_ptr<DESFireKey> key) const;
+
+    /**
+     * \brief Set the key the selected application is authenticated with.
+     * \param keyno The key number.
+     * \param key The key, copied.
+     */
+    void setAuthenticated(unsigned char keyno, std::shared_ptr<DESFireKey> key);
+
+    /**
+     * \brief Forget the authentication. The next authentication is sent to the
+     * card.
+     */
+    void invalidateAuthentication();
+
+    bool getApplicationIDs(std::vector<unsigned int> &aids) const;
+
+    void setApplicationIDs(const std::vector<unsigned int> &aids);
+
+    /**
+     * \brief Get the file IDs of the selected application.
+     * \return True if cached, false otherwise.
+     */
+    bool getFileIDs(ByteVector &files) const;
+
+    void setFileIDs(const ByteVector &files);
+
+    /**
+     * \brief Get the settings of a file of the selected application.
+     * \return True if cached, false otherwise.
+     */
+    bool getFileSettings(unsigned char fileno,
+                         DESFireCommands::FileSetting &settings) const;
+
+    void setFileSettings(unsigned char fileno,
+                         const DESFireCommands::FileSetting &settings);
+
+    /**
+     * \brief Get the key settings of the selected application.
+     * \return True if cached, false otherwise.
+     */
+    bool getKeySettings(DESFireKeySettings &settings, unsigned char &maxNbKeys,
+                        DESFireKeyType &keyType) const;
+
+    void setKeySettings(DESFireKeySettings settings, unsigned char maxNbKeys,
+                        DESFireKeyType keyType);
+
+  private:
+    struct KeySettings
+    {
+        DESFireKeySettings settings;
+
+        unsigned char maxNbKeys;
+
+        DESFireKeyType keyType;
+    };
+
+    struct Application
+    {
+        Application();
+
+        bool hasFileIDs;
+
+        ByteVector fileIDs;
+
+        std::map<unsigned char, DESFireCommands::FileSetting> fileSettings;
+
+        bool hasKeySettings;
+
+        KeySettings keySettings;
+    };
+
+    /**
+     * \brief Get the selected application metadata.
+     * \return The metadata, or null if the selection is unknown.
+     */
+    const Application *getSelectedApplication() const;
+
+    Application *getSelectedApplication();
+
+    ByteVector d_identifier;
+
+    bool d_selectionValid;
+
+    unsigned int d_selectedAid;
+
+    /**
+     * \brief The key the selected application is authenticated with, null if
+     * unknown.
+     */
+    std::shared_ptr<DESFireKey> d_authenticatedKey;
+
+    unsigned char d_authenticatedKeyNo;
+
+    bool d_hasApplicationIDs;
+
+    std::vector<unsigned int> d_applicationIDs;
+
+    std::map<unsigned int, Application> d_applications;
+};
+}
+
+#endif /* LOGICALACCESS_DESFIREMETADATACACHE_HPP */
@@ -71,6 +71,15 @@ ByteVector NXPAV2KeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
 {
     LOG(LogLevel::INFOS) << "Using key diversification NXP AV2 with div : "
                          << BufferHelper::getHex(diversify);
+    if (std::dynamic_pointer_cast<DESFireKey>(key)->getKeyType() == DF_KEY_AES &&
+        key->getKeyStorage()->getType() == KST_PKCS)
+    {
+        // The master key never leaves the token.
+        AESCryptoService aes_crypto;
+        AESOperation op = getAESOperation(key, diversify);
+        return aes_crypto.aes_cmac(op.data, key, op.iv, AES_PADDING_SIZE, d_forceK2Use);
+    }
+
     std::shared_ptr<openssl::OpenSSLSymmetricCipher> d_cipher;
     ByteVector keycipher = key->getData();
     ByteVector emptyIV, keydiv;
@@ -127,6 +136,14 @@ ByteVector NXPAV2KeyDiversification::getDiversifiedKey(std::shared_ptr<Key> key,
     return keydiv;
 }
 
+AESOperation NXPAV2KeyDiversification::getAESOperation(std::shared_ptr<Key> key,
+                                                       ByteVector diversify)
+{
+    // const AES 128
+    diversify.insert(diversify.begin(), 0x01);
+    return {diversify, {}, key};
+}
+
 void NXPAV2KeyDiversification::serialize(boost::property_tree::ptree &parentNode)
 {
     boost::property_tree::ptree node;
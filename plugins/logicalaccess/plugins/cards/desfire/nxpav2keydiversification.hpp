@@ -3,6 +3,7 @@
 
 #include <logicalaccess/cards/keydiversification.hpp>
 #include <logicalaccess/key.hpp>
+#include <logicalaccess/services/aes_crypto_service.hpp>
 #include <logicalaccess/plugins/cards/desfire/nxpkeydiversification.hpp>
 #include <vector>
 #include <string>
@@ -17,6 +18,17 @@ class LLA_CARDS_DESFIRE_API NXPAV2KeyDiversification : public NXPKeyDiversificat
                              ByteVector &diversify) override;
     ByteVector getDiversifiedKey(std::shared_ptr<Key> key, ByteVector diversify) override;
 
+    /**
+     * \brief Size the AES diversification input is padded to, for its CMAC.
+     */
+    static const unsigned int AES_PADDING_SIZE = 32;
+
+    /**
+     * \brief Get the CMAC input of an AES key diversification, to compute it with
+     * AESCryptoService::aes_cmac(), possibly in a batch.
+     */
+    static AESOperation getAESOperation(std::shared_ptr<Key> key, ByteVector diversify);
+
     NXPAV2KeyDiversification()
         : d_revertAID(false)
         , d_forceK2Use(false)
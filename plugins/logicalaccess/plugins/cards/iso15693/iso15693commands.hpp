@@ -66,6 +66,13 @@ class LLA_CARDS_ISO15693_API ISO15693Commands : public Commands
     virtual SystemInformation getSystemInformation() = 0;
 
     virtual unsigned char getSecurityStatus(size_t block) = 0;
+
+    /**
+     * \brief Run the ISO15693 anticollision and get all the VICC in the field.
+     * \param afi The Application Family Identifier to select, 0x00 for all VICC.
+     * \return The VICC UIDs, as received (LSB first).
+     */
+    virtual std::vector<ByteVector> inventory(unsigned char afi = 0x00) = 0;
 };
 }
 
@@ -12,6 +12,7 @@
 #include <logicalaccess/plugins/cards/mifare/mifarechip.hpp>
 #include <logicalaccess/plugins/cards/mifare/mifarelocation.hpp>
 #include <logicalaccess/myexception.hpp>
+#include <logicalaccess/metrics.hpp>
 
 #define PREFIX_PATTERN 0xE3
 #define POLYNOM_PATTERN 0x1D
@@ -21,6 +22,8 @@ namespace logicalaccess
 void MifareCommands::authenticate(std::shared_ptr<Location> location,
                                   std::shared_ptr<AccessInfo> ai, bool write)
 {
+    AuthenticationRecorder metrics(*this);
+
     EXCEPTION_ASSERT_WITH_LOG(location, std::invalid_argument,
                               "location cannot be null.");
     EXCEPTION_ASSERT_WITH_LOG(ai, std::invalid_argument, "ai cannot be null.");
@@ -44,6 +47,7 @@ void MifareCommands::authenticate(std::shared_ptr<Location> location,
     loadKey(location, keytype, key);
     authenticate(static_cast<unsigned char>(getSectorStartBlock(mLocation->sector)),
                  key->getKeyStorage(), keytype);
+    metrics.succeed();
 }
 
 unsigned int MifareCommands::getSectorFromMAD(long aid,
@@ -295,6 +299,8 @@ MifareKeyType MifareCommands::getKeyType(const MifareAccessInfo::SectorAccessBit
 void MifareCommands::authenticate(MifareKeyType keytype, std::shared_ptr<MifareKey> key,
                                   int sector, int block, bool /*write*/)
 {
+    AuthenticationRecorder metrics(*this);
+
     std::shared_ptr<MifareLocation> location(new MifareLocation());
     location->sector = sector;
     location->block  = block;
@@ -307,6 +313,7 @@ void MifareCommands::authenticate(MifareKeyType keytype, std::shared_ptr<MifareK
     loadKey(location, keytype, key);
     authenticate(static_cast<unsigned char>(getSectorStartBlock(sector)),
                  key->getKeyStorage(), keytype);
+    metrics.succeed();
 }
 
 ByteVector MifareCommands::readSector(int sector, int start_block,
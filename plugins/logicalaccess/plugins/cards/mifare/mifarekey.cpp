@@ -50,4 +50,9 @@ std::string MifareKey::getDefaultXmlNodeName() const
 {
     return "MifareKey";
 }
+
+std::shared_ptr<Key> MifareKey::clone() const
+{
+    return std::make_shared<MifareKey>(*this);
+}
 }
\ No newline at end of file
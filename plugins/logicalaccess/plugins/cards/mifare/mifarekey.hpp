@@ -49,6 +49,12 @@ class LLA_CARDS_MIFARE_API MifareKey : public Key
      */
     explicit MifareKey(const ByteVector &data);
 
+    /**
+     * \brief Copy the key.
+     * \return The copy.
+     */
+    std::shared_ptr<Key> clone() const override;
+
     /**
      * \brief Get the key length.
      * \return The key length.
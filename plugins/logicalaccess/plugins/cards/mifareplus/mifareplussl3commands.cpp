@@ -12,6 +12,7 @@
 #include <logicalaccess/plugins/cards/mifareplus/MifarePlusSL0Commands.hpp>
 #include <logicalaccess/plugins/cards/mifareplus/MifarePlusAESAuth.hpp>
 #include <logicalaccess/plugins/cards/mifareplus/MifarePlusSL3Auth.hpp>
+#include <logicalaccess/metrics.hpp>
 
 namespace logicalaccess
 {
@@ -19,8 +20,12 @@ namespace logicalaccess
 bool MifarePlusSL3Commands_NEW::authenticate(int sector, std::shared_ptr<AES128Key> key,
                                              MifareKeyType type)
 {
+    AuthenticationRecorder metrics(*this);
+
     auth_.reset(new MifarePlusSL3Auth(getReaderCardAdapter()));
-    return auth_->firstAuthenticate(sector, key, type);
+    const bool authenticated = auth_->firstAuthenticate(sector, key, type);
+    metrics.setResult(authenticated ? "ok" : "failed");
+    return authenticated;
 }
 
 ByteVector MifarePlusSL3Commands_NEW::readBinaryPlain(unsigned char blockno, size_t len)
@@ -88,4 +88,9 @@ void SeosKey::setKeyType(SeosKeyType keyType)
     d_keyType = keyType;
     d_data.resize(getLength(), 0x00);
 }
+
+std::shared_ptr<Key> SeosKey::clone() const
+{
+    return std::make_shared<SeosKey>(*this);
+}
 }
\ No newline at end of file
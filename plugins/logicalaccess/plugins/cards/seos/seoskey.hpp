@@ -60,6 +60,12 @@ class LLA_CARDS_SEOS_API SeosKey : public Key
      */
     explicit SeosKey(const ByteVector &data);
 
+    /**
+     * \brief Copy the key.
+     * \return The copy.
+     */
+    std::shared_ptr<Key> clone() const override;
+
     /**
      * \brief Get the key length.
      * \return The key length.
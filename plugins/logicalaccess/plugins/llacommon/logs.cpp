@@ -9,16 +9,15 @@
 #include <logicalaccess/colorize.hpp>
 #include <boost/date_time.hpp>
 
-#ifdef WIN32
-// For now the additional context for the logger wont be thread safe,
-// because the compiler doesn't support it.
-static std::vector<std::string> context_;
-#else
 /**
  * A queue of "context string" to help make sense of the log message.
  */
 static thread_local std::vector<std::string> context_;
-#endif
+
+/**
+ * The log levels enabled for the current thread, restricted by LogContext.
+ */
+static thread_local logicalaccess::LogLevelMask log_mask_ = logicalaccess::LOG_ALL_LEVELS;
 
 namespace logicalaccess
 {
@@ -29,10 +28,17 @@ std::map<LogLevel, std::string> Logs::logLevelMsg;
 Logs::Logs(const char *file, const char *func, int line, enum LogLevel level)
     : d_level(level)
 {
-    if (!Settings::getInstance()->IsLogEnabled ||
-        (d_level == COMS && !Settings::getInstance()->SeeCommunicationLog) ||
-        ((d_level == PLUGINS || d_level == PLUGINS_ERROR) &&
-         !Settings::getInstance()->SeePluginLog))
+    // Checked first: filtered polling loops shouldn't pay for the settings.
+    if ((log_mask_ & logLevelBit(d_level)) == 0)
+    {
+        d_level = NONE;
+        return;
+    }
+
+    std::shared_ptr<const Settings> settings = Settings::getInstance();
+    if (!settings->IsLogEnabled ||
+        (d_level == COMS && !settings->SeeCommunicationLog) ||
+        ((d_level == PLUGINS || d_level == PLUGINS_ERROR) && !settings->SeePluginLog))
         d_level = NONE;
 
     if (logLevelMsg.empty())
@@ -59,7 +65,7 @@ Logs::Logs(const char *file, const char *func, int line, enum LogLevel level)
         catch (std::exception)
         {
         }
-        if (Settings::getInstance()->ColorizeLog)
+        if (settings->ColorizeLog)
         {
             _stream << Colorize::underline(to_simple_string(now)) << " - "
                     << Colorize::red(logLevelMsg[d_level]) << ": \t{" << line << "}\t{"
@@ -70,7 +76,7 @@ Logs::Logs(const char *file, const char *func, int line, enum LogLevel level)
             _stream << to_simple_string(now) << " - " << logLevelMsg[d_level] << ": \t{"
                     << line << "}\t{" << func << "}\t{" << file << "}:" << std::endl;
         }
-        if (Settings::getInstance()->ContextLog)
+        if (settings->ContextLog)
             _stream << pretty_context_infos();
     }
 }
@@ -81,8 +87,9 @@ std::string Logs::pretty_context_infos()
     if (context_.size() == 0)
         return "";
 
+    const bool colorize = Settings::getInstance()->ColorizeLog;
     std::string ret;
-    if (Settings::getInstance()->ColorizeLog)
+    if (colorize)
         ret = green(underline("Context:")) + ' ';
     else
         ret   = "Context: ";
@@ -94,7 +101,7 @@ std::string Logs::pretty_context_infos()
             ret += std::string(9, ' ');
         std::stringstream ss;
         ss << count << ") ";
-        if (Settings::getInstance()->ColorizeLog)
+        if (colorize)
             ret += yellow(ss.str()) + itr + '\n';
         else
             ret += ss.str() + itr + '\n';
@@ -149,14 +156,12 @@ std::ostream &operator<<(std::ostream &ss, const std::vector<bool> &bytebuff)
 }
 
 LogDisabler::LogDisabler()
+    : filter_("", 0)
 {
-    old_                                  = Settings::getInstance()->IsLogEnabled;
-    Settings::getInstance()->IsLogEnabled = false;
 }
 
 LogDisabler::~LogDisabler()
 {
-    Settings::getInstance()->IsLogEnabled = old_;
 }
 
 std::string get_nth_param_name(const char *param_names, int idx)
@@ -189,12 +194,30 @@ void trace_print_helper(std::stringstream &ss, const char *param_names, int /*id
 }
 
 LogContext::LogContext(const std::string &msg)
+    : pushed_(true)
+    , old_mask_(log_mask_)
 {
     context_.push_back(msg);
 }
 
+LogContext::LogContext(const std::string &msg, LogLevelMask mask)
+    : pushed_(!msg.empty())
+    , old_mask_(log_mask_)
+{
+    if (pushed_)
+        context_.push_back(msg);
+    log_mask_ &= mask;
+}
+
 LogContext::~LogContext()
 {
-    context_.pop_back();
+    log_mask_ = old_mask_;
+    if (pushed_)
+        context_.pop_back();
+}
+
+LogLevelMask LogContext::getThreadLogMask()
+{
+    return log_mask_;
 }
 }
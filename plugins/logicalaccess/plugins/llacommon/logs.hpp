@@ -51,6 +51,24 @@ enum LogLevel
     PLUGINS_ERROR
 };
 
+/**
+ * A set of log levels, one bit per LogLevel.
+ */
+typedef uint32_t LogLevelMask;
+
+/**
+ * The mask enabling all log levels.
+ */
+const LogLevelMask LOG_ALL_LEVELS = 0xFFFFFFFF;
+
+/**
+ * Get the mask bit of a log level.
+ */
+inline LogLevelMask logLevelBit(LogLevel level)
+{
+    return static_cast<LogLevelMask>(1) << level;
+}
+
 /**
  * An overload to pretty-print a byte vector to an ostream.
  */
@@ -83,7 +101,24 @@ class LLA_COMMON_API LogContext
 {
   public:
     explicit LogContext(const std::string &);
+
+    /**
+     * Push a context and restrict the log levels of the current thread to
+     * `mask` until destruction. Other threads are not affected. An empty
+     * context string only applies the mask.
+     */
+    LogContext(const std::string &, LogLevelMask mask);
+
     ~LogContext();
+
+    /**
+     * The log levels enabled for the current thread.
+     */
+    static LogLevelMask getThreadLogMask();
+
+  private:
+    bool pushed_;
+    LogLevelMask old_mask_;
 };
 
 class LLA_COMMON_API Logs
@@ -120,8 +155,8 @@ class LLA_COMMON_API Logs
 };
 
 /**
- * A RAII object that disable logging in its constructor, and restore
- * the old value in its destructor.
+ * A RAII object that disable logging for the current thread in its
+ * constructor, and restore the old value in its destructor.
  *
  * This is used where we need to temporarily disable logging. This is
  * exception safe.
@@ -132,7 +167,7 @@ struct LLA_COMMON_API LogDisabler
     ~LogDisabler();
 
   private:
-    bool old_;
+    LogContext filter_;
 };
 
 #ifdef SWIG
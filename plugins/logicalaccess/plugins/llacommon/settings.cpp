@@ -16,6 +16,8 @@
 
 #include <string>
 #include <list>
+#include <memory>
+#include <mutex>
 
 #ifdef __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
@@ -31,7 +33,27 @@ __declspec(dllexport) HMODULE __hLibLogicalAccessModule;
 
 namespace logicalaccess
 {
-Settings *Settings::instance = nullptr;
+namespace
+{
+/**
+ * \brief The current settings, read and replaced with the atomic shared_ptr
+ * functions. Never destroyed, as logs may read it during the static destruction.
+ */
+std::shared_ptr<Settings> &currentSettings()
+{
+    static std::shared_ptr<Settings> *settings = new std::shared_ptr<Settings>();
+    return *settings;
+}
+
+/**
+ * \brief Guards the creation and replacement of the settings.
+ */
+std::recursive_mutex &settingsMutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+}
 
 Settings::Settings()
 {
@@ -84,15 +106,45 @@ void Settings::Uninitialize()
     }
 }
 
-Settings *Settings::getInstance()
+std::shared_ptr<Settings> Settings::getInstance()
 {
-    if (instance == nullptr)
-    {
-        instance = new Settings();
-        LOG(LogLevel::INFOS) << "New settings instance created.";
-    }
-    instance->Initialize();
-    return instance;
+    std::shared_ptr<Settings> settings = std::atomic_load(&currentSettings());
+    if (!settings)
+        settings = createInstance();
+    return settings;
+}
+
+std::shared_ptr<Settings> Settings::createInstance()
+{
+    // Loading the settings logs, which reads the settings being loaded.
+    static std::shared_ptr<Settings> loading;
+
+    std::lock_guard<std::recursive_mutex> lock(settingsMutex());
+    std::shared_ptr<Settings> settings = std::atomic_load(&currentSettings());
+    if (settings)
+        return settings;
+    if (loading)
+        return loading;
+
+    loading.reset(new Settings());
+    loading->Initialize();
+    std::atomic_store(&currentSettings(), loading);
+    LOG(LogLevel::INFOS) << "New settings instance created.";
+    return loading;
+}
+
+void Settings::reload()
+{
+    std::shared_ptr<Settings> settings(new Settings());
+    settings->LoadSettings();
+
+    // The first settings also open the log file.
+    std::lock_guard<std::recursive_mutex> lock(settingsMutex());
+    getInstance();
+
+    // Readers still holding the previous settings keep them alive.
+    std::atomic_store(&currentSettings(), settings);
+    LOG(LogLevel::INFOS) << "Settings reloaded.";
 }
 
 // Loads log settings structure from the specified XML file
@@ -153,8 +205,13 @@ void Settings::LoadSettings()
         DefaultReader = pt.get<std::string>("config.reader.default", "PCSC");
         SystemReaders = pt.get("config.reader.systemReaders", false);
 
+        PluginManifestFile      = pt.get<std::string>("config.plugins.manifest", "");
+        BackgroundPluginLoading = pt.get("config.plugins.backgroundLoading", false);
+
         DataTransportTimeout = pt.get<int>("config.dataTransportTimeout", 3000);
         ProximityCheckResponseTimeMultiplier = pt.get<double>("config.proximityCheckResponseTimeMultiplier", 2);
+        IsDESFireAuthenticationCacheEnabled =
+            pt.get("config.desfire.authenticationCache", true);
 
         PluginFolders.clear();
         BOOST_FOREACH (ptree::value_type const &v, pt.get_child("config.PluginFolders"))
@@ -211,8 +268,12 @@ void Settings::SaveSettings() const
         pt.put("config.reader.default", "PCSC");
         pt.put("config.reader.systemReaders", SystemReaders);
 
+        pt.put("config.plugins.manifest", PluginManifestFile);
+        pt.put("config.plugins.backgroundLoading", BackgroundPluginLoading);
+
         pt.put("config.dataTransportTimeout", DataTransportTimeout);
         pt.put("config.proximityCheckResponseTimeMultiplier", ProximityCheckResponseTimeMultiplier);
+        pt.put("config.desfire.authenticationCache", IsDESFireAuthenticationCacheEnabled);
 
         // Write the property tree to the XML file.
         write_xml((getDllPath() + "/liblogicalaccess.config"), pt);
@@ -243,8 +304,12 @@ void Settings::reset()
     SystemReaders               = false;
     PluginFolders.clear();
     PluginFolders.push_back(getDllPath());
+    PluginManifestFile      = "";
+    BackgroundPluginLoading = false;
 
     DataTransportTimeout = 3000;
+
+    IsDESFireAuthenticationCacheEnabled = true;
 }
 
 std::string Settings::getDllPath()
@@ -268,7 +333,7 @@ std::string Settings::getDllPath()
             HMODULE hm = nullptr;
             if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
                                         GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
-                                    (LPCSTR)&instance, &hm))
+                                    (LPCSTR)&__hLibLogicalAccessModule, &hm))
             {
                 int ret = GetLastError();
                 sprintf(tmp, "GetModuleHandle returned %d\n", ret);
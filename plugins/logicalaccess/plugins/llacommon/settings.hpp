@@ -7,6 +7,7 @@
 #ifndef LOGICALACCESS_SETTINGS_HPP
 #define LOGICALACCESS_SETTINGS_HPP
 
+#include <memory>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -17,7 +18,24 @@ namespace logicalaccess
 class LLA_COMMON_API Settings
 {
   public:
-    static Settings *getInstance();
+    /**
+     * \brief Get the current settings.
+     *
+     * Once loaded, this is an atomic load of a shared pointer, without lock
+     * contention. Callers reading several fields should keep the returned
+     * pointer, so that a concurrent reload() doesn't mix two configurations.
+     */
+    static std::shared_ptr<Settings> getInstance();
+
+    /**
+     * \brief Load the configuration files again and publish the result as the
+     * current settings.
+     *
+     * The previous settings stay valid for readers still holding them, and are
+     * freed with the last of them. Programmatic changes made to them are not
+     * carried over. The log file is not reopened.
+     */
+    static void reload();
 
     void Initialize();
     static void Uninitialize();
@@ -46,6 +64,17 @@ class LLA_COMMON_API Settings
     std::vector<std::string> PluginFolders;
     bool SystemReaders;
 
+    /**
+     * Plug-in manifest file, listing the plug-ins and their types. When set,
+     * plug-ins are loaded on demand as long as the manifest is up to date.
+     */
+    std::string PluginManifestFile;
+
+    /**
+     * Load the plug-ins not requested yet in background, with a manifest.
+     */
+    bool BackgroundPluginLoading;
+
     /* Networking */
 
     /**
@@ -66,6 +95,14 @@ class LLA_COMMON_API Settings
      */
     double ProximityCheckResponseTimeMultiplier;
 
+    /**
+     * Skip DESFire authentications when the selected application is already
+     * authenticated with the same key.
+     *
+     * Enabled by default.
+     */
+    bool IsDESFireAuthenticationCacheEnabled;
+
     static std::string getDllPath();
 
   protected:
@@ -74,7 +111,10 @@ class LLA_COMMON_API Settings
     void LoadSettings();
     void SaveSettings() const;
 
-    static Settings *instance;
+    /**
+     * \brief Create and load the first settings, on first use.
+     */
+    static std::shared_ptr<Settings> createInstance();
 
   private:
     void reset();
@@ -1,14 +1,16 @@
 #include <logicalaccess/lla_fwd.hpp>
 #include <logicalaccess/services/aes_crypto_service.hpp>
 #include "cppkcs11/services/crypto_service.hpp"
-#include "cppkcs11/services/object_service.hpp"
-#include "cppkcs11/session.hpp"
+#include "pkcssessionpool.hpp"
 #include <logicalaccess/cards/pkcskeystorage.hpp>
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <logicalaccess/myexception.hpp>
 #include "cppkcs11/cppkcs11.hpp"
 #include "logicalaccess/key.hpp"
 
+#include <map>
+#include <mutex>
+
 namespace logicalaccess
 {
 class AESCryptoPKCSProvider : public IAESCryptoService
@@ -17,49 +19,93 @@ class AESCryptoPKCSProvider : public IAESCryptoService
     ByteVector aes_encrypt(const ByteVector &data, const ByteVector &iv,
                            std::shared_ptr<logicalaccess::Key> key) override
     {
-        std::shared_ptr<PKCSKeyStorage> storage =
-            std::dynamic_pointer_cast<PKCSKeyStorage>(key->getKeyStorage());
-        EXCEPTION_ASSERT_WITH_LOG(storage, LibLogicalAccessException, "No key storage.");
-
-        auto session        = cppkcs::open_session(static_cast<CK_SLOT_ID>(storage->get_slot_id()), 0);
-        std::string pw_copy = storage->get_pkcs_session_password();
-        session.login(cppkcs::SecureString(std::move(pw_copy)));
-
-        auto pkcs_key = find_key(session, *storage);
-
-        cppkcs::CryptoService cs(session);
-
-        cppkcs::SecureString secure_data(data.data(), data.size());
-        return cs.aes_encrypt(secure_data, iv, pkcs_key);
+        return aes_encrypt(std::vector<AESOperation>{{data, iv, key}}).at(0);
     }
 
     ByteVector aes_decrypt(const ByteVector &data, const ByteVector &iv,
                            std::shared_ptr<logicalaccess::Key> key) override
     {
-        std::shared_ptr<PKCSKeyStorage> storage =
-            std::dynamic_pointer_cast<PKCSKeyStorage>(key->getKeyStorage());
-        EXCEPTION_ASSERT_WITH_LOG(storage, LibLogicalAccessException, "No key storage.");
-
-        auto session        = cppkcs::open_session(static_cast<CK_SLOT_ID>(storage->get_slot_id()), 0);
-        std::string pw_copy = storage->get_pkcs_session_password();
-        session.login(cppkcs::SecureString(std::move(pw_copy)));
-
-        auto pkcs_key = find_key(session, *storage);
+        return aes_decrypt(std::vector<AESOperation>{{data, iv, key}}).at(0);
+    }
 
-        cppkcs::CryptoService cs(session);
+    std::vector<ByteVector>
+    aes_encrypt(const std::vector<AESOperation> &operations) override
+    {
+        return run(operations, [](cppkcs::CryptoService &cs, const AESOperation &op,
+                                  cppkcs::Object &pkcs_key) {
+            cppkcs::SecureString secure_data(op.data.data(), op.data.size());
+            return cs.aes_encrypt(secure_data, op.iv, pkcs_key);
+        });
+    }
 
-        auto clear = cs.aes_decrypt(data, iv, pkcs_key);
-        return ByteVector(clear.data(), clear.data() + clear.size());
+    std::vector<ByteVector>
+    aes_decrypt(const std::vector<AESOperation> &operations) override
+    {
+        return run(operations, [](cppkcs::CryptoService &cs, const AESOperation &op,
+                                  cppkcs::Object &pkcs_key) {
+            auto clear = cs.aes_decrypt(op.data, op.iv, pkcs_key);
+            return ByteVector(clear.data(), clear.data() + clear.size());
+        });
     }
 
   private:
-    cppkcs::Object find_key(cppkcs::Session &session, const PKCSKeyStorage &storage)
+    typedef std::function<ByteVector(cppkcs::CryptoService &, const AESOperation &,
+                                     cppkcs::Object &)>
+        Operation;
+
+    static std::shared_ptr<PKCSKeyStorage> get_storage(const AESOperation &op)
     {
-        cppkcs::ObjectService os(session);
+        std::shared_ptr<PKCSKeyStorage> storage =
+            std::dynamic_pointer_cast<PKCSKeyStorage>(op.key->getKeyStorage());
+        EXCEPTION_ASSERT_WITH_LOG(storage, LibLogicalAccessException, "No key storage.");
+        return storage;
+    }
 
-        return std::move(
-            os.find_objects(cppkcs::make_attribute<CKA_ID>(storage.get_key_id())).at(0));
+    /**
+     * Run a batch with a single session lease per slot.
+     */
+    std::vector<ByteVector> run(const std::vector<AESOperation> &operations,
+                                const Operation &operation)
+    {
+        std::map<CK_SLOT_ID, std::vector<size_t>> slots;
+        for (size_t i = 0; i < operations.size(); ++i)
+        {
+            size_t slot = get_storage(operations[i])->get_slot_id();
+            slots[static_cast<CK_SLOT_ID>(slot)].push_back(i);
+        }
+
+        std::vector<ByteVector> results(operations.size());
+        for (const auto &slot : slots)
+        {
+            const std::vector<size_t> &indexes = slot.second;
+            std::vector<ByteVector> keyIds;
+            for (size_t i : indexes)
+            {
+                keyIds.push_back(get_storage(operations[i])->get_key_id());
+            }
+
+            std::vector<ByteVector> slotResults = pool_.run(
+                slot.first,
+                get_storage(operations[indexes.front()])->get_pkcs_session_password(),
+                keyIds,
+                [&](cppkcs::Session &session, const std::vector<cppkcs::Object *> &keys) {
+                    cppkcs::CryptoService cs(session);
+                    std::vector<ByteVector> ret;
+                    for (size_t i = 0; i < keys.size(); ++i)
+                    {
+                        ret.push_back(operation(cs, operations[indexes[i]], *keys[i]));
+                    }
+                    return ret;
+                });
+            for (size_t i = 0; i < indexes.size(); ++i)
+            {
+                results[indexes[i]] = std::move(slotResults[i]);
+            }
+        }
+        return results;
     }
+
+    PKCSSessionPool pool_;
 };
 }
 
@@ -70,18 +116,21 @@ char *getLibraryName()
     return (char *)"PKCSAESCrypto";
 }
 
-static bool pkcs_initialized = false;
+static std::mutex pkcs_mutex;
+static std::shared_ptr<logicalaccess::IAESCryptoService> pkcs_provider;
 
 void
 getPKCSAESCrypto(std::shared_ptr<logicalaccess::IAESCryptoService> &aes_crypto,
                  const std::string &pkcs_shared_object_path)
 {
-    if (!pkcs_initialized)
+    // A single provider, so that its session pool is shared by every caller.
+    std::lock_guard<std::mutex> lock(pkcs_mutex);
+    if (!pkcs_provider)
     {
         cppkcs::load_pkcs(pkcs_shared_object_path);
         cppkcs::initialize();
-        pkcs_initialized = true;
+        pkcs_provider = std::make_shared<logicalaccess::AESCryptoPKCSProvider>();
     }
-    aes_crypto = std::make_shared<logicalaccess::AESCryptoPKCSProvider>();
+    aes_crypto = pkcs_provider;
 }
 }
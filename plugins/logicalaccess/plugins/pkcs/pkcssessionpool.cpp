@@ -0,0 +1,144 @@
+/**
+ * \file pkcssessionpool.cpp
+ * \brief Pool of logged-in PKCS#11 sessions.
+ */
+
+#include "pkcssessionpool.hpp"
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include "cppkcs11/cppkcs11.hpp"
+
+namespace logicalaccess
+{
+std::vector<ByteVector> PKCSSessionPool::run(CK_SLOT_ID slot, const std::string &password,
+                                             const std::vector<ByteVector> &keyIds,
+                                             const Operation &operation)
+{
+    for (unsigned int attempt = 0;; ++attempt)
+    {
+        SessionLease session(*this, slot, acquire(slot, password));
+        // The cached key objects of another session may be stale as well.
+        if (attempt > 0)
+            session->keys.clear();
+
+        bool cached = false;
+        try
+        {
+            std::vector<cppkcs::Object *> keys;
+            keys.reserve(keyIds.size());
+            for (const ByteVector &keyId : keyIds)
+            {
+                auto it = session->keys.find(keyId);
+                if (it != session->keys.end())
+                {
+                    cached = true;
+                }
+                else
+                {
+                    cppkcs::ObjectService os(session->session);
+                    auto objects = os.find_objects(cppkcs::make_attribute<CKA_ID>(keyId));
+                    it = session->keys.emplace(keyId, std::move(objects.at(0))).first;
+                }
+                keys.push_back(&it->second);
+            }
+
+            std::vector<ByteVector> results = operation(session->session, keys);
+            session.release();
+            return results;
+        }
+        catch (std::exception &e)
+        {
+            LOG(LogLevel::WARNINGS) << "PKCS operation failed on slot {" << slot
+                                    << "}, discarding its session: " << e.what();
+            if (!cached || attempt > 0)
+                throw;
+        }
+    }
+}
+
+std::unique_ptr<PKCSSessionPool::PooledSession>
+PKCSSessionPool::acquire(CK_SLOT_ID slot, const std::string &password)
+{
+    bool login;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot &s = slots_[slot];
+        if (!s.idle.empty())
+        {
+            std::unique_ptr<PooledSession> session = std::move(s.idle.back());
+            s.idle.pop_back();
+            return session;
+        }
+        login = !s.loggedIn;
+        ++s.opened;
+    }
+
+    try
+    {
+        std::unique_ptr<PooledSession> session(
+            new PooledSession(cppkcs::open_session(slot, 0)));
+        if (login)
+        {
+            try
+            {
+                std::string pw_copy = password;
+                session->session.login(cppkcs::SecureString(std::move(pw_copy)));
+            }
+            catch (cppkcs::PKCSException &e)
+            {
+                // Another session of the slot, opened concurrently, logged in
+                // first. Other failures, such as a wrong PIN, are reported.
+                if (e.rv() != CKR_USER_ALREADY_LOGGED_IN)
+                    throw;
+                LOG(LogLevel::INFOS) << "PKCS slot {" << slot
+                                     << "} is already logged in.";
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots_[slot].loggedIn = true;
+        }
+        return session;
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --slots_[slot].opened;
+        throw;
+    }
+}
+
+void PKCSSessionPool::release(CK_SLOT_ID slot, std::unique_ptr<PooledSession> session)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_[slot].idle.push_back(std::move(session));
+}
+
+void PKCSSessionPool::discard(CK_SLOT_ID slot, std::unique_ptr<PooledSession> session)
+{
+    // Closed outside of the pool lock.
+    session.reset();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot &s = slots_[slot];
+    // Closing the last session of the application logs the token out.
+    if (--s.opened == 0)
+        s.loggedIn = false;
+}
+
+PKCSSessionPool::SessionLease::SessionLease(PKCSSessionPool &pool, CK_SLOT_ID slot,
+                                            std::unique_ptr<PooledSession> session)
+    : pool_(pool)
+    , slot_(slot)
+    , session_(std::move(session))
+{
+}
+
+PKCSSessionPool::SessionLease::~SessionLease()
+{
+    if (session_)
+        pool_.discard(slot_, std::move(session_));
+}
+
+void PKCSSessionPool::SessionLease::release()
+{
+    pool_.release(slot_, std::move(session_));
+}
+}
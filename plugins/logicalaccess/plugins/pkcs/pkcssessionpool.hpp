@@ -0,0 +1,143 @@
+/**
+ * \file pkcssessionpool.hpp
+ * \brief Pool of logged-in PKCS#11 sessions.
+ */
+
+#ifndef LOGICALACCESS_PKCSSESSIONPOOL_HPP
+#define LOGICALACCESS_PKCSSESSIONPOOL_HPP
+
+#include <logicalaccess/lla_fwd.hpp>
+#include "cppkcs11/services/object_service.hpp"
+#include "cppkcs11/session.hpp"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace logicalaccess
+{
+/**
+ * \brief Pool of PKCS#11 sessions, by slot.
+ *
+ * Opening a session and logging in is the most expensive part of a PKCS#11
+ * operation, and DESFire or OSDP authentication does several of them per card.
+ * Sessions are opened and logged in once, then lent to one operation at a
+ * time: threads working on the same slot each get their own session. Every
+ * pooled session also caches the objects of the keys already found on it.
+ *
+ * An operation that fails discards its session and key cache: the token may
+ * have been removed, logged out or its keys changed. The other sessions of the
+ * slot are kept, an operation retried after a cached key failed looks its keys
+ * up again.
+ */
+class PKCSSessionPool
+{
+  public:
+    /**
+     * \brief A session lent to an operation.
+     */
+    struct PooledSession
+    {
+        explicit PooledSession(cppkcs::Session &&s)
+            : session(std::move(s))
+        {
+        }
+
+        cppkcs::Session session;
+
+        /**
+         * \brief Key objects already found on this session, by CKA_ID.
+         */
+        std::map<ByteVector, cppkcs::Object> keys;
+    };
+
+    typedef std::function<std::vector<ByteVector>(cppkcs::Session &,
+                                                  const std::vector<cppkcs::Object *> &)>
+        Operation;
+
+    /**
+     * \brief Run a batch of operations with a logged-in session of a slot and
+     * the objects of their keys. The batch is retried once, with a new session,
+     * if it failed with a key object taken from the cache.
+     * \param slot The token slot.
+     * \param password The user password, used when a new login is needed.
+     * \param keyIds The CKA_ID of the key of each operation.
+     * \param operation The operations, given the key objects in the same order.
+     * \return The operation results.
+     */
+    std::vector<ByteVector> run(CK_SLOT_ID slot, const std::string &password,
+                                const std::vector<ByteVector> &keyIds,
+                                const Operation &operation);
+
+  private:
+    struct Slot
+    {
+        Slot()
+            : opened(0)
+            , loggedIn(false)
+        {
+        }
+
+        /**
+         * \brief Number of sessions open on the slot, idle, lent or being opened.
+         */
+        size_t opened;
+
+        /**
+         * \brief The login state is shared by every session of the
+         * application on the token.
+         */
+        bool loggedIn;
+
+        std::vector<std::unique_ptr<PooledSession>> idle;
+    };
+
+    /**
+     * \brief A session lent to an operation. Unless released back to the pool,
+     * the session is discarded when the lease ends, whatever the exception.
+     */
+    class SessionLease
+    {
+      public:
+        SessionLease(PKCSSessionPool &pool, CK_SLOT_ID slot,
+                     std::unique_ptr<PooledSession> session);
+
+        ~SessionLease();
+
+        SessionLease(const SessionLease &) = delete;
+        SessionLease &operator=(const SessionLease &) = delete;
+
+        PooledSession *operator->() const
+        {
+            return session_.get();
+        }
+
+        void release();
+
+      private:
+        PKCSSessionPool &pool_;
+
+        CK_SLOT_ID slot_;
+
+        std::unique_ptr<PooledSession> session_;
+    };
+
+    /**
+     * \brief Take an idle session of the slot, or open a new one. Opening and
+     * logging in are done outside of the pool lock.
+     */
+    std::unique_ptr<PooledSession> acquire(CK_SLOT_ID slot, const std::string &password);
+
+    void release(CK_SLOT_ID slot, std::unique_ptr<PooledSession> session);
+
+    void discard(CK_SLOT_ID slot, std::unique_ptr<PooledSession> session);
+
+    std::mutex mutex_;
+
+    std::map<CK_SLOT_ID, Slot> slots_;
+};
+}
+
+#endif /* LOGICALACCESS_PKCSSESSIONPOOL_HPP */
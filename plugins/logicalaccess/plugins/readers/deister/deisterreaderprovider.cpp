@@ -80,4 +80,9 @@ bool DeisterReaderProvider::refreshReaderList()
 
     return true;
 }
+
+bool DeisterReaderProvider::waitReaderListChange(unsigned int maxwait)
+{
+    return d_portListWatcher.wait(maxwait);
+}
 }
\ No newline at end of file
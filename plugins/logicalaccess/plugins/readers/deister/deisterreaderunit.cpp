@@ -11,6 +11,7 @@
 #include <sstream>
 
 #include <logicalaccess/plugins/readers/deister/deisterreaderprovider.hpp>
+#include <logicalaccess/readerproviders/insertionpoller.hpp>
 #include <logicalaccess/services/accesscontrol/cardsformatcomposite.hpp>
 #include <logicalaccess/cards/chip.hpp>
 #include <logicalaccess/plugins/readers/deister/readercardadapters/deisterreadercardadapter.hpp>
@@ -19,6 +20,7 @@
 #include <logicalaccess/myexception.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/metrics.hpp>
 
 namespace logicalaccess
 {
@@ -31,6 +33,11 @@ DeisterReaderUnit::DeisterReaderUnit()
     ReaderUnit::setDataTransport(dataTransport);
     d_card_type = CHIP_UNKNOWN;
 
+    d_insertionPoller =
+        std::make_shared<InsertionPoller>([this]() { return getChipInAir(); });
+    // Deister 'forget' the card after about one second.
+    d_insertionPoller->setRemovalInterval(1000);
+
     try
     {
         boost::property_tree::ptree pt;
@@ -46,6 +53,7 @@ DeisterReaderUnit::DeisterReaderUnit()
 
 DeisterReaderUnit::~DeisterReaderUnit()
 {
+    d_insertionPoller->stop();
     DeisterReaderUnit::disconnectFromReader();
 }
 
@@ -66,24 +74,16 @@ void DeisterReaderUnit::setCardType(std::string cardType)
 
 bool DeisterReaderUnit::waitInsertion(unsigned int maxwait)
 {
-    bool inserted = false;
-    std::chrono::steady_clock::time_point const clock_timeout =
-        std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-
-    do
+    d_insertionPoller->listen(getDataTransport());
+    LatencyRecorder metrics("lla_wait_insertion", {{"reader", getName()}});
+    std::shared_ptr<Chip> chip = d_insertionPoller->waitInsertion(maxwait);
+    metrics.setResult(chip ? "inserted" : "timeout");
+    if (chip)
     {
-        std::shared_ptr<Chip> chip = getChipInAir();
-        if (chip)
-        {
-            d_insertedChip = chip;
-            inserted       = true;
-        }
-
-        if (!inserted)
-            std::this_thread::sleep_for(std::chrono::milliseconds(250));
-    } while (!inserted && std::chrono::steady_clock::now() < clock_timeout);
+        d_insertedChip = chip;
+    }
 
-    return inserted;
+    return bool(chip);
 }
 
 bool DeisterReaderUnit::waitRemoval(unsigned int maxwait)
@@ -92,30 +92,12 @@ bool DeisterReaderUnit::waitRemoval(unsigned int maxwait)
 
     if (d_insertedChip)
     {
-        std::chrono::steady_clock::time_point const clock_timeout =
-            std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-        do
+        removed = d_insertionPoller->waitRemoval(d_insertedChip->getChipIdentifier(),
+                                                 maxwait);
+        if (removed)
         {
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds(1000)); // Deister 'forget' the card...
-            std::shared_ptr<Chip> chip = getChipInAir();
-            if (chip)
-            {
-                if (chip->getChipIdentifier() != d_insertedChip->getChipIdentifier())
-                {
-                    d_insertedChip.reset();
-                    removed = true;
-                }
-            }
-            else
-            {
-                d_insertedChip.reset();
-                removed = true;
-            }
-
-            if (!removed)
-                std::this_thread::sleep_for(std::chrono::milliseconds(250));
-        } while (!removed && std::chrono::steady_clock::now() < clock_timeout);
+            d_insertedChip.reset();
+        }
     }
 
     return removed;
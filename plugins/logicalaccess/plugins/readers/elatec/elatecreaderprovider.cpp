@@ -80,4 +80,9 @@ bool ElatecReaderProvider::refreshReaderList()
 
     return true;
 }
+
+bool ElatecReaderProvider::waitReaderListChange(unsigned int maxwait)
+{
+    return d_portListWatcher.wait(maxwait);
+}
 }
\ No newline at end of file
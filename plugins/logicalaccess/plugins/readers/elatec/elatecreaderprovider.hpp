@@ -8,6 +8,7 @@
 #define LOGICALACCESS_READERELATEC_PROVIDER_HPP
 
 #include <logicalaccess/readerproviders/readerprovider.hpp>
+#include <logicalaccess/readerproviders/serialportxml.hpp>
 #include <logicalaccess/plugins/readers/elatec/elatecreaderunit.hpp>
 
 #include <string>
@@ -64,6 +65,13 @@ class LLA_READERS_ELATEC_API ElatecReaderProvider : public ReaderProvider
      */
     bool refreshReaderList() override;
 
+    /**
+     * \brief Wait for a serial port to be plugged or unplugged.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the reader list may have changed, false on timeout.
+     */
+    bool waitReaderListChange(unsigned int maxwait) override;
+
     /**
      * \brief Get reader list for this reader provider.
      * \return The reader list.
@@ -89,6 +97,11 @@ class LLA_READERS_ELATEC_API ElatecReaderProvider : public ReaderProvider
      * \brief The reader list.
      */
     ReaderList d_readers;
+
+    /**
+     * \brief Watch the serial ports plugged or unplugged between two waits.
+     */
+    SerialPortListWatcher d_portListWatcher;
 };
 }
 
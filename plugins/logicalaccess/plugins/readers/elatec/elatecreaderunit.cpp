@@ -11,12 +11,14 @@
 #include <sstream>
 
 #include <logicalaccess/plugins/readers/elatec/elatecreaderprovider.hpp>
+#include <logicalaccess/readerproviders/insertionpoller.hpp>
 #include <logicalaccess/services/accesscontrol/cardsformatcomposite.hpp>
 #include <logicalaccess/cards/chip.hpp>
 #include <logicalaccess/plugins/readers/elatec/readercardadapters/elatecreadercardadapter.hpp>
 #include <boost/filesystem.hpp>
 #include <logicalaccess/plugins/readers/elatec/readercardadapters/elatecserialportdatatransport.hpp>
 #include <logicalaccess/plugins/readers/elatec/readercardadapters/elatecbufferparser.hpp>
+#include <logicalaccess/metrics.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
 namespace logicalaccess
@@ -30,6 +32,9 @@ ElatecReaderUnit::ElatecReaderUnit()
     ReaderUnit::setDataTransport(dataTransport);
     d_card_type = CHIP_UNKNOWN;
 
+    d_insertionPoller =
+        std::make_shared<InsertionPoller>([this]() { return getChipInAir(); });
+
     try
     {
         boost::property_tree::ptree pt;
@@ -45,6 +50,7 @@ ElatecReaderUnit::ElatecReaderUnit()
 
 ElatecReaderUnit::~ElatecReaderUnit()
 {
+    d_insertionPoller->stop();
     ElatecReaderUnit::disconnectFromReader();
 }
 
@@ -65,24 +71,16 @@ void ElatecReaderUnit::setCardType(std::string cardType)
 
 bool ElatecReaderUnit::waitInsertion(unsigned int maxwait)
 {
-    bool inserted = false;
-    std::chrono::steady_clock::time_point const clock_timeout =
-        std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-
-    do
+    d_insertionPoller->listen(getDataTransport());
+    LatencyRecorder metrics("lla_wait_insertion", {{"reader", getName()}});
+    std::shared_ptr<Chip> chip = d_insertionPoller->waitInsertion(maxwait);
+    metrics.setResult(chip ? "inserted" : "timeout");
+    if (chip)
     {
-        std::shared_ptr<Chip> chip = getChipInAir();
-        if (chip)
-        {
-            d_insertedChip = chip;
-            inserted       = true;
-        }
-
-        if (!inserted)
-            std::this_thread::sleep_for(std::chrono::milliseconds(250));
-    } while (!inserted && std::chrono::steady_clock::now() < clock_timeout);
+        d_insertedChip = chip;
+    }
 
-    return inserted;
+    return bool(chip);
 }
 
 bool ElatecReaderUnit::waitRemoval(unsigned int maxwait)
@@ -91,28 +89,12 @@ bool ElatecReaderUnit::waitRemoval(unsigned int maxwait)
 
     if (d_insertedChip)
     {
-        std::chrono::steady_clock::time_point const clock_timeout =
-            std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-        do
+        removed = d_insertionPoller->waitRemoval(d_insertedChip->getChipIdentifier(),
+                                                 maxwait);
+        if (removed)
         {
-            std::shared_ptr<Chip> chip = getChipInAir();
-            if (chip)
-            {
-                if (chip->getChipIdentifier() != d_insertedChip->getChipIdentifier())
-                {
-                    d_insertedChip.reset();
-                    removed = true;
-                }
-            }
-            else
-            {
-                d_insertedChip.reset();
-                removed = true;
-            }
-
-            if (!removed)
-                std::this_thread::sleep_for(std::chrono::milliseconds(250));
-        } while (!removed && std::chrono::steady_clock::now() < clock_timeout);
+            d_insertedChip.reset();
+        }
     }
 
     return removed;
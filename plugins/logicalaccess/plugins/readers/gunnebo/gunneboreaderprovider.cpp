@@ -83,4 +83,9 @@ bool GunneboReaderProvider::refreshReaderList()
 
     return true;
 }
+
+bool GunneboReaderProvider::waitReaderListChange(unsigned int maxwait)
+{
+    return d_portListWatcher.wait(maxwait);
+}
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #define LOGICALACCESS_READERGUNNEBO_PROVIDER_HPP
 
 #include <logicalaccess/readerproviders/readerprovider.hpp>
+#include <logicalaccess/readerproviders/serialportxml.hpp>
 #include <logicalaccess/plugins/readers/gunnebo/gunneboreaderunit.hpp>
 #include <logicalaccess/plugins/readers/gunnebo/lla_readers_gunnebo_api.hpp>
 #include <string>
@@ -66,6 +67,13 @@ class LLA_READERS_GUNNEBO_API GunneboReaderProvider : public ReaderProvider
      */
     bool refreshReaderList() override;
 
+    /**
+     * \brief Wait for a serial port to be plugged or unplugged.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the reader list may have changed, false on timeout.
+     */
+    bool waitReaderListChange(unsigned int maxwait) override;
+
     /**
      * \brief Get reader list for this reader provider.
      * \return The reader list.
@@ -91,6 +99,11 @@ class LLA_READERS_GUNNEBO_API GunneboReaderProvider : public ReaderProvider
      * \brief The reader list.
      */
     ReaderList d_readers;
+
+    /**
+     * \brief Watch the serial ports plugged or unplugged between two waits.
+     */
+    SerialPortListWatcher d_portListWatcher;
 };
 }
 
@@ -11,6 +11,7 @@
 #include <sstream>
 
 #include <logicalaccess/plugins/readers/gunnebo/gunneboreaderprovider.hpp>
+#include <logicalaccess/readerproviders/insertionpoller.hpp>
 #include <logicalaccess/services/accesscontrol/cardsformatcomposite.hpp>
 #include <logicalaccess/cards/chip.hpp>
 #include <logicalaccess/plugins/readers/gunnebo/readercardadapters/gunneboreadercardadapter.hpp>
@@ -23,6 +24,7 @@
 #include <boost/property_tree/xml_parser.hpp>
 
 #include <logicalaccess/plugins/readers/gunnebo/readercardadapters/gunneboserialportdatatransport.hpp>
+#include <logicalaccess/metrics.hpp>
 
 namespace logicalaccess
 {
@@ -42,6 +44,30 @@ GunneboReaderUnit::GunneboReaderUnit()
     ReaderUnit::setDataTransport(dataTransport);
     d_card_type = CHIP_UNKNOWN;
 
+    d_insertionPoller = std::make_shared<InsertionPoller>([this]() {
+        std::shared_ptr<Chip> chip;
+        ByteVector createChipId = readCardId();
+        if (createChipId.size() > 0)
+        {
+            chip = ReaderUnit::createChip(
+                (d_card_type == CHIP_UNKNOWN ? CHIP_GENERICTAG : d_card_type),
+                createChipId);
+        }
+        return chip;
+    });
+    // The inserted chip will stay inserted until a new identifier is read on the
+    // serial port.
+    d_insertionPoller->setRemovalScan([this]() {
+        std::shared_ptr<Chip> chip = d_insertedChip;
+        ByteVector tmpId           = readCardId();
+        if (tmpId.size() > 0)
+        {
+            chip = ReaderUnit::createChip(
+                (d_card_type == CHIP_UNKNOWN ? CHIP_GENERICTAG : d_card_type), tmpId);
+        }
+        return chip;
+    });
+
     try
     {
         boost::property_tree::ptree pt;
@@ -59,6 +85,7 @@ GunneboReaderUnit::GunneboReaderUnit()
 
 GunneboReaderUnit::~GunneboReaderUnit()
 {
+    d_insertionPoller->stop();
     GunneboReaderUnit::disconnectFromReader();
 }
 
@@ -79,159 +106,104 @@ void GunneboReaderUnit::setCardType(std::string cardType)
     d_card_type = cardType;
 }
 
-bool GunneboReaderUnit::waitInsertion(unsigned int maxwait)
+ByteVector GunneboReaderUnit::readCardId()
 {
-    std::chrono::system_clock::time_point wait_until(std::chrono::system_clock::now() +
-                                                     std::chrono::milliseconds(maxwait));
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
+    ByteVector cardId;
+    try
     {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
+        // Gunnebo reader doesn't handle commands but we want to simulate the same
+        // behavior that for all readers
+        // So we send a dummy commmand which does nothing
+        ByteVector cmd;
+        cmd.push_back(0xff); // trick
+
+        ByteVector tmpASCIIId = getDefaultGunneboReaderCardAdapter()->sendCommand(cmd);
+        if (tmpASCIIId.size() > 0)
+        {
+            cardId = processCardId(tmpASCIIId);
+        }
+    }
+    catch (std::exception &)
+    {
+        // No response received is ignored !
     }
+    return cardId;
+}
+
+bool GunneboReaderUnit::waitInsertion(unsigned int maxwait)
+{
+    // Disable logs for this part (otherwise too much log output in file)
+    LogContext logFilter("", getLogMask() & (Settings::getInstance()->SeeWaitInsertionLog
+                                                 ? LOG_ALL_LEVELS
+                                                 : 0));
 
     LOG(LogLevel::INFOS) << "Waiting insertion... max wait {" << maxwait << "}";
 
     bool inserted = false;
-    ByteVector createChipId;
 
-    try
+    if (removalIdentifier.size() > 0)
     {
-        // Gunnebo reader doesn't handle commands but we want to simulate the same
-        // behavior that for all readers
-        // So we send a dummy commmand which does nothing
-        do
+        d_insertedChip = ReaderUnit::createChip(
+            (d_card_type == CHIP_UNKNOWN ? CHIP_GENERICTAG : d_card_type),
+            removalIdentifier);
+        inserted = true;
+    }
+    else
+    {
+        // The reader sends the identifiers on its own: each frame wakes up
+        // the poller.
+        d_insertionPoller->listen(getDataTransport());
+        LatencyRecorder metrics("lla_wait_insertion", {{"reader", getName()}});
+        std::shared_ptr<Chip> chip = d_insertionPoller->waitInsertion(
+            maxwait == 0 ? InsertionPoller::WAIT_FOREVER : maxwait);
+        metrics.setResult(chip ? "inserted" : "timeout");
+        if (chip)
         {
-            try
-            {
-                if (removalIdentifier.size() > 0)
-                {
-                    createChipId = removalIdentifier;
-                }
-                else
-                {
-                    ByteVector cmd;
-                    cmd.push_back(0xff); // trick
-
-                    ByteVector tmpASCIIId =
-                        getDefaultGunneboReaderCardAdapter()->sendCommand(cmd);
-
-                    if (tmpASCIIId.size() > 0)
-                    {
-                        createChipId = processCardId(tmpASCIIId);
-                    }
-                }
-
-                if (createChipId.size() > 0)
-                {
-                    d_insertedChip = ReaderUnit::createChip(
-                        (d_card_type == CHIP_UNKNOWN ? CHIP_GENERICTAG : d_card_type),
-                        createChipId);
-                    LOG(LogLevel::INFOS) << "Chip detected !";
-                    inserted = true;
-                }
-            }
-            catch (std::exception &)
-            {
-                // No response received is ignored !
-            }
-
-            if (!inserted)
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(250));
-            }
-        } while (!inserted &&
-                 (std::chrono::system_clock::now() < wait_until || maxwait == 0));
+            d_insertedChip = chip;
+            inserted       = true;
+        }
     }
-    catch (...)
+
+    if (inserted)
     {
-        Settings::getInstance()->IsLogEnabled = oldValue;
-        throw;
+        LOG(LogLevel::INFOS) << "Chip detected !";
     }
 
     removalIdentifier.clear();
 
-    LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted
-                         << "} function timeout expired ? {"
-                         << (std::chrono::system_clock::now() > wait_until &&
-                             maxwait != 0)
-                         << "}";
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted << "}";
 
     return inserted;
 }
 
 bool GunneboReaderUnit::waitRemoval(unsigned int maxwait)
 {
-    std::chrono::steady_clock::time_point wait_until(std::chrono::steady_clock::now() +
-                                                     std::chrono::milliseconds(maxwait));
-
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
-    {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
-    }
+    // Disable logs for this part (otherwise too much log output in file)
+    LogContext logFilter("", getLogMask() & (Settings::getInstance()->SeeWaitRemovalLog
+                                                 ? LOG_ALL_LEVELS
+                                                 : 0));
 
     LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
     bool removed = false;
     removalIdentifier.clear();
 
-    try
+    if (d_insertedChip)
     {
-        // The inserted chip will stay inserted until a new identifier is read on the
-        // serial port.
-        if (d_insertedChip)
+        d_insertionPoller->listen(getDataTransport());
+        std::shared_ptr<Chip> replacement;
+        removed = d_insertionPoller->waitRemoval(
+            d_insertedChip->getChipIdentifier(),
+            maxwait == 0 ? InsertionPoller::WAIT_FOREVER : maxwait, &replacement);
+        if (removed)
         {
-            do
-            {
-                try
-                {
-                    ByteVector cmd;
-                    cmd.push_back(0xff); // trick
-
-                    ByteVector buf =
-                        getDefaultGunneboReaderCardAdapter()->sendCommand(cmd);
-                    if (buf.size() > 0)
-                    {
-                        ByteVector tmpId = processCardId(buf);
-                        if (tmpId.size() > 0 &&
-                            (tmpId != d_insertedChip->getChipIdentifier()))
-                        {
-                            LOG(LogLevel::INFOS) << "Card found but not same chip ! The "
-                                                    "previous card has been removed !";
-                            d_insertedChip.reset();
-                            removalIdentifier = tmpId;
-                            removed           = true;
-                        }
-                    }
-                }
-                catch (std::exception &)
-                {
-                    // No response received is ignored !
-                }
-
-                if (!removed)
-                {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250));
-                }
-            } while (!removed &&
-                     (std::chrono::steady_clock::now() < wait_until || maxwait == 0));
+            LOG(LogLevel::INFOS) << "Card found but not same chip ! The "
+                                    "previous card has been removed !";
+            d_insertedChip.reset();
+            removalIdentifier = replacement->getChipIdentifier();
         }
     }
-    catch (...)
-    {
-        Settings::getInstance()->IsLogEnabled = oldValue;
-        throw;
-    }
-
-    LOG(LogLevel::INFOS) << "Returns card removed ? {" << removed
-                         << "} - function timeout expired ? {"
-                         << (std::chrono::steady_clock::now() > wait_until &&
-                             maxwait != 0)
-                         << "}";
 
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    LOG(LogLevel::INFOS) << "Returns card removed ? {" << removed << "}";
 
     return removed;
 }
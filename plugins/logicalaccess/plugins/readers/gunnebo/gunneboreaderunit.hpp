@@ -186,6 +186,12 @@ class LLA_READERS_GUNNEBO_API GunneboReaderUnit : public ReaderUnit
      */
     ByteVector processCardId(ByteVector &rawSerialData) const;
 
+    /**
+     * \brief Read the last identifier sent by the reader.
+     * \return The card identifier, empty if no identifier was sent.
+     */
+    ByteVector readCardId();
+
   protected:
     /**
      * \brief The new identifier that will be used for the next waitInsertion after the
@@ -28,9 +28,29 @@
 #include <logicalaccess/dynlibrary/librarymanager.hpp>
 #include <logicalaccess/services/aes_crypto_service.hpp>
 #include <logicalaccess/cards/computermemorykeystorage.hpp>
+#include <logicalaccess/metrics.hpp>
 
 namespace logicalaccess
 {
+namespace
+{
+/**
+ * \brief ISO 7816 commands sent to a DESFire card. An ISO SELECT changes the
+ * selected application behind the DESFire commands back.
+ */
+class DESFireISO7816ISO7816Commands : public ISO7816ISO7816Commands
+{
+  public:
+    void selectFile(unsigned char p1, unsigned char p2, const ByteVector &data) override
+    {
+        auto chip = std::dynamic_pointer_cast<DESFireChip>(getChip());
+        if (chip)
+            chip->getMetadataCache()->invalidateSelection();
+        ISO7816ISO7816Commands::selectFile(p1, p2, data);
+    }
+};
+}
+
 DESFireEV1ISO7816Commands::DESFireEV1ISO7816Commands()
     : DESFireISO7816Commands(CMD_DESFIREEV1ISO7816)
 {
@@ -138,6 +158,10 @@ void DESFireEV1ISO7816Commands::getKeySettings(DESFireKeySettings &settings,
                                                unsigned char &maxNbKeys,
                                                DESFireKeyType &keyType)
 {
+    auto cache = getDESFireChip()->getMetadataCache();
+    if (cache->getKeySettings(settings, maxNbKeys, keyType))
+        return;
+
     ByteVector r = transmit(DF_INS_GET_KEY_SETTINGS).getData();
 
     if (r.size() == 0)
@@ -159,6 +183,7 @@ void DESFireEV1ISO7816Commands::getKeySettings(DESFireKeySettings &settings,
     {
         keyType = DF_KEY_DES;
     }
+    cache->setKeySettings(settings, maxNbKeys, keyType);
 }
 
 ByteVector DESFireEV1ISO7816Commands::getCardUID()
@@ -290,10 +315,17 @@ void DESFireEV1ISO7816Commands::createCyclicRecordFile(
 void DESFireEV1ISO7816Commands::authenticate(unsigned char keyno,
                                              std::shared_ptr<DESFireKey> key)
 {
+    AuthenticationRecorder metrics(*this);
+
     if (!key)
     {
         key = DESFireCrypto::getDefaultKey(DF_KEY_DES);
     }
+    if (isAuthenticated(keyno, key))
+    {
+        metrics.setResult("skipped");
+        return;
+    }
 
     std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
     crypto->setKey(crypto->d_currentAid, 0, keyno, key);
@@ -317,6 +349,8 @@ void DESFireEV1ISO7816Commands::authenticate(unsigned char keyno,
         }
     }
     onAuthenticated();
+    setAuthenticated(keyno, key);
+    metrics.succeed();
 }
 
 void DESFireEV1ISO7816Commands::iso_authenticate(unsigned char keyno, std::shared_ptr<DESFireKey> key)
@@ -1271,6 +1305,10 @@ DESFireCommands::DESFireCardVersion DESFireEV1ISO7816Commands::getVersion()
 std::vector<unsigned int> DESFireEV1ISO7816Commands::getApplicationIDs()
 {
     std::vector<unsigned int> aids;
+    auto cache = getDESFireChip()->getMetadataCache();
+    if (cache->getApplicationIDs(aids))
+        return aids;
+
     std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
 
     auto result = transmit(DF_INS_GET_APPLICATION_IDS);
@@ -1293,13 +1331,20 @@ std::vector<unsigned int> DESFireEV1ISO7816Commands::getApplicationIDs()
         aids.push_back(DESFireLocation::convertAidToUInt(aid));
     }
 
+    cache->setApplicationIDs(aids);
     return aids;
 }
 
 ByteVector DESFireEV1ISO7816Commands::getFileIDs()
 {
-    std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
-    return transmit(DF_INS_GET_FILE_IDS).getData();
+    ByteVector files;
+    auto cache = getDESFireChip()->getMetadataCache();
+    if (cache->getFileIDs(files))
+        return files;
+
+    files = transmit(DF_INS_GET_FILE_IDS).getData();
+    cache->setFileIDs(files);
+    return files;
 }
 
 int32_t DESFireEV1ISO7816Commands::getValue(unsigned char fileno, EncryptionMode mode)
@@ -1403,8 +1448,11 @@ ISO7816Response DESFireEV1ISO7816Commands::transmit(unsigned char cmd,
 
         auto rCMAC = ByteVector(r.getData().end() - 8, r.getData().end());
         LOG(LogLevel::DEBUGS) << "Checking computed CMAC " << BufferHelper::getHex(CMAC) << " with received CMAC " << BufferHelper::getHex(rCMAC);
-        EXCEPTION_ASSERT_WITH_LOG(rCMAC == CMAC,
-                                  LibLogicalAccessException, "Wrong CMAC.");
+        if (rCMAC != CMAC)
+        {
+            getDESFireChip()->getMetadataCache()->invalidateSelection();
+            THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "Wrong CMAC.");
+        }
 
         r = ISO7816Response(ByteVector(r.getData().begin(), r.getData().end() - 8),
                             r.getSW1(), r.getSW2());
@@ -1413,6 +1461,14 @@ ISO7816Response DESFireEV1ISO7816Commands::transmit(unsigned char cmd,
     return r;
 }
 
+std::shared_ptr<ISO7816Commands> DESFireEV1ISO7816Commands::getISO7816Commands() const
+{
+    auto command = std::make_shared<DESFireISO7816ISO7816Commands>();
+    command->setChip(getChip());
+    command->setReaderCardAdapter(getReaderCardAdapter());
+    return command;
+}
+
 ISO7816Response DESFireEV1ISO7816Commands::transmit_plain(unsigned char cmd,
                                                           unsigned char lc)
 {
@@ -1456,6 +1512,7 @@ ISO7816Response DESFireEV1ISO7816Commands::transmit_full(unsigned char cmd,
         // That means this helper doesn't support command chaining (0xAF) for now
         if (!crypto->verifyMAC(true, dd))
         {
+            getDESFireChip()->getMetadataCache()->invalidateSelection();
             THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "MAC verification failed.");
         }
         // Remove MAC from message response
@@ -210,6 +210,14 @@ class LLA_READERS_ISO7816_API DESFireEV1ISO7816Commands : public DESFireISO7816C
     ByteVector readData(unsigned char fileno, unsigned int offset, unsigned int length,
                         EncryptionMode mode) override;
 
+    /**
+     * \brief Reads of length 0 are sent as such, the card returns the whole file.
+     */
+    bool readsToEndOfFile() const override
+    {
+        return true;
+    }
+
     /**
      * \brief Read record from a specific record file.
      * \param fileno The file number
@@ -315,13 +323,12 @@ class LLA_READERS_ISO7816_API DESFireEV1ISO7816Commands : public DESFireISO7816C
         return DESFireISO7816Commands::getReaderCardAdapter();
     }
 
-    std::shared_ptr<ISO7816Commands> getISO7816Commands() const override
-    {
-        auto command = std::make_shared<ISO7816ISO7816Commands>();
-        command->setChip(getChip());
-        command->setReaderCardAdapter(getReaderCardAdapter());
-        return command;
-    }
+    /**
+     * \brief Get the ISO 7816 commands of the card. Their SELECT FILE commands
+     * invalidate the application selected by the DESFire commands.
+     * \return The ISO 7816 commands.
+     */
+    std::shared_ptr<ISO7816Commands> getISO7816Commands() const override;
 
   protected:
     /**
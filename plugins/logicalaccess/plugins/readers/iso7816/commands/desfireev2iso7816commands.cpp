@@ -16,6 +16,7 @@
 #include <logicalaccess/utils.hpp>
 #include <logicalaccess/plugins/llacommon/settings.hpp>
 #include <logicalaccess/plugins/readers/iso7816/guardswap.hpp>
+#include <logicalaccess/metrics.hpp>
 
 using namespace logicalaccess;
 
@@ -84,12 +85,21 @@ void DESFireEV2ISO7816Commands::changeKeyEV2(uint8_t keysetno, uint8_t keyno,
 void DESFireEV2ISO7816Commands::authenticate(unsigned char keyno,
                                              std::shared_ptr<DESFireKey> key)
 {
+    AuthenticationRecorder metrics(*this);
+
     EXCEPTION_ASSERT_WITH_LOG(key != nullptr, LibLogicalAccessException,
                               "Key shall not be null");
 
+    if (isAuthenticated(keyno, key))
+    {
+        metrics.setResult("skipped");
+        return;
+    }
+
     if (key->getKeyType() != DF_KEY_AES)
     {
         DESFireEV1ISO7816Commands::authenticate(keyno, key);
+        metrics.succeed();
         return;
     }
 
@@ -110,6 +120,8 @@ void DESFireEV2ISO7816Commands::authenticate(unsigned char keyno,
             authenticateEV2First(keyno, key);
     }
     onAuthenticated();
+    setAuthenticated(keyno, key);
+    metrics.succeed();
 }
 
 void DESFireEV2ISO7816Commands::authenticateEV2First(
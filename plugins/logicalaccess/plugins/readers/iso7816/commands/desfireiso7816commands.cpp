@@ -15,6 +15,7 @@
 #include <logicalaccess/plugins/llacommon/settings.hpp>
 #include <logicalaccess/cards/computermemorykeystorage.hpp>
 #include <logicalaccess/dynlibrary/librarymanager.hpp>
+#include <logicalaccess/metrics.hpp>
 #include <algorithm>
 
 namespace logicalaccess
@@ -75,6 +76,16 @@ DESFireCommands::DESFireCardVersion DESFireISO7816Commands::getVersion()
 
 void DESFireISO7816Commands::selectApplication(unsigned int aid)
 {
+    // The card and the crypto keep their state, authentication included, as
+    // long as the application stays selected.
+    auto cache = getDESFireChip()->getMetadataCache();
+    if (cache->isSelected(aid))
+    {
+        LOG(LogLevel::DEBUGS) << "Application " << std::hex << aid << std::dec
+                              << " already selected.";
+        return;
+    }
+
     ByteVector command; //, samaid;
     DESFireLocation::convertUIntToAid(aid, command);
 
@@ -98,6 +109,7 @@ void DESFireISO7816Commands::selectApplication(unsigned int aid)
     }
 
     getDESFireChip()->getCrypto()->selectApplication(aid);
+    cache->setSelected(aid);
 }
 
 void DESFireISO7816Commands::createApplication(unsigned int aid,
@@ -125,6 +137,10 @@ void DESFireISO7816Commands::deleteApplication(unsigned int aid)
 std::vector<unsigned int> DESFireISO7816Commands::getApplicationIDs()
 {
     std::vector<unsigned int> aids;
+    auto cache = getDESFireChip()->getMetadataCache();
+    if (cache->getApplicationIDs(aids))
+        return aids;
+
     auto result = transmit(DF_INS_GET_APPLICATION_IDS);
 
     while (result.getSW2() == DF_INS_ADDITIONAL_FRAME)
@@ -144,6 +160,7 @@ std::vector<unsigned int> DESFireISO7816Commands::getApplicationIDs()
         aids.push_back(DESFireLocation::convertAidToUInt(aid));
     }
 
+    cache->setApplicationIDs(aids);
     return aids;
 }
 
@@ -356,14 +373,18 @@ void DESFireISO7816Commands::changeKey(unsigned char keyno,
 
 ByteVector DESFireISO7816Commands::getFileIDs()
 {
-    ByteVector result = transmit(DF_INS_GET_FILE_IDS).getData();
     ByteVector files;
+    auto cache = getDESFireChip()->getMetadataCache();
+    if (cache->getFileIDs(files))
+        return files;
 
+    ByteVector result = transmit(DF_INS_GET_FILE_IDS).getData();
     for (size_t i = 0; i < result.size(); ++i)
     {
         files.push_back(result[i]);
     }
 
+    cache->setFileIDs(files);
     return files;
 }
 
@@ -388,11 +409,16 @@ void DESFireISO7816Commands::changeKeySettings(DESFireKeySettings settings)
 DESFireCommands::FileSetting DESFireISO7816Commands::getFileSettings(unsigned char fileno)
 {
     FileSetting fileSetting;
+    auto cache = getDESFireChip()->getMetadataCache();
+    if (cache->getFileSettings(fileno, fileSetting))
+        return fileSetting;
+
     ByteVector command;
     command.push_back(fileno);
 
     ByteVector result = transmit(DF_INS_GET_FILE_SETTINGS, command).getData();
     memcpy(&fileSetting, &result[0], result.size());
+    cache->setFileSettings(fileno, fileSetting);
     return fileSetting;
 }
 
@@ -850,6 +876,29 @@ void DESFireISO7816Commands::authenticate(unsigned char keyno)
     authenticate(keyno, key);
 }
 
+bool DESFireISO7816Commands::isAuthenticated(unsigned char keyno,
+                                             std::shared_ptr<DESFireKey> key) const
+{
+    if (!Settings::getInstance()->IsDESFireAuthenticationCacheEnabled)
+        return false;
+
+    std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
+    auto cache                            = getDESFireChip()->getMetadataCache();
+    if (crypto->d_sessionKey.empty() || crypto->d_currentKeyNo != keyno ||
+        !cache->isSelected(crypto->d_currentAid) || !cache->isAuthenticated(keyno, key))
+        return false;
+
+    LOG(LogLevel::DEBUGS) << "Already authenticated with key " << static_cast<int>(keyno)
+                          << ", authentication skipped.";
+    return true;
+}
+
+void DESFireISO7816Commands::setAuthenticated(unsigned char keyno,
+                                              std::shared_ptr<DESFireKey> key) const
+{
+    getDESFireChip()->getMetadataCache()->setAuthenticated(keyno, key);
+}
+
 void DESFireISO7816Commands::getKeyFromSAM(std::shared_ptr<DESFireKey> key,
                                            ByteVector diversify) const
 {
@@ -1010,6 +1059,8 @@ void DESFireISO7816Commands::sam_authenticate_p2(unsigned char keyno,
 void DESFireISO7816Commands::authenticate(unsigned char keyno,
                                           std::shared_ptr<DESFireKey> currentKey)
 {
+    AuthenticationRecorder metrics(*this);
+
     ByteVector command;
 
     std::shared_ptr<DESFireCrypto> crypto = getDESFireChip()->getCrypto();
@@ -1017,6 +1068,11 @@ void DESFireISO7816Commands::authenticate(unsigned char keyno,
     {
         currentKey = crypto->getDefaultKey(DF_KEY_DES);
     }
+    if (isAuthenticated(keyno, currentKey))
+    {
+        metrics.setResult("skipped");
+        return;
+    }
     std::shared_ptr<DESFireKey> key = std::make_shared<DESFireKey>(*currentKey);
 
     auto diversify = getKeyInformations(key, keyno);
@@ -1053,6 +1109,8 @@ void DESFireISO7816Commands::authenticate(unsigned char keyno,
     }
     else
         THROW_EXCEPTION_WITH_LOG(CardException, "DESFire authentication P1 failed.");
+    setAuthenticated(keyno, currentKey);
+    metrics.succeed();
 }
 
 ISO7816Response DESFireISO7816Commands::transmit(unsigned char cmd, unsigned char lc)
@@ -1064,20 +1122,40 @@ ISO7816Response DESFireISO7816Commands::transmit(unsigned char cmd,
                                                  const ByteVector &data, unsigned char lc,
                                                  bool forceLc)
 {
-    if (data.size())
+    // Invalidated before sending, as the card may apply a command and still
+    // report an error.
+    std::shared_ptr<DESFireMetadataCache> cache;
+    if (getDESFireChip())
     {
-        return getISO7816ReaderCardAdapter()->sendAPDUCommand(
-            DF_CLA_ISO_WRAP, cmd, 0x00, 0x00, static_cast<unsigned char>(data.size()),
-            data, 0x00);
+        cache = getDESFireChip()->getMetadataCache();
+        cache->invalidate(cmd, data);
     }
-    if (forceLc)
+
+    try
     {
+        if (data.size())
+        {
+            return getISO7816ReaderCardAdapter()->sendAPDUCommand(
+                DF_CLA_ISO_WRAP, cmd, 0x00, 0x00, static_cast<unsigned char>(data.size()),
+                data, 0x00);
+        }
+        if (forceLc)
+        {
+            return getISO7816ReaderCardAdapter()->sendAPDUCommand(DF_CLA_ISO_WRAP, cmd,
+                                                                  0x00, 0x00, lc, 0x00);
+        }
+
         return getISO7816ReaderCardAdapter()->sendAPDUCommand(DF_CLA_ISO_WRAP, cmd, 0x00,
-                                                              0x00, lc, 0x00);
+                                                              0x00, 0x00);
+    }
+    catch (...)
+    {
+        // Errors reset the card authentication: the next selection must reset the
+        // crypto too.
+        if (cache)
+            cache->invalidateSelection();
+        throw;
     }
-
-    return getISO7816ReaderCardAdapter()->sendAPDUCommand(DF_CLA_ISO_WRAP, cmd, 0x00,
-                                                          0x00, 0x00);
 }
 
 void DESFireISO7816Commands::setChip(std::shared_ptr<Chip> chip)
@@ -354,6 +354,22 @@ class LLA_READERS_ISO7816_API DESFireISO7816Commands : public DESFireCommands
   protected:
     ByteVector getKeyInformations(std::shared_ptr<DESFireKey> key, uint8_t keyno) const;
 
+    /**
+     * \brief Check if the selected application is still authenticated with a key,
+     * so that the authentication can be skipped.
+     * \param keyno The key number.
+     * \param key The key.
+     * \return True if the card and the crypto are authenticated with the key.
+     */
+    bool isAuthenticated(unsigned char keyno, std::shared_ptr<DESFireKey> key) const;
+
+    /**
+     * \brief Record a successful authentication.
+     * \param keyno The key number.
+     * \param key The key.
+     */
+    void setAuthenticated(unsigned char keyno, std::shared_ptr<DESFireKey> key) const;
+
     virtual ByteVector getChangeKeySAMCryptogram(unsigned char keyno,
                                          std::shared_ptr<DESFireKey> key,
                                          bool changeKeyEV2 = false,
@@ -20,6 +20,7 @@
 #include <logicalaccess/plugins/crypto/des_initialization_vector.hpp>
 #include <logicalaccess/plugins/crypto/des_cipher.hpp>
 #include <logicalaccess/plugins/crypto/cmac.hpp>
+#include <logicalaccess/metrics.hpp>
 
 #include <boost/interprocess/shared_memory_object.hpp>
 #include <boost/interprocess/mapped_region.hpp>
@@ -158,10 +159,13 @@ void SAMAV1ISO7816Commands::changeKeyEntry(
 void SAMAV1ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
                                              unsigned char keyno)
 {
+    AuthenticationRecorder metrics(*this);
+
     if (key->getKeyType() == DF_KEY_DES)
         authenticateHostDES(key, keyno);
     else
         authenticateHost_AES_3K3DES(key, keyno);
+    metrics.succeed();
 }
 
 void SAMAV1ISO7816Commands::authenticateHost_AES_3K3DES(std::shared_ptr<DESFireKey> key,
@@ -17,6 +17,7 @@
 #include <logicalaccess/plugins/crypto/aes_initialization_vector.hpp>
 #include <logicalaccess/plugins/crypto/aes_cipher.hpp>
 #include <logicalaccess/plugins/crypto/cmac.hpp>
+#include <logicalaccess/metrics.hpp>
 
 #include <cstring>
 
@@ -205,6 +206,8 @@ void SAMAV2ISO7816Commands::generateOfflineSessionKey(std::shared_ptr<DESFireKey
 void SAMAV2ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
                                              unsigned char keyno)
 {
+    AuthenticationRecorder metrics(*this);
+
     unsigned char hostmode = 2;
     ByteVector emptyIV(16);
     ByteVector data_p1(3, 0x00);
@@ -329,6 +332,7 @@ void SAMAV2ISO7816Commands::authenticateHost(std::shared_ptr<DESFireKey> key,
 
     generateSessionKey(rndA, dencRndB);
     d_cmdCtr = 0;
+    metrics.succeed();
 }
 
 ByteVector SAMAV2ISO7816Commands::createfullProtectionCmd(ByteVector cmd)
@@ -69,6 +69,11 @@ bool ISO7816ReaderUnit::reconnect(int /*action*/)
 
             unlockSAM(chip);
         }
+
+        // The card is reset: nothing is selected anymore.
+        auto desfireChip = std::dynamic_pointer_cast<DESFireChip>(chip);
+        if (desfireChip)
+            desfireChip->getMetadataCache()->invalidateSelection();
     }
     catch (std::exception &ex)
     {
@@ -8,10 +8,15 @@
 #include <logicalaccess/plugins/readers/libusb/libusbreaderprovider.hpp>
 #include <logicalaccess/myexception.hpp>
 
+#include <chrono>
+
 namespace logicalaccess
 {
 LibUSBReaderProvider::LibUSBReaderProvider()
     : ReaderProvider()
+    , d_hotplugRegistered(false)
+    , d_hotplugHandle(0)
+    , d_hotplugEvent(false)
 {
     int r = libusb_init(&d_context);
     if (r < 0 || d_context == nullptr)
@@ -36,6 +41,11 @@ void LibUSBReaderProvider::release()
 {
     if (d_context != nullptr)
     {
+        if (d_hotplugRegistered)
+        {
+            libusb_hotplug_deregister_callback(d_context, d_hotplugHandle);
+            d_hotplugRegistered = false;
+        }
         libusb_exit(d_context);
         d_context = nullptr;
     }
@@ -55,7 +65,8 @@ bool LibUSBReaderProvider::refreshReaderList()
 {
     libusb_device **devices;
     ssize_t device_count = libusb_get_device_list(d_context, &devices);
-    
+    d_readers.clear();
+
     std::shared_ptr<LibUSBReaderUnit> anyYubikeyReader(new LibUSBReaderUnit(nullptr));
     anyYubikeyReader->setVendorID(LIBUSB_DEVICE_YUBIKEY_VENDORID);
     anyYubikeyReader->setReaderProvider(std::weak_ptr<ReaderProvider>(shared_from_this()));
@@ -92,4 +103,69 @@ bool LibUSBReaderProvider::refreshReaderList()
     
     return true;
 }
-}
\ No newline at end of file
+
+bool LibUSBReaderProvider::waitReaderListChange(unsigned int maxwait)
+{
+    if (!libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG))
+    {
+        return ReaderProvider::waitReaderListChange(maxwait);
+    }
+
+    if (!d_hotplugRegistered)
+    {
+        int r = libusb_hotplug_register_callback(
+            d_context,
+            static_cast<libusb_hotplug_event>(LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED |
+                                              LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT),
+            static_cast<libusb_hotplug_flag>(0), LIBUSB_HOTPLUG_MATCH_ANY,
+            LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY, &hotplugCallback, this,
+            &d_hotplugHandle);
+        if (r != LIBUSB_SUCCESS)
+        {
+            LOG(ERRORS) << "Failed to register the hot-plug callback: " << r;
+            return ReaderProvider::waitReaderListChange(maxwait);
+        }
+        d_hotplugRegistered = true;
+    }
+
+    d_hotplugEvent = false;
+    std::chrono::steady_clock::time_point const clock_timeout =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
+    while (!d_hotplugEvent)
+    {
+        std::chrono::steady_clock::time_point const now = std::chrono::steady_clock::now();
+        if (now >= clock_timeout)
+            break;
+
+        long long remaining =
+            std::chrono::duration_cast<std::chrono::microseconds>(clock_timeout - now)
+                .count();
+        struct timeval tv;
+        tv.tv_sec  = static_cast<long>(remaining / 1000000);
+        tv.tv_usec = static_cast<long>(remaining % 1000000);
+        int r = libusb_handle_events_timeout_completed(d_context, &tv, nullptr);
+        if (r != LIBUSB_SUCCESS && r != LIBUSB_ERROR_INTERRUPTED)
+        {
+            LOG(ERRORS) << "Failed to handle libusb events: " << r;
+            return ReaderProvider::waitReaderListChange(maxwait);
+        }
+    }
+    return d_hotplugEvent;
+}
+
+int LIBUSB_CALL LibUSBReaderProvider::hotplugCallback(libusb_context * /*context*/,
+                                                      libusb_device *device,
+                                                      libusb_hotplug_event /*event*/,
+                                                      void *user_data)
+{
+    struct libusb_device_descriptor desc;
+    if (libusb_get_device_descriptor(device, &desc) >= 0 &&
+        (desc.idVendor == LIBUSB_DEVICE_YUBIKEY_VENDORID ||
+         desc.idVendor == LIBUSB_DEVICE_ONLYKEY_VENDORID))
+    {
+        static_cast<LibUSBReaderProvider *>(user_data)->d_hotplugEvent = true;
+    }
+    // Keep the callback registered.
+    return 0;
+}
+}
@@ -67,6 +67,15 @@ class LLA_READERS_LIBUSB_API LibUSBReaderProvider : public ReaderProvider
      */
     bool refreshReaderList() override;
 
+    /**
+     * \brief Wait for a supported device to be plugged or unplugged, using
+     * the libusb hot-plug notification. Polls if the platform doesn't
+     * support it.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the reader list may have changed, false on timeout.
+     */
+    bool waitReaderListChange(unsigned int maxwait) override;
+
     /**
      * \brief Get reader list for this reader provider.
      * \return The reader list.
@@ -108,6 +117,28 @@ class LLA_READERS_LIBUSB_API LibUSBReaderProvider : public ReaderProvider
      * \brief The LibUSB Context.
     */
     libusb_context *d_context;
+
+    /**
+     * \brief The hot-plug callback, called from libusb event handling.
+     */
+    static int LIBUSB_CALL hotplugCallback(libusb_context *context, libusb_device *device,
+                                           libusb_hotplug_event event, void *user_data);
+
+    /**
+     * \brief True if the hot-plug callback is registered.
+     */
+    bool d_hotplugRegistered;
+
+    /**
+     * \brief The hot-plug callback handle.
+     */
+    libusb_hotplug_callback_handle d_hotplugHandle;
+
+    /**
+     * \brief Set by the hot-plug callback when a supported device is plugged
+     * or unplugged.
+     */
+    bool d_hotplugEvent;
 };
 }
 
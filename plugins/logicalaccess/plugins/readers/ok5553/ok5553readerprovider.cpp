@@ -87,4 +87,9 @@ bool OK5553ReaderProvider::refreshReaderList()
 
     return true;
 }
+
+bool OK5553ReaderProvider::waitReaderListChange(unsigned int maxwait)
+{
+    return d_portListWatcher.wait(maxwait);
+}
 }
\ No newline at end of file
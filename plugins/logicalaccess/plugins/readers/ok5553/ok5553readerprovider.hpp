@@ -8,6 +8,7 @@
 #define LOGICALACCESS_READEROK5553_PROVIDER_HPP
 
 #include <logicalaccess/readerproviders/readerprovider.hpp>
+#include <logicalaccess/readerproviders/serialportxml.hpp>
 #include <logicalaccess/plugins/readers/ok5553/ok5553readerunit.hpp>
 #include <logicalaccess/plugins/readers/ok5553/lla_readers_ok5553_api.hpp>
 #include <string>
@@ -69,6 +70,13 @@ class LLA_READERS_OK5553_API OK5553ReaderProvider : public ReaderProvider
      */
     bool refreshReaderList() override;
 
+    /**
+     * \brief Wait for a serial port to be plugged or unplugged.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the reader list may have changed, false on timeout.
+     */
+    bool waitReaderListChange(unsigned int maxwait) override;
+
     /**
      * \brief Get reader list for this reader provider.
      * \return The reader list.
@@ -96,6 +104,11 @@ class LLA_READERS_OK5553_API OK5553ReaderProvider : public ReaderProvider
      * \brief The reader list.
      */
     ReaderList d_readers;
+
+    /**
+     * \brief Watch the serial ports plugged or unplugged between two waits.
+     */
+    SerialPortListWatcher d_portListWatcher;
 };
 }
 
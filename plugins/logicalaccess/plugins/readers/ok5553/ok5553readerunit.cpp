@@ -15,6 +15,7 @@
 
 #include <logicalaccess/bufferhelper.hpp>
 #include <logicalaccess/plugins/readers/ok5553/ok5553readerprovider.hpp>
+#include <logicalaccess/readerproviders/insertionpoller.hpp>
 #include <logicalaccess/services/accesscontrol/cardsformatcomposite.hpp>
 #include <logicalaccess/cards/chip.hpp>
 #include <logicalaccess/plugins/readers/ok5553/readercardadapters/ok5553readercardadapter.hpp>
@@ -30,6 +31,7 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <logicalaccess/readerproviders/serialportdatatransport.hpp>
+#include <logicalaccess/metrics.hpp>
 
 namespace logicalaccess
 {
@@ -43,6 +45,9 @@ OK5553ReaderUnit::OK5553ReaderUnit()
     ReaderUnit::setDataTransport(dataTransport);
     d_card_type = CHIP_UNKNOWN;
 
+    d_insertionPoller =
+        std::make_shared<InsertionPoller>([this]() { return scanChip(); });
+
     try
     {
         boost::property_tree::ptree pt;
@@ -58,6 +63,7 @@ OK5553ReaderUnit::OK5553ReaderUnit()
 
 OK5553ReaderUnit::~OK5553ReaderUnit()
 {
+    d_insertionPoller->stop();
     OK5553ReaderUnit::disconnectFromReader();
 }
 
@@ -89,6 +95,7 @@ bool OK5553ReaderUnit::waitInsertion(unsigned int maxwait)
     }
     else
     {
+        d_insertionPoller->listen(getDataTransport());
         std::shared_ptr<Chip> chip = getChipInAir(maxwait);
         if (chip)
         {
@@ -106,29 +113,16 @@ bool OK5553ReaderUnit::waitRemoval(unsigned int maxwait)
     removalIdentifier.clear();
     if (d_insertedChip)
     {
-        unsigned int currentWait = 0;
-        while (!removed && ((currentWait < maxwait) || maxwait == 0))
+        std::shared_ptr<Chip> replacement;
+        removed = d_insertionPoller->waitRemoval(
+            d_insertedChip->getChipIdentifier(),
+            maxwait == 0 ? InsertionPoller::WAIT_FOREVER : maxwait, &replacement);
+        if (removed)
         {
-            std::shared_ptr<Chip> chip = getChipInAir(250);
-            if (chip)
+            d_insertedChip.reset();
+            if (replacement)
             {
-                ByteVector tmpId = chip->getChipIdentifier();
-                if (tmpId != d_insertedChip->getChipIdentifier())
-                {
-                    d_insertedChip.reset();
-                    removalIdentifier = tmpId;
-                    removed           = true;
-                }
-                else
-                {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                    currentWait += 250;
-                }
-            }
-            else
-            {
-                d_insertedChip.reset();
-                removed = true;
+                removalIdentifier = replacement->getChipIdentifier();
             }
         }
     }
@@ -194,50 +188,49 @@ ByteVector OK5553ReaderUnit::asciiToHex(const ByteVector &source)
 std::shared_ptr<Chip> OK5553ReaderUnit::getChipInAir(unsigned int maxwait)
 {
     LOG(LogLevel::INFOS) << "Starting get chip in air...";
+    LatencyRecorder metrics("lla_wait_insertion", {{"reader", getName()}});
+    std::shared_ptr<Chip> chip = d_insertionPoller->waitInsertion(
+        maxwait == 0 ? InsertionPoller::WAIT_FOREVER : maxwait);
+    metrics.setResult(chip ? "inserted" : "timeout");
+    return chip;
+}
 
+std::shared_ptr<Chip> OK5553ReaderUnit::scanChip()
+{
     std::shared_ptr<Chip> chip;
     ByteVector buf;
-    unsigned int currentWait = 0;
-    while (!chip && (maxwait == 0 || currentWait < maxwait))
+    try
     {
-        try
-        {
-            buf = getDefaultOK5553ReaderCardAdapter()->sendAsciiCommand("s");
-        }
-        catch (std::exception &)
+        buf = getDefaultOK5553ReaderCardAdapter()->sendAsciiCommand("s");
+    }
+    catch (std::exception &)
+    {
+        buf.clear();
+    }
+    d_successedRATS.clear();
+    if (buf.size() > 0)
+    {
+        buf = asciiToHex(buf);
+        if (buf[0] == MIFARE)
         {
-            buf.clear();
+            chip = createChip("Mifare");
+            buf.erase(buf.begin());
+            chip->setChipIdentifier(buf);
         }
-        d_successedRATS.clear();
-        if (buf.size() > 0)
+        else if (buf[0] == DESFIRE)
         {
-            buf = asciiToHex(buf);
-            if (buf[0] == MIFARE)
-            {
-                chip = createChip("Mifare");
-                buf.erase(buf.begin());
-                chip->setChipIdentifier(buf);
-            }
-            else if (buf[0] == DESFIRE)
-            {
-                chip = createChip("DESFire");
-                buf.erase(buf.begin());
-                chip->setChipIdentifier(buf);
-                std::dynamic_pointer_cast<DESFireChip>(chip)
-                    ->getCrypto()
-                    ->setCryptoContext(chip->getChipIdentifier());
-            }
-            else if (buf[0] == MIFAREULTRALIGHT)
-            {
-                chip = createChip("MifareUltralight");
-                buf.erase(buf.begin());
-                chip->setChipIdentifier(buf);
-            }
+            chip = createChip("DESFire");
+            buf.erase(buf.begin());
+            chip->setChipIdentifier(buf);
+            std::dynamic_pointer_cast<DESFireChip>(chip)
+                ->getCrypto()
+                ->setCryptoContext(chip->getChipIdentifier());
         }
-        if (!chip)
+        else if (buf[0] == MIFAREULTRALIGHT)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(250));
-            currentWait += 250;
+            chip = createChip("MifareUltralight");
+            buf.erase(buf.begin());
+            chip->setChipIdentifier(buf);
         }
     }
 
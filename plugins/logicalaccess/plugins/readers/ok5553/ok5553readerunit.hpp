@@ -104,6 +104,12 @@ class LLA_READERS_OK5553_API OK5553ReaderUnit : public ReaderUnit
      */
     std::shared_ptr<Chip> getChipInAir(unsigned int maxwait = 2000);
 
+    /**
+     * \brief Scan the field once.
+     * \return The chip in air, or null.
+     */
+    std::shared_ptr<Chip> scanChip();
+
     /**
      * \brief Get the default OK5553 reader/card adapter.
      * \return The default OK5553 reader/card adapter.
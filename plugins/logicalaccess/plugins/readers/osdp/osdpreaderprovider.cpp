@@ -83,4 +83,9 @@ bool OSDPReaderProvider::refreshReaderList()
 
     return true;
 }
+
+bool OSDPReaderProvider::waitReaderListChange(unsigned int maxwait)
+{
+    return d_portListWatcher.wait(maxwait);
+}
 }
@@ -8,6 +8,7 @@
 #define LOGICALACCESS_OSDPREADER_PROVIDER_HPP
 
 #include <logicalaccess/readerproviders/readerprovider.hpp>
+#include <logicalaccess/readerproviders/serialportxml.hpp>
 #include <logicalaccess/plugins/readers/osdp/osdpreaderunit.hpp>
 #include <logicalaccess/plugins/readers/osdp/lla_readers_osdp_api.hpp>
 
@@ -62,6 +63,13 @@ class LLA_READERS_OSDP_API OSDPReaderProvider : public ReaderProvider
      */
     bool refreshReaderList() override;
 
+    /**
+     * \brief Wait for a serial port to be plugged or unplugged.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the reader list may have changed, false on timeout.
+     */
+    bool waitReaderListChange(unsigned int maxwait) override;
+
     /**
      * \brief Get reader list for this reader provider.
      * \return The reader list.
@@ -87,6 +95,11 @@ class LLA_READERS_OSDP_API OSDPReaderProvider : public ReaderProvider
      * \brief The reader list.
      */
     ReaderList d_readers;
+
+    /**
+     * \brief Watch the serial ports plugged or unplugged between two waits.
+     */
+    SerialPortListWatcher d_portListWatcher;
 };
 }
 
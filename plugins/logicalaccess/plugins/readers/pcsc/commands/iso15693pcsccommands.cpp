@@ -9,9 +9,11 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 
 #include <logicalaccess/plugins/cards/iso15693/iso15693chip.hpp>
 #include <logicalaccess/myexception.hpp>
+#include <logicalaccess/bufferhelper.hpp>
 
 namespace logicalaccess
 {
@@ -192,4 +194,128 @@ unsigned char ISO15693PCSCCommands::getSecurityStatus(size_t block)
 
     return result[0];
 }
-}
\ No newline at end of file
+
+std::vector<ByteVector> ISO15693PCSCCommands::inventory(unsigned char afi)
+{
+    std::shared_ptr<PCSCReaderCardAdapter> adapter = getPCSCReaderCardAdapter();
+
+    // PC/SC part 3 transparent session, closed whatever the anticollision outcome.
+    adapter->sendAPDUCommand(0xff, 0xc2, 0x00, 0x00, 0x02, ByteVector{0x81, 0x00});
+
+    std::vector<ByteVector> uids;
+    try
+    {
+        // Binary search tree on the UID mask: each collision is resolved by
+        // extending the mask with one more bit, set to 0 then to 1.
+        std::vector<std::pair<ByteVector, unsigned char>> masks;
+        masks.push_back(std::make_pair(ByteVector(), 0));
+        while (!masks.empty())
+        {
+            ByteVector mask          = masks.back().first;
+            unsigned char maskLength = masks.back().second;
+            masks.pop_back();
+
+            ByteVector uid;
+            InventoryStatus status = inventoryRequest(afi, mask, maskLength, uid);
+            if (status == IS_RESPONSE)
+            {
+                if (std::find(uids.begin(), uids.end(), uid) == uids.end())
+                    uids.push_back(uid);
+            }
+            else if (status == IS_COLLISION && maskLength < 64)
+            {
+                mask.resize(maskLength / 8 + 1, 0x00);
+                masks.push_back(std::make_pair(mask, maskLength + 1));
+                mask[maskLength / 8] |= static_cast<unsigned char>(1 << (maskLength % 8));
+                masks.push_back(std::make_pair(mask, maskLength + 1));
+            }
+        }
+    }
+    catch (...)
+    {
+        adapter->sendAPDUCommand(0xff, 0xc2, 0x00, 0x00, 0x02, ByteVector{0x82, 0x00});
+        throw;
+    }
+    adapter->sendAPDUCommand(0xff, 0xc2, 0x00, 0x00, 0x02, ByteVector{0x82, 0x00});
+
+    return uids;
+}
+
+ISO15693PCSCCommands::InventoryStatus
+ISO15693PCSCCommands::inventoryRequest(unsigned char afi, const ByteVector &mask,
+                                       unsigned char maskLength, ByteVector &uid)
+{
+    // Flags: high data rate, inventory, one slot, and AFI when selected.
+    ByteVector frame;
+    frame.push_back(afi != 0x00 ? 0x36 : 0x26);
+    frame.push_back(0x01);
+    if (afi != 0x00)
+        frame.push_back(afi);
+    frame.push_back(maskLength);
+    frame.insert(frame.end(), mask.begin(), mask.begin() + (maskLength + 7) / 8);
+
+    ByteVector command;
+    command.push_back(0x95);
+    command.push_back(static_cast<unsigned char>(frame.size()));
+    command.insert(command.end(), frame.begin(), frame.end());
+
+    ByteVector result = getPCSCReaderCardAdapter()
+                            ->sendAPDUCommand(0xff, 0xc2, 0x00, 0x01,
+                                              static_cast<unsigned char>(command.size()),
+                                              command, 0x00)
+                            .getData();
+
+    // Response data objects: C0 generic error status, 96 response status and
+    // 97 ICC response.
+    ByteVector response;
+    bool noResponse = false, collision = false;
+    for (size_t i = 0; i + 1 < result.size();)
+    {
+        unsigned char tag = result[i];
+        size_t length     = result[i + 1];
+        EXCEPTION_ASSERT_WITH_LOG(i + 2 + length <= result.size(), CardException,
+                                  "Bad transparent exchange response.");
+        ByteVector value(result.begin() + i + 2, result.begin() + i + 2 + length);
+        if (tag == 0xc0 && value.size() == 3 && value[0] != 0x00)
+        {
+            // Only 64 01, no VICC answered, is part of the anticollision. Other
+            // errors, such as an unsupported function, would never resolve.
+            EXCEPTION_ASSERT_WITH_LOG(value[1] == 0x64 && value[2] == 0x01,
+                                      CardException,
+                                      "Inventory request failed with status " +
+                                          BufferHelper::getHex(value) + ".");
+            noResponse = true;
+        }
+        else if (tag == 0x96 && !value.empty() && value[0] != 0x00)
+        {
+            // CRC, collision, parity and framing errors: several VICC answered.
+            EXCEPTION_ASSERT_WITH_LOG((value[0] & 0xf0) == 0x00, CardException,
+                                      "Inventory request failed with response status " +
+                                          BufferHelper::getHex(value) + ".");
+            collision = true;
+        }
+        else if (tag == 0x97)
+        {
+            response = value;
+        }
+        i += 2 + length;
+    }
+
+    if (noResponse)
+        return IS_NO_RESPONSE;
+    if (collision)
+        return IS_COLLISION;
+    if (response.empty())
+        return IS_NO_RESPONSE;
+    EXCEPTION_ASSERT_WITH_LOG((response[0] & 0x01) == 0x00, CardException,
+                              "Inventory request failed with VICC error " +
+                                  BufferHelper::getHex(response) + ".");
+    // A truncated answer is garbled by simultaneous answers.
+    if (response.size() < 10)
+        return IS_COLLISION;
+
+    // Response: flags, DSFID and the 8 bytes UID.
+    uid.assign(response.begin() + 2, response.begin() + 10);
+    return IS_RESPONSE;
+}
+}
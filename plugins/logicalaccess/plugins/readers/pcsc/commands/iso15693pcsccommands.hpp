@@ -46,6 +46,7 @@ class LLA_READERS_PCSC_API ISO15693PCSCCommands : public ISO15693Commands
     void lockDSFID() override;
     SystemInformation getSystemInformation() override;
     unsigned char getSecurityStatus(size_t block) override;
+    std::vector<ByteVector> inventory(unsigned char afi = 0x00) override;
 
     /**
      * \brief Get the PC/SC reader/card adapter.
@@ -55,6 +56,30 @@ class LLA_READERS_PCSC_API ISO15693PCSCCommands : public ISO15693Commands
     {
         return std::dynamic_pointer_cast<PCSCReaderCardAdapter>(getReaderCardAdapter());
     }
+
+  protected:
+    /**
+     * \brief Result of an Inventory request with a mask.
+     */
+    enum InventoryStatus
+    {
+        IS_NO_RESPONSE = 0x00,
+        IS_RESPONSE    = 0x01,
+        IS_COLLISION   = 0x02
+    };
+
+    /**
+     * \brief Send a one slot Inventory request through the PC/SC transparent
+     * exchange.
+     * \param afi The Application Family Identifier, 0x00 for all VICC.
+     * \param mask The UID mask, LSB first.
+     * \param maskLength The mask length in bits.
+     * \param uid The UID of the VICC that answered.
+     * \return The request status. Errors other than a missing or garbled
+     * answer throw a CardException.
+     */
+    virtual InventoryStatus inventoryRequest(unsigned char afi, const ByteVector &mask,
+                                             unsigned char maskLength, ByteVector &uid);
 };
 }
 
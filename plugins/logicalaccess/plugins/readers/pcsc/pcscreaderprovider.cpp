@@ -23,6 +23,9 @@ namespace logicalaccess
 {
 PCSCReaderProvider::PCSCReaderProvider()
     : ISO7816ReaderProvider()
+    , d_pnpContext(0)
+    , d_pnpState(SCARD_STATE_UNAWARE)
+    , d_pnpSupported(true)
 {
     d_scc      = 0;
     long scres = SCardEstablishContext(Settings::getInstance()->SystemReaders ? SCARD_SCOPE_SYSTEM : SCARD_SCOPE_USER, nullptr, nullptr, &d_scc);
@@ -43,6 +46,14 @@ PCSCReaderProvider::~PCSCReaderProvider()
 
 void PCSCReaderProvider::release()
 {
+    if (d_pnpContext != 0)
+    {
+        SCardReleaseContext(d_pnpContext);
+
+        d_pnpContext = 0;
+        d_pnpState   = SCARD_STATE_UNAWARE;
+    }
+
     if (d_scc != 0)
     {
         SCardReleaseContext(d_scc);
@@ -92,6 +103,70 @@ bool PCSCReaderProvider::refreshReaderList()
     return r;
 }
 
+bool PCSCReaderProvider::waitReaderListChange(unsigned int maxwait)
+{
+    if (!d_pnpSupported)
+    {
+        return ReaderProvider::waitReaderListChange(maxwait);
+    }
+
+    if (d_pnpContext == 0)
+    {
+        LONG scres = SCardEstablishContext(Settings::getInstance()->SystemReaders
+                                               ? SCARD_SCOPE_SYSTEM
+                                               : SCARD_SCOPE_USER,
+                                           nullptr, nullptr, &d_pnpContext);
+        if (scres != SCARD_S_SUCCESS)
+        {
+            LOG(LogLevel::ERRORS) << "Can't establish the PC/SC context for Plug and "
+                                     "Play notification: "
+                                  << scres << ".";
+            d_pnpContext = 0;
+            return ReaderProvider::waitReaderListChange(maxwait);
+        }
+    }
+
+    SCARD_READERSTATE pnp;
+    memset(&pnp, 0x00, sizeof(pnp));
+    pnp.szReader = "\\\\?PnP?\\Notification";
+
+    // Learn the current state first, otherwise the wait returns immediately.
+    bool learning = (d_pnpState == SCARD_STATE_UNAWARE);
+    while (true)
+    {
+        pnp.dwCurrentState = d_pnpState;
+        LONG r = SCardGetStatusChange(d_pnpContext, learning ? 0 : static_cast<DWORD>(maxwait),
+                                      &pnp, 1);
+        if (r == SCARD_E_TIMEOUT)
+        {
+            return false;
+        }
+        if (r != SCARD_S_SUCCESS)
+        {
+            LOG(LogLevel::ERRORS) << "Cannot get Plug and Play status change: " << r
+                                  << ".";
+            SCardReleaseContext(d_pnpContext);
+            d_pnpContext = 0;
+            d_pnpState   = SCARD_STATE_UNAWARE;
+            return ReaderProvider::waitReaderListChange(maxwait);
+        }
+        if ((pnp.dwEventState & SCARD_STATE_UNKNOWN) != 0)
+        {
+            LOG(LogLevel::WARNINGS) << "The PC/SC service doesn't support Plug and Play "
+                                       "notification. Polling the reader list.";
+            d_pnpSupported = false;
+            return ReaderProvider::waitReaderListChange(maxwait);
+        }
+
+        d_pnpState = pnp.dwEventState & ~SCARD_STATE_CHANGED;
+        if (!learning)
+        {
+            return (pnp.dwEventState & SCARD_STATE_CHANGED) != 0;
+        }
+        learning = false;
+    }
+}
+
 std::shared_ptr<ReaderUnit> PCSCReaderProvider::createReaderUnit()
 {
     // return createReaderUnit("Generic PCSC ReaderUnit");
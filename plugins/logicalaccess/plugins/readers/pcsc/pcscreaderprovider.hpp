@@ -71,6 +71,14 @@ class LLA_READERS_PCSC_API PCSCReaderProvider : public ISO7816ReaderProvider
      */
     bool refreshReaderList() override;
 
+    /**
+     * \brief Wait for a reader to be plugged or unplugged, using the PC/SC
+     * Plug and Play notification. Polls if the service doesn't support it.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the reader list may have changed, false on timeout.
+     */
+    bool waitReaderListChange(unsigned int maxwait) override;
+
     /**
      * \brief Get reader list for this reader provider.
      * \return The reader list.
@@ -127,6 +135,23 @@ class LLA_READERS_PCSC_API PCSCReaderProvider : public ISO7816ReaderProvider
      * \brief The context.
      */
     SCARDCONTEXT d_scc;
+
+    /**
+     * \brief The context dedicated to the Plug and Play notification, as the
+     * wait blocks its context.
+     */
+    SCARDCONTEXT d_pnpContext;
+
+    /**
+     * \brief The last known Plug and Play notification state.
+     */
+    DWORD d_pnpState;
+
+    /**
+     * \brief False if the PC/SC service doesn't support the Plug and Play
+     * notification.
+     */
+    bool d_pnpSupported;
 };
 }
 
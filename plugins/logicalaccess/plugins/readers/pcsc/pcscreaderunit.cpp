@@ -104,6 +104,8 @@
 #include <logicalaccess/plugins/readers/pcsc/readers/cardprobes/pcsccardprobe.hpp>
 #include <logicalaccess/plugins/readers/pcsc/atrparser.hpp>
 #include <logicalaccess/plugins/readers/pcsc/commands/id3resultchecker.hpp>
+#include <logicalaccess/metrics.hpp>
+#include <logicalaccess/readerproviders/readerunitconfigstore.hpp>
 
 #include <cstring>
 
@@ -119,18 +121,8 @@ PCSCReaderUnit::PCSCReaderUnit(const std::string &name)
     , d_name(name)
     , d_connectedName(name)
 {
-    d_card_type = CHIP_UNKNOWN;
-
-    try
-    {
-        boost::property_tree::ptree pt;
-        read_xml((boost::filesystem::current_path().string() + "/PCSCReaderUnit.config"),
-                 pt);
-        d_card_type = pt.get("config.cardType", CHIP_UNKNOWN);
-    }
-    catch (...)
-    {
-    }
+    d_card_type =
+        ReaderUnitConfigStore::getInstance("PCSCReaderUnit.config").getConfig()->cardType;
 
     d_proxyReaderUnit.reset();
     d_readerUnitConfig.reset(new PCSCReaderUnitConfiguration());
@@ -272,6 +264,8 @@ bool PCSCReaderUnit::isConnected()
 
 bool PCSCReaderUnit::waitInsertion(unsigned int maxwait)
 {
+    LatencyRecorder metrics("lla_wait_insertion", {{"reader", getName()}});
+
     if (isConnected())
     {
         LOG(LogLevel::ERRORS) << EXCEPTION_MSG_CONNECTED;
@@ -319,7 +313,10 @@ bool PCSCReaderUnit::waitInsertion(unsigned int maxwait)
                         std::string cardType =
                             ATRParser::guessCardType(atr_, getPCSCType());
                         LOG(INFOS) << "Guessed card type from atr: " << cardType;
-                        return process_insertion(cardType, maxwait, time_counter);
+                        const bool inserted =
+                            process_insertion(cardType, maxwait, time_counter);
+                        metrics.setResult(inserted ? "inserted" : "timeout");
+                        return inserted;
                     }
                 }
             }
@@ -334,6 +331,7 @@ bool PCSCReaderUnit::waitInsertion(unsigned int maxwait)
             break;
         }
     } while (maxwait == 0 || time_counter.elapsed() < maxwait);
+    metrics.setResult("timeout");
     return false;
 }
 
@@ -515,6 +513,11 @@ bool PCSCReaderUnit::connect(PCSCShareMode share_mode)
 		if (d_insertedChip) {
 			detect_mifareplus_security_level(d_insertedChip);
 			d_insertedChip = adjustChip(d_insertedChip);
+
+			// A new connection starts with nothing selected.
+			auto desfireChip = std::dynamic_pointer_cast<DESFireChip>(d_insertedChip);
+			if (desfireChip)
+				desfireChip->getMetadataCache()->invalidateSelection();
 		}
         if (d_proxyReaderUnit)
         {
@@ -968,6 +971,50 @@ std::vector<std::shared_ptr<Chip>> PCSCReaderUnit::getChipList()
     return chipList;
 }
 
+std::vector<std::shared_ptr<Chip>> PCSCReaderUnit::inventory()
+{
+    if (d_proxyReaderUnit)
+        return d_proxyReaderUnit->inventory();
+
+    std::shared_ptr<Chip> singleChip = getSingleChip();
+    if (!singleChip || !isConnected())
+        return getChipList();
+
+    std::shared_ptr<ISO15693Commands> cmd =
+        std::dynamic_pointer_cast<ISO15693Commands>(singleChip->getCommands());
+    if (!cmd)
+        return getChipList();
+
+    std::vector<ByteVector> uids;
+    try
+    {
+        uids = cmd->inventory();
+    }
+    catch (LibLogicalAccessException &e)
+    {
+        LOG(LogLevel::WARNINGS) << "Inventory not supported by the reader: " << e.what();
+    }
+    if (uids.empty())
+        return getChipList();
+
+    // Commands of the listed chips go through the same card handle: they are
+    // addressed to the connected VICC.
+    std::vector<std::shared_ptr<Chip>> chipList;
+    for (const auto &uid : uids)
+    {
+        if (uid == singleChip->getChipIdentifier())
+        {
+            chipList.push_back(singleChip);
+            continue;
+        }
+        std::shared_ptr<Chip> chip = createChip(singleChip->getCardType());
+        chip->setChipIdentifier(uid);
+        chipList.push_back(chip);
+    }
+    LOG(LogLevel::INFOS) << chipList.size() << " chip(s) found by inventory.";
+    return chipList;
+}
+
 std::shared_ptr<PCSCReaderCardAdapter> PCSCReaderUnit::getDefaultPCSCReaderCardAdapter()
 {
     return std::dynamic_pointer_cast<PCSCReaderCardAdapter>(
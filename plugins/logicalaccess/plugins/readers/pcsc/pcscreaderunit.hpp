@@ -168,6 +168,13 @@ class LLA_READERS_PCSC_API PCSCReaderUnit : public ISO7816ReaderUnit
      */
     std::vector<std::shared_ptr<Chip>> getChipList() override;
 
+    /**
+     * \brief Get all the chips in the RFID range. ISO15693 VICC are
+     * enumerated with the anticollision, the card must be connected.
+     * \return The chip list.
+     */
+    std::vector<std::shared_ptr<Chip>> inventory() override;
+
     /**
      * \brief Get the card serial number.
      * \return The card serial number.
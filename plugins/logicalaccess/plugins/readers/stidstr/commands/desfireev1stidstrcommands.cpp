@@ -18,6 +18,7 @@
 #include <logicalaccess/cards/computermemorykeystorage.hpp>
 #include <logicalaccess/cards/readermemorykeystorage.hpp>
 #include <logicalaccess/myexception.hpp>
+#include <logicalaccess/metrics.hpp>
 
 namespace logicalaccess
 {
@@ -536,6 +537,8 @@ void DESFireEV1STidSTRCommands::authenticate(unsigned char keyno)
 void DESFireEV1STidSTRCommands::authenticate(unsigned char keyno,
                                              std::shared_ptr<DESFireKey> key)
 {
+    AuthenticationRecorder metrics(*this);
+
     LOG(LogLevel::INFOS) << "Authenticating... key number {0x" << std::hex << keyno
                          << std::dec << "(" << keyno << ")}";
 
@@ -556,6 +559,7 @@ void DESFireEV1STidSTRCommands::authenticate(unsigned char keyno,
     }
 
     authenticate(keylocation, keyno, key->getKeyType(), keyindex);
+    metrics.succeed();
 }
 
 void DESFireEV1STidSTRCommands::authenticateISO(unsigned char /*keyno*/,
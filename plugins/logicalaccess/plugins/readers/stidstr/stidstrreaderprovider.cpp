@@ -94,4 +94,9 @@ bool STidSTRReaderProvider::refreshReaderList()
 
     return true;
 }
+
+bool STidSTRReaderProvider::waitReaderListChange(unsigned int maxwait)
+{
+    return d_portListWatcher.wait(maxwait);
+}
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #define LOGICALACCESS_READERSTIDSTR_PROVIDER_HPP
 
 #include <logicalaccess/plugins/readers/iso7816/iso7816readerprovider.hpp>
+#include <logicalaccess/readerproviders/serialportxml.hpp>
 #include <logicalaccess/plugins/readers/stidstr/lla_readers_stidstr_api.hpp>
 
 namespace logicalaccess
@@ -61,6 +62,13 @@ class LLA_READERS_STIDSTR_API STidSTRReaderProvider : public ISO7816ReaderProvid
      */
     bool refreshReaderList() override;
 
+    /**
+     * \brief Wait for a serial port to be plugged or unplugged.
+     * \param maxwait The maximum wait time in milliseconds.
+     * \return True if the reader list may have changed, false on timeout.
+     */
+    bool waitReaderListChange(unsigned int maxwait) override;
+
     /**
      * \brief Get reader list for this reader provider.
      * \return The reader list.
@@ -93,6 +101,11 @@ class LLA_READERS_STIDSTR_API STidSTRReaderProvider : public ISO7816ReaderProvid
      * \brief The reader list.
      */
     ReaderList d_readers;
+
+    /**
+     * \brief Watch the serial ports plugged or unplugged between two waits.
+     */
+    SerialPortListWatcher d_portListWatcher;
 };
 }
 
@@ -6,6 +6,7 @@
 
 #include <logicalaccess/plugins/readers/stidstr/stidstrreaderunit.hpp>
 #include <logicalaccess/plugins/readers/stidstr/stidstrreaderprovider.hpp>
+#include <logicalaccess/readerproviders/insertionpoller.hpp>
 
 #include <iostream>
 #include <iomanip>
@@ -37,6 +38,7 @@
 
 #include <logicalaccess/plugins/readers/stidstr/stidstrreaderunitconfiguration.hpp>
 #include <logicalaccess/plugins/llacommon/settings.hpp>
+#include <logicalaccess/metrics.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
 namespace logicalaccess
@@ -53,6 +55,9 @@ STidSTRReaderUnit::STidSTRReaderUnit()
     ReaderUnit::setDataTransport(dataTransport);
     d_card_type = CHIP_UNKNOWN;
 
+    d_insertionPoller =
+        std::make_shared<InsertionPoller>([this]() { return scanChip(); });
+
     try
     {
         boost::property_tree::ptree pt;
@@ -68,6 +73,7 @@ STidSTRReaderUnit::STidSTRReaderUnit()
 
 STidSTRReaderUnit::~STidSTRReaderUnit()
 {
+    d_insertionPoller->stop();
     STidSTRReaderUnit::disconnectFromReader();
 }
 
@@ -89,12 +95,10 @@ void STidSTRReaderUnit::setCardType(std::string cardType)
 
 bool STidSTRReaderUnit::waitInsertion(unsigned int maxwait)
 {
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitInsertionLog)
-    {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
-    }
+    // Disable logs for this part (otherwise too much log output in file)
+    LogContext logFilter("", getLogMask() & (Settings::getInstance()->SeeWaitInsertionLog
+                                                 ? LOG_ALL_LEVELS
+                                                 : 0));
 
     auto stidprgdt = std::dynamic_pointer_cast<STidSTRSerialPortDataTransport>(getDataTransport());
     EXCEPTION_ASSERT_WITH_LOG(stidprgdt, LibLogicalAccessException,
@@ -102,143 +106,86 @@ bool STidSTRReaderUnit::waitInsertion(unsigned int maxwait)
 
     LOG(LogLevel::INFOS) << "Waiting insertion... max wait {" << maxwait << "}";
     bool inserted = false;
-    std::chrono::steady_clock::time_point const clock_timeout =
-        std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
 
-    try
+    d_insertionPoller->listen(stidprgdt);
+    LatencyRecorder metrics("lla_wait_insertion", {{"reader", getName()}});
+    std::shared_ptr<Chip> chip = d_insertionPoller->waitInsertion(maxwait);
+    metrics.setResult(chip ? "inserted" : "timeout");
+    if (chip)
     {
-        do
-        {
-            std::shared_ptr<Chip> chip;
-            if (getSTidSTRConfiguration()->getScanMode() == STID_SCAN_LEGACY)
-            {
-                chip = scanARaw(); // scan14443A() => Obsolete. It's just used for testing purpose !
-                if (!chip)
-                {
-                    chip = scan14443B();
-                }
-            }
-            else if (getSTidSTRConfiguration()->getScanMode() == STID_SCAN_LEGACY)
-            {
-                chip = scanBlueNFC();
-            }
-            else
-            {
-                chip = scanGlobal();
-            }
-
-            if (chip)
-            {
-                LOG(LogLevel::INFOS) << "Chip detected !";
-                d_insertedChip = chip;
-                inserted       = true;
-            }
+        LOG(LogLevel::INFOS) << "Chip detected !";
+        d_insertedChip = chip;
+        inserted       = true;
 
-            if (!inserted)
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(250));
-            }
-            else
-            {
-                if ((chip->getCardType() == CHIP_DESFIRE_EV1 ||
-                     chip->getCardType() == CHIP_DESFIRE) &&
-                    getSTidSTRConfiguration()->getPN532Direct())
-                {
-                    std::dynamic_pointer_cast<DESFireISO7816Commands>(
-                        d_insertedChip->getCommands())
-                        ->setSAMChip(getSAMChip());
-                }
-            }
-        } while (!inserted && std::chrono::steady_clock::now() < clock_timeout);
-    }
-    catch (...)
-    {
-        Settings::getInstance()->IsLogEnabled = oldValue;
-        throw;
+        if ((chip->getCardType() == CHIP_DESFIRE_EV1 ||
+             chip->getCardType() == CHIP_DESFIRE) &&
+            getSTidSTRConfiguration()->getPN532Direct())
+        {
+            std::dynamic_pointer_cast<DESFireISO7816Commands>(
+                d_insertedChip->getCommands())
+                ->setSAMChip(getSAMChip());
+        }
     }
 
-    LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted
-                         << "} function timeout expired ? {"
-                         << (std::chrono::steady_clock::now() < clock_timeout) << "}";
-    Settings::getInstance()->IsLogEnabled = oldValue;
+    LOG(LogLevel::INFOS) << "Returns card inserted ? {" << inserted << "}";
 
     return inserted;
 }
 
 bool STidSTRReaderUnit::waitRemoval(unsigned int maxwait)
 {
-    bool oldValue = Settings::getInstance()->IsLogEnabled;
-    if (oldValue && !Settings::getInstance()->SeeWaitRemovalLog)
-    {
-        Settings::getInstance()->IsLogEnabled =
-            false; // Disable logs for this part (otherwise too much log output in file)
-    }
+    // Disable logs for this part (otherwise too much log output in file)
+    LogContext logFilter("", getLogMask() & (Settings::getInstance()->SeeWaitRemovalLog
+                                                 ? LOG_ALL_LEVELS
+                                                 : 0));
 
     LOG(LogLevel::INFOS) << "Waiting removal... max wait {" << maxwait << "}";
     bool removed = false;
-    std::chrono::steady_clock::time_point const clock_timeout =
-        std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
-    try
+    if (d_insertedChip)
     {
-        if (d_insertedChip)
+        std::shared_ptr<Chip> replacement;
+        removed = d_insertionPoller->waitRemoval(d_insertedChip->getChipIdentifier(),
+                                                 maxwait, &replacement);
+        if (removed)
         {
-            do
+            if (replacement)
             {
-                std::shared_ptr<Chip> chip;
-                if (getSTidSTRConfiguration()->getScanMode() == STID_SCAN_LEGACY)
-                {
-                    chip = scanARaw(); // scan14443A() => Obsolete. It's
-                                                             // just used for testing purpose
-                                                             // !
-                    if (!chip)
-                    {
-                        chip = scan14443B();
-                    }
-                }
-                else if (getSTidSTRConfiguration()->getScanMode() == STID_SCAN_VIRTUAL)
-                {
-                    chip = scanBlueNFC();
-                }
-                else
-                {
-                    chip = scanGlobal();
-                }
+                LOG(LogLevel::INFOS) << "Card found but not same chip ! The "
+                                        "previous card has been removed !";
+            }
+            else
+            {
+                LOG(LogLevel::INFOS) << "Card removed !";
+            }
+            d_insertedChip.reset();
+        }
+    }
 
-                if (chip)
-                {
-                    if (chip->getChipIdentifier() != d_insertedChip->getChipIdentifier())
-                    {
-                        LOG(LogLevel::INFOS) << "Card found but not same chip ! The "
-                                                "previous card has been removed !";
-                        d_insertedChip.reset();
-                        removed = true;
-                    }
-                }
-                else
-                {
-                    LOG(LogLevel::INFOS) << "Card removed !";
-                    d_insertedChip.reset();
-                    removed = true;
-                }
+    LOG(LogLevel::INFOS) << "Returns card removed ? {" << removed << "}";
 
-                if (!removed)
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250));
-            } while (!removed && std::chrono::steady_clock::now() < clock_timeout);
+    return removed;
+}
+
+std::shared_ptr<Chip> STidSTRReaderUnit::scanChip()
+{
+    std::shared_ptr<Chip> chip;
+    if (getSTidSTRConfiguration()->getScanMode() == STID_SCAN_LEGACY)
+    {
+        chip = scanARaw(); // scan14443A() => Obsolete. It's just used for testing purpose !
+        if (!chip)
+        {
+            chip = scan14443B();
         }
     }
-    catch (...)
+    else if (getSTidSTRConfiguration()->getScanMode() == STID_SCAN_VIRTUAL)
     {
-        Settings::getInstance()->IsLogEnabled = oldValue;
-        throw;
+        chip = scanBlueNFC();
     }
-
-    LOG(LogLevel::INFOS) << "Returns card removed ? {" << removed
-                         << "} - function timeout expired ? {"
-                         << (std::chrono::steady_clock::now() < clock_timeout) << "}";
-
-    Settings::getInstance()->IsLogEnabled = oldValue;
-
-    return removed;
+    else
+    {
+        chip = scanGlobal();
+    }
+    return chip;
 }
 
 bool STidSTRReaderUnit::connect()
@@ -371,6 +318,30 @@ std::vector<std::shared_ptr<Chip>> STidSTRReaderUnit::getChipList()
     return chipList;
 }
 
+std::vector<std::shared_ptr<Chip>> STidSTRReaderUnit::inventory()
+{
+    // The reader reports a single tag per scan command: every technology is
+    // scanned to get all the chips in the field.
+    std::vector<std::shared_ptr<Chip>> chipList;
+    std::shared_ptr<Chip> chip = scanARaw();
+    if (chip)
+    {
+        chipList.push_back(chip);
+    }
+    chip = scan14443B();
+    if (chip)
+    {
+        chipList.push_back(chip);
+    }
+
+    if (chipList.empty())
+    {
+        return getChipList();
+    }
+    d_insertedChip = chipList.back();
+    return chipList;
+}
+
 std::shared_ptr<STidSTRReaderCardAdapter>
 STidSTRReaderUnit::getDefaultSTidSTRReaderCardAdapter()
 {
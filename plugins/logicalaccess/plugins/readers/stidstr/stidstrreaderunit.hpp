@@ -121,6 +121,13 @@ class LLA_READERS_STIDSTR_API STidSTRReaderUnit : public ISO7816ReaderUnit
      */
     std::vector<std::shared_ptr<Chip>> getChipList() override;
 
+    /**
+     * \brief Get all the chips in the RFID range, one per technology.
+     * \return The chip list. The last scanned chip is the one selected by the
+     * reader.
+     */
+    std::vector<std::shared_ptr<Chip>> inventory() override;
+
     /**
      * \brief Get the default STidSTR reader/card adapter.
      * \return The default STidSTR reader/card adapter.
@@ -231,6 +238,12 @@ class LLA_READERS_STIDSTR_API STidSTRReaderUnit : public ISO7816ReaderUnit
      */
     std::shared_ptr<Chip> scanGlobal(bool iso14443a, bool activeRats, bool iso14443b, bool lf125khz, bool blueNfc, bool selectedKeyBlueNfc, bool keyboard, bool imageScanEngine);
 
+    /**
+     * \brief Scan once with the configured scan mode.
+     * \return The chip object if a tag is inserted.
+     */
+    std::shared_ptr<Chip> scanChip();
+
     /**
      * \brief Authenticate the host with the reader and genereate session keys for HMAC
      * and enciphering, 1/2. SSCP v1 only.
@@ -15,208 +15,246 @@
 
 namespace logicalaccess
 {
+namespace
+{
+/**
+ * Upper case hex digits of each byte value.
+ */
+const char HEX_PAIRS[] =
+    "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+/**
+ * Value of each hex digit, -1 for other characters.
+ */
+const int8_t HEX_DIGITS[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+const char BASE64_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * Value of each base 64 character, -1 for other characters.
+ */
+const int8_t BASE64_DIGITS[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
 /**
-    * \brief Encode a chunk of data into base 64.
-    * \param in The chunk of data to encode.
-    * \param out The buffer to fill with the encoded data.
-    * \param len The length of in (must be 3 bytes max).
-    */
-static void base64EncodeBlock(const unsigned char in[3], unsigned char out[4], size_t len)
+ * Decode one or two hex digits. Like the stream based parser this replaces, the
+ * digits stop at the first non-hex character.
+ */
+uint8_t decodeHexPair(const char *pair, size_t len)
 {
-    static const char cb64[] =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-    out[0] = cb64[in[0] >> 2];
-    out[1] = cb64[((in[0] & 0x03) << 4) | (len > 1 ? ((in[1] & 0xf0) >> 4) : 0)];
-    out[2] =
-        (len > 1 ? cb64[((in[1] & 0x0f) << 2) | (len > 2 ? ((in[2] & 0xc0) >> 6) : 0)]
-                 : '=');
-    out[3] = (len > 2 ? cb64[in[2] & 0x3f] : '=');
+    int high = HEX_DIGITS[static_cast<unsigned char>(pair[0])];
+    if (high < 0)
+        return 0;
+    if (len == 1)
+        return static_cast<uint8_t>(high);
+
+    int low = HEX_DIGITS[static_cast<unsigned char>(pair[1])];
+    if (low < 0)
+        return static_cast<uint8_t>(high);
+    return static_cast<uint8_t>((high << 4) | low);
 }
 
-/**
-    * \brief Decode a chunk of base 64 encoded data.
-    * \param in The encoded chunk of data.
-    * \param out The out buffer.
-    * \param len The length of the out buffer.
-    */
-static void base64DecodeBlock(const unsigned char in[4], unsigned char out[3],
-                              size_t &len)
+void checkBase64Char(unsigned char c, bool padding)
 {
-    len = 3;
+    EXCEPTION_ASSERT(BASE64_DIGITS[c] >= 0 || (padding && c == '='),
+                     LibLogicalAccessException,
+                     (std::string("Unexpected character '") + static_cast<char>(c) + "'")
+                         .c_str());
+}
+}
 
-    for (size_t i = 0; i < 4; ++i)
+size_t BufferHelper::hexEncode(const uint8_t *in, size_t len, char *out)
+{
+    for (size_t i = 0; i < len; ++i)
     {
-        EXCEPTION_ASSERT(
-            isalnum(in[i]) || (in[i] == '+') || (in[i] == '/') ||
-                ((i >= 2) && (in[i] == '=')),
-            LibLogicalAccessException,
-            (std::string("Unexpected character '") + static_cast<char>(in[i]) + "'")
-                .c_str());
+        const char *pair = HEX_PAIRS + in[i] * 2;
+        out[i * 2]       = pair[0];
+        out[i * 2 + 1]   = pair[1];
     }
+    return len * 2;
+}
 
-    if (in[2] == '=')
+size_t BufferHelper::hexDecode(const char *in, size_t len, uint8_t *out)
+{
+    size_t written = 0;
+    char pair[2];
+    size_t count = 0;
+    for (size_t i = 0; i < len; ++i)
     {
-        if (in[3] == '=')
-        {
-            len = 1;
-        }
-        else
+        if (in[i] == ' ')
+            continue;
+
+        pair[count++] = in[i];
+        if (count == 2)
         {
-            THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException, "'=' character expected");
+            out[written++] = decodeHexPair(pair, 2);
+            count          = 0;
         }
     }
-    else
+    if (count == 1)
     {
-        if (in[3] == '=')
-        {
-            len = 2;
-        }
+        out[written++] = decodeHexPair(pair, 1);
     }
+    return written;
+}
 
-    static char tin[4] = {0x00, 0x00, 0x00, 0x00};
+size_t BufferHelper::getBase64EncodedSize(size_t len)
+{
+    return ((len + 2) / 3) * 4;
+}
 
-    memcpy(tin, in, 4);
+size_t BufferHelper::base64Encode(const uint8_t *in, size_t len, char *out)
+{
+    size_t written = 0;
+    size_t i       = 0;
+    for (; i + 3 <= len; i += 3)
+    {
+        uint32_t block = (static_cast<uint32_t>(in[i]) << 16) |
+                         (static_cast<uint32_t>(in[i + 1]) << 8) | in[i + 2];
+        out[written++] = BASE64_CHARS[(block >> 18) & 0x3f];
+        out[written++] = BASE64_CHARS[(block >> 12) & 0x3f];
+        out[written++] = BASE64_CHARS[(block >> 6) & 0x3f];
+        out[written++] = BASE64_CHARS[block & 0x3f];
+    }
 
-    for (size_t i = 0; i < 4; ++i)
+    if (i < len)
     {
-        if ((tin[i] >= 'A') && (tin[i] <= 'Z'))
+        uint32_t block = static_cast<uint32_t>(in[i]) << 16;
+        if (i + 1 < len)
+            block |= static_cast<uint32_t>(in[i + 1]) << 8;
+        out[written++] = BASE64_CHARS[(block >> 18) & 0x3f];
+        out[written++] = BASE64_CHARS[(block >> 12) & 0x3f];
+        out[written++] = (i + 1 < len) ? BASE64_CHARS[(block >> 6) & 0x3f] : '=';
+        out[written++] = '=';
+    }
+    return written;
+}
+
+size_t BufferHelper::base64Decode(const char *in, size_t len, uint8_t *out)
+{
+    EXCEPTION_ASSERT((len % 4) == 0, std::invalid_argument,
+                     "The buffer size must be multiple of 4");
+
+    size_t written = 0;
+    for (size_t i = 0; i < len; i += 4)
+    {
+        const unsigned char *quad = reinterpret_cast<const unsigned char *>(in + i);
+        int a                     = BASE64_DIGITS[quad[0]];
+        int b                     = BASE64_DIGITS[quad[1]];
+        int c                     = BASE64_DIGITS[quad[2]];
+        int d                     = BASE64_DIGITS[quad[3]];
+        if ((a | b | c | d) >= 0)
         {
-            tin[i] -= 'A';
+            uint32_t block = (static_cast<uint32_t>(a) << 18) |
+                             (static_cast<uint32_t>(b) << 12) |
+                             (static_cast<uint32_t>(c) << 6) | static_cast<uint32_t>(d);
+            out[written++] = static_cast<uint8_t>(block >> 16);
+            out[written++] = static_cast<uint8_t>(block >> 8);
+            out[written++] = static_cast<uint8_t>(block);
+            continue;
         }
-        else
+
+        // Padding, which ends the data, or an invalid character.
+        checkBase64Char(quad[0], false);
+        checkBase64Char(quad[1], false);
+        checkBase64Char(quad[2], true);
+        checkBase64Char(quad[3], true);
+        if (quad[2] == '=')
         {
-            if ((tin[i] >= 'a') && (tin[i] <= 'z'))
+            if (quad[3] != '=')
             {
-                tin[i] -= 'a' - ('Z' - 'A' + 1);
-            }
-            else
-            {
-                if ((tin[i] >= '0') && (tin[i] <= '9'))
-                {
-                    tin[i] -= '0' - ('Z' - 'A' + 1) - ('z' - 'a' + 1);
-                }
-                else
-                {
-                    if (tin[i] == '+')
-                    {
-                        tin[i] = 62;
-                    }
-                    else
-                    {
-                        if (tin[i] == '/')
-                        {
-                            tin[i] = 63;
-                        }
-                        else
-                        {
-                            tin[i] = 0;
-                        }
-                    }
-                }
+                THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                         "'=' character expected");
             }
+            out[written++] = static_cast<uint8_t>((a << 2) | (b >> 4));
+        }
+        else
+        {
+            out[written++] = static_cast<uint8_t>((a << 2) | (b >> 4));
+            out[written++] = static_cast<uint8_t>((b << 4) | (c >> 2));
         }
+        break;
     }
-
-    out[0] = (tin[0] << 2 | tin[1] >> 4);
-    out[1] = (tin[1] << 4 | tin[2] >> 2);
-    out[2] = (((tin[2] << 6) & 0xc0) | tin[3]);
+    return written;
 }
 
 std::string BufferHelper::getHex(const ByteVector &buffer)
 {
-    std::ostringstream ss;
-
-    ss << std::hex << std::uppercase << std::setfill('0');
-    std::for_each(buffer.cbegin(), buffer.cend(),
-                  [&](int c) { ss << std::setw(2) << c; });
-
-    std::string result = ss.str();
+    std::string result(buffer.size() * 2, '\0');
+    if (!buffer.empty())
+        hexEncode(buffer.data(), buffer.size(), &result[0]);
     return result;
 }
 
 std::string BufferHelper::getHex(const std::string &buffer)
 {
-    return getHex(ByteVector(buffer.begin(), buffer.end()));
+    std::string result(buffer.size() * 2, '\0');
+    if (!buffer.empty())
+        hexEncode(reinterpret_cast<const uint8_t *>(buffer.data()), buffer.size(),
+                  &result[0]);
+    return result;
 }
 
 std::string BufferHelper::toBase64(const ByteVector &buf)
 {
-    std::string result;
-    result.resize(((buf.size() + 2) / 3) * 4);
-
-    size_t result_len = 0;
-
-    for (size_t i = 0; i < buf.size();)
-    {
-        size_t len = (buf.size() - i);
-
-        if (len > 3)
-        {
-            len = 3;
-        }
-
-        result_len += 4;
-        base64EncodeBlock(
-            &buf[i], reinterpret_cast<unsigned char *>(&result[0] + result_len - 4), len);
-
-        i += len;
-    }
-
+    std::string result(getBase64EncodedSize(buf.size()), '\0');
+    if (!buf.empty())
+        base64Encode(buf.data(), buf.size(), &result[0]);
     return result;
 }
 
 ByteVector BufferHelper::fromBase64(const std::string &b64str)
 {
-    EXCEPTION_ASSERT((b64str.size() % 4) == 0, std::invalid_argument,
-                     "The buffer size must be multiple of 4");
-
-    ByteVector result;
-    unsigned char tmp[64];
-
-    for (size_t i = 0; i < b64str.size(); i += 4)
-    {
-        size_t len = 0;
-        base64DecodeBlock(reinterpret_cast<const unsigned char *>(&b64str[0] + i), tmp,
-                          len);
-
-        result.insert(result.end(), tmp, tmp + len);
-
-        if (len < 3)
-        {
-            break;
-        }
-    }
-
+    ByteVector result(b64str.size() / 4 * 3);
+    result.resize(base64Decode(b64str.data(), b64str.size(), result.data()));
     return result;
 }
 
 ByteVector BufferHelper::fromHexString(std::string hexString)
 {
-    ByteVector data;
-    std::stringstream convertStream;
-
-    // delete spaces
-    hexString.erase(std::remove(hexString.begin(), hexString.end(), ' '),
-                    hexString.end());
-
-    size_t offset = 0;
-    while (offset < hexString.length())
-    {
-        unsigned int buffer;
-
-        convertStream << std::hex << hexString.substr(offset, 2);
-        convertStream >> std::hex >> buffer;
-
-        data.push_back(static_cast<unsigned char>(buffer));
-
-        offset += 2;
-
-        // empty the stringstream
-        convertStream.str(std::string());
-        convertStream.clear();
-    }
-
+    ByteVector data((hexString.size() + 1) / 2);
+    data.resize(hexDecode(hexString.data(), hexString.size(), data.data()));
     return data;
 }
 
@@ -50,4 +50,9 @@ std::string AES128Key::getDefaultXmlNodeName() const
 {
     return "AES128Key";
 }
+
+std::shared_ptr<Key> AES128Key::clone() const
+{
+    return std::make_shared<AES128Key>(*this);
+}
 }
\ No newline at end of file
@@ -50,4 +50,9 @@ std::string HMAC1Key::getDefaultXmlNodeName() const
 {
     return "HMAC1Key";
 }
+
+std::shared_ptr<Key> HMAC1Key::clone() const
+{
+    return std::make_shared<HMAC1Key>(*this);
+}
 }
\ No newline at end of file
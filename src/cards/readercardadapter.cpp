@@ -5,7 +5,10 @@
  */
 
 #include <logicalaccess/cards/readercardadapter.hpp>
+#include <logicalaccess/cards/chip.hpp>
+#include <logicalaccess/readerproviders/readerunit.hpp>
 #include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/metrics.hpp>
 #include <logicalaccess/myexception.hpp>
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <logicalaccess/plugins/llacommon/settings.hpp>
@@ -31,6 +34,25 @@ ByteVector ReaderCardAdapter::sendCommand(const ByteVector &command, long timeou
 
     if (d_dataTransport)
     {
+        std::shared_ptr<ReaderUnit> readerUnit = d_dataTransport->getReaderUnit();
+        std::shared_ptr<Chip> chip =
+            readerUnit ? readerUnit->getInsertedChip() : std::shared_ptr<Chip>();
+        std::shared_ptr<const LatencyMetrics> commandMetrics;
+        if (MetricsRegistry::getInstance().isEnabled())
+        {
+            const std::string reader = readerUnit ? readerUnit->getName() : "";
+            const std::string card   = chip ? chip->getCardType() : "";
+            commandMetrics           = std::atomic_load(&d_commandMetrics);
+            if (!commandMetrics || commandMetrics->getLabel("reader") != reader ||
+                commandMetrics->getLabel("card") != card)
+            {
+                commandMetrics = std::make_shared<LatencyMetrics>(
+                    "lla_card_command", MetricLabels{{"reader", reader}, {"card", card}});
+                std::atomic_store(&d_commandMetrics, commandMetrics);
+            }
+        }
+        LatencyRecorder metrics(commandMetrics);
+
         res = adaptAnswer(d_dataTransport->sendCommand(adaptCommand(command), timeout));
 
         if (res.size() > 0 && getResultChecker())
@@ -44,6 +66,7 @@ ByteVector ReaderCardAdapter::sendCommand(const ByteVector &command, long timeou
                 LibLogicalAccessException,
                 "ResultChecker is set but no data has been received !!!")
         }
+        metrics.succeed();
     }
     else
     {
@@ -50,4 +50,9 @@ std::string TripleDESKey::getDefaultXmlNodeName() const
 {
     return "TripleDESKey";
 }
+
+std::shared_ptr<Key> TripleDESKey::clone() const
+{
+    return std::make_shared<TripleDESKey>(*this);
+}
 }
\ No newline at end of file
@@ -0,0 +1,409 @@
+/**
+ * \file compiledconfiguration.cpp
+ * \brief Binary compiled form of a XML configuration.
+ */
+
+#include <logicalaccess/compiledconfiguration.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace logicalaccess
+{
+namespace
+{
+const uint8_t MAGIC[4] = {'L', 'L', 'A', 'C'};
+
+const size_t HEADER_SIZE = 20;
+
+const size_t STRING_ENTRY_SIZE = 8;
+
+enum NodeField
+{
+    NAME = 0,
+    VALUE,
+    CHILD_COUNT,
+    DESCENDANT_COUNT,
+    NODE_FIELD_COUNT
+};
+
+const size_t NODE_SIZE = NODE_FIELD_COUNT * 4;
+
+typedef std::array<uint32_t, NODE_FIELD_COUNT> NodeRecord;
+
+void appendUInt32(ByteVector &buffer, uint32_t value)
+{
+    buffer.push_back(static_cast<uint8_t>(value & 0xff));
+    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xff));
+    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xff));
+    buffer.push_back(static_cast<uint8_t>((value >> 24) & 0xff));
+}
+
+uint32_t readUInt32(const uint8_t *data)
+{
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint32_t checkedSize(size_t size)
+{
+    EXCEPTION_ASSERT_WITH_LOG(size <= std::numeric_limits<uint32_t>::max(),
+                              LibLogicalAccessException,
+                              "The configuration is too large to be compiled.");
+    return static_cast<uint32_t>(size);
+}
+
+/**
+ * Flatten a property tree to the node table and string table.
+ */
+class Compiler
+{
+  public:
+    void addNode(const std::string &name, const boost::property_tree::ptree &tree)
+    {
+        size_t index = nodes.size();
+        nodes.push_back(NodeRecord());
+        NodeRecord record;
+        record[NAME]        = addString(name);
+        record[VALUE]       = addString(tree.data());
+        record[CHILD_COUNT] = checkedSize(tree.size());
+
+        for (const auto &child : tree)
+        {
+            addNode(child.first, child.second);
+        }
+        record[DESCENDANT_COUNT] = checkedSize(nodes.size() - index - 1);
+        nodes[index]             = record;
+    }
+
+    std::vector<NodeRecord> nodes;
+
+    /**
+     * Offset and length of each string in the pool.
+     */
+    std::vector<std::pair<uint32_t, uint32_t>> strings;
+
+    ByteVector pool;
+
+  private:
+    uint32_t addString(const std::string &str)
+    {
+        auto it = indexes.find(str);
+        if (it != indexes.end())
+            return it->second;
+
+        uint32_t index = checkedSize(strings.size());
+        strings.push_back(
+            std::make_pair(checkedSize(pool.size()), checkedSize(str.size())));
+        pool.insert(pool.end(), str.begin(), str.end());
+        checkedSize(pool.size());
+        indexes[str] = index;
+        return index;
+    }
+
+    std::map<std::string, uint32_t> indexes;
+};
+}
+
+struct CompiledConfiguration::Mapping
+{
+    boost::interprocess::file_mapping file;
+
+    boost::interprocess::mapped_region region;
+};
+
+CompiledConfiguration::CompiledConfiguration()
+    : d_data(nullptr)
+    , d_size(0)
+    , d_nodeCount(0)
+    , d_stringCount(0)
+    , d_nodes(nullptr)
+    , d_strings(nullptr)
+    , d_pool(nullptr)
+{
+}
+
+CompiledConfiguration::CompiledConfiguration(const ByteVector &image)
+    : CompiledConfiguration()
+{
+    d_image = image;
+    d_data  = d_image.data();
+    d_size  = d_image.size();
+    validate();
+}
+
+CompiledConfiguration::~CompiledConfiguration()
+{
+}
+
+std::shared_ptr<CompiledConfiguration>
+CompiledConfiguration::fromFile(const std::string &filename)
+{
+    std::shared_ptr<CompiledConfiguration> config(new CompiledConfiguration());
+    try
+    {
+        config->d_mapping.reset(new Mapping());
+        config->d_mapping->file = boost::interprocess::file_mapping(
+            filename.c_str(), boost::interprocess::read_only);
+        config->d_mapping->region = boost::interprocess::mapped_region(
+            config->d_mapping->file, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception &ex)
+    {
+        THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                                 "Unable to map the compiled configuration " + filename +
+                                     ": " + ex.what());
+    }
+    config->d_data =
+        static_cast<const uint8_t *>(config->d_mapping->region.get_address());
+    config->d_size = config->d_mapping->region.get_size();
+    config->validate();
+    return config;
+}
+
+ByteVector CompiledConfiguration::compile(const boost::property_tree::ptree &tree)
+{
+    Compiler compiler;
+    compiler.addNode("", tree);
+
+    ByteVector image;
+    image.reserve(HEADER_SIZE + compiler.strings.size() * STRING_ENTRY_SIZE +
+                  compiler.nodes.size() * NODE_SIZE + compiler.pool.size());
+    image.insert(image.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    image.push_back(static_cast<uint8_t>(VERSION & 0xff));
+    image.push_back(static_cast<uint8_t>(VERSION >> 8));
+    image.push_back(0x00);
+    image.push_back(0x00);
+    appendUInt32(image, checkedSize(compiler.nodes.size()));
+    appendUInt32(image, checkedSize(compiler.strings.size()));
+    appendUInt32(image, checkedSize(compiler.pool.size()));
+    for (const auto &entry : compiler.strings)
+    {
+        appendUInt32(image, entry.first);
+        appendUInt32(image, entry.second);
+    }
+    for (const auto &record : compiler.nodes)
+    {
+        for (uint32_t field : record)
+        {
+            appendUInt32(image, field);
+        }
+    }
+    image.insert(image.end(), compiler.pool.begin(), compiler.pool.end());
+    return image;
+}
+
+void CompiledConfiguration::compileToFile(const boost::property_tree::ptree &tree,
+                                          const std::string &filename)
+{
+    ByteVector image = compile(tree);
+    std::ofstream ofs(filename.c_str(), std::ios_base::binary | std::ios_base::trunc);
+    EXCEPTION_ASSERT_WITH_LOG(ofs.is_open(), LibLogicalAccessException,
+                              "Unable to open the file");
+    ofs.write(reinterpret_cast<const char *>(image.data()),
+              static_cast<std::streamsize>(image.size()));
+    ofs.close();
+    EXCEPTION_ASSERT_WITH_LOG(!ofs.fail(), LibLogicalAccessException,
+                              "Writing the compiled configuration failed.");
+}
+
+void CompiledConfiguration::compileXmlFile(const std::string &xmlFilename,
+                                           const std::string &filename)
+{
+    boost::property_tree::ptree pt;
+    read_xml(xmlFilename, pt);
+    compileToFile(pt, filename);
+}
+
+void CompiledConfiguration::validate()
+{
+    EXCEPTION_ASSERT_WITH_LOG(d_size >= HEADER_SIZE &&
+                                  std::memcmp(d_data, MAGIC, sizeof(MAGIC)) == 0,
+                              LibLogicalAccessException,
+                              "Not a compiled configuration.");
+    uint16_t version = static_cast<uint16_t>(d_data[4] | (d_data[5] << 8));
+    EXCEPTION_ASSERT_WITH_LOG(version == VERSION, LibLogicalAccessException,
+                              "Unsupported compiled configuration version.");
+
+    d_nodeCount       = readUInt32(d_data + 8);
+    d_stringCount     = readUInt32(d_data + 12);
+    uint32_t poolSize = readUInt32(d_data + 16);
+    uint64_t expected = HEADER_SIZE +
+                        static_cast<uint64_t>(d_stringCount) * STRING_ENTRY_SIZE +
+                        static_cast<uint64_t>(d_nodeCount) * NODE_SIZE + poolSize;
+    EXCEPTION_ASSERT_WITH_LOG(d_nodeCount > 0 && expected == d_size,
+                              LibLogicalAccessException,
+                              "Truncated or corrupted compiled configuration.");
+    d_strings = d_data + HEADER_SIZE;
+    d_nodes   = d_strings + d_stringCount * STRING_ENTRY_SIZE;
+    d_pool    = d_nodes + d_nodeCount * NODE_SIZE;
+
+    // Check the whole image once, so that reading it later needs no check.
+    for (size_t index = 0; index < d_stringCount; ++index)
+    {
+        const uint8_t *entry = d_strings + index * STRING_ENTRY_SIZE;
+        EXCEPTION_ASSERT_WITH_LOG(static_cast<uint64_t>(readUInt32(entry)) +
+                                          readUInt32(entry + 4) <=
+                                      poolSize,
+                                  LibLogicalAccessException,
+                                  "Corrupted compiled configuration.");
+    }
+    EXCEPTION_ASSERT_WITH_LOG(readNodeField(0, DESCENDANT_COUNT) == d_nodeCount - 1,
+                              LibLogicalAccessException,
+                              "Corrupted compiled configuration.");
+    for (size_t node = 0; node < d_nodeCount; ++node)
+    {
+        uint64_t subtreeEnd =
+            static_cast<uint64_t>(node) + 1 + readNodeField(node, DESCENDANT_COUNT);
+        EXCEPTION_ASSERT_WITH_LOG(readNodeField(node, NAME) < d_stringCount &&
+                                      readNodeField(node, VALUE) < d_stringCount &&
+                                      subtreeEnd <= d_nodeCount,
+                                  LibLogicalAccessException,
+                                  "Corrupted compiled configuration.");
+
+        uint64_t child = node + 1;
+        for (uint32_t i = 0; i < readNodeField(node, CHILD_COUNT); ++i)
+        {
+            EXCEPTION_ASSERT_WITH_LOG(child < subtreeEnd, LibLogicalAccessException,
+                                      "Corrupted compiled configuration.");
+            child += 1 + readNodeField(static_cast<size_t>(child), DESCENDANT_COUNT);
+        }
+        EXCEPTION_ASSERT_WITH_LOG(child == subtreeEnd, LibLogicalAccessException,
+                                  "Corrupted compiled configuration.");
+    }
+
+    // Bound the depth, as the unSerialize() of the configured objects recurse.
+    std::vector<uint32_t> remaining(1, readNodeField(0, CHILD_COUNT));
+    for (size_t node = 1; node < d_nodeCount; ++node)
+    {
+        while (remaining.back() == 0)
+            remaining.pop_back();
+        --remaining.back();
+        remaining.push_back(readNodeField(node, CHILD_COUNT));
+        EXCEPTION_ASSERT_WITH_LOG(remaining.size() <= MAX_DEPTH + 1,
+                                  LibLogicalAccessException,
+                                  "Compiled configuration too deep.");
+    }
+}
+
+uint32_t CompiledConfiguration::readNodeField(size_t node, size_t field) const
+{
+    return readUInt32(d_nodes + node * NODE_SIZE + field * 4);
+}
+
+const char *CompiledConfiguration::getString(uint32_t index, size_t &length) const
+{
+    const uint8_t *entry = d_strings + index * STRING_ENTRY_SIZE;
+    length               = readUInt32(entry + 4);
+    return reinterpret_cast<const char *>(d_pool) + readUInt32(entry);
+}
+
+std::string CompiledConfiguration::readString(uint32_t index) const
+{
+    size_t length;
+    const char *str = getString(index, length);
+    return std::string(str, length);
+}
+
+void CompiledConfiguration::buildTree(size_t node,
+                                      boost::property_tree::ptree &tree) const
+{
+    // Iterative, the nodes being in depth-first order: each entry is a tree
+    // being filled and the number of its children still to add.
+    std::vector<std::pair<boost::property_tree::ptree *, uint32_t>> parents;
+    tree.data() = readString(readNodeField(node, VALUE));
+    parents.push_back(std::make_pair(&tree, readNodeField(node, CHILD_COUNT)));
+
+    size_t end = node + 1 + readNodeField(node, DESCENDANT_COUNT);
+    for (size_t child = node + 1; child < end; ++child)
+    {
+        while (parents.back().second == 0)
+            parents.pop_back();
+        --parents.back().second;
+
+        auto it = parents.back().first->push_back(
+            std::make_pair(readString(readNodeField(child, NAME)),
+                           boost::property_tree::ptree(
+                               readString(readNodeField(child, VALUE)))));
+        parents.push_back(std::make_pair(&it->second, readNodeField(child, CHILD_COUNT)));
+    }
+}
+
+void CompiledConfiguration::toPtree(boost::property_tree::ptree &tree) const
+{
+    tree.clear();
+    buildTree(0, tree);
+}
+
+bool CompiledConfiguration::toPtree(const std::string &path,
+                                    boost::property_tree::ptree &tree) const
+{
+    size_t node;
+    if (!findNode(path, node))
+        return false;
+
+    tree.clear();
+    buildTree(node, tree);
+    return true;
+}
+
+bool CompiledConfiguration::findNode(const std::string &path, size_t &node) const
+{
+    node         = 0;
+    size_t begin = 0;
+    while (begin <= path.size() && !path.empty())
+    {
+        size_t end = path.find('.', begin);
+        if (end == std::string::npos)
+            end = path.size();
+
+        bool found   = false;
+        size_t child = node + 1;
+        for (uint32_t i = 0; i < readNodeField(node, CHILD_COUNT) && !found; ++i)
+        {
+            size_t length;
+            const char *name = getString(readNodeField(child, NAME), length);
+            if (length == end - begin && path.compare(begin, length, name, length) == 0)
+            {
+                found = true;
+                node  = child;
+            }
+            else
+            {
+                child += 1 + readNodeField(child, DESCENDANT_COUNT);
+            }
+        }
+        if (!found)
+            return false;
+        begin = end + 1;
+    }
+    return true;
+}
+
+bool CompiledConfiguration::findValue(const std::string &path, std::string &value) const
+{
+    size_t node;
+    if (!findNode(path, node))
+        return false;
+
+    value = readString(readNodeField(node, VALUE));
+    return true;
+}
+
+size_t CompiledConfiguration::getNodeCount() const
+{
+    return d_nodeCount;
+}
+}
@@ -1,5 +1,8 @@
 #include <logicalaccess/dynlibrary/librarymanager.hpp>
+#include <logicalaccess/dynlibrary/staticpluginregistry.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 
 // TODO: Data transport should also be through plug-in
@@ -11,6 +14,8 @@
 #include <logicalaccess/utils.hpp>
 #include <logicalaccess/myexception.hpp>
 
+#include <algorithm>
+
 namespace logicalaccess
 {
 const std::string LibraryManager::enumType[3] = {"readers", "cards", "unified"};
@@ -26,21 +31,101 @@ bool LibraryManager::hasEnding(std::string const &fullString, std::string ending
     return false;
 }
 
+LibraryManager::LibraryManager()
+    : scanned_(false)
+    , allLoaded_(false)
+    , stopBackground_(false)
+{
+}
+
+LibraryManager::~LibraryManager()
+{
+    stopBackgroundLoad();
+}
+
 LibraryManager *LibraryManager::getInstance()
 {
     static LibraryManager instance;
     return &instance;
 }
 
+void *LibraryManager::getCachedFctFromType(SymbolKind kind, const std::string &type)
+{
+    std::shared_ptr<const SymbolMap> map = std::atomic_load(&symbolCache_[kind]);
+    if (map)
+    {
+        auto it = map->find(type);
+        if (it != map->end())
+            return it->second;
+    }
+
+    std::lock_guard<std::recursive_mutex> lg(mutex_);
+    map = std::atomic_load(&symbolCache_[kind]);
+    if (map)
+    {
+        auto it = map->find(type);
+        if (it != map->end())
+            return it->second;
+    }
+
+    std::string fctname;
+    LibraryType libraryType = READERS_TYPE;
+    switch (kind)
+    {
+    case READER_PROVIDER_SYMBOL: fctname = "get" + type + "Reader"; break;
+    case CHIP_SYMBOL:
+        fctname     = "get" + type + "Chip";
+        libraryType = CARDS_TYPE;
+        break;
+    case COMMANDS_SYMBOL: fctname = "get" + type + "Commands"; break;
+    case DIVERSIFICATION_SYMBOL:
+        fctname     = "get" + type + "Diversification";
+        libraryType = CARDS_TYPE;
+        break;
+    default: break;
+    }
+
+    // Static plug-ins don't require a scan. Otherwise only the plug-in
+    // declaring the type is loaded when it is known. A type not found there,
+    // or not declared, requires every plug-in.
+    void *fct = StaticPluginRegistry::getSymbol(fctname);
+    if (fct == nullptr)
+    {
+        if (!scanned_)
+            scanPlugins();
+
+        IDynLibrary *lib = loadPluginFor(kind, type);
+        if (lib != nullptr && lib->hasSymbol(fctname.c_str()))
+            fct = lib->getSymbol(fctname.c_str());
+        if (fct == nullptr)
+            fct = getFctFromName(fctname, libraryType);
+    }
+
+    std::shared_ptr<SymbolMap> newMap =
+        map ? std::make_shared<SymbolMap>(*map) : std::make_shared<SymbolMap>();
+    (*newMap)[type] = fct;
+    std::atomic_store(&symbolCache_[kind], std::shared_ptr<const SymbolMap>(newMap));
+    return fct;
+}
+
+void LibraryManager::clearSymbolCache()
+{
+    for (auto &cache : symbolCache_)
+    {
+        std::atomic_store(&cache, std::shared_ptr<const SymbolMap>());
+    }
+}
+
 void *LibraryManager::getFctFromName(const std::string &fctname, LibraryType libraryType)
 {
     std::lock_guard<std::recursive_mutex> lg(mutex_);
     void *fct;
-    boost::filesystem::directory_iterator end_iter;
     std::string extension = EXTENSION_LIB;
 
-    if (libLoaded.empty())
-        scanPlugins();
+    if ((fct = StaticPluginRegistry::getSymbol(fctname)) != nullptr)
+        return fct;
+
+    loadAllPlugins();
 
     for (std::map<std::string, IDynLibrary *>::iterator it = libLoaded.begin();
          it != libLoaded.end(); ++it)
@@ -63,12 +148,10 @@ void *LibraryManager::getFctFromName(const std::string &fctname, LibraryType lib
 std::shared_ptr<ReaderProvider>
 LibraryManager::getReaderProvider(const std::string &readertype)
 {
-    std::lock_guard<std::recursive_mutex> lg(mutex_);
     std::shared_ptr<ReaderProvider> ret;
-    std::string fctname = "get" + readertype + "Reader";
 
     getprovider getpcscsfct;
-    *(void **)(&getpcscsfct) = getFctFromName(fctname, READERS_TYPE);
+    *(void **)(&getpcscsfct) = getCachedFctFromType(READER_PROVIDER_SYMBOL, readertype);
 
     if (getpcscsfct)
     {
@@ -80,12 +163,10 @@ LibraryManager::getReaderProvider(const std::string &readertype)
 
 std::shared_ptr<Chip> LibraryManager::getCard(const std::string &cardtype)
 {
-    std::lock_guard<std::recursive_mutex> lg(mutex_);
     std::shared_ptr<Chip> ret;
-    std::string fctname = "get" + cardtype + "Chip";
 
     getcard getcardfct;
-    *(void **)(&getcardfct) = getFctFromName(fctname, CARDS_TYPE);
+    *(void **)(&getcardfct) = getCachedFctFromType(CHIP_SYMBOL, cardtype);
 
     if (getcardfct)
     {
@@ -98,12 +179,11 @@ std::shared_ptr<Chip> LibraryManager::getCard(const std::string &cardtype)
 std::shared_ptr<KeyDiversification>
 LibraryManager::getKeyDiversification(const std::string &keydivtype)
 {
-    std::lock_guard<std::recursive_mutex> lg(mutex_);
     std::shared_ptr<KeyDiversification> ret;
-    std::string fctname = "get" + keydivtype + "Diversification";
 
     getdiversification getdiversificationfct;
-    *(void **)(&getdiversificationfct) = getFctFromName(fctname, CARDS_TYPE);
+    *(void **)(&getdiversificationfct) =
+        getCachedFctFromType(DIVERSIFICATION_SYMBOL, keydivtype);
 
     if (getdiversificationfct)
     {
@@ -115,13 +195,11 @@ LibraryManager::getKeyDiversification(const std::string &keydivtype)
 
 std::shared_ptr<Commands> LibraryManager::getCommands(const std::string &extendedtype)
 {
-    std::lock_guard<std::recursive_mutex> lg(mutex_);
     std::shared_ptr<Commands> ret;
-    std::string fctname = "get" + extendedtype + "Commands";
 
     LOG(LogLevel::INFOS) << "Trying to find commands: " << extendedtype;
     getcommands getcommandsfct;
-    *(void **)(&getcommandsfct) = getFctFromName(fctname, READERS_TYPE);
+    *(void **)(&getcommandsfct) = getCachedFctFromType(COMMANDS_SYMBOL, extendedtype);
     if (getcommandsfct)
     {
         LOG(LogLevel::INFOS) << "Found command " << extendedtype;
@@ -178,39 +256,19 @@ std::vector<std::string> LibraryManager::getAvailableDataTransports()
 std::vector<std::string> LibraryManager::getAvailablePlugins(LibraryType libraryType)
 {
     std::lock_guard<std::recursive_mutex> lg(mutex_);
-    std::vector<std::string> plugins;
-    void *fct;
-    boost::filesystem::directory_iterator end_iter;
-    std::string fctname;
-
-    if (libraryType == CARDS_TYPE)
-    {
-        fctname = "getChipInfoAt";
-    }
-    else if (libraryType == READERS_TYPE)
-    {
-        fctname = "getReaderInfoAt";
-    }
+    std::vector<std::string> plugins = (libraryType == CARDS_TYPE)
+                                           ? StaticPluginRegistry::getChipTypes()
+                                           : StaticPluginRegistry::getReaderTypes();
 
-    if (libLoaded.empty())
+    if (!scanned_)
         scanPlugins();
 
-    for (std::map<std::string, IDynLibrary *>::iterator it = libLoaded.begin();
-         it != libLoaded.end(); ++it)
+    // The manifest lists the types of plug-ins not loaded yet.
+    for (const auto &plugin : manifest_)
     {
-        try
-        {
-            if ((*it).second != nullptr &&
-                (fct = (*it).second->getSymbol(fctname.c_str())) != nullptr)
-            {
-                getobjectinfoat objectinfoptr;
-                *(void **)(&objectinfoptr) = fct;
-                getAvailablePlugins(plugins, objectinfoptr);
-            }
-        }
-        catch (...)
-        {
-        }
+        const std::vector<std::string> &types =
+            (libraryType == CARDS_TYPE) ? plugin.second.chips : plugin.second.readers;
+        plugins.insert(plugins.end(), types.begin(), types.end());
     }
 
     return plugins;
@@ -240,8 +298,7 @@ std::shared_ptr<ReaderUnit> LibraryManager::getReader(const std::string &readerN
     // that some module will be able to fulfil our request.
     std::shared_ptr<ReaderUnit> readerUnit;
 
-    if (libLoaded.empty())
-        scanPlugins();
+    loadAllPlugins();
 
     for (auto &&itr : libLoaded)
     {
@@ -260,13 +317,12 @@ std::shared_ptr<ReaderUnit> LibraryManager::getReader(const std::string &readerN
     return readerUnit;
 }
 
-void LibraryManager::scanPlugins()
+std::map<std::string, std::string> LibraryManager::listPluginFiles()
 {
-    std::lock_guard<std::recursive_mutex> lg(mutex_);
+    std::map<std::string, std::string> files;
     boost::filesystem::directory_iterator end_iter;
-    std::string extension = EXTENSION_LIB;
-    Settings *setting     = Settings::getInstance();
-    std::string fctname   = "getLibraryName";
+    std::string extension             = EXTENSION_LIB;
+    std::shared_ptr<Settings> setting = Settings::getInstance();
 
     LOG(LogLevel::PLUGINS) << "Will scan " << setting->PluginFolders.size()
                            << " folders.";
@@ -295,22 +351,8 @@ void LibraryManager::scanPlugins()
                          hasEnding(dir_iter->path().filename().string(),
                                    enumType[LibraryManager::UNIFIED_TYPE] + extension)))
                     {
-                        IDynLibrary *lib = newDynLibrary(dir_iter->path().string());
-                        void *fct        = lib->getSymbol(fctname.c_str());
-                        if (fct != nullptr)
-                        {
-                            LOG(LogLevel::PLUGINS) << "Library "
-                                                   << dir_iter->path().filename().string()
-                                                   << " loaded.";
-                            libLoaded[dir_iter->path().filename().string()] = lib;
-                        }
-                        else
-                        {
-                            LOG(LogLevel::PLUGINS)
-                                << "Cannot found library entry point in "
-                                << dir_iter->path().filename().string() << ". Skipped.";
-                            delete lib;
-                        }
+                        files[dir_iter->path().filename().string()] =
+                            dir_iter->path().string();
                     }
                     else
                     {
@@ -332,6 +374,297 @@ void LibraryManager::scanPlugins()
             LOG(LogLevel::WARNINGS) << "Cannot found plug-in folder " << (*it);
         }
     }
+    return files;
+}
+
+IDynLibrary *LibraryManager::openPlugin(const std::string &path)
+{
+    std::string filename = boost::filesystem::path(path).filename().string();
+    try
+    {
+        IDynLibrary *lib = newDynLibrary(path);
+        if (lib->hasSymbol("getLibraryName"))
+        {
+            LOG(LogLevel::PLUGINS) << "Library " << filename << " loaded.";
+            return lib;
+        }
+
+        LOG(LogLevel::PLUGINS) << "Cannot found library entry point in " << filename
+                               << ". Skipped.";
+        delete lib;
+    }
+    catch (const std::exception &e)
+    {
+        LOG(LogLevel::ERRORS) << "Something bad happened when handling " << filename
+                              << ": " << e.what();
+    }
+    return nullptr;
+}
+
+bool LibraryManager::readManifest(const std::string &filename,
+                                  const std::map<std::string, std::string> &files,
+                                  PluginManifest &manifest)
+{
+    using boost::property_tree::ptree;
+    try
+    {
+        if (!boost::filesystem::exists(filename))
+            return false;
+
+        ptree pt;
+        read_xml(filename, pt);
+
+        const ptree empty;
+        PluginManifest plugins;
+        for (const ptree::value_type &v : pt.get_child("manifest"))
+        {
+            if (v.first != "plugin")
+                continue;
+
+            std::string name    = v.second.get<std::string>("name");
+            PluginEntry entry;
+            entry.path          = v.second.get<std::string>("path");
+            entry.lastWriteTime = v.second.get<std::time_t>("lastWriteTime");
+            entry.size          = v.second.get<uintmax_t>("size");
+
+            auto file = files.find(name);
+            if (file == files.end() || file->second != entry.path ||
+                boost::filesystem::last_write_time(entry.path) != entry.lastWriteTime ||
+                boost::filesystem::file_size(entry.path) != entry.size)
+            {
+                LOG(LogLevel::PLUGINS) << "Plug-in " << name
+                                       << " changed since the manifest was written.";
+                return false;
+            }
+
+            for (const ptree::value_type &chip : v.second.get_child("chips", empty))
+            {
+                entry.chips.push_back(chip.second.get_value<std::string>());
+            }
+            for (const ptree::value_type &reader : v.second.get_child("readers", empty))
+            {
+                entry.readers.push_back(reader.second.get_value<std::string>());
+            }
+            plugins[name] = entry;
+        }
+
+        if (plugins.size() != files.size())
+        {
+            LOG(LogLevel::PLUGINS) << "New plug-ins since the manifest was written.";
+            return false;
+        }
+
+        manifest.swap(plugins);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        LOG(LogLevel::WARNINGS) << "Cannot read plug-in manifest " << filename << ": "
+                                << e.what();
+    }
+    return false;
+}
+
+void LibraryManager::writeManifest(const std::string &filename,
+                                   const PluginManifest &manifest)
+{
+    using boost::property_tree::ptree;
+    try
+    {
+        ptree pt;
+        ptree &plugins = pt.put_child("manifest", ptree());
+        for (const auto &plugin : manifest)
+        {
+            ptree node;
+            node.put("name", plugin.first);
+            node.put("path", plugin.second.path);
+            node.put("lastWriteTime", plugin.second.lastWriteTime);
+            node.put("size", plugin.second.size);
+            ptree &chips = node.put_child("chips", ptree());
+            for (const auto &chip : plugin.second.chips)
+            {
+                chips.add("chip", chip);
+            }
+            ptree &readers = node.put_child("readers", ptree());
+            for (const auto &reader : plugin.second.readers)
+            {
+                readers.add("reader", reader);
+            }
+            plugins.add_child("plugin", node);
+        }
+
+        write_xml(filename, pt);
+        LOG(LogLevel::PLUGINS) << "Plug-in manifest " << filename << " written.";
+    }
+    catch (const std::exception &e)
+    {
+        LOG(LogLevel::WARNINGS) << "Cannot write plug-in manifest " << filename << ": "
+                                << e.what();
+    }
+}
+
+IDynLibrary *LibraryManager::loadPluginFor(SymbolKind kind, const std::string &type)
+{
+    if (kind != CHIP_SYMBOL && kind != READER_PROVIDER_SYMBOL)
+        return nullptr;
+
+    for (const auto &plugin : manifest_)
+    {
+        const std::vector<std::string> &types =
+            (kind == CHIP_SYMBOL) ? plugin.second.chips : plugin.second.readers;
+        if (std::find(types.begin(), types.end(), type) == types.end())
+            continue;
+
+        auto loaded = libLoaded.find(plugin.first);
+        if (loaded != libLoaded.end())
+            return loaded->second;
+
+        IDynLibrary *lib = openPlugin(plugin.second.path);
+        if (lib != nullptr)
+            libLoaded[plugin.first] = lib;
+        return lib;
+    }
+    return nullptr;
+}
+
+void LibraryManager::loadAllPlugins()
+{
+    std::lock_guard<std::recursive_mutex> lg(mutex_);
+    if (!scanned_)
+        scanPlugins();
+    if (allLoaded_)
+        return;
+
+    for (const auto &plugin : manifest_)
+    {
+        if (libLoaded.find(plugin.first) != libLoaded.end())
+            continue;
+
+        IDynLibrary *lib = openPlugin(plugin.second.path);
+        if (lib != nullptr)
+            libLoaded[plugin.first] = lib;
+    }
+    allLoaded_ = true;
+}
+
+void LibraryManager::backgroundLoad()
+{
+    // Libraries are opened without the manager lock, so that lookups are not
+    // delayed by the loading of unrelated plug-ins.
+    std::map<std::string, std::string> files;
+    {
+        std::lock_guard<std::recursive_mutex> lg(mutex_);
+        for (const auto &plugin : manifest_)
+        {
+            files[plugin.first] = plugin.second.path;
+        }
+    }
+
+    for (const auto &file : files)
+    {
+        if (stopBackground_)
+            return;
+
+        {
+            std::lock_guard<std::recursive_mutex> lg(mutex_);
+            if (libLoaded.find(file.first) != libLoaded.end())
+                continue;
+        }
+
+        IDynLibrary *lib = openPlugin(file.second);
+        if (lib == nullptr)
+            continue;
+
+        std::lock_guard<std::recursive_mutex> lg(mutex_);
+        if (libLoaded.find(file.first) == libLoaded.end())
+            libLoaded[file.first] = lib;
+        else
+            delete lib;
+    }
+}
+
+void LibraryManager::stopBackgroundLoad()
+{
+    stopBackground_ = true;
+    if (backgroundThread_.joinable())
+        backgroundThread_.join();
+}
+
+void LibraryManager::scanPlugins()
+{
+    std::lock_guard<std::recursive_mutex> lg(mutex_);
+    std::shared_ptr<Settings> setting = Settings::getInstance();
+
+    // Newly loaded libraries may provide types previously not found.
+    clearSymbolCache();
+
+    std::map<std::string, std::string> files = listPluginFiles();
+    PluginManifest manifest;
+    if (!setting->PluginManifestFile.empty() &&
+        readManifest(setting->PluginManifestFile, files, manifest))
+    {
+        LOG(LogLevel::PLUGINS) << "Plug-in manifest " << setting->PluginManifestFile
+                               << " is up to date, " << manifest.size()
+                               << " plug-ins will be loaded on demand.";
+        manifest_.swap(manifest);
+        scanned_   = true;
+        allLoaded_ = false;
+
+        if (setting->BackgroundPluginLoading && !backgroundThread_.joinable())
+            backgroundThread_ = std::thread(&LibraryManager::backgroundLoad, this);
+        return;
+    }
+
+    for (const auto &file : files)
+    {
+        IDynLibrary *lib = nullptr;
+        auto loaded      = libLoaded.find(file.first);
+        if (loaded != libLoaded.end())
+        {
+            lib = loaded->second;
+        }
+        else
+        {
+            lib = openPlugin(file.second);
+            if (lib == nullptr)
+                continue;
+            libLoaded[file.first] = lib;
+        }
+
+        PluginEntry entry;
+        entry.path          = file.second;
+        entry.lastWriteTime = 0;
+        entry.size          = 0;
+        try
+        {
+            entry.lastWriteTime = boost::filesystem::last_write_time(file.second);
+            entry.size          = boost::filesystem::file_size(file.second);
+            getobjectinfoat objectinfoptr;
+            if (lib->hasSymbol("getChipInfoAt"))
+            {
+                *(void **)(&objectinfoptr) = lib->getSymbol("getChipInfoAt");
+                getAvailablePlugins(entry.chips, objectinfoptr);
+            }
+            if (lib->hasSymbol("getReaderInfoAt"))
+            {
+                *(void **)(&objectinfoptr) = lib->getSymbol("getReaderInfoAt");
+                getAvailablePlugins(entry.readers, objectinfoptr);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            LOG(LogLevel::ERRORS) << "Something bad happened when handling "
+                                  << file.first << ": " << e.what();
+        }
+        manifest[file.first] = entry;
+    }
+
+    manifest_.swap(manifest);
+    scanned_   = true;
+    allLoaded_ = true;
+
+    if (!setting->PluginManifestFile.empty())
+        writeManifest(setting->PluginManifestFile, manifest_);
 }
 
 std::shared_ptr<CardService> LibraryManager::getCardService(std::shared_ptr<Chip> chip,
@@ -340,8 +673,7 @@ std::shared_ptr<CardService> LibraryManager::getCardService(std::shared_ptr<Chip
     std::lock_guard<std::recursive_mutex> lg(mutex_);
     std::shared_ptr<CardService> srv;
 
-    if (libLoaded.empty())
-        scanPlugins();
+    loadAllPlugins();
 
     for (auto &&itr : libLoaded)
     {
@@ -367,8 +699,7 @@ ReaderServicePtr LibraryManager::getReaderService(ReaderUnitPtr reader,
     std::lock_guard<std::recursive_mutex> lg(mutex_);
     ReaderServicePtr srv;
 
-    if (libLoaded.empty())
-        scanPlugins();
+    loadAllPlugins();
 
     for (auto &&itr : libLoaded)
     {
@@ -394,8 +725,7 @@ LibraryManager::getPKCSAESCrypto(const std::string &pkcs_library_shared_object_p
     std::lock_guard<std::recursive_mutex> lg(mutex_);
     IAESCryptoServicePtr pkcs_crypto;
 
-    if (libLoaded.empty())
-        scanPlugins();
+    loadAllPlugins();
 
     for (auto &&itr : libLoaded)
     {
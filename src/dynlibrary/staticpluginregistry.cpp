@@ -0,0 +1,164 @@
+/**
+ * \file staticpluginregistry.cpp
+ * \brief Factory functions of plug-ins linked statically.
+ */
+
+#include <logicalaccess/dynlibrary/staticpluginregistry.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace logicalaccess
+{
+namespace
+{
+/**
+ * The registered plug-ins. A table is never modified once published.
+ */
+struct Table
+{
+    /**
+     * Every registered entry, sorted by symbol name.
+     */
+    std::vector<const StaticPluginEntry *> entries;
+
+    std::vector<getobjectinfoat> chipInfos;
+
+    std::vector<getobjectinfoat> readerInfos;
+};
+
+struct Registry
+{
+    Registry()
+        : table(nullptr)
+    {
+    }
+
+    /**
+     * Serializes the registrations, done during static initialization.
+     */
+    std::mutex mutex;
+
+    /**
+     * The current table, read without lock.
+     */
+    std::atomic<const Table *> table;
+
+    /**
+     * Every published table. The previous ones are kept, as lookups may still
+     * read them: there is one per registration, so a few at most.
+     */
+    std::vector<std::unique_ptr<Table>> tables;
+};
+
+/**
+ * The registry is used from static initializers of other translation units:
+ * it is created on first use.
+ */
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+const Table *currentTable()
+{
+    return registry().table.load(std::memory_order_acquire);
+}
+
+bool symbolLess(const StaticPluginEntry *entry, const char *symbol)
+{
+    return std::strcmp(entry->symbol, symbol) < 0;
+}
+
+void addInfos(std::vector<getobjectinfoat> &infos, const getobjectinfoat *added)
+{
+    for (; added != nullptr && *added != nullptr; ++added)
+    {
+        if (std::find(infos.begin(), infos.end(), *added) == infos.end())
+            infos.push_back(*added);
+    }
+}
+
+std::vector<std::string> getTypes(const std::vector<getobjectinfoat> &infos)
+{
+    std::vector<std::string> types;
+    for (getobjectinfoat info : infos)
+    {
+        char objectname[PLUGINOBJECT_MAXLEN];
+        memset(objectname, 0x00, sizeof(objectname));
+        void *getobjectptr;
+
+        unsigned int i = 0;
+        while (info(i, objectname, sizeof(objectname), &getobjectptr))
+        {
+            types.push_back(std::string(objectname));
+            memset(objectname, 0x00, sizeof(objectname));
+            ++i;
+        }
+    }
+    return types;
+}
+}
+
+void StaticPluginRegistry::registerPlugins(const StaticPluginEntry *entries, size_t count,
+                                           const getobjectinfoat *chipInfos,
+                                           const getobjectinfoat *readerInfos)
+{
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    const Table *current = reg.table.load(std::memory_order_relaxed);
+    std::unique_ptr<Table> table(current ? new Table(*current) : new Table());
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto it = std::lower_bound(table->entries.begin(), table->entries.end(),
+                                   entries[i].symbol, symbolLess);
+        if (it == table->entries.end() ||
+            std::strcmp((*it)->symbol, entries[i].symbol) != 0)
+            table->entries.insert(it, &entries[i]);
+    }
+    addInfos(table->chipInfos, chipInfos);
+    addInfos(table->readerInfos, readerInfos);
+
+    reg.table.store(table.get(), std::memory_order_release);
+    reg.tables.push_back(std::move(table));
+}
+
+void *StaticPluginRegistry::getSymbol(const std::string &symbol)
+{
+    const Table *table = currentTable();
+    if (table == nullptr)
+        return nullptr;
+
+    auto it = std::lower_bound(table->entries.begin(), table->entries.end(),
+                               symbol.c_str(), symbolLess);
+    if (it == table->entries.end() || symbol != (*it)->symbol)
+        return nullptr;
+
+    void *fct = nullptr;
+    if ((*it)->chip)
+        *(getcard *)(&fct) = (*it)->chip;
+    else if ((*it)->reader)
+        *(getprovider *)(&fct) = (*it)->reader;
+    else if ((*it)->commands)
+        *(getcommands *)(&fct) = (*it)->commands;
+    else if ((*it)->diversification)
+        *(getdiversification *)(&fct) = (*it)->diversification;
+    return fct;
+}
+
+std::vector<std::string> StaticPluginRegistry::getChipTypes()
+{
+    const Table *table = currentTable();
+    return table ? getTypes(table->chipInfos) : std::vector<std::string>();
+}
+
+std::vector<std::string> StaticPluginRegistry::getReaderTypes()
+{
+    const Table *table = currentTable();
+    return table ? getTypes(table->readerInfos) : std::vector<std::string>();
+}
+}
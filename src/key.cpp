@@ -25,8 +25,72 @@
 #include <boost/property_tree/ptree.hpp>
 #include <logicalaccess/cards/keydiversification.hpp>
 
+#include <map>
+#include <mutex>
+
 namespace logicalaccess
 {
+namespace
+{
+/**
+ * Maximum number of derived keys kept in the cache.
+ */
+const size_t DERIVED_KEY_CACHE_SIZE = 16;
+
+/**
+ * Get the AES key that ciphers the key data stored in XML, derived from a cipher
+ * passphrase. Derived keys are cached in secure memory by passphrase: a
+ * configuration usually ciphers all its keys with the same one.
+ */
+openssl::AESSymmetricKey getDerivedCipherKey(const std::string &passphrase)
+{
+    static std::mutex mutex;
+    static std::map<std::string, SecureByteVector> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(passphrase);
+    if (it == cache.end())
+    {
+        ByteVector hash              = openssl::SHA256Hash(passphrase);
+        openssl::AESSymmetricKey aes = openssl::AESSymmetricKey::createFromData(hash);
+        secureZero(hash.data(), hash.size());
+        openssl::AESInitializationVector iv =
+            openssl::AESInitializationVector::createNull();
+        openssl::AESCipher aescipher;
+
+        ByteVector divaesbuf;
+        std::string strdata   = "Data";
+        ByteVector keynamebuf = ByteVector(strdata.begin(), strdata.end());
+        keynamebuf.resize(32, 0x00);
+        aescipher.cipher(keynamebuf, divaesbuf, aes, iv, false);
+
+        if (cache.size() >= DERIVED_KEY_CACHE_SIZE)
+        {
+            cache.clear();
+        }
+        it = cache.insert(std::make_pair(passphrase, SecureByteVector(divaesbuf.begin(),
+                                                                      divaesbuf.end())))
+                 .first;
+        secureZero(divaesbuf.data(), divaesbuf.size());
+    }
+    return openssl::AESSymmetricKey::createFromData(
+        ByteVector(it->second.begin(), it->second.end()));
+}
+}
+
+KeyDataView::KeyDataView(const uint8_t *data, size_t size)
+    : data_(data)
+    , size_(size)
+{
+}
+
+KeyDataView::KeyDataView(SecureByteVector &&padded)
+    : padded_(std::move(padded))
+    , data_(padded_.data())
+    , size_(padded_.size())
+{
+}
+
 const std::string Key::secureAiKey = "Obscurity is not security Julien would say. But...";
 
 Key::Key()
@@ -54,7 +118,7 @@ std::string Key::getString(bool withSpace) const
 
     if (!isEmpty())
     {
-        ByteVector data = getData();
+        KeyDataView data = getDataView();
         for (size_t i = 0; i < data.size(); ++i)
         {
             oss << std::setw(2) << std::hex << static_cast<unsigned int>(data[i]);
@@ -126,12 +190,19 @@ void Key::setData(const ByteVector &data)
 
 ByteVector Key::getData() const
 {
-    ByteVector data = d_data;
-    if (getLength() > 0 && data.size() != getLength())
+    KeyDataView data = getDataView();
+    return ByteVector(data.begin(), data.end());
+}
+
+KeyDataView Key::getDataView() const
+{
+    if (getLength() > 0 && d_data.size() != getLength())
     {
+        SecureByteVector data = d_data;
         data.resize(getLength(), getEmptyByte());
+        return KeyDataView(std::move(data));
     }
-    return data;
+    return KeyDataView(d_data.data(), d_data.size());
 }
 
 void Key::setKeyStorage(std::shared_ptr<KeyStorage> key_storage)
@@ -218,24 +289,17 @@ void Key::cipherKeyData(boost::property_tree::ptree &node)
     else
     {
         std::string secureKey = ((d_cipherKey == "") ? secureAiKey : d_cipherKey);
-        openssl::AESSymmetricKey aes =
-            openssl::AESSymmetricKey::createFromPassphrase(secureKey);
+        openssl::AESSymmetricKey divaes = getDerivedCipherKey(secureKey);
         openssl::AESInitializationVector iv =
             openssl::AESInitializationVector::createNull();
         openssl::AESCipher aescipher;
 
-        ByteVector divaesbuf;
-        std::string strdata   = "Data";
-        ByteVector keynamebuf = ByteVector(strdata.begin(), strdata.end());
-        keynamebuf.resize(32, 0x00);
-        aescipher.cipher(keynamebuf, divaesbuf, aes, iv, false);
-        openssl::AESSymmetricKey divaes =
-            openssl::AESSymmetricKey::createFromData(divaesbuf);
-
-        strdata           = getString();
-        ByteVector keybuf = ByteVector(strdata.begin(), strdata.end());
+        std::string strdata = getString();
+        ByteVector keybuf   = ByteVector(strdata.begin(), strdata.end());
+        secureZero(&strdata[0], strdata.size());
         ByteVector cipheredkey;
         aescipher.cipher(keybuf, cipheredkey, divaes, iv, true);
+        secureZero(keybuf.data(), keybuf.size());
 
         node.put("Data", BufferHelper::toBase64(cipheredkey));
     }
@@ -254,29 +318,20 @@ void Key::uncipherKeyData(boost::property_tree::ptree &node)
     else
     {
         LOG(LogLevel::INFOS) << "Data was ciphered ! Unciphering..";
-        std::string secureKey        = ((d_cipherKey == "") ? secureAiKey : d_cipherKey);
-        ByteVector hash              = openssl::SHA256Hash(secureKey);
-        openssl::AESSymmetricKey aes = openssl::AESSymmetricKey::createFromData(hash);
+        std::string secureKey = ((d_cipherKey == "") ? secureAiKey : d_cipherKey);
+        openssl::AESSymmetricKey divaes = getDerivedCipherKey(secureKey);
         openssl::AESInitializationVector iv =
             openssl::AESInitializationVector::createNull();
         openssl::AESCipher aescipher;
 
-        ByteVector divaesbuf;
-        std::string strdata   = "Data";
-        ByteVector keynamebuf = ByteVector(strdata.begin(), strdata.end());
-        keynamebuf.resize(32, 0x00);
-        aescipher.cipher(keynamebuf, divaesbuf, aes, iv, false);
-        openssl::AESSymmetricKey divaes =
-            openssl::AESSymmetricKey::createFromData(divaesbuf);
-
-        ByteVector keybuf(data.begin(), data.end()), uncipheredkey;
-        aescipher.decipher(BufferHelper::fromBase64(BufferHelper::getStdString(keybuf)),
-                           uncipheredkey, divaes, iv, true);
-
-        // LOG(LogLevel::DEBUGS) << "Data unciphered: {%s}",
-        // uncipheredkey.toStdString().c_str());
+        ByteVector uncipheredkey;
+        aescipher.decipher(BufferHelper::fromBase64(data), uncipheredkey, divaes, iv,
+                           true);
 
-        fromString(BufferHelper::getStdString(uncipheredkey));
+        std::string strdata = BufferHelper::getStdString(uncipheredkey);
+        secureZero(uncipheredkey.data(), uncipheredkey.size());
+        fromString(strdata);
+        secureZero(&strdata[0], strdata.size());
     }
 }
 
@@ -292,7 +347,10 @@ bool Key::isEqual(const Key &key) const
         return false;
     }
 
-    return std::equal(getData().begin(), getData().end(), key.getData().begin());
+    KeyDataView data    = getDataView();
+    KeyDataView keyData = key.getDataView();
+    return data.size() == keyData.size() &&
+           std::equal(data.begin(), data.end(), keyData.begin());
 }
 
 bool Key::operator==(const Key &key) const
@@ -319,4 +377,10 @@ void Key::setKeyDiversification(std::shared_ptr<KeyDiversification> div)
 {
     d_key_diversification = div;
 }
+
+std::shared_ptr<Key> Key::clone() const
+{
+    THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
+                             "This key type doesn't support copies.");
+}
 }
\ No newline at end of file
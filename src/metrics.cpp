@@ -0,0 +1,443 @@
+/**
+ * \file metrics.cpp
+ * \brief Counters and latency histograms of reader and card operations.
+ */
+
+#include <logicalaccess/metrics.hpp>
+#include <logicalaccess/cards/chip.hpp>
+#include <logicalaccess/cards/commands.hpp>
+#include <logicalaccess/cards/readercardadapter.hpp>
+#include <logicalaccess/readerproviders/datatransport.hpp>
+#include <logicalaccess/readerproviders/readerunit.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace logicalaccess
+{
+namespace
+{
+/**
+ * Nesting depth of the authentications of the current thread.
+ */
+thread_local unsigned int authenticationDepth = 0;
+
+std::string escapeLabelValue(const std::string &value)
+{
+    std::string escaped;
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '\\': escaped += "\\\\"; break;
+        case '"': escaped += "\\\""; break;
+        case '\n': escaped += "\\n"; break;
+        default: escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void writeLabels(std::ostream &os, const MetricLabels &labels,
+                 const std::string &extraName = "", const std::string &extraValue = "")
+{
+    if (labels.empty() && extraName.empty())
+        return;
+
+    os << '{';
+    bool first = true;
+    for (const auto &label : labels)
+    {
+        if (!first)
+            os << ',';
+        os << label.first << "=\"" << escapeLabelValue(label.second) << '"';
+        first = false;
+    }
+    if (!extraName.empty())
+    {
+        if (!first)
+            os << ',';
+        os << extraName << "=\"" << extraValue << '"';
+    }
+    os << '}';
+}
+
+std::string toSeconds(uint64_t micro)
+{
+    // 15 digits are enough for the bucket bounds, 17 always read back the same
+    // double, for large sums.
+    const double seconds = static_cast<double>(micro) / 1000000.0;
+    std::ostringstream oss;
+    oss << std::setprecision(15) << seconds;
+    if (std::stod(oss.str()) != seconds)
+    {
+        oss.str("");
+        oss << std::setprecision(17) << seconds;
+    }
+    return oss.str();
+}
+}
+
+MetricCounter::MetricCounter()
+    : value_(0)
+{
+}
+
+void MetricCounter::increment(uint64_t value)
+{
+    value_.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t MetricCounter::getValue() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+void MetricCounter::reset()
+{
+    value_.store(0, std::memory_order_relaxed);
+}
+
+const std::array<uint64_t, MetricHistogram::BUCKET_COUNT - 1> &
+MetricHistogram::getBounds()
+{
+    // From 100 us (a short APDU) to 1 min (a long card wait).
+    static const std::array<uint64_t, BUCKET_COUNT - 1> bounds = {
+        {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+         1000000, 2500000, 5000000, 10000000, 30000000, 60000000}};
+    return bounds;
+}
+
+MetricHistogram::MetricHistogram()
+    : sum_(0)
+{
+    for (auto &bucket : buckets_)
+    {
+        bucket.store(0);
+    }
+}
+
+void MetricHistogram::observe(uint64_t micro)
+{
+    const auto &bounds = getBounds();
+    size_t index       = static_cast<size_t>(
+        std::lower_bound(bounds.begin(), bounds.end(), micro) - bounds.begin());
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(micro, std::memory_order_relaxed);
+}
+
+uint64_t MetricHistogram::getCount() const
+{
+    uint64_t count = 0;
+    for (const auto &bucket : buckets_)
+    {
+        count += bucket.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+uint64_t MetricHistogram::getSum() const
+{
+    return sum_.load(std::memory_order_relaxed);
+}
+
+std::array<uint64_t, MetricHistogram::BUCKET_COUNT>
+MetricHistogram::getBucketCounts() const
+{
+    std::array<uint64_t, BUCKET_COUNT> counts;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+double MetricHistogram::getQuantile(double quantile) const
+{
+    const auto counts = getBucketCounts();
+    uint64_t count    = 0;
+    for (uint64_t bucketCount : counts)
+    {
+        count += bucketCount;
+    }
+    if (count == 0)
+        return 0;
+
+    const auto &bounds = getBounds();
+    const double rank  = std::min(std::max(quantile, 0.0), 1.0) * count;
+    uint64_t cumulated = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        if (counts[i] == 0 || cumulated + counts[i] < rank)
+        {
+            cumulated += counts[i];
+            continue;
+        }
+        // The last bucket has no upper bound: its lower bound is the estimate.
+        if (i == BUCKET_COUNT - 1)
+            return static_cast<double>(bounds[i - 1]);
+
+        const double lower = (i == 0) ? 0.0 : static_cast<double>(bounds[i - 1]);
+        const double upper = static_cast<double>(bounds[i]);
+        return lower + (upper - lower) * (rank - cumulated) / counts[i];
+    }
+    return static_cast<double>(bounds.back());
+}
+
+void MetricHistogram::reset()
+{
+    for (auto &bucket : buckets_)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum_.store(0, std::memory_order_relaxed);
+}
+
+MetricsRegistry::MetricsRegistry()
+    : enabled_(true)
+{
+}
+
+MetricsRegistry &MetricsRegistry::getInstance()
+{
+    static MetricsRegistry instance;
+    return instance;
+}
+
+void MetricsRegistry::setEnabled(bool enabled)
+{
+    enabled_ = enabled;
+}
+
+bool MetricsRegistry::isEnabled() const
+{
+    return enabled_;
+}
+
+MetricCounter &MetricsRegistry::getCounter(const std::string &name,
+                                           const MetricLabels &labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<MetricCounter> &counter = counters_[MetricKey(name, labels)];
+    if (!counter)
+        counter.reset(new MetricCounter());
+    return *counter;
+}
+
+MetricHistogram &MetricsRegistry::getHistogram(const std::string &name,
+                                               const MetricLabels &labels)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<MetricHistogram> &histogram = histograms_[MetricKey(name, labels)];
+    if (!histogram)
+        histogram.reset(new MetricHistogram());
+    return *histogram;
+}
+
+std::vector<MetricSnapshot> MetricsRegistry::collect() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<MetricSnapshot> snapshots;
+    for (const auto &counter : counters_)
+    {
+        MetricSnapshot snapshot = MetricSnapshot();
+        snapshot.name           = counter.first.first;
+        snapshot.labels         = counter.first.second;
+        snapshot.histogram      = false;
+        snapshot.count          = counter.second->getValue();
+        snapshots.push_back(snapshot);
+    }
+    for (const auto &histogram : histograms_)
+    {
+        MetricSnapshot snapshot = MetricSnapshot();
+        snapshot.name           = histogram.first.first;
+        snapshot.labels         = histogram.first.second;
+        snapshot.histogram      = true;
+        snapshot.buckets        = histogram.second->getBucketCounts();
+        snapshot.count          = 0;
+        for (uint64_t count : snapshot.buckets)
+        {
+            snapshot.count += count;
+        }
+        snapshot.sum = histogram.second->getSum();
+        snapshot.p50 = histogram.second->getQuantile(0.5);
+        snapshot.p99 = histogram.second->getQuantile(0.99);
+        snapshots.push_back(snapshot);
+    }
+    return snapshots;
+}
+
+std::string MetricsRegistry::toPrometheus() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream oss;
+
+    std::string name;
+    for (const auto &counter : counters_)
+    {
+        if (counter.first.first != name)
+        {
+            name = counter.first.first;
+            oss << "# TYPE " << name << " counter\n";
+        }
+        oss << name;
+        writeLabels(oss, counter.first.second);
+        oss << ' ' << counter.second->getValue() << '\n';
+    }
+
+    name.clear();
+    const auto &bounds = MetricHistogram::getBounds();
+    for (const auto &histogram : histograms_)
+    {
+        if (histogram.first.first != name)
+        {
+            name = histogram.first.first;
+            oss << "# TYPE " << name << " histogram\n";
+        }
+
+        const MetricLabels &labels = histogram.first.second;
+        const auto counts          = histogram.second->getBucketCounts();
+        uint64_t cumulated         = 0;
+        for (size_t i = 0; i < MetricHistogram::BUCKET_COUNT; ++i)
+        {
+            cumulated += counts[i];
+            oss << name << "_bucket";
+            writeLabels(oss, labels, "le",
+                        (i < bounds.size()) ? toSeconds(bounds[i]) : "+Inf");
+            oss << ' ' << cumulated << '\n';
+        }
+        oss << name << "_sum";
+        writeLabels(oss, labels);
+        oss << ' ' << toSeconds(histogram.second->getSum()) << '\n';
+        oss << name << "_count";
+        writeLabels(oss, labels);
+        oss << ' ' << cumulated << '\n';
+    }
+    return oss.str();
+}
+
+void MetricsRegistry::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &counter : counters_)
+    {
+        counter.second->reset();
+    }
+    for (auto &histogram : histograms_)
+    {
+        histogram.second->reset();
+    }
+}
+
+LatencyMetrics::LatencyMetrics(const std::string &name, const MetricLabels &labels)
+    : name_(name)
+    , labels_(labels)
+    , histogram_(MetricsRegistry::getInstance().getHistogram(name + "_seconds", labels))
+    , ok_(MetricsRegistry::getInstance().getCounter(name + "_total", [&labels]() {
+        MetricLabels resultLabels = labels;
+        resultLabels["result"]    = "ok";
+        return resultLabels;
+    }()))
+    , error_(MetricsRegistry::getInstance().getCounter(name + "_total", [&labels]() {
+        MetricLabels resultLabels = labels;
+        resultLabels["result"]    = "error";
+        return resultLabels;
+    }()))
+{
+}
+
+const std::string &LatencyMetrics::getLabel(const std::string &label) const
+{
+    static const std::string empty;
+    auto it = labels_.find(label);
+    return (it != labels_.end()) ? it->second : empty;
+}
+
+void LatencyMetrics::record(uint64_t micro, const std::string &result) const
+{
+    histogram_.observe(micro);
+    if (result == "ok")
+    {
+        ok_.increment();
+    }
+    else if (result == "error")
+    {
+        error_.increment();
+    }
+    else
+    {
+        MetricLabels resultLabels = labels_;
+        resultLabels["result"]    = result;
+        MetricsRegistry::getInstance()
+            .getCounter(name_ + "_total", resultLabels)
+            .increment();
+    }
+}
+
+LatencyRecorder::LatencyRecorder(const std::string &name, const MetricLabels &labels)
+    : result_("error")
+{
+    if (MetricsRegistry::getInstance().isEnabled())
+        metrics_ = std::make_shared<LatencyMetrics>(name, labels);
+}
+
+LatencyRecorder::LatencyRecorder(std::shared_ptr<const LatencyMetrics> metrics)
+    : metrics_(std::move(metrics))
+    , result_("error")
+{
+}
+
+LatencyRecorder::~LatencyRecorder()
+{
+    if (metrics_)
+        metrics_->record(counter_.elapsed_micro(), result_);
+}
+
+void LatencyRecorder::setResult(const std::string &result)
+{
+    result_ = result;
+}
+
+void LatencyRecorder::succeed()
+{
+    result_ = "ok";
+}
+
+AuthenticationRecorder::AuthenticationRecorder(const Commands &commands)
+{
+    if (authenticationDepth++ > 0 || !MetricsRegistry::getInstance().isEnabled())
+        return;
+
+    MetricLabels labels;
+    std::shared_ptr<Chip> chip = commands.getChip();
+    labels["card"]             = chip ? chip->getCardType() : "";
+
+    std::shared_ptr<ReaderCardAdapter> adapter = commands.getReaderCardAdapter();
+    std::shared_ptr<DataTransport> transport =
+        adapter ? adapter->getDataTransport() : nullptr;
+    std::shared_ptr<ReaderUnit> reader = transport ? transport->getReaderUnit() : nullptr;
+    labels["reader"]                   = reader ? reader->getName() : "";
+
+    recorder_.reset(new LatencyRecorder("lla_authentication", labels));
+}
+
+AuthenticationRecorder::~AuthenticationRecorder()
+{
+    recorder_.reset();
+    --authenticationDepth;
+}
+
+void AuthenticationRecorder::setResult(const std::string &result)
+{
+    if (recorder_)
+        recorder_->setResult(result);
+}
+
+void AuthenticationRecorder::succeed()
+{
+    if (recorder_)
+        recorder_->succeed();
+}
+}
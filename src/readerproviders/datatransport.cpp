@@ -5,7 +5,9 @@
  */
 
 #include <logicalaccess/readerproviders/datatransport.hpp>
+#include <logicalaccess/readerproviders/readerunit.hpp>
 #include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/metrics.hpp>
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <logicalaccess/plugins/llacommon/settings.hpp>
 
@@ -13,6 +15,23 @@ namespace logicalaccess
 {
 ByteVector DataTransport::sendCommand(const ByteVector &command, long int timeout)
 {
+    std::shared_ptr<ReaderUnit> readerUnit = getReaderUnit();
+    LogContext logFilter("", readerUnit ? readerUnit->getLogMask() : LOG_ALL_LEVELS);
+    std::shared_ptr<const LatencyMetrics> commandMetrics;
+    if (MetricsRegistry::getInstance().isEnabled())
+    {
+        const std::string reader = readerUnit ? readerUnit->getName() : "";
+        commandMetrics           = std::atomic_load(&d_commandMetrics);
+        if (!commandMetrics || commandMetrics->getLabel("reader") != reader)
+        {
+            commandMetrics = std::make_shared<LatencyMetrics>(
+                "lla_transport_command",
+                MetricLabels{{"reader", reader}, {"transport", getTransportType()}});
+            std::atomic_store(&d_commandMetrics, commandMetrics);
+        }
+    }
+    LatencyRecorder metrics(commandMetrics);
+
     if (timeout == -1)
         timeout = Settings::getInstance()->DataTransportTimeout;
 
@@ -35,6 +54,7 @@ ByteVector DataTransport::sendCommand(const ByteVector &command, long int timeou
 
     LOG(LogLevel::COMS) << "Response received successfully ! Response: "
                         << BufferHelper::getHex(res) << " size {" << res.size() << "}";
+    metrics.succeed();
     return res;
 }
 }
\ No newline at end of file
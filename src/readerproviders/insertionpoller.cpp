@@ -0,0 +1,324 @@
+/**
+ * \file insertionpoller.cpp
+ * \brief Card insertion/removal detection for readers without card events.
+ */
+
+#include <logicalaccess/readerproviders/insertionpoller.hpp>
+#include <logicalaccess/readerproviders/serialportdatatransport.hpp>
+#include <logicalaccess/cards/chip.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/myexception.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace logicalaccess
+{
+const unsigned int InsertionPoller::WAIT_FOREVER =
+    std::numeric_limits<unsigned int>::max();
+
+InsertionPoller::InsertionPoller(ScanFunction scan)
+    : d_scan(scan)
+    , d_removalScan(scan)
+    , d_minInterval(25)
+    , d_maxInterval(500)
+    , d_fastDuration(2000)
+    , d_removalInterval(250)
+    , d_interval(25)
+    , d_fastUntil(Clock::now())
+    , d_wakeUp(false)
+    , d_sleeping(false)
+    , d_stopGeneration(0)
+    , d_runGeneration(0)
+{
+    EXCEPTION_ASSERT_WITH_LOG(d_scan, std::invalid_argument,
+                              "scan function can't be null.");
+}
+
+InsertionPoller::~InsertionPoller()
+{
+    stop();
+    // Destroyed from a callback: the thread can't join itself.
+    if (d_thread.joinable())
+        d_thread.detach();
+}
+
+void InsertionPoller::setRemovalScan(ScanFunction scan)
+{
+    EXCEPTION_ASSERT_WITH_LOG(scan, std::invalid_argument,
+                              "scan function can't be null.");
+    d_removalScan = scan;
+}
+
+void InsertionPoller::setIntervals(unsigned int minInterval, unsigned int maxInterval)
+{
+    EXCEPTION_ASSERT_WITH_LOG(minInterval <= maxInterval, std::invalid_argument,
+                              "The minimum interval must not exceed the maximum.");
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_minInterval = minInterval;
+    d_maxInterval = maxInterval;
+    d_interval    = std::min(std::max(d_interval, minInterval), maxInterval);
+}
+
+unsigned int InsertionPoller::getMinInterval() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_minInterval;
+}
+
+unsigned int InsertionPoller::getMaxInterval() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_maxInterval;
+}
+
+void InsertionPoller::setFastPollingDuration(unsigned int duration)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_fastDuration = duration;
+}
+
+unsigned int InsertionPoller::getFastPollingDuration() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_fastDuration;
+}
+
+void InsertionPoller::setRemovalInterval(unsigned int interval)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_removalInterval = interval;
+}
+
+unsigned int InsertionPoller::getRemovalInterval() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_removalInterval;
+}
+
+InsertionPoller::Clock::time_point InsertionPoller::deadline(unsigned int maxwait)
+{
+    if (maxwait == WAIT_FOREVER)
+        return Clock::time_point::max();
+    return Clock::now() + std::chrono::milliseconds(maxwait);
+}
+
+bool InsertionPoller::sleep(unsigned int interval, const Clock::time_point &until,
+                            unsigned int generation)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    if (d_stopGeneration != generation)
+        return false;
+
+    Clock::time_point now = Clock::now();
+    if (now >= until)
+        return false;
+
+    Clock::time_point wakeUp = now + std::chrono::milliseconds(interval);
+    d_sleeping               = true;
+    d_condition.wait_until(lock, std::min(wakeUp, until), [this, generation]() {
+        return d_wakeUp || d_stopGeneration != generation;
+    });
+    d_sleeping = false;
+    d_wakeUp   = false;
+    return d_stopGeneration == generation;
+}
+
+std::shared_ptr<Chip> InsertionPoller::waitInsertion(unsigned int maxwait)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    const unsigned int generation = d_stopGeneration;
+    lock.unlock();
+    return waitInsertion(deadline(maxwait), generation);
+}
+
+std::shared_ptr<Chip> InsertionPoller::waitInsertion(const Clock::time_point &until,
+                                                     unsigned int generation)
+{
+    while (true)
+    {
+        std::shared_ptr<Chip> chip = d_scan();
+
+        unsigned int interval;
+        {
+            // A wake-up during the scan is served by it.
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_wakeUp = false;
+            if (chip || Clock::now() < d_fastUntil)
+            {
+                d_interval = d_minInterval;
+            }
+            else
+            {
+                d_interval = std::min(std::max(d_interval * 2, d_minInterval),
+                                      d_maxInterval);
+            }
+            interval = d_interval;
+        }
+
+        if (chip)
+            return chip;
+        if (!sleep(interval, until, generation))
+            return nullptr;
+    }
+}
+
+bool InsertionPoller::waitRemoval(const ByteVector &identifier, unsigned int maxwait,
+                                  std::shared_ptr<Chip> *replacement)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    const unsigned int generation = d_stopGeneration;
+    lock.unlock();
+    return waitRemoval(identifier, deadline(maxwait), generation, replacement);
+}
+
+bool InsertionPoller::waitRemoval(const ByteVector &identifier,
+                                  const Clock::time_point &until, unsigned int generation,
+                                  std::shared_ptr<Chip> *replacement)
+{
+    while (true)
+    {
+        std::shared_ptr<Chip> chip = d_removalScan();
+
+        std::unique_lock<std::mutex> lock(d_mutex);
+        d_wakeUp = false;
+        if (!chip || chip->getChipIdentifier() != identifier)
+        {
+            d_fastUntil = Clock::now() + std::chrono::milliseconds(d_fastDuration);
+            d_interval  = d_minInterval;
+            if (replacement)
+                *replacement = chip;
+            return true;
+        }
+
+        const unsigned int interval = d_removalInterval;
+        lock.unlock();
+        if (!sleep(interval, until, generation))
+            return false;
+    }
+}
+
+void InsertionPoller::wakeUp()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_wakeUp = true;
+    }
+    d_condition.notify_all();
+}
+
+void InsertionPoller::onData()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        // Data received during a scan, or outside of any wait, are answers to
+        // the reader commands.
+        if (!d_sleeping)
+            return;
+        d_wakeUp   = true;
+        d_interval = d_minInterval;
+    }
+    d_condition.notify_all();
+}
+
+void InsertionPoller::listen(std::shared_ptr<DataTransport> transport)
+{
+    std::shared_ptr<SerialPortDataTransport> serialTransport =
+        std::dynamic_pointer_cast<SerialPortDataTransport>(transport);
+    if (!serialTransport || !serialTransport->getSerialPort() ||
+        !serialTransport->getSerialPort()->getSerialPort())
+        return;
+
+    std::weak_ptr<InsertionPoller> weakPoller = shared_from_this();
+    serialTransport->getSerialPort()->getSerialPort()->setDataListener([weakPoller]() {
+        std::shared_ptr<InsertionPoller> poller = weakPoller.lock();
+        if (poller)
+            poller->onData();
+    });
+}
+
+void InsertionPoller::start(ChipCallback onInsertion, ChipCallback onRemoval)
+{
+    std::thread previous;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        EXCEPTION_ASSERT_WITH_LOG(!d_thread.joinable() ||
+                                      d_runGeneration != d_stopGeneration,
+                                  LibLogicalAccessException,
+                                  "The insertion poller is already started.");
+        previous.swap(d_thread);
+        d_runGeneration = d_stopGeneration;
+        d_thread = std::thread(&InsertionPoller::run, this, onInsertion, onRemoval,
+                               d_runGeneration);
+    }
+    joinThread(previous);
+}
+
+void InsertionPoller::stop()
+{
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        ++d_stopGeneration;
+        // Stopped from a callback: the thread ends once the callback returns,
+        // and is joined by the next stop() or start().
+        if (d_thread.get_id() != std::this_thread::get_id())
+            thread.swap(d_thread);
+    }
+    d_condition.notify_all();
+    joinThread(thread);
+}
+
+bool InsertionPoller::isStarted() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_thread.joinable() && d_runGeneration == d_stopGeneration;
+}
+
+void InsertionPoller::joinThread(std::thread &thread)
+{
+    if (!thread.joinable())
+        return;
+    if (thread.get_id() == std::this_thread::get_id())
+        thread.detach();
+    else
+        thread.join();
+}
+
+void InsertionPoller::run(ChipCallback onInsertion, ChipCallback onRemoval,
+                          unsigned int generation)
+{
+    std::shared_ptr<Chip> chip;
+    while (true)
+    {
+        try
+        {
+            if (!chip)
+            {
+                chip = waitInsertion(Clock::time_point::max(), generation);
+                if (!chip)
+                    return;
+                if (onInsertion)
+                    onInsertion(chip);
+            }
+
+            std::shared_ptr<Chip> replacement;
+            if (!waitRemoval(chip->getChipIdentifier(), Clock::time_point::max(),
+                             generation, &replacement))
+                return;
+            if (onRemoval)
+                onRemoval(chip);
+
+            chip = replacement;
+            if (chip && onInsertion)
+                onInsertion(chip);
+        }
+        catch (std::exception &e)
+        {
+            LOG(LogLevel::ERRORS) << "Card polling failed: " << e.what();
+            if (!sleep(getMaxInterval(), Clock::time_point::max(), generation))
+                return;
+        }
+    }
+}
+}
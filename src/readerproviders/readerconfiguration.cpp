@@ -20,7 +20,7 @@ namespace logicalaccess
 {
 ReaderConfiguration::ReaderConfiguration()
 {
-    Settings *config = Settings::getInstance();
+    std::shared_ptr<Settings> config = Settings::getInstance();
 
     try
     {
@@ -0,0 +1,125 @@
+/**
+ * \file readermonitor.cpp
+ * \brief Reader hot-plug monitoring.
+ */
+
+#include <logicalaccess/readerproviders/readermonitor.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/myexception.hpp>
+
+namespace logicalaccess
+{
+ReaderMonitor::ReaderMonitor(std::shared_ptr<ReaderProvider> provider)
+    : d_provider(provider)
+    , d_stopLatency(500)
+    , d_stopping(false)
+{
+    EXCEPTION_ASSERT_WITH_LOG(d_provider, std::invalid_argument,
+                              "reader provider can't be null.");
+}
+
+ReaderMonitor::~ReaderMonitor()
+{
+    stop();
+}
+
+void ReaderMonitor::start(ReaderCallback onAdded, ReaderCallback onRemoved)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    EXCEPTION_ASSERT_WITH_LOG(!d_thread.joinable(), LibLogicalAccessException,
+                              "The reader monitor is already started.");
+    d_stopping = false;
+    d_readers.clear();
+    d_thread = std::thread(&ReaderMonitor::run, this, onAdded, onRemoved);
+}
+
+void ReaderMonitor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stopping = true;
+    }
+
+    if (d_thread.joinable())
+        d_thread.join();
+}
+
+bool ReaderMonitor::isStarted() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_thread.joinable() && !d_stopping;
+}
+
+void ReaderMonitor::setStopLatency(unsigned int latency)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_stopLatency = latency;
+}
+
+unsigned int ReaderMonitor::getStopLatency() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_stopLatency;
+}
+
+void ReaderMonitor::run(ReaderCallback onAdded, ReaderCallback onRemoved)
+{
+    bool changed = true;
+    while (true)
+    {
+        unsigned int latency;
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            if (d_stopping)
+                return;
+            latency = d_stopLatency;
+        }
+
+        try
+        {
+            if (changed)
+                update(onAdded, onRemoved);
+            changed = d_provider->waitReaderListChange(latency);
+        }
+        catch (std::exception &e)
+        {
+            LOG(LogLevel::ERRORS) << "Reader monitoring failed: " << e.what();
+            std::this_thread::sleep_for(std::chrono::milliseconds(latency));
+            changed = true;
+        }
+    }
+}
+
+void ReaderMonitor::update(const ReaderCallback &onAdded, const ReaderCallback &onRemoved)
+{
+    d_provider->refreshReaderList();
+
+    std::map<std::string, std::shared_ptr<ReaderUnit>> readers;
+    for (const auto &reader : d_provider->getReaderList())
+    {
+        readers[reader->getName()] = reader;
+    }
+
+    for (const auto &reader : d_readers)
+    {
+        if (readers.find(reader.first) == readers.end())
+        {
+            LOG(LogLevel::INFOS) << "Reader {" << reader.first << "} removed.";
+            if (onRemoved)
+                onRemoved(reader.second);
+        }
+    }
+
+    for (const auto &reader : readers)
+    {
+        if (d_readers.find(reader.first) == d_readers.end())
+        {
+            LOG(LogLevel::INFOS) << "Reader {" << reader.first << "} added.";
+            if (onAdded)
+                onAdded(reader.second);
+        }
+    }
+
+    d_readers.swap(readers);
+}
+}
@@ -7,7 +7,6 @@
 #include <logicalaccess/readerproviders/readerprovider.hpp>
 #include <logicalaccess/dynlibrary/idynlibrary.hpp>
 #include <map>
-#include <time.h>
 #include <logicalaccess/dynlibrary/librarymanager.hpp>
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <vector>
@@ -31,19 +30,14 @@ const ReaderList ReaderProvider::waitForReaders(std::vector<std::string> readers
                                                 double maxwait, bool all)
 {
     ReaderList ret;
-    bool notfound = true;
-    time_t timer, current_timer;
+    std::chrono::steady_clock::time_point const clock_timeout =
+        std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(static_cast<long long>(maxwait * 1000));
 
-    time(&timer);
-
-    while (notfound)
+    while (true)
     {
         ret.clear();
 
-        time(&current_timer);
-        if (maxwait != 0 && difftime(current_timer, timer) > maxwait)
-            return ret;
-
         refreshReaderList();
         ReaderList rl = getReaderList();
         for (const auto &it : rl)
@@ -57,10 +51,30 @@ const ReaderList ReaderProvider::waitForReaders(std::vector<std::string> readers
 
         if ((all == false && ret.size() != 0) ||
             (all == true && ret.size() == readers.size()))
-            notfound = false;
-        else
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            break;
+
+        unsigned int wait = 1000;
+        if (maxwait != 0)
+        {
+            std::chrono::steady_clock::time_point const now =
+                std::chrono::steady_clock::now();
+            if (now >= clock_timeout)
+            {
+                ret.clear();
+                break;
+            }
+            wait = static_cast<unsigned int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(clock_timeout - now)
+                    .count());
+        }
+        waitReaderListChange(wait);
     }
     return ret;
 }
-}
\ No newline at end of file
+
+bool ReaderProvider::waitReaderListChange(unsigned int maxwait)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(std::min(maxwait, 1000u)));
+    return true;
+}
+}
@@ -0,0 +1,225 @@
+/**
+ * \file readersessionmanager.cpp
+ * \brief Drive many reader units in parallel from a bounded thread pool.
+ */
+
+#include <logicalaccess/readerproviders/readersessionmanager.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/myexception.hpp>
+
+#include <algorithm>
+
+namespace logicalaccess
+{
+ReaderSessionManager::ReaderSessionManager(unsigned int threads)
+    : d_stopping(false)
+{
+    for (unsigned int i = 0; i < std::max(1u, threads); ++i)
+    {
+        d_threads.emplace_back(&ReaderSessionManager::run, this);
+    }
+}
+
+ReaderSessionManager::~ReaderSessionManager()
+{
+    stop();
+}
+
+void ReaderSessionManager::addReader(std::shared_ptr<ReaderUnit> reader)
+{
+    EXCEPTION_ASSERT_WITH_LOG(reader, std::invalid_argument,
+                              "reader unit can't be null.");
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (d_sessions.find(reader.get()) != d_sessions.end())
+        return;
+
+    auto session                      = std::make_shared<Session>();
+    session->statistics.reader        = reader;
+    session->statistics.queueDepth    = 0;
+    session->statistics.busy          = false;
+    session->statistics.completed     = 0;
+    session->statistics.failed        = 0;
+    session->statistics.totalWaitTime = 0;
+    session->statistics.totalRunTime  = 0;
+    session->statistics.maxLatency    = 0;
+    session->scheduled                = false;
+    d_sessions[reader.get()]          = session;
+}
+
+void ReaderSessionManager::removeReader(std::shared_ptr<ReaderUnit> reader)
+{
+    std::deque<Task> dropped;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        auto it = d_sessions.find(reader.get());
+        if (it == d_sessions.end())
+            return;
+
+        dropped.swap(it->second->tasks);
+        it->second->statistics.queueDepth = 0;
+        d_ready.erase(std::remove(d_ready.begin(), d_ready.end(), it->second),
+                      d_ready.end());
+        d_sessions.erase(it);
+    }
+    // The dropped operations break their promises outside of the lock.
+}
+
+std::vector<std::shared_ptr<ReaderUnit>> ReaderSessionManager::getReaders() const
+{
+    std::vector<std::shared_ptr<ReaderUnit>> readers;
+    std::lock_guard<std::mutex> lock(d_mutex);
+    for (const auto &session : d_sessions)
+    {
+        readers.push_back(session.second->statistics.reader);
+    }
+    return readers;
+}
+
+std::future<std::shared_ptr<Chip>>
+ReaderSessionManager::waitInsertion(std::shared_ptr<ReaderUnit> reader,
+                                    unsigned int maxwait)
+{
+    return post(reader, [maxwait](std::shared_ptr<ReaderUnit> unit) {
+        std::shared_ptr<Chip> chip;
+        if (unit->waitInsertion(maxwait))
+            chip = unit->getSingleChip();
+        return chip;
+    });
+}
+
+std::future<bool> ReaderSessionManager::waitRemoval(std::shared_ptr<ReaderUnit> reader,
+                                                    unsigned int maxwait)
+{
+    return post(reader, [maxwait](std::shared_ptr<ReaderUnit> unit) {
+        return unit->waitRemoval(maxwait);
+    });
+}
+
+std::vector<ReaderSessionStatistics> ReaderSessionManager::getStatistics() const
+{
+    std::vector<ReaderSessionStatistics> statistics;
+    std::lock_guard<std::mutex> lock(d_mutex);
+    for (const auto &session : d_sessions)
+    {
+        statistics.push_back(session.second->statistics);
+    }
+    return statistics;
+}
+
+void ReaderSessionManager::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stopping = true;
+        d_ready.clear();
+    }
+    d_condition.notify_all();
+
+    for (auto &thread : d_threads)
+    {
+        thread.join();
+    }
+    d_threads.clear();
+
+    std::lock_guard<std::mutex> lock(d_mutex);
+    for (auto &session : d_sessions)
+    {
+        session.second->tasks.clear();
+        session.second->statistics.queueDepth = 0;
+        session.second->scheduled             = false;
+    }
+}
+
+void ReaderSessionManager::enqueue(std::shared_ptr<ReaderUnit> reader,
+                                   std::function<bool(std::function<void()> &)> operation)
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        EXCEPTION_ASSERT_WITH_LOG(!d_stopping, LibLogicalAccessException,
+                                  "The reader session manager is stopped.");
+        auto it = d_sessions.find(reader.get());
+        EXCEPTION_ASSERT_WITH_LOG(it != d_sessions.end(), std::invalid_argument,
+                                  "The reader unit isn't managed.");
+
+        std::shared_ptr<Session> session = it->second;
+        Task task;
+        task.operation = operation;
+        session->tasks.push_back(task);
+        ++session->statistics.queueDepth;
+        if (!session->scheduled)
+        {
+            session->scheduled = true;
+            d_ready.push_back(session);
+        }
+    }
+    d_condition.notify_one();
+}
+
+void ReaderSessionManager::run()
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (true)
+    {
+        d_condition.wait(lock, [this]() { return d_stopping || !d_ready.empty(); });
+        if (d_stopping)
+            return;
+
+        std::shared_ptr<Session> session = d_ready.front();
+        d_ready.pop_front();
+
+        Task task = session->tasks.front();
+        session->tasks.pop_front();
+        --session->statistics.queueDepth;
+        session->statistics.busy = true;
+        const size_t waitTime    = task.queued.elapsed_micro();
+        lock.unlock();
+
+        ElapsedTimeCounter counter;
+        std::function<void()> complete;
+        bool success = false;
+        try
+        {
+            success = task.operation(complete);
+        }
+        catch (std::exception &e)
+        {
+            LOG(LogLevel::ERRORS) << "Reader operation failed: " << e.what();
+        }
+        const size_t runTime = counter.elapsed_micro();
+        task.operation       = nullptr;
+
+        lock.lock();
+        ReaderSessionStatistics &statistics = session->statistics;
+        statistics.busy                     = false;
+        if (success)
+            ++statistics.completed;
+        else
+            ++statistics.failed;
+        statistics.totalWaitTime += waitTime;
+        statistics.totalRunTime += runTime;
+        statistics.maxLatency =
+            std::max<uint64_t>(statistics.maxLatency, waitTime + runTime);
+
+        // Round-robin: the reader unit goes back at the end of the ready list.
+        if (!session->tasks.empty() && !d_stopping)
+        {
+            d_ready.push_back(session);
+            d_condition.notify_one();
+        }
+        else
+        {
+            session->scheduled = false;
+        }
+
+        // The result is published once the statistics account for it.
+        if (complete)
+        {
+            lock.unlock();
+            complete();
+            complete = nullptr;
+            lock.lock();
+        }
+    }
+}
+}
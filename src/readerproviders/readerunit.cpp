@@ -29,6 +29,8 @@
 #include <logicalaccess/readerproviders/lcddisplay.hpp>
 #include <logicalaccess/readerproviders/ledbuzzerdisplay.hpp>
 #include <logicalaccess/readerproviders/readerunitconfiguration.hpp>
+#include <logicalaccess/readerproviders/readerunitconfigstore.hpp>
+#include <logicalaccess/readerproviders/insertionpoller.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
@@ -38,16 +40,9 @@ ReaderUnit::ReaderUnit(std::string rpt)
     : XmlSerializable()
     , d_readerProviderType(rpt)
     , d_card_type(CHIP_UNKNOWN)
+    , d_logMask(LOG_ALL_LEVELS)
 {
-    try
-    {
-        boost::property_tree::ptree pt;
-        read_xml((boost::filesystem::current_path().string() + "/ReaderUnit.config"), pt);
-        d_card_type = pt.get("config.cardType", CHIP_UNKNOWN);
-    }
-    catch (...)
-    {
-    }
+    d_card_type = ReaderUnitConfigStore::getInstance().getConfig()->cardType;
 }
 
 ReaderUnit::~ReaderUnit()
@@ -110,7 +105,7 @@ bool ReaderUnit::waitInsertion(const ByteVector &identifier, unsigned int maxwai
             LOG(LogLevel::INFOS)
                 << "Chip(s) detected ! Looking in the list to find the chip...";
             bool found                                  = false;
-            std::vector<std::shared_ptr<Chip>> chipList = getChipList();
+            std::vector<std::shared_ptr<Chip>> chipList = inventory();
             for (std::vector<std::shared_ptr<Chip>>::iterator i = chipList.begin();
                  i != chipList.end() && !found; ++i)
             {
@@ -145,6 +140,26 @@ bool ReaderUnit::waitInsertion(const ByteVector &identifier, unsigned int maxwai
     return inserted;
 }
 
+std::shared_ptr<InsertionPoller> ReaderUnit::getInsertionPoller() const
+{
+    return d_insertionPoller;
+}
+
+void ReaderUnit::setLogMask(LogLevelMask mask)
+{
+    d_logMask = mask;
+}
+
+LogLevelMask ReaderUnit::getLogMask() const
+{
+    return d_logMask;
+}
+
+std::vector<std::shared_ptr<Chip>> ReaderUnit::inventory()
+{
+    return getChipList();
+}
+
 ByteVector ReaderUnit::getNumber(std::shared_ptr<Chip> chip,
                                  std::shared_ptr<CardsFormatComposite> composite)
 {
@@ -0,0 +1,414 @@
+/**
+ * \file readerunitconfigstore.cpp
+ * \brief Process-wide cache of reader unit configuration files.
+ */
+
+#include <logicalaccess/readerproviders/readerunitconfigstore.hpp>
+#include <logicalaccess/cards/chip.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace logicalaccess
+{
+/**
+ * \brief The thread checking every store for changes, at its own interval. It
+ * is started with the first store.
+ */
+class ReaderUnitConfigStore::Watcher
+{
+  public:
+    static Watcher &getInstance()
+    {
+        static Watcher instance;
+        return instance;
+    }
+
+    ~Watcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_stopping = true;
+        }
+        d_condition.notify_all();
+        if (d_thread.joinable())
+            d_thread.join();
+    }
+
+    void add(ReaderUnitConfigStore *store)
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stores[store] = nextCheck(store);
+        if (!d_thread.joinable())
+            d_thread = std::thread(&Watcher::run, this);
+    }
+
+    /**
+     * \brief Remove a store, waiting for its check in progress.
+     */
+    void remove(ReaderUnitConfigStore *store)
+    {
+        std::unique_lock<std::mutex> lock(d_mutex);
+        d_condition.wait(lock, [this, store]() { return d_checking != store; });
+        d_stores.erase(store);
+    }
+
+    /**
+     * \brief Apply a new watch interval of a store at once.
+     */
+    void reschedule(ReaderUnitConfigStore *store)
+    {
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            auto it = d_stores.find(store);
+            if (it != d_stores.end())
+                it->second = nextCheck(store);
+        }
+        d_condition.notify_all();
+    }
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    Watcher()
+        : d_checking(nullptr)
+        , d_stopping(false)
+    {
+    }
+
+    /**
+     * \brief Next check time of a store, or the maximum when it is not watched.
+     */
+    static Clock::time_point nextCheck(ReaderUnitConfigStore *store)
+    {
+        unsigned int interval;
+        {
+            std::lock_guard<std::mutex> lock(store->d_mutex);
+            interval = store->d_watchInterval;
+        }
+        if (interval == 0)
+            return Clock::time_point::max();
+        return Clock::now() + std::chrono::milliseconds(interval);
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(d_mutex);
+        while (!d_stopping)
+        {
+            Clock::time_point now        = Clock::now();
+            Clock::time_point next       = Clock::time_point::max();
+            ReaderUnitConfigStore *store = nullptr;
+            for (const auto &watched : d_stores)
+            {
+                if (watched.second <= now)
+                {
+                    store = watched.first;
+                    break;
+                }
+                next = std::min(next, watched.second);
+            }
+
+            if (store == nullptr)
+            {
+                if (next == Clock::time_point::max())
+                    d_condition.wait(lock);
+                else
+                    d_condition.wait_until(lock, next);
+                continue;
+            }
+
+            d_checking = store;
+            lock.unlock();
+            try
+            {
+                store->update(false);
+            }
+            catch (std::exception &e)
+            {
+                LOG(LogLevel::WARNINGS) << "Reader unit configuration check failed: "
+                                        << e.what();
+            }
+            Clock::time_point checkTime = nextCheck(store);
+            lock.lock();
+            d_stores[store] = checkTime;
+            d_checking      = nullptr;
+            d_condition.notify_all();
+        }
+    }
+
+    std::mutex d_mutex;
+
+    std::condition_variable d_condition;
+
+    /**
+     * \brief The watched stores, with their next check time.
+     */
+    std::map<ReaderUnitConfigStore *, Clock::time_point> d_stores;
+
+    /**
+     * \brief The store being checked, outside of the lock.
+     */
+    ReaderUnitConfigStore *d_checking;
+
+    bool d_stopping;
+
+    std::thread d_thread;
+};
+
+ReaderUnitConfigStore::Config::Config()
+    : cardType(CHIP_UNKNOWN)
+{
+}
+
+ReaderUnitConfigStore::FileState::FileState()
+    : exists(false)
+    , size(0)
+    , lastWrite(0)
+    , contentHash(0)
+{
+}
+
+bool ReaderUnitConfigStore::FileState::operator==(const FileState &other) const
+{
+    return filename == other.filename && exists == other.exists && size == other.size &&
+           contentHash == other.contentHash;
+}
+
+bool ReaderUnitConfigStore::FileState::sameStatus(const FileState &other) const
+{
+    return filename == other.filename && exists == other.exists && size == other.size &&
+           lastWrite == other.lastWrite;
+}
+
+bool ReaderUnitConfigStore::FileState::isRecent() const
+{
+    // A file rewritten within the modification time resolution can keep its
+    // status, so its content is compared until that time has passed.
+    return exists && std::difftime(std::time(nullptr), lastWrite) <= 2;
+}
+
+ReaderUnitConfigStore::ReaderUnitConfigStore(const std::string &name)
+    : d_configVersion(0)
+    , d_name(name)
+    , d_watchInterval(DEFAULT_WATCH_INTERVAL)
+    , d_nextListenerId(0)
+{
+    d_config = std::make_shared<Config>();
+    update(true);
+    Watcher::getInstance().add(this);
+}
+
+ReaderUnitConfigStore::~ReaderUnitConfigStore()
+{
+    Watcher::getInstance().remove(this);
+}
+
+ReaderUnitConfigStore &ReaderUnitConfigStore::getInstance(const std::string &name)
+{
+    // Created first, so that the watcher outlives the stores at exit.
+    Watcher::getInstance();
+    static std::mutex mutex;
+    static std::map<std::string, std::unique_ptr<ReaderUnitConfigStore>> instances;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<ReaderUnitConfigStore> &instance = instances[name];
+    if (!instance)
+        instance.reset(new ReaderUnitConfigStore(name));
+    return *instance;
+}
+
+std::shared_ptr<const ReaderUnitConfigStore::Config>
+ReaderUnitConfigStore::getConfig() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_config;
+}
+
+void ReaderUnitConfigStore::setFilename(const std::string &filename)
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_filename = filename;
+    }
+    update(true);
+}
+
+std::string ReaderUnitConfigStore::getFilename() const
+{
+    return resolveFilename();
+}
+
+void ReaderUnitConfigStore::setWatchInterval(unsigned int interval)
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_watchInterval = interval;
+    }
+    Watcher::getInstance().reschedule(this);
+}
+
+bool ReaderUnitConfigStore::refresh()
+{
+    return update(false);
+}
+
+size_t ReaderUnitConfigStore::addListener(Listener listener)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    size_t id       = d_nextListenerId++;
+    d_listeners[id] = listener;
+    return id;
+}
+
+void ReaderUnitConfigStore::removeListener(size_t id)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_listeners.erase(id);
+}
+
+std::string ReaderUnitConfigStore::resolveFilename() const
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (!d_filename.empty())
+            return d_filename;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::path current = boost::filesystem::current_path(ec);
+    return (current / d_name).string();
+}
+
+ReaderUnitConfigStore::FileState
+ReaderUnitConfigStore::getFileState(const std::string &filename)
+{
+    FileState state;
+    state.filename = filename;
+
+    boost::system::error_code ec;
+    state.exists = boost::filesystem::is_regular_file(filename, ec);
+    if (state.exists)
+    {
+        state.size      = static_cast<size_t>(boost::filesystem::file_size(filename, ec));
+        state.lastWrite = boost::filesystem::last_write_time(filename, ec);
+    }
+    return state;
+}
+
+std::string ReaderUnitConfigStore::readFile(FileState &state)
+{
+    if (!state.exists)
+        return std::string();
+
+    std::ifstream ifs(state.filename.c_str(), std::ios_base::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    std::string content = oss.str();
+    state.size          = content.size();
+    state.contentHash   = std::hash<std::string>()(content);
+    return content;
+}
+
+std::shared_ptr<const ReaderUnitConfigStore::Config>
+ReaderUnitConfigStore::load(const std::string &content)
+{
+    std::shared_ptr<Config> config = std::make_shared<Config>();
+    try
+    {
+        std::istringstream iss(content);
+        boost::property_tree::ptree pt;
+        read_xml(iss, pt);
+        config->cardType = pt.get("config.cardType", CHIP_UNKNOWN);
+    }
+    catch (...)
+    {
+    }
+    return config;
+}
+
+bool ReaderUnitConfigStore::update(bool force)
+{
+    std::shared_ptr<const Config> config;
+    unsigned int version;
+    {
+        std::lock_guard<std::mutex> loadLock(d_loadMutex);
+
+        std::string filename = resolveFilename();
+        FileState state      = getFileState(filename);
+        FileState previous;
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            previous = d_fileState;
+        }
+        if (!force && state.sameStatus(previous) && !state.isRecent())
+            return false;
+
+        std::string content = readFile(state);
+        if (!force && state == previous)
+        {
+            // Touched, but not modified.
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_fileState = state;
+            return false;
+        }
+
+        config = load(content);
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_config    = config;
+            d_fileState = state;
+            version     = ++d_configVersion;
+        }
+
+        if (state.exists)
+        {
+            LOG(LogLevel::INFOS) << "Reader unit configuration loaded from " << filename
+                                 << " (card type " << config->cardType << ").";
+        }
+    }
+
+    notify(config, version);
+    return true;
+}
+
+void ReaderUnitConfigStore::notify(std::shared_ptr<const Config> config,
+                                   unsigned int version)
+{
+    std::lock_guard<std::recursive_mutex> notifyLock(d_notifyMutex);
+    std::map<size_t, Listener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        listeners = d_listeners;
+    }
+
+    for (const auto &listener : listeners)
+    {
+        {
+            // A newer configuration was published, maybe by a listener: the
+            // listeners are notified with it instead.
+            std::lock_guard<std::mutex> lock(d_mutex);
+            if (d_configVersion != version)
+                return;
+        }
+        try
+        {
+            listener.second(config);
+        }
+        catch (std::exception &e)
+        {
+            LOG(LogLevel::WARNINGS) << "Reader unit configuration listener failed: "
+                                    << e.what();
+        }
+    }
+}
+}
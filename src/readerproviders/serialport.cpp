@@ -29,6 +29,7 @@ SerialPort::SerialPort()
     , m_circular_read_buffer(256)
     , m_read_buffer(128)
     , data_flag_(false)
+    , log_mask_(LOG_ALL_LEVELS)
 {
 }
 
@@ -38,6 +39,7 @@ SerialPort::SerialPort(const std::string &dev)
     , m_circular_read_buffer(256)
     , m_read_buffer(128)
     , data_flag_(false)
+    , log_mask_(LOG_ALL_LEVELS)
 {
 }
 
@@ -180,6 +182,7 @@ size_t SerialPort::read(ByteVector &buf)
 void SerialPort::do_read(const boost::system::error_code &error,
                          const size_t bytes_transferred)
 {
+    LogContext logFilter("", log_mask_);
     if (error == boost::asio::error::operation_aborted)
     {
         LOG(DEBUGS) << "Read aborted: " << error.message();
@@ -210,9 +213,12 @@ void SerialPort::do_read(const boost::system::error_code &error,
                                            m_read_buffer.begin() + bytes_transferred))
                          << " Size: " << bytes_transferred;
 
-    data_flag_ = true;
+    data_flag_                     = true;
+    std::function<void()> listener = data_listener_;
     cond_var_mutex_.unlock();
     cond_var_.notify_all();
+    if (listener)
+        listener();
 
     // start the next read
     m_serial_port.async_read_some(
@@ -226,6 +232,7 @@ size_t SerialPort::write(const ByteVector &buf)
     EXCEPTION_ASSERT(isOpen(), LibLogicalAccessException,
                      "Cannot write on a closed device");
 
+    log_mask_ = LogContext::getThreadLogMask();
     m_io.post(boost::bind(&SerialPort::do_write, this, buf));
     return buf.size();
 }
@@ -269,4 +276,10 @@ void SerialPort::dataConsumed()
 {
     data_flag_ = false;
 }
+
+void SerialPort::setDataListener(std::function<void()> listener)
+{
+    std::unique_lock<std::mutex> ul(cond_var_mutex_);
+    data_listener_ = listener;
+}
 }
\ No newline at end of file
@@ -12,10 +12,15 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
 #endif
 
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 namespace logicalaccess
 {
@@ -149,4 +154,95 @@ bool SerialPortXml::EnumerateUsingCreateFile(
 #endif
     return true;
 }
+
+bool SerialPortXml::WaitPortListChange(unsigned int maxwait)
+{
+    SerialPortListWatcher watcher;
+    return watcher.wait(maxwait);
+}
+
+SerialPortListWatcher::SerialPortListWatcher()
+    : d_fd(-1)
+{
+#ifdef __linux__
+    // Serial device nodes are created and deleted in /dev by udev on hot-plug.
+    d_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (d_fd >= 0 && inotify_add_watch(d_fd, "/dev", IN_CREATE | IN_DELETE |
+                                                         IN_MOVED_TO | IN_MOVED_FROM) < 0)
+    {
+        close(d_fd);
+        d_fd = -1;
+    }
+    if (d_fd < 0)
+    {
+        LOG(LogLevel::WARNINGS) << "Impossible to watch the SerialPort list, polling.";
+    }
+#endif
+}
+
+SerialPortListWatcher::~SerialPortListWatcher()
+{
+#ifdef __linux__
+    if (d_fd >= 0)
+        close(d_fd);
+#endif
+}
+
+bool SerialPortListWatcher::wait(unsigned int maxwait)
+{
+#ifdef __linux__
+    if (d_fd >= 0)
+    {
+        bool changed = false;
+        std::chrono::steady_clock::time_point const clock_timeout =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
+        // The events queued since the previous wait are read without waiting.
+        bool first = true;
+        while (!changed)
+        {
+            std::chrono::steady_clock::time_point const now =
+                std::chrono::steady_clock::now();
+            if (!first && now >= clock_timeout)
+                break;
+
+            struct pollfd pfd;
+            pfd.fd      = d_fd;
+            pfd.events  = POLLIN;
+            pfd.revents = 0;
+            const auto remaining =
+                std::chrono::duration_cast<std::chrono::milliseconds>(clock_timeout - now)
+                    .count();
+            int timeout =
+                now < clock_timeout ? std::max(static_cast<int>(remaining), 1) : 0;
+            first = false;
+            if (poll(&pfd, 1, timeout) <= 0)
+                continue;
+
+            char buffer[4096]
+                __attribute__((aligned(__alignof__(struct inotify_event))));
+            ssize_t len = read(d_fd, buffer, sizeof(buffer));
+            if (len <= 0)
+                continue;
+            for (size_t i = 0; i < static_cast<size_t>(len);)
+            {
+                const struct inotify_event *event =
+                    reinterpret_cast<const struct inotify_event *>(buffer + i);
+                if ((event->mask & IN_Q_OVERFLOW) ||
+                    (event->len > 0 && ((strstr(event->name, "ttyS") != 0) ||
+                                        (strstr(event->name, "ttyUSB") != 0) ||
+                                        (strstr(event->name, "ttyACM") != 0))))
+                {
+                    changed = true;
+                }
+                i += sizeof(struct inotify_event) + event->len;
+            }
+        }
+        return changed;
+    }
+#endif
+    // Changes can't be seen without opening the ports: the callers enumerate
+    // again at most every second.
+    std::this_thread::sleep_for(std::chrono::milliseconds(std::min(maxwait, 1000u)));
+    return true;
+}
 }
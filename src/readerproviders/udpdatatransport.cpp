@@ -4,20 +4,23 @@
  * \brief UDP data transport.
  */
 
+#include <logicalaccess/myexception.hpp>
 #include <logicalaccess/readerproviders/udpdatatransport.hpp>
 #include <logicalaccess/cards/readercardadapter.hpp>
 #include <logicalaccess/boost_version_types.hpp>
 
 #include <boost/foreach.hpp>
 #include <boost/optional.hpp>
-#include <boost/array.hpp>
+#include <boost/bind.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <boost/property_tree/ptree.hpp>
-#include <thread>
 
 namespace logicalaccess
 {
 UDPDataTransport::UDPDataTransport()
-    : d_ipAddress("127.0.0.1")
+    : d_timer(ios)
+    , d_read_error(true)
+    , d_ipAddress("127.0.0.1")
     , d_port(9559)
 {
 }
@@ -100,28 +103,63 @@ void UDPDataTransport::send(const ByteVector &data)
     }
 }
 
+void UDPDataTransport::read_complete(const boost::system::error_code &error)
+{
+    d_read_error = static_cast<bool>(error);
+    d_timer.cancel();
+}
+
+void UDPDataTransport::time_out(const boost::system::error_code &error)
+{
+    if (error)
+        return;
+    d_socket->cancel();
+}
+
 ByteVector UDPDataTransport::receive(long int timeout)
 {
     ByteVector res;
     std::shared_ptr<boost::asio::ip::udp::socket> socket = getSocket();
+    EXCEPTION_ASSERT_WITH_LOG(socket, LibLogicalAccessException,
+                              "The UDP data transport is not connected.");
+
+    const boost::asio::ip::udp::endpoint remote = socket->remote_endpoint();
+    const boost::posix_time::ptime deadline =
+        boost::posix_time::microsec_clock::universal_time() +
+        boost::posix_time::milliseconds(timeout);
 
-    long int currentWait = 0;
-    size_t lenav         = socket->available();
-    while (lenav == 0 && (timeout == 0 || currentWait < timeout))
+    while (res.empty())
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(250));
-        currentWait += 250;
+        // Wait for the socket to be readable, the datagram is then read with
+        // its actual size.
+        d_read_error = true;
+        ios.reset();
+        socket->async_receive(boost::asio::null_buffers(),
+                              boost::bind(&UDPDataTransport::read_complete, this,
+                                          boost::asio::placeholders::error));
+        if (timeout != 0)
+        {
+            d_timer.expires_at(deadline);
+            d_timer.async_wait(boost::bind(&UDPDataTransport::time_out, this,
+                                           boost::asio::placeholders::error));
+        }
+        ios.run();
 
-        lenav = socket->available();
-    }
+        if (d_read_error)
+            break;
 
-    if (lenav > 0)
-    {
-        boost::array<char, 128> recv_buf;
-        boost::asio::ip::udp::endpoint sender_endpoint;
-        // TODO: Need to set up a timeout here !
-        size_t len = socket->receive_from(boost::asio::buffer(recv_buf), sender_endpoint);
-        res        = ByteVector(recv_buf.begin(), recv_buf.begin() + len);
+        ByteVector datagram(std::max<size_t>(socket->available(), 1));
+        boost::asio::ip::udp::endpoint sender;
+        size_t len = socket->receive_from(boost::asio::buffer(datagram), sender);
+        if (sender != remote)
+        {
+            LOG(LogLevel::WARNINGS) << "Datagram from unexpected endpoint "
+                                    << sender.address().to_string() << ":"
+                                    << sender.port() << " dropped.";
+            continue;
+        }
+        datagram.resize(len);
+        res = datagram;
     }
 
     return res;
@@ -0,0 +1,58 @@
+/**
+ * \file securememory.cpp
+ * \brief Locked, zeroized on free, memory for key material.
+ */
+
+#include <logicalaccess/securememory.hpp>
+
+#include <openssl/crypto.h>
+
+namespace logicalaccess
+{
+namespace
+{
+/**
+ * Size of the secure heap arena, and its smallest allocation. Key material is
+ * small: the arena holds hundreds of keys.
+ */
+const size_t SECURE_HEAP_SIZE = 32 * 1024;
+
+const int SECURE_HEAP_MIN_SIZE = 16;
+
+void initSecureHeap()
+{
+    // Once per process, unless the application already set it up.
+    static const bool initialized =
+        CRYPTO_secure_malloc_initialized() ||
+        CRYPTO_secure_malloc_init(SECURE_HEAP_SIZE, SECURE_HEAP_MIN_SIZE) != 0;
+    (void)initialized;
+}
+}
+
+void *secureAllocate(size_t size)
+{
+    initSecureHeap();
+
+    size_t length = (size == 0) ? 1 : size;
+    void *ptr     = OPENSSL_secure_zalloc(length);
+    // The arena is full: OpenSSL frees and zeroizes outside allocations as well.
+    if (ptr == nullptr)
+        ptr = OPENSSL_zalloc(length);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void secureFree(void *ptr, size_t size)
+{
+    if (ptr == nullptr)
+        return;
+
+    OPENSSL_secure_clear_free(ptr, (size == 0) ? 1 : size);
+}
+
+void secureZero(void *ptr, size_t size)
+{
+    OPENSSL_cleanse(ptr, size);
+}
+}
@@ -9,12 +9,40 @@
 #include <logicalaccess/cards/accessinfo.hpp>
 #include <logicalaccess/cards/chip.hpp>
 #include <logicalaccess/services/accesscontrol/accesscontrolcardservice.hpp>
+#include <logicalaccess/compiledconfiguration.hpp>
 #include <boost/foreach.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
 namespace logicalaccess
 {
+namespace
+{
+std::shared_ptr<Format> createFormat(boost::property_tree::ptree &n)
+{
+    std::shared_ptr<Format> ret;
+    if (!n.empty())
+    {
+        FormatType type = static_cast<FormatType>(
+            n.get_child("<xmlattr>.type").get_value<unsigned int>());
+        ret = Format::getByFormatType(type);
+        ret->unSerialize(n);
+    }
+
+    return ret;
+}
+
+std::shared_ptr<Format> createFormatFromTree(boost::property_tree::ptree &pt,
+                                             const std::string &rootNode)
+{
+    if (rootNode != "")
+    {
+        return createFormat(pt.get_child(rootNode));
+    }
+    return createFormat(pt.front().second);
+}
+}
+
 CardsFormatComposite::CardsFormatComposite()
 {
 }
@@ -27,32 +55,23 @@ std::shared_ptr<Format>
 CardsFormatComposite::createFormatFromXml(const std::string &xmlstring,
                                           const std::string &rootNode) const
 {
-    std::shared_ptr<Format> ret;
-
     std::istringstream iss(xmlstring);
     boost::property_tree::ptree pt;
     read_xml(iss, pt);
 
-    boost::property_tree::ptree n;
-
-    if (rootNode != "")
-    {
-        n = pt.get_child(rootNode);
-    }
-    else
-    {
-        n = pt.front().second;
-    }
+    return createFormatFromTree(pt, rootNode);
+}
 
-    if (!n.empty())
-    {
-        FormatType type = static_cast<FormatType>(
-            n.get_child("<xmlattr>.type").get_value<unsigned int>());
-        ret = Format::getByFormatType(type);
-        ret->unSerialize(n);
-    }
+std::shared_ptr<Format>
+CardsFormatComposite::createFormatFromCompiled(const CompiledConfiguration &config,
+                                               const std::string &rootNode) const
+{
+    // Only the format sub tree is rebuilt from the node table.
+    boost::property_tree::ptree pt;
+    EXCEPTION_ASSERT_WITH_LOG(config.toPtree(rootNode, pt), LibLogicalAccessException,
+                              "Node not found in the compiled configuration.");
 
-    return ret;
+    return rootNode != "" ? createFormat(pt) : createFormatFromTree(pt, "");
 }
 
 void CardsFormatComposite::addFormatForCard(const std::string &type,
@@ -0,0 +1,356 @@
+/**
+ * \file encodingpipeline.cpp
+ * \brief Bulk encoding of credentials across several reader units.
+ */
+
+#include <logicalaccess/services/accesscontrol/encodingpipeline.hpp>
+#include <logicalaccess/services/accesscontrol/accesscontrolcardservice.hpp>
+#include <logicalaccess/readerproviders/readerunit.hpp>
+#include <logicalaccess/cards/chip.hpp>
+#include <logicalaccess/cards/keydiversification.hpp>
+#include <logicalaccess/key.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/utils.hpp>
+
+#include <algorithm>
+
+namespace logicalaccess
+{
+EncodingPipeline::EncodingPipeline(const std::vector<std::shared_ptr<ReaderUnit>> &readers,
+                                   unsigned int prepareThreads)
+    : d_readers(readers)
+    , d_prepareThreads(std::max(1u, prepareThreads))
+    , d_pollingPeriod(500)
+    , d_running(false)
+    , d_preparing(0)
+    , d_metrics()
+{
+    EXCEPTION_ASSERT_WITH_LOG(!d_readers.empty(), std::invalid_argument,
+                              "At least one reader unit is required.");
+    for (const auto &reader : d_readers)
+    {
+        EXCEPTION_ASSERT_WITH_LOG(reader, std::invalid_argument,
+                                  "reader unit can't be null.");
+    }
+}
+
+EncodingPipeline::~EncodingPipeline()
+{
+    stop();
+}
+
+void EncodingPipeline::setPollingPeriod(unsigned int period)
+{
+    d_pollingPeriod = period;
+}
+
+unsigned int EncodingPipeline::getPollingPeriod() const
+{
+    return d_pollingPeriod;
+}
+
+void EncodingPipeline::start()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    EXCEPTION_ASSERT_WITH_LOG(!d_running && d_threads.empty(), LibLogicalAccessException,
+                              "The encoding pipeline is already started.");
+
+    d_running = true;
+    for (unsigned int i = 0; i < d_prepareThreads; ++i)
+    {
+        d_threads.emplace_back(&EncodingPipeline::prepareLoop, this);
+    }
+    for (const auto &reader : d_readers)
+    {
+        d_threads.emplace_back(&EncodingPipeline::readerLoop, this, reader);
+    }
+}
+
+void EncodingPipeline::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_running = false;
+    }
+    d_condition.notify_all();
+
+    for (auto &thread : d_threads)
+    {
+        thread.join();
+    }
+    d_threads.clear();
+    failPending();
+}
+
+std::future<EncodingResult> EncodingPipeline::submit(const EncodingJob &job)
+{
+    auto task    = std::make_shared<Task>();
+    task->job    = job;
+    task->result = EncodingResult();
+    std::future<EncodingResult> ret = task->promise.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_pending.push_back(task);
+    }
+    d_condition.notify_all();
+    return ret;
+}
+
+EncodingPipelineMetrics EncodingPipeline::getMetrics() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_metrics;
+}
+
+void EncodingPipeline::prepareLoop()
+{
+    while (true)
+    {
+        std::shared_ptr<Task> task;
+        {
+            std::unique_lock<std::mutex> lock(d_mutex);
+            d_condition.wait(lock, [this]() { return !d_running || !d_pending.empty(); });
+            if (!d_running)
+                return;
+
+            task = d_pending.front();
+            d_pending.pop_front();
+            ++d_preparing;
+        }
+
+        ElapsedTimeCounter counter;
+        try
+        {
+            prepare(*task);
+            task->result.success = true;
+        }
+        catch (std::exception &e)
+        {
+            task->result.error = e.what();
+        }
+        task->result.times.prepare = counter.elapsed_micro();
+
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            --d_preparing;
+            if (task->result.success)
+                d_ready.push_back(task);
+        }
+        d_condition.notify_all();
+
+        if (!task->result.success)
+            complete(task);
+    }
+}
+
+void EncodingPipeline::prepare(Task &task)
+{
+    // Encoding the format checks the field values before a card is consumed.
+    if (task.job.format)
+        task.job.format->getLinearData();
+
+    task.keys.clear();
+    for (const auto &encodingKey : task.job.keys)
+    {
+        // Jobs share their master keys: only copies are diversified.
+        std::shared_ptr<Key> key = encodingKey.key;
+        if (key && key->getKeyDiversification() && !task.job.identifier.empty())
+        {
+            std::shared_ptr<KeyDiversification> keyDiversification =
+                key->getKeyDiversification();
+            ByteVector diversify;
+            keyDiversification->initDiversification(
+                task.job.identifier, encodingKey.aid, key, encodingKey.keyno, diversify);
+            ByteVector data = keyDiversification->getDiversifiedKey(key, diversify);
+
+            key = key->clone();
+            key->setKeyDiversification(nullptr);
+            key->setData(data);
+        }
+        task.keys.push_back(key);
+    }
+}
+
+void EncodingPipeline::readerLoop(std::shared_ptr<ReaderUnit> reader)
+{
+    ElapsedTimeCounter idle;
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            if (!d_running)
+                return;
+        }
+
+        ByteVector identifier;
+        try
+        {
+            if (!reader->waitInsertion(d_pollingPeriod))
+                continue;
+
+            std::shared_ptr<Chip> chip = reader->getSingleChip();
+            if (chip)
+                identifier = chip->getChipIdentifier();
+        }
+        catch (std::exception &e)
+        {
+            LOG(LogLevel::ERRORS) << "Card detection failed on " << reader->getName()
+                                  << ": " << e.what();
+            continue;
+        }
+
+        // The card stays on the reader when no job matches it: it is detected
+        // again on the next iteration.
+        std::shared_ptr<Task> task = takeTask(identifier);
+        if (!task)
+            continue;
+
+        task->result.times.insertion = idle.elapsed_micro();
+        task->result.readerName      = reader->getName();
+        task->result.chipIdentifier  = identifier;
+        encode(*reader, *task);
+
+        ElapsedTimeCounter removal;
+        try
+        {
+            bool removed = false;
+            while (!removed)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(d_mutex);
+                    if (!d_running)
+                        break;
+                }
+                removed = reader->waitRemoval(d_pollingPeriod);
+            }
+        }
+        catch (std::exception &e)
+        {
+            LOG(LogLevel::ERRORS) << "Card removal failed on " << reader->getName()
+                                  << ": " << e.what();
+        }
+        task->result.times.removal = removal.elapsed_micro();
+
+        complete(task);
+        idle = ElapsedTimeCounter();
+    }
+}
+
+std::shared_ptr<EncodingPipeline::Task>
+EncodingPipeline::takeTask(const ByteVector &identifier)
+{
+    auto findTask = [this, &identifier]() {
+        auto it = std::find_if(d_ready.begin(), d_ready.end(),
+                               [&identifier](const std::shared_ptr<Task> &task) {
+                                   return !identifier.empty() &&
+                                          task->job.identifier == identifier;
+                               });
+        if (it == d_ready.end())
+        {
+            it = std::find_if(d_ready.begin(), d_ready.end(),
+                              [](const std::shared_ptr<Task> &task) {
+                                  return task->job.identifier.empty();
+                              });
+        }
+        return it;
+    };
+
+    std::unique_lock<std::mutex> lock(d_mutex);
+    auto it = findTask();
+    if (it == d_ready.end() && d_running)
+    {
+        d_condition.wait_for(lock, std::chrono::milliseconds(d_pollingPeriod));
+        it = findTask();
+    }
+    if (it == d_ready.end() || !d_running)
+        return nullptr;
+
+    std::shared_ptr<Task> task = *it;
+    d_ready.erase(it);
+    return task;
+}
+
+void EncodingPipeline::encode(ReaderUnit &reader, Task &task)
+{
+    ElapsedTimeCounter counter;
+    task.result.success = false;
+    try
+    {
+        EXCEPTION_ASSERT_WITH_LOG(reader.connect(), CardException,
+                                  "Unable to connect to the card.");
+        try
+        {
+            std::shared_ptr<Chip> chip = reader.getSingleChip();
+            EXCEPTION_ASSERT_WITH_LOG(chip, CardException, "No chip connected.");
+
+            if (task.job.format)
+            {
+                std::shared_ptr<AccessControlCardService> acs =
+                    std::dynamic_pointer_cast<AccessControlCardService>(
+                        chip->getService(CST_ACCESS_CONTROL));
+                EXCEPTION_ASSERT_WITH_LOG(
+                    acs, CardException,
+                    "The chip doesn't support the access control card service.");
+                EXCEPTION_ASSERT_WITH_LOG(acs->writeFormat(task.job.format,
+                                                           task.job.location,
+                                                           task.job.aiToUse,
+                                                           task.job.aiToWrite),
+                                          CardException, "Unable to write the format.");
+            }
+
+            if (task.job.operations)
+                task.job.operations(chip, task.keys);
+        }
+        catch (...)
+        {
+            reader.disconnect();
+            throw;
+        }
+        reader.disconnect();
+        task.result.success = true;
+    }
+    catch (std::exception &e)
+    {
+        LOG(LogLevel::ERRORS) << "Encoding failed on " << reader.getName() << ": "
+                              << e.what();
+        task.result.error = e.what();
+    }
+    task.result.times.write = counter.elapsed_micro();
+}
+
+void EncodingPipeline::complete(std::shared_ptr<Task> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (task->result.success)
+            ++d_metrics.succeeded;
+        else
+            ++d_metrics.failed;
+        d_metrics.total.prepare += task->result.times.prepare;
+        d_metrics.total.insertion += task->result.times.insertion;
+        d_metrics.total.write += task->result.times.write;
+        d_metrics.total.removal += task->result.times.removal;
+    }
+    task->promise.set_value(task->result);
+}
+
+void EncodingPipeline::failPending()
+{
+    std::deque<std::shared_ptr<Task>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        tasks.swap(d_ready);
+        tasks.insert(tasks.end(), d_pending.begin(), d_pending.end());
+        d_pending.clear();
+    }
+
+    for (const auto &task : tasks)
+    {
+        task->result.success = false;
+        task->result.error   = "The encoding pipeline was stopped.";
+        complete(task);
+    }
+}
+}
@@ -5,9 +5,54 @@
 */
 
 #include <logicalaccess/services/accesscontrol/formats/BitsetStream.hpp>
+#include <algorithm>
+#include <stdexcept>
 
 namespace logicalaccess
 {
+namespace
+{
+const unsigned int WORD_BITS = 64;
+
+/**
+ * Bits are copied between buffers by chunks of this size so that a chunk,
+ * plus its sub-byte offset, always fits in a single 64-bit word.
+ */
+const unsigned int CHUNK_BITS = 56;
+
+uint64_t lowMask(unsigned int length)
+{
+    return length >= WORD_BITS ? ~0ULL : ((1ULL << length) - 1);
+}
+
+/**
+ * Read up to CHUNK_BITS bits from a byte buffer, high weight bit first.
+ */
+uint64_t readBufferBits(const unsigned char *data, size_t pos, unsigned int length)
+{
+    size_t first        = pos / 8;
+    unsigned int offset = pos % 8;
+    unsigned int nbytes = (offset + length + 7) / 8;
+
+    uint64_t value = 0;
+    for (unsigned int i = 0; i < nbytes; ++i)
+    {
+        value = (value << 8) | data[first + i];
+    }
+    return (value >> (nbytes * 8 - offset - length)) & lowMask(length);
+}
+
+void checkBufferRange(const unsigned char *data, size_t dataSize,
+                      unsigned int readPosStart, unsigned int readLength)
+{
+    if ((data == nullptr || dataSize == 0) && readLength != 0)
+        throw std::invalid_argument("Data vector is empty.");
+    if (readPosStart > dataSize * 8 ||
+        static_cast<size_t>(readPosStart) + readLength > dataSize * 8)
+        throw std::out_of_range("Invalid reading size.");
+}
+}
+
 BitsetStream::BitsetStream()
     : _pos(0)
 {
@@ -16,19 +61,20 @@ BitsetStream::BitsetStream()
 BitsetStream::BitsetStream(unsigned char data, unsigned int byteSize)
     : _pos(0)
 {
-    for (unsigned long long i = 0; i < byteSize; ++i)
+    resize(static_cast<size_t>(byteSize) * 8);
+    const uint64_t pattern = 0x0101010101010101ULL * data;
+    for (size_t i = 0; i < stream.size(); ++i)
     {
-        append(data);
+        stream[i] = pattern;
     }
+    if (_pos % WORD_BITS != 0)
+        stream.back() &= ~lowMask(WORD_BITS - _pos % WORD_BITS);
 }
 
 BitsetStream::BitsetStream(unsigned long long bitsSize)
     : _pos(0)
 {
-    for (unsigned long long i = 0; i < bitsSize; ++i)
-    {
-        append(0x00, 0, 1);
-    }
+    resize(static_cast<size_t>(bitsSize));
 }
 
 BitsetStream::~BitsetStream()
@@ -53,29 +99,43 @@ void BitsetStream::append(unsigned char data, unsigned int readPosStart,
     if (readLength == 0)
         return;
 
-    unsigned int block  = _pos / 8;
-    unsigned int offset = _pos % 8;
-
-
-    if (block >= stream.size())
-        stream.push_back(0);
+    appendValue(data >> (8 - (readPosStart + readLength)), readLength);
+}
 
-    stream[block] |= (data >> (8 - (readPosStart + readLength))
-                                  << ((8 - (readPosStart + readLength)) + readPosStart) &
-                      0xFF) >>
-                     offset;
-    unsigned char newData =
-        data >> (8 - (readPosStart + readLength))
-                    << (8 - (readPosStart + readLength) + readPosStart) << (8 - offset);
-    if (offset + readLength > 8)
-        stream.push_back(newData);
+void BitsetStream::appendValue(unsigned long long value, unsigned int length)
+{
+    if (length > WORD_BITS)
+        throw std::out_of_range("Invalid reading size.");
+    if (length == 0)
+        return;
 
-    _pos += readLength;
+    size_t pos = _pos;
+    resize(pos + length);
+    orBits(pos, value & lowMask(length), length);
 }
 
 void BitsetStream::concat(const BitsetStream &data)
 {
-    concat(data.getData(), 0, data.getBitSize());
+    concat(data, 0, data.getBitSize());
+}
+
+void BitsetStream::concat(const BitsetStream &data, unsigned int readPosStart,
+                          unsigned int readLength)
+{
+    if (static_cast<size_t>(readPosStart) + readLength > data._pos)
+        throw std::out_of_range("Invalid reading size.");
+
+    // Source and destination never overlap, even when data is *this:
+    // bits are read below the old end and written after it.
+    size_t pos = _pos;
+    resize(pos + readLength);
+    for (size_t done = 0; done < readLength;)
+    {
+        unsigned int length =
+            static_cast<unsigned int>(std::min<size_t>(readLength - done, WORD_BITS));
+        orBits(pos + done, data.readBits(readPosStart + done, length), length);
+        done += length;
+    }
 }
 
 void BitsetStream::concat(const ByteVector &data)
@@ -91,30 +151,22 @@ void BitsetStream::concat(const ByteVector &data, unsigned int readPosStart)
 void BitsetStream::concat(const ByteVector &data, unsigned int readPosStart,
                           unsigned int readLength)
 {
-    if (data.empty() && readLength != 0)
-        throw std::invalid_argument("Data vector is empty.");
-    if (readPosStart > data.size() * 8 || readLength + readPosStart > data.size() * 8)
-        throw std::out_of_range("Invalid reading size.");
+    concat(data.data(), data.size(), readPosStart, readLength);
+}
 
-    unsigned int offset   = readPosStart % 8;
-    unsigned int readBits = 0;
-    unsigned int i        = readPosStart / 8;
+void BitsetStream::concat(const unsigned char *data, size_t dataSize,
+                          unsigned int readPosStart, unsigned int readLength)
+{
+    checkBufferRange(data, dataSize, readPosStart, readLength);
 
-    while (readBits < readLength)
+    size_t pos = _pos;
+    resize(pos + readLength);
+    for (size_t done = 0; done < readLength;)
     {
-        if (offset + (readLength - readBits) > 8)
-        {
-            unsigned char length =
-                (readLength - readBits) < 8 ? (readLength - readBits) : 8;
-            append((data[i] << offset) | (data[i + 1] >> (8 - offset)), 0, length);
-            readBits += length;
-            i++;
-        }
-        else
-        {
-            append(data[i], offset, readLength - readBits);
-            readBits += (readLength - readBits);
-        }
+        unsigned int length =
+            static_cast<unsigned int>(std::min<size_t>(readLength - done, CHUNK_BITS));
+        orBits(pos + done, readBufferBits(data, readPosStart + done, length), length);
+        done += length;
     }
 }
 
@@ -125,68 +177,65 @@ void BitsetStream::writeAt(unsigned int pos, unsigned char data,
         throw std::out_of_range("Invalid reading size.");
     if (pos > _pos)
         throw std::out_of_range("Invalid start position.");
-    if (pos >= _pos)
+    if (pos >= _pos || pos + readLength > getByteSize() * 8)
         throw std::out_of_range("Cannot write at this position.");
 
-    unsigned int block  = pos / 8;
-    unsigned int offset = pos % 8;
+    writeBits(pos, data >> (8 - (readPosStart + readLength)), readLength);
+}
 
-    if ((8 - offset) >= readLength)
-    {
-        unsigned char save = stream[block] >> (8 - offset) << (8 - offset);
-        stream[block] = (((stream[block] << offset << readLength & 0xFF) >> readLength) |
-                         (data << readPosStart & 0xFF)) >>
-                            offset |
-                        save;
-    }
-    else
+void BitsetStream::writeAt(unsigned int pos, ByteVector const &data,
+                           unsigned int readPosStart, unsigned int readLength)
+{
+    writeAt(pos, data.data(), data.size(), readPosStart, readLength);
+}
+
+void BitsetStream::writeAt(unsigned int pos, const unsigned char *data, size_t dataSize,
+                           unsigned int readPosStart, unsigned int readLength)
+{
+    checkBufferRange(data, dataSize, readPosStart, readLength);
+    if (dataSize != 0 && readPosStart == dataSize * 8)
+        throw std::out_of_range("Invalid reading size.");
+    if (pos > _pos)
+        throw std::out_of_range("Invalid start position.");
+    if (readLength == 0)
+        return;
+    if (pos >= _pos || static_cast<size_t>(pos) + readLength > getByteSize() * 8)
+        throw std::out_of_range("Cannot write at this position.");
+
+    for (size_t done = 0; done < readLength;)
     {
-        stream[block] = stream[block] >> (8 - pos % 8) << (8 - pos % 8);
-        stream[block] |= ((data >> (8 - (readPosStart + readLength)))
-                              << ((8 - (readPosStart + readLength)) + readPosStart) &
-                          0xFF) >>
-                         offset;
-        block++;
-        stream[block] = (stream[block] << (pos % 8) & 0xFF) >> (pos % 8);
-        stream[block] |= ((data >> (8 - (readPosStart + readLength)))
-                              << ((8 - (readPosStart + readLength)) + readPosStart) &
-                          0xFF)
-                         << (8 - offset);
+        unsigned int length =
+            static_cast<unsigned int>(std::min<size_t>(readLength - done, CHUNK_BITS));
+        writeBits(pos + done, readBufferBits(data, readPosStart + done, length), length);
+        done += length;
     }
 }
 
-void BitsetStream::writeAt(unsigned int pos, ByteVector const &data,
+void BitsetStream::writeAt(unsigned int pos, const BitsetStream &data,
                            unsigned int readPosStart, unsigned int readLength)
 {
-    if (data.empty() && readLength != 0)
-        throw std::invalid_argument("Data vector is empty.");
-    if (readPosStart > (data.size() * 8) - 1 ||
-        readPosStart + readLength > (data.size() * 8))
+    if (&data == this)
+    {
+        BitsetStream copy(data);
+        writeAt(pos, copy, readPosStart, readLength);
+        return;
+    }
+
+    if (static_cast<size_t>(readPosStart) + readLength > data._pos)
         throw std::out_of_range("Invalid reading size.");
     if (pos > _pos)
         throw std::out_of_range("Invalid start position.");
+    if (readLength == 0)
+        return;
+    if (pos >= _pos || static_cast<size_t>(pos) + readLength > getByteSize() * 8)
+        throw std::out_of_range("Cannot write at this position.");
 
-    unsigned int offset   = readPosStart % 8;
-    unsigned int readBits = 0;
-    unsigned int i        = readPosStart / 8;
-
-    while (readBits < readLength)
+    for (size_t done = 0; done < readLength;)
     {
-        if (offset + (readLength - readBits) > 8)
-        {
-            const unsigned char length =
-                (readLength - readBits) < 8 ? (readLength - readBits) : 8;
-            const unsigned char newBlock =
-                (data[i] << offset & 0xFF) + (data[i + 1] >> (8 - offset));
-            writeAt(pos + readBits, newBlock, 0, length);
-            readBits += length;
-            ++i;
-        }
-        else
-        {
-            writeAt(pos + readBits, data[i], offset, readLength - readBits);
-            readBits += (readLength - readBits);
-        }
+        unsigned int length =
+            static_cast<unsigned int>(std::min<size_t>(readLength - done, WORD_BITS));
+        writeBits(pos + done, data.readBits(readPosStart + done, length), length);
+        done += length;
     }
 }
 
@@ -198,134 +247,157 @@ void BitsetStream::insert(unsigned int pos, unsigned char data, unsigned int rea
     if (pos > _pos)
         throw std::out_of_range("Invalid start position.");
 
-    if (pos == _pos)
-    {
-        append(data, readPosStart, readLength);
-    }
-    else
-    {
-        unsigned int last  = static_cast<unsigned int>(stream.size()) - 1;
-        unsigned int block = pos / 8;
-        if (_pos % 8 < readLength)
-        {
-            stream.push_back(0);
-            stream[last + 1] = stream[last] << (8 - readLength) & 0xFF;
-        }
-
-        for (unsigned int i = last; i != block; i--)
-        {
-            unsigned int a = stream[i] >> readLength;
-            unsigned int b = stream[i - 1] << (8 - readLength);
-            stream[i]      = a + b;
-        }
-
-        if (_pos % 8 > readLength)
-        {
-            unsigned char save = (stream[block] >> (8 - pos % 8) & 0xFF) << (8 - pos % 8);
-            stream[block] =
-                ((stream[block] << (pos % 8) & 0xFF) >> (pos % 8) >> readLength & 0xFF) |
-                save;
-        }
-        writeAt(pos, data, readPosStart, readLength);
-        _pos += readLength;
-    }
+    BitsetStream bits;
+    bits.append(data, readPosStart, readLength);
+    insert(pos, bits, 0, readLength);
 }
 
 void BitsetStream::insert(unsigned int pos, ByteVector const &data,
                           unsigned int readPosStart, unsigned int readLength)
 {
-    if (data.empty())
+    insert(pos, data.data(), data.size(), readPosStart, readLength);
+}
+
+void BitsetStream::insert(unsigned int pos, const unsigned char *data, size_t dataSize,
+                          unsigned int readPosStart, unsigned int readLength)
+{
+    if (data == nullptr || dataSize == 0)
         throw std::invalid_argument("Data vector is empty.");
-    if (readPosStart >= data.size() * 8 || readPosStart + readLength > data.size() * 8)
+    if (readPosStart >= dataSize * 8 ||
+        static_cast<size_t>(readPosStart) + readLength > dataSize * 8)
         throw std::out_of_range("Invalid reading size.");
     if (pos > _pos)
         throw std::out_of_range("Invalid start position.");
 
-    unsigned int i = readPosStart / 8;
-    while ((int)readLength > 0)
+    BitsetStream bits;
+    bits.concat(data, dataSize, readPosStart, readLength);
+    insert(pos, bits, 0, readLength);
+}
+
+void BitsetStream::insert(unsigned int pos, const BitsetStream &data,
+                          unsigned int readPosStart, unsigned int readLength)
+{
+    if (static_cast<size_t>(readPosStart) + readLength > data._pos)
+        throw std::out_of_range("Invalid reading size.");
+    if (pos > _pos)
+        throw std::out_of_range("Invalid start position.");
+
+    if (pos == _pos)
     {
-        insert(pos, data[i], readPosStart % 8,
-               (readLength + readPosStart > 8) ? 8 - readPosStart % 8 : readLength);
-        pos += (readLength + readPosStart > 8) ? 8 - readPosStart % 8 : readLength;
-        readPosStart = 0;
-        readLength -= (8 - readLength % 8);
-        i++;
+        concat(data, readPosStart, readLength);
+        return;
     }
+
+    BitsetStream bits = data.extract(readPosStart, readLength);
+    BitsetStream tail = extract(pos, _pos - pos);
+
+    // Drop the tail, including any bit written after the end of the stream.
+    stream.resize((static_cast<size_t>(pos) + WORD_BITS - 1) / WORD_BITS);
+    if (pos % WORD_BITS != 0)
+        stream.back() &= ~lowMask(WORD_BITS - pos % WORD_BITS);
+    _pos = pos;
+
+    concat(bits, 0, bits._pos);
+    concat(tail, 0, tail._pos);
+}
+
+BitsetStream BitsetStream::extract(unsigned int pos, unsigned int length) const
+{
+    if (static_cast<size_t>(pos) + length > _pos)
+        throw std::out_of_range("Invalid reading size.");
+
+    BitsetStream result;
+    result.concat(*this, pos, length);
+    return result;
+}
+
+unsigned long long BitsetStream::extractValue(unsigned int pos, unsigned int length) const
+{
+    if (length > WORD_BITS || static_cast<size_t>(pos) + length > _pos)
+        throw std::out_of_range("Invalid reading size.");
+
+    return readBits(pos, length);
 }
 
 ByteVector BitsetStream::getData() const
 {
-    return stream;
+    ByteVector data(getByteSize());
+    getData(data.data(), data.size());
+    return data;
+}
+
+size_t BitsetStream::getData(unsigned char *data, size_t dataSize) const
+{
+    const size_t byteSize = getByteSize();
+    if (dataSize < byteSize)
+        throw std::out_of_range("Destination buffer is too small.");
+
+    size_t i = 0;
+    for (; i + 8 <= byteSize; i += 8)
+    {
+        const uint64_t word = stream[i / 8];
+        for (unsigned int j = 0; j < 8; ++j)
+        {
+            data[i + j] = static_cast<unsigned char>(word >> (56 - j * 8));
+        }
+    }
+    for (; i < byteSize; ++i)
+    {
+        data[i] = getByte(i);
+    }
+    return byteSize;
 }
 
 unsigned int BitsetStream::getByteSize() const
 {
-    return static_cast<unsigned int>(stream.size());
+    return (_pos + 7) / 8;
 }
 
 unsigned int BitsetStream::getBitSize() const
 {
-    if (_pos == 0)
-        return static_cast<unsigned int>(stream.size()) * 8;
     return _pos;
 }
 
 std::string BitsetStream::toString() const
 {
-    std::string tmp("");
-    unsigned char value = 0;
-
-    for (unsigned int i = 0; i / 8 < stream.size() && i < _pos; i++)
-    {
-        value = stream[i / 8] >> (7 - i % 8) & 0x01;
-        if (value == 1)
-            tmp += '1';
-        else
-            tmp += '0';
-    }
-    return tmp;
+    return toString(0, _pos);
 }
 
 std::string BitsetStream::toString(size_t begin, size_t end) const
 {
     std::string str;
-    unsigned char tmp = 0;
 
-    for (size_t i = begin; i <= end && i / 8 < stream.size() && i < _pos; i++)
+    for (size_t i = begin; i <= end && i < _pos; i++)
     {
-        tmp = stream[i / 8] >> (7 - i % 8) & 0x01;
-        if (tmp == 1)
-            str.append("1");
-        else
-            str.append("0");
+        str += test(i) ? '1' : '0';
     }
     return str;
 }
 
 unsigned long BitsetStream::toULong() const
 {
-    if (stream.size() > 4)
+    if (getByteSize() > 4)
         throw std::overflow_error("Base value overflows the size of an unsigned long.");
 
     unsigned long tmp = 0;
 
-    for (unsigned int i = 0; i < stream.size(); i++)
+    for (unsigned int i = 0; i < getByteSize(); i++)
     {
-        tmp |= stream[i] << (i * 8);
+        tmp |= getByte(i) << (i * 8);
     }
     return tmp;
 }
 
 unsigned long long BitsetStream::toULLong() const
 {
-    if (stream.size() > 8)
+    if (getByteSize() > 8)
         throw std::overflow_error("Base value overflows the size of an unsigned long.");
 
     unsigned long long tmp = 0;
 
-    for (unsigned int i = 0; i < stream.size(); i++)
+    for (unsigned int i = 0; i < getByteSize(); i++)
     {
-        tmp |= (static_cast<unsigned long long>(stream[i]) << (i * 8));
+        tmp |= (static_cast<unsigned long long>(getByte(i)) << (i * 8));
     }
     return tmp;
 }
@@ -334,22 +406,18 @@ bool BitsetStream::test(size_t index) const
 {
     if (index >= _pos)
         throw std::out_of_range("Index is out of bounds.");
-    if (((stream[index / 8] >> (7 - index % 8)) & 0x01) == 1)
-        return true;
-    return false;
+    return ((stream[index / WORD_BITS] >> (WORD_BITS - 1 - index % WORD_BITS)) & 0x01) ==
+           1;
 }
 
 bool BitsetStream::none() const
 {
-    for (unsigned int i = 0; i < stream.size(); i++)
-        if (stream[i] != 0)
-            return false;
-    return true;
+    return !any();
 }
 
 bool BitsetStream::any() const
 {
-    for (unsigned int i = 0; i < stream.size(); i++)
+    for (size_t i = 0; i < stream.size(); i++)
         if (stream[i] != 0)
             return true;
     return false;
@@ -357,10 +425,15 @@ bool BitsetStream::any() const
 
 bool BitsetStream::all() const
 {
-    for (unsigned int i = 0; i < stream.size(); i++)
-        if (stream[i] != 1)
+    const size_t fullWords = _pos / WORD_BITS;
+    for (size_t i = 0; i < fullWords; i++)
+        if (stream[i] != ~0ULL)
             return false;
-    return true;
+    const unsigned int remaining = _pos % WORD_BITS;
+    if (remaining == 0)
+        return true;
+    const uint64_t mask = ~lowMask(WORD_BITS - remaining);
+    return (stream[fullWords] & mask) == mask;
 }
 
 void BitsetStream::clear()
@@ -368,4 +441,75 @@ void BitsetStream::clear()
     stream.clear();
     _pos = 0;
 }
+
+unsigned char BitsetStream::getByte(size_t index) const
+{
+    return static_cast<unsigned char>(stream[index / 8] >> (56 - (index % 8) * 8));
+}
+
+uint64_t BitsetStream::readBits(size_t pos, unsigned int length) const
+{
+    if (length == 0)
+        return 0;
+
+    const size_t word         = pos / WORD_BITS;
+    const unsigned int offset = pos % WORD_BITS;
+    if (offset + length <= WORD_BITS)
+        return (stream[word] >> (WORD_BITS - offset - length)) & lowMask(length);
+
+    const unsigned int overflow = offset + length - WORD_BITS;
+    return ((stream[word] << overflow) | (stream[word + 1] >> (WORD_BITS - overflow))) &
+           lowMask(length);
+}
+
+void BitsetStream::orBits(size_t pos, uint64_t value, unsigned int length)
+{
+    if (length == 0)
+        return;
+
+    const size_t word         = pos / WORD_BITS;
+    const unsigned int offset = pos % WORD_BITS;
+    if (offset + length <= WORD_BITS)
+    {
+        stream[word] |= value << (WORD_BITS - offset - length);
+    }
+    else
+    {
+        const unsigned int overflow = offset + length - WORD_BITS;
+        stream[word] |= value >> overflow;
+        stream[word + 1] |= value << (WORD_BITS - overflow);
+    }
+}
+
+void BitsetStream::writeBits(size_t pos, uint64_t value, unsigned int length)
+{
+    if (length == 0)
+        return;
+
+    const size_t word         = pos / WORD_BITS;
+    const unsigned int offset = pos % WORD_BITS;
+    value &= lowMask(length);
+    if (offset + length <= WORD_BITS)
+    {
+        const unsigned int shift = WORD_BITS - offset - length;
+        stream[word] = (stream[word] & ~(lowMask(length) << shift)) | (value << shift);
+    }
+    else
+    {
+        const unsigned int overflow = offset + length - WORD_BITS;
+        const unsigned int shift    = WORD_BITS - overflow;
+        stream[word] = (stream[word] & ~lowMask(length - overflow)) | (value >> overflow);
+        stream[word + 1] =
+            (stream[word + 1] & ~(lowMask(overflow) << shift)) | (value << shift);
+    }
+}
+
+void BitsetStream::resize(size_t bitSize)
+{
+    if (bitSize > static_cast<unsigned int>(-1))
+        throw std::out_of_range("Bitset stream is too large.");
+
+    stream.resize((bitSize + WORD_BITS - 1) / WORD_BITS, 0);
+    _pos = static_cast<unsigned int>(bitSize);
+}
 }
@@ -104,16 +104,10 @@ BitsetStream BitHelper::swapBytes(const BitsetStream &data)
 BitsetStream BitHelper::extract(const BitsetStream &data, unsigned int readPosBits,
                                 unsigned int readLengthBits)
 {
-    BitsetStream extractData;
-
-    if ((readPosBits + readLengthBits) <= data.getBitSize())
-    {
-        extractData.concat(data.getData(), readPosBits, readLengthBits);
-    }
-    else
+    if ((readPosBits + readLengthBits) > data.getBitSize())
         THROW_EXCEPTION_WITH_LOG(LibLogicalAccessException,
                                  "Data is too small to extract this size.");
 
-    return extractData;
+    return data.extract(readPosBits, readLengthBits);
 }
 }
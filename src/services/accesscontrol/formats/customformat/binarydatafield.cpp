@@ -156,4 +156,9 @@ std::string BinaryDataField::getDefaultXmlNodeName() const
 {
     return "BinaryDataField";
 }
+
+std::shared_ptr<Key> BinaryFieldValue::clone() const
+{
+    return std::make_shared<BinaryFieldValue>(*this);
+}
 }
@@ -78,7 +78,7 @@ ByteVector CustomFormat::getLinearData() const
         {
             pos = lastpos;
         }
-        data.writeAt(pos, tmp.getData(), 0, tmp.getBitSize());
+        data.writeAt(pos, tmp, 0, tmp.getBitSize());
 
         lastpos = pos + tmp.getBitSize();
     }
@@ -82,10 +82,11 @@ bool FieldSortPredicate(const std::shared_ptr<DataField> &lhs,
 unsigned char Format::calculateParity(const BitsetStream &data, ParityType parityType,
                                       std::vector<unsigned int> positions)
 {
-    unsigned char parity = 0x00;
+    const ByteVector bytes = data.getData();
+    unsigned char parity   = 0x00;
     for (size_t i = 0; i < positions.size() && i < (data.getByteSize() * 8); i++)
     {
-        parity = (unsigned char)((parity & 0x01) ^ ((data.getData()[positions[i] / 8] >>
+        parity = (unsigned char)((parity & 0x01) ^ ((bytes[positions[i] / 8] >>
                                                      (7 - (positions[i] % 8))) &
                                                     0x01));
     }
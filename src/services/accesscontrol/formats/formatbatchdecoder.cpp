@@ -0,0 +1,182 @@
+/**
+ * \file formatbatchdecoder.cpp
+ * \brief Batch decoding of raw credentials for a format.
+ */
+
+#include <logicalaccess/services/accesscontrol/formats/formatbatchdecoder.hpp>
+#include <logicalaccess/services/accesscontrol/formats/customformat/numberdatafield.hpp>
+#include <logicalaccess/myexception.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <thread>
+
+namespace logicalaccess
+{
+namespace
+{
+/**
+ * Decode credentials [begin, end) with a format owned by the calling thread.
+ */
+void decodeRange(std::shared_ptr<Format> format, const std::vector<std::string> &names,
+                 const unsigned char *data, size_t begin, size_t end, size_t stride,
+                 FormatBatchResult &result)
+{
+    std::vector<std::shared_ptr<NumberDataField>> fields;
+    for (const auto &name : names)
+    {
+        fields.push_back(
+            std::dynamic_pointer_cast<NumberDataField>(format->getFieldFromName(name)));
+    }
+
+    ByteVector credential(stride);
+    for (size_t i = begin; i < end; ++i)
+    {
+        std::copy(data + i * stride, data + (i + 1) * stride, credential.begin());
+        for (const auto &field : fields)
+        {
+            field->setValue(0);
+        }
+
+        bool valid = true;
+        try
+        {
+            format->setLinearData(credential);
+        }
+        catch (std::exception &)
+        {
+            valid = false;
+        }
+
+        for (size_t f = 0; f < fields.size(); ++f)
+        {
+            result.columns[f][i] = fields[f]->getValue();
+        }
+        result.valid[i] = valid ? 1 : 0;
+    }
+}
+}
+
+size_t FormatBatchResult::size() const
+{
+    return valid.size();
+}
+
+const std::vector<unsigned long long> &
+FormatBatchResult::getColumn(const std::string &field) const
+{
+    auto it = std::find(fieldNames.begin(), fieldNames.end(), field);
+    EXCEPTION_ASSERT_WITH_LOG(it != fieldNames.end(), std::invalid_argument,
+                              "The field is not part of the batch result.");
+    return columns[static_cast<size_t>(std::distance(fieldNames.begin(), it))];
+}
+
+FormatBatchDecoder::FormatBatchDecoder(std::shared_ptr<Format> format)
+    : d_format(format)
+{
+    EXCEPTION_ASSERT_WITH_LOG(d_format, std::invalid_argument,
+                              "format to decode can't be null.");
+
+    for (const auto &name : d_format->getValuesFieldList())
+    {
+        if (std::dynamic_pointer_cast<NumberDataField>(d_format->getFieldFromName(name)))
+        {
+            d_fieldNames.push_back(name);
+        }
+    }
+}
+
+std::shared_ptr<Format> FormatBatchDecoder::getFormat() const
+{
+    return d_format;
+}
+
+const std::vector<std::string> &FormatBatchDecoder::getFieldNames() const
+{
+    return d_fieldNames;
+}
+
+std::shared_ptr<Format> FormatBatchDecoder::cloneFormat() const
+{
+    std::shared_ptr<Format> format = Format::getByFormatType(d_format->getType());
+    EXCEPTION_ASSERT_WITH_LOG(format, LibLogicalAccessException,
+                              "Unable to duplicate the format.");
+    format->unSerialize(d_format->serialize(), "");
+    return format;
+}
+
+FormatBatchResult FormatBatchDecoder::decode(const unsigned char *data, size_t count,
+                                             size_t stride, unsigned int threads) const
+{
+    EXCEPTION_ASSERT_WITH_LOG(data != nullptr || count == 0, std::invalid_argument,
+                              "Credential data can't be null.");
+    EXCEPTION_ASSERT_WITH_LOG(stride >= (d_format->getDataLength() + 7) / 8,
+                              std::invalid_argument,
+                              "Credential stride is smaller than the format length.");
+
+    FormatBatchResult result;
+    result.fieldNames = d_fieldNames;
+    result.columns.assign(d_fieldNames.size(), std::vector<unsigned long long>(count));
+    result.valid.assign(count, 0);
+    if (count == 0)
+        return result;
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned int>(std::min<size_t>(threads, count));
+
+    // Formats are duplicated from the calling thread: the XML round-trip and
+    // the format factory are not meant to run concurrently.
+    std::vector<std::shared_ptr<Format>> formats;
+    for (unsigned int t = 0; t < threads; ++t)
+    {
+        formats.push_back(cloneFormat());
+    }
+
+    if (threads == 1)
+    {
+        decodeRange(formats[0], d_fieldNames, data, 0, count, stride, result);
+        return result;
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    const size_t chunk = (count + threads - 1) / threads;
+    for (unsigned int t = 0; t < threads; ++t)
+    {
+        const size_t begin = std::min(count, t * chunk);
+        const size_t end   = std::min(count, begin + chunk);
+        workers.emplace_back([&, t, begin, end]() {
+            try
+            {
+                decodeRange(formats[t], d_fieldNames, data, begin, end, stride, result);
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    for (const auto &error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    return result;
+}
+
+FormatBatchResult FormatBatchDecoder::decode(const ByteVector &data, size_t stride,
+                                             unsigned int threads) const
+{
+    EXCEPTION_ASSERT_WITH_LOG(stride != 0 && data.size() % stride == 0,
+                              std::invalid_argument,
+                              "Credential data size must be a multiple of the stride.");
+    return decode(data.data(), data.size() / stride, stride, threads);
+}
+}
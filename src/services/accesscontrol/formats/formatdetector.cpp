@@ -0,0 +1,331 @@
+/**
+ * \file formatdetector.cpp
+ * \brief Detection of the format of a raw credential.
+ */
+
+#include <logicalaccess/services/accesscontrol/formats/formatdetector.hpp>
+#include <logicalaccess/services/accesscontrol/formats/wiegand26format.hpp>
+#include <logicalaccess/services/accesscontrol/formats/wiegand34format.hpp>
+#include <logicalaccess/services/accesscontrol/formats/wiegand34withfacilityformat.hpp>
+#include <logicalaccess/services/accesscontrol/formats/wiegand35format.hpp>
+#include <logicalaccess/services/accesscontrol/formats/wiegand37format.hpp>
+#include <logicalaccess/services/accesscontrol/formats/wiegand37withfacilityformat.hpp>
+#include <logicalaccess/services/accesscontrol/formats/wiegand37withfacilityrightparity2format.hpp>
+#include <logicalaccess/services/accesscontrol/formats/dataclockformat.hpp>
+#include <logicalaccess/services/accesscontrol/formats/fascn200bitformat.hpp>
+#include <logicalaccess/services/accesscontrol/formats/hidhoneywell40bitformat.hpp>
+#include <logicalaccess/services/accesscontrol/formats/getronik40bitformat.hpp>
+#include <logicalaccess/services/accesscontrol/formats/bariumferritepcscformat.hpp>
+#include <logicalaccess/services/accesscontrol/formats/customformat/numberdatafield.hpp>
+#include <logicalaccess/services/accesscontrol/formats/customformat/binarydatafield.hpp>
+#include <logicalaccess/myexception.hpp>
+
+#include <algorithm>
+#include <bitset>
+
+namespace logicalaccess
+{
+namespace
+{
+/**
+ * Values used to toggle every bit of binary fields and every bit of BCD
+ * digits (repeated 1, 2, 4 and 8 digits) when computing signatures.
+ */
+const unsigned long long BINARY_PATTERNS[] = {~0ULL, 0x5555555555555555ULL,
+                                              0xAAAAAAAAAAAAAAAAULL};
+const unsigned int DECIMAL_DIGITS[] = {1, 2, 4, 8};
+
+unsigned int chunkLength(unsigned int bitLength, size_t chunk)
+{
+    return std::min<unsigned int>(64, bitLength - static_cast<unsigned int>(chunk) * 64);
+}
+
+unsigned long long lowMask(unsigned int length)
+{
+    return length >= 64 ? ~0ULL : ((1ULL << length) - 1);
+}
+
+std::vector<unsigned long long> toChunks(const BitsetStream &data)
+{
+    const unsigned int length = data.getBitSize();
+    std::vector<unsigned long long> chunks((length + 63) / 64);
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        chunks[i] =
+            data.extractValue(static_cast<unsigned int>(i) * 64, chunkLength(length, i));
+    }
+    return chunks;
+}
+
+bool encode(std::shared_ptr<Format> format, std::vector<unsigned long long> &chunks)
+{
+    try
+    {
+        const unsigned int length = format->getDataLength();
+        ByteVector data           = format->getLinearData();
+        if (data.size() * 8 < length)
+            return false;
+
+        BitsetStream bits;
+        bits.concat(data, 0, length);
+        chunks = toChunks(bits);
+        return true;
+    }
+    catch (std::exception &)
+    {
+        return false;
+    }
+}
+
+std::vector<unsigned long long> samplePatterns(unsigned int fieldLength)
+{
+    std::vector<unsigned long long> patterns(std::begin(BINARY_PATTERNS),
+                                             std::end(BINARY_PATTERNS));
+    const unsigned int digits = std::max(1u, std::min(19u, fieldLength / 4));
+    for (unsigned int digit : DECIMAL_DIGITS)
+    {
+        unsigned long long value = 0;
+        for (unsigned int i = 0; i < digits; ++i)
+        {
+            value = value * 10 + digit;
+        }
+        patterns.push_back(value);
+    }
+    return patterns;
+}
+}
+
+FormatDetector::FormatDetector(bool registerBuiltins)
+    : d_count(0)
+{
+    if (registerBuiltins)
+    {
+        registerFormatFactory([]() { return std::make_shared<Wiegand26Format>(); });
+        registerFormatFactory([]() { return std::make_shared<Wiegand34Format>(); });
+        registerFormatFactory(
+            []() { return std::make_shared<Wiegand34WithFacilityFormat>(); });
+        registerFormatFactory([]() { return std::make_shared<Wiegand35Format>(); });
+        registerFormatFactory([]() { return std::make_shared<Wiegand37Format>(); });
+        registerFormatFactory(
+            []() { return std::make_shared<Wiegand37WithFacilityFormat>(); });
+        registerFormatFactory(
+            []() { return std::make_shared<Wiegand37WithFacilityRightParity2Format>(); });
+        registerFormatFactory([]() { return std::make_shared<DataClockFormat>(); });
+        // Serie and credential codes are not value fields of the FASC-N format.
+        registerFormatFactory(
+            []() { return std::make_shared<FASCN200BitFormat>(); },
+            {{[](Format &format, unsigned long long value) {
+                  dynamic_cast<FASCN200BitFormat &>(format).setSerieCode(
+                      static_cast<unsigned char>(value));
+              },
+              4},
+             {[](Format &format, unsigned long long value) {
+                  dynamic_cast<FASCN200BitFormat &>(format).setCredentialCode(
+                      static_cast<unsigned char>(value));
+              },
+              4}});
+        registerFormatFactory(
+            []() { return std::make_shared<HIDHoneywell40BitFormat>(); });
+        registerFormatFactory([]() { return std::make_shared<Getronik40BitFormat>(); });
+        registerFormatFactory(
+            []() { return std::make_shared<BariumFerritePCSCFormat>(); });
+    }
+}
+
+void FormatDetector::registerFormat(std::shared_ptr<Format> format)
+{
+    EXCEPTION_ASSERT_WITH_LOG(format, std::invalid_argument,
+                              "format to register can't be null.");
+
+    const FormatType type = format->getType();
+    EXCEPTION_ASSERT_WITH_LOG(Format::getByFormatType(type), std::invalid_argument,
+                              "The format type cannot be instantiated, register a "
+                              "factory instead.");
+
+    const std::string xml = format->serialize();
+    registerFormatFactory([type, xml]() {
+        std::shared_ptr<Format> ret = Format::getByFormatType(type);
+        ret->unSerialize(xml, "");
+        return ret;
+    });
+}
+
+void FormatDetector::registerFormatFactory(
+    std::function<std::shared_ptr<Format>()> factory)
+{
+    registerFormatFactory(factory, std::vector<Sampler>());
+}
+
+void FormatDetector::registerFormatFactory(
+    std::function<std::shared_ptr<Format>()> factory, const std::vector<Sampler> &samplers)
+{
+    EXCEPTION_ASSERT_WITH_LOG(factory, std::invalid_argument,
+                              "format factory can't be null.");
+    std::shared_ptr<Format> format = factory();
+    EXCEPTION_ASSERT_WITH_LOG(format, std::invalid_argument,
+                              "format factory returned a null format.");
+
+    Entry entry;
+    entry.factory = factory;
+    entry.order   = d_count++;
+    computeSignature(format, samplers, entry);
+    d_index[format->getDataLength()].push_back(entry);
+}
+
+size_t FormatDetector::size() const
+{
+    return d_count;
+}
+
+void FormatDetector::computeSignature(std::shared_ptr<Format> format,
+                                      std::vector<Sampler> samplers, Entry &entry)
+{
+    const unsigned int length = format->getDataLength();
+    entry.mask.assign((length + 63) / 64, 0);
+    entry.value.assign(entry.mask.size(), 0);
+    entry.fixedBits = 0;
+
+    // Without a reliable sample for every value field, no bit can be
+    // considered fixed: the format then only matches on its length.
+    for (const auto &name : format->getValuesFieldList())
+    {
+        auto field = format->getFieldFromName(name);
+        if (std::dynamic_pointer_cast<NumberDataField>(field))
+        {
+            samplers.push_back({[name](Format &f, unsigned long long value) {
+                                    std::dynamic_pointer_cast<NumberDataField>(
+                                        f.getFieldFromName(name))
+                                        ->setValue(value);
+                                },
+                                field->getDataLength()});
+        }
+        else if (std::dynamic_pointer_cast<BinaryDataField>(field))
+        {
+            samplers.push_back({[name](Format &f, unsigned long long value) {
+                                    auto binary = std::dynamic_pointer_cast<BinaryDataField>(
+                                        f.getFieldFromName(name));
+                                    binary->setValue(
+                                        ByteVector((binary->getDataLength() + 7) / 8,
+                                                   static_cast<unsigned char>(value)));
+                                },
+                                field->getDataLength()});
+        }
+        else
+            return;
+    }
+
+    auto setSample = [&format](const Sampler &sampler, unsigned long long value) {
+        try
+        {
+            sampler.setValue(*format, value & lowMask(sampler.length));
+            return true;
+        }
+        catch (std::exception &)
+        {
+            return false;
+        }
+    };
+
+    for (const auto &sampler : samplers)
+    {
+        if (!setSample(sampler, 0))
+            return;
+    }
+
+    std::vector<unsigned long long> base;
+    if (!encode(format, base))
+        return;
+
+    std::vector<unsigned long long> varying(base.size(), 0), sample;
+    for (const auto &sampler : samplers)
+    {
+        size_t samples = 0;
+        for (unsigned long long pattern : samplePatterns(sampler.length))
+        {
+            if (!setSample(sampler, pattern) || !encode(format, sample))
+                continue;
+            for (size_t i = 0; i < base.size(); ++i)
+            {
+                varying[i] |= sample[i] ^ base[i];
+            }
+            ++samples;
+        }
+        if (samples == 0 || !setSample(sampler, 0))
+            return;
+    }
+
+    for (size_t i = 0; i < base.size(); ++i)
+    {
+        entry.mask[i]  = ~varying[i] & lowMask(chunkLength(length, i));
+        entry.value[i] = base[i] & entry.mask[i];
+        entry.fixedBits +=
+            static_cast<unsigned int>(std::bitset<64>(entry.mask[i]).count());
+    }
+}
+
+std::vector<FormatCandidate> FormatDetector::detect(const ByteVector &data,
+                                                    unsigned int bitLength) const
+{
+    EXCEPTION_ASSERT_WITH_LOG(bitLength <= data.size() * 8, std::invalid_argument,
+                              "Credential data is too small for this bit length.");
+
+    BitsetStream bits;
+    bits.concat(data, 0, bitLength);
+    return detect(bits);
+}
+
+std::vector<FormatCandidate> FormatDetector::detect(const BitsetStream &data) const
+{
+    std::vector<FormatCandidate> candidates;
+    auto it = d_index.find(data.getBitSize());
+    if (it == d_index.end())
+        return candidates;
+
+    const std::vector<unsigned long long> chunks = toChunks(data);
+    const ByteVector linearData                  = data.getData();
+    std::vector<size_t> orders;
+    for (const auto &entry : it->second)
+    {
+        bool match = true;
+        for (size_t i = 0; match && i < chunks.size(); ++i)
+        {
+            match = (chunks[i] & entry.mask[i]) == entry.value[i];
+        }
+        if (!match)
+            continue;
+
+        FormatCandidate candidate;
+        candidate.format    = entry.factory();
+        candidate.fixedBits = entry.fixedBits;
+        candidate.valid     = true;
+        try
+        {
+            candidate.format->setLinearData(linearData);
+        }
+        catch (std::exception &)
+        {
+            candidate.valid = false;
+        }
+        candidates.push_back(candidate);
+        orders.push_back(entry.order);
+    }
+
+    std::vector<size_t> ranks(candidates.size());
+    for (size_t i = 0; i < ranks.size(); ++i)
+        ranks[i] = i;
+    std::sort(ranks.begin(), ranks.end(), [&](size_t lhs, size_t rhs) {
+        if (candidates[lhs].valid != candidates[rhs].valid)
+            return candidates[lhs].valid;
+        if (candidates[lhs].fixedBits != candidates[rhs].fixedBits)
+            return candidates[lhs].fixedBits > candidates[rhs].fixedBits;
+        return orders[lhs] < orders[rhs];
+    });
+
+    std::vector<FormatCandidate> ranked;
+    for (size_t rank : ranks)
+    {
+        ranked.push_back(candidates[rank]);
+    }
+    return ranked;
+}
+}
@@ -58,11 +58,12 @@ unsigned char StaticFormat::calculateParity(const BitsetStream &data,
     EXCEPTION_ASSERT_WITH_LOG(data.getBitSize() > start, std::out_of_range,
                               "Bit position is out of bounds.");
 
-    unsigned char parity = 0x00;
+    const ByteVector bytes = data.getData();
+    unsigned char parity   = 0x00;
     for (size_t i = start; i < (start + parityLengthBits) && i < (data.getByteSize() * 8);
          i++)
     {
-        parity = (parity & 0x01) ^ ((data.getData()[i / 8] >> (7 - (i % 8))) & 0x01);
+        parity = (parity & 0x01) ^ ((bytes[i / 8] >> (7 - (i % 8))) & 0x01);
     }
 
     switch (parityType)
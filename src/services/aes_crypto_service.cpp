@@ -1,13 +1,111 @@
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <logicalaccess/myexception.hpp>
 #include <logicalaccess/plugins/crypto/aes_helper.hpp>
+#include <logicalaccess/plugins/crypto/aes_cipher.hpp>
+#include <logicalaccess/plugins/crypto/cmac.hpp>
 #include <logicalaccess/cards/pkcskeystorage.hpp>
 #include <logicalaccess/dynlibrary/librarymanager.hpp>
 #include "logicalaccess/services/aes_crypto_service.hpp"
 #include "logicalaccess/key.hpp"
 
+#include <map>
+
 namespace logicalaccess
 {
+namespace
+{
+const size_t AES_BLOCK_SIZE = 16;
+
+// Pad `data` and XOR its last block with the K1 or K2 subkey derived from
+// L = E(K, 0), as the CMAC algorithm does before the CBC encryption.
+ByteVector cmac_prepare(const ByteVector &data, const ByteVector &L,
+                        unsigned int padding_size, bool forceK2Use)
+{
+    const unsigned char Rb = 0x87;
+    ByteVector K1 = openssl::CMACCrypto::shift_string(L, (L[0] & 0x80) ? Rb : 0x00);
+    ByteVector K2 = openssl::CMACCrypto::shift_string(K1, (K1[0] & 0x80) ? Rb : 0x00);
+
+    if (padding_size == 0)
+        padding_size = AES_BLOCK_SIZE;
+    size_t pad = (padding_size - (data.size() % padding_size)) % padding_size;
+    if (data.empty())
+        pad = padding_size;
+
+    ByteVector padded = data;
+    if (pad > 0)
+    {
+        padded.push_back(0x80);
+        padded.resize(padded.size() + pad - 1, 0x00);
+    }
+
+    const ByteVector &subkey = (pad == 0 && !forceK2Use) ? K1 : K2;
+    for (size_t i = 0; i < subkey.size(); ++i)
+    {
+        padded[padded.size() - subkey.size() + i] ^= subkey[i];
+    }
+    return padded;
+}
+}
+
+std::vector<ByteVector>
+IAESCryptoService::aes_encrypt(const std::vector<AESOperation> &operations)
+{
+    std::vector<ByteVector> results;
+    results.reserve(operations.size());
+    for (const auto &op : operations)
+    {
+        results.push_back(aes_encrypt(op.data, op.iv, op.key));
+    }
+    return results;
+}
+
+std::vector<ByteVector>
+IAESCryptoService::aes_decrypt(const std::vector<AESOperation> &operations)
+{
+    std::vector<ByteVector> results;
+    results.reserve(operations.size());
+    for (const auto &op : operations)
+    {
+        results.push_back(aes_decrypt(op.data, op.iv, op.key));
+    }
+    return results;
+}
+
+std::vector<ByteVector>
+IAESCryptoService::aes_cmac(const std::vector<AESOperation> &operations,
+                            unsigned int padding_size, bool forceK2Use)
+{
+    std::vector<AESOperation> subkeys;
+    subkeys.reserve(operations.size());
+    for (const auto &op : operations)
+    {
+        subkeys.push_back(
+            {ByteVector(AES_BLOCK_SIZE, 0x00), ByteVector(AES_BLOCK_SIZE, 0x00), op.key});
+    }
+    std::vector<ByteVector> L = aes_encrypt(subkeys);
+
+    std::vector<AESOperation> macs;
+    macs.reserve(operations.size());
+    for (size_t i = 0; i < operations.size(); ++i)
+    {
+        EXCEPTION_ASSERT_WITH_LOG(L[i].size() == AES_BLOCK_SIZE,
+                                  LibLogicalAccessException,
+                                  "Invalid CMAC subkey length.");
+        macs.push_back({cmac_prepare(operations[i].data, L[i], padding_size, forceK2Use),
+                        operations[i].iv.empty() ? ByteVector(AES_BLOCK_SIZE, 0x00)
+                                                 : operations[i].iv,
+                        operations[i].key});
+    }
+
+    std::vector<ByteVector> results = aes_encrypt(macs);
+    for (auto &mac : results)
+    {
+        if (mac.size() > AES_BLOCK_SIZE)
+            mac.erase(mac.begin(), mac.end() - AES_BLOCK_SIZE);
+    }
+    return results;
+}
+
 
 ByteVector AESCryptoService::aes_encrypt(const ByteVector &data, const ByteVector &iv,
                                          std::shared_ptr<Key> key)
@@ -72,4 +170,118 @@ ByteVector AESCryptoService::adjust_iv(const ByteVector &iv)
 
     return iv;
 }
+
+std::vector<ByteVector>
+AESCryptoService::aes_encrypt(const std::vector<AESOperation> &operations)
+{
+    return perform_batch(
+        operations,
+        [this](const AESOperation &op) {
+            return in_memory(op.data, adjust_iv(op.iv), op.key, true);
+        },
+        [](IAESCryptoService &service, const std::vector<AESOperation> &ops) {
+            return service.aes_encrypt(ops);
+        });
+}
+
+std::vector<ByteVector>
+AESCryptoService::aes_decrypt(const std::vector<AESOperation> &operations)
+{
+    return perform_batch(
+        operations,
+        [this](const AESOperation &op) {
+            return in_memory(op.data, adjust_iv(op.iv), op.key, false);
+        },
+        [](IAESCryptoService &service, const std::vector<AESOperation> &ops) {
+            return service.aes_decrypt(ops);
+        });
+}
+
+ByteVector AESCryptoService::aes_cmac(const ByteVector &data, std::shared_ptr<Key> key,
+                                      const ByteVector &iv, unsigned int padding_size,
+                                      bool forceK2Use)
+{
+    return aes_cmac(std::vector<AESOperation>{{data, iv, key}}, padding_size, forceK2Use)
+        .at(0);
+}
+
+std::vector<ByteVector>
+AESCryptoService::aes_cmac(const std::vector<AESOperation> &operations,
+                           unsigned int padding_size, bool forceK2Use)
+{
+    return perform_batch(
+        operations,
+        [padding_size, forceK2Use](const AESOperation &op) {
+            EXCEPTION_ASSERT_WITH_LOG(op.key->getData().size() == 16,
+                                      LibLogicalAccessException,
+                                      "Key length is not valid for AES crypto");
+            return openssl::CMACCrypto::cmac(op.key->getData(),
+                                             std::make_shared<openssl::AESCipher>(),
+                                             op.data, op.iv, padding_size, forceK2Use);
+        },
+        [padding_size, forceK2Use](IAESCryptoService &service,
+                                   const std::vector<AESOperation> &ops) {
+            return service.aes_cmac(ops, padding_size, forceK2Use);
+        });
+}
+
+std::vector<ByteVector> AESCryptoService::perform_batch(
+    const std::vector<AESOperation> &operations,
+    const std::function<ByteVector(const AESOperation &)> &in_memory_op,
+    const std::function<std::vector<ByteVector>(
+        IAESCryptoService &, const std::vector<AESOperation> &)> &pkcs_op)
+{
+    std::vector<ByteVector> results(operations.size());
+
+    // Operations of keys stored in PKCS tokens, by PKCS library.
+    std::map<std::string, std::vector<size_t>> pkcs_operations;
+    for (size_t i = 0; i < operations.size(); ++i)
+    {
+        const AESOperation &op = operations[i];
+        EXCEPTION_ASSERT_WITH_LOG(op.key, LibLogicalAccessException, "No key.");
+        switch (op.key->getKeyStorage()->getType())
+        {
+        case KST_COMPUTER_MEMORY: results[i] = in_memory_op(op); break;
+
+        case KST_PKCS:
+        {
+            std::shared_ptr<PKCSKeyStorage> storage =
+                std::dynamic_pointer_cast<PKCSKeyStorage>(op.key->getKeyStorage());
+            EXCEPTION_ASSERT_WITH_LOG(storage, LibLogicalAccessException,
+                                      "No key storage.");
+            pkcs_operations[storage->get_pkcs_shared_object_path()].push_back(i);
+            break;
+        }
+
+        default:
+            throw LibLogicalAccessException("Key type not supported in AESCryptoService");
+        }
+    }
+
+    for (const auto &library : pkcs_operations)
+    {
+        std::vector<AESOperation> batch;
+        batch.reserve(library.second.size());
+        for (size_t i : library.second)
+        {
+            batch.push_back(operations[i]);
+            batch.back().iv = adjust_iv(batch.back().iv);
+        }
+
+        std::shared_ptr<PKCSKeyStorage> storage =
+            std::dynamic_pointer_cast<PKCSKeyStorage>(batch.front().key->getKeyStorage());
+        auto pkcs_crypto_service = LibraryManager::getInstance()->getPKCSAESCrypto(
+            storage->get_pkcs_shared_object_path(), storage->get_pkcs_properties());
+
+        std::vector<ByteVector> batch_results = pkcs_op(*pkcs_crypto_service, batch);
+        EXCEPTION_ASSERT_WITH_LOG(batch_results.size() == batch.size(),
+                                  LibLogicalAccessException,
+                                  "Invalid PKCS batch result.");
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            results[library.second[i]] = std::move(batch_results[i]);
+        }
+    }
+    return results;
+}
 }
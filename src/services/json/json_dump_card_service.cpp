@@ -15,8 +15,11 @@
 #include <logicalaccess/services/accesscontrol/accesscontrolcardservice.hpp>
 #include <logicalaccess/utils.hpp>
 #include <logicalaccess/services/accesscontrol/encodings/bcdnibbledatatype.hpp>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
 #include "logicalaccess/services/json/json_dump_card_service.hpp"
+#include "logicalaccess/services/json/json_writer.hpp"
 #include "nlohmann/json.hpp"
+#include <algorithm>
 
 namespace logicalaccess
 {
@@ -145,41 +148,56 @@ void JsonDumpCardService::extract_keys(const nlohmann::json &json)
 }
 
 // for a single file / format read.
-nlohmann::json result_to_json(const std::shared_ptr<logicalaccess::Format> &format)
+void write_format(JsonWriter &writer, const std::shared_ptr<Format> &format)
 {
-    nlohmann::json json_result;
+    writer.startObject();
     for (const auto &field : format->getFieldList())
     {
         if (std::dynamic_pointer_cast<logicalaccess::NumberDataField>(field))
         {
             auto ndf = std::dynamic_pointer_cast<logicalaccess::NumberDataField>(field);
-            json_result[field->getName()]["type"]         = "NUMBER";
-            json_result[field->getName()]["value"]        = ndf->getValue();
-            json_result[field->getName()]["isIdentifier"] = ndf->getIsIdentifier();
+            writer.key(field->getName());
+            writer.startObject();
+            writer.key("type");
+            writer.value("NUMBER");
+            writer.key("value");
+            writer.value(static_cast<uint64_t>(ndf->getValue()));
+            writer.key("isIdentifier");
+            writer.value(ndf->getIsIdentifier());
+            writer.endObject();
         }
         else if (std::dynamic_pointer_cast<logicalaccess::StringDataField>(field))
         {
             auto sdf = std::dynamic_pointer_cast<logicalaccess::StringDataField>(field);
-            json_result[field->getName()]["type"] = "STRING";
-            auto str_value                        = sdf->getValue();
+            auto str_value = sdf->getValue();
             str_value.erase(std::remove(str_value.begin(), str_value.end(), 0),
                             str_value.end());
-            json_result[field->getName()]["value"]        = str_value;
-            json_result[field->getName()]["isIdentifier"] = sdf->getIsIdentifier();
+            writer.key(field->getName());
+            writer.startObject();
+            writer.key("type");
+            writer.value("STRING");
+            writer.key("value");
+            writer.value(str_value);
+            writer.key("isIdentifier");
+            writer.value(sdf->getIsIdentifier());
+            writer.endObject();
         }
         else if (std::dynamic_pointer_cast<logicalaccess::BinaryDataField>(field))
         {
-            auto bdf = std::dynamic_pointer_cast<logicalaccess::BinaryDataField>(field);
-            json_result[field->getName()]["type"] = "BINARY";
-            auto data                             = bdf->getValue();
-
-            std::string dataString = base64_encode(data.data(), static_cast<unsigned int>(data.size()));
-            json_result[field->getName()]["value"]        = dataString;
-            json_result[field->getName()]["isIdentifier"] = bdf->getIsIdentifier();
+            auto bdf  = std::dynamic_pointer_cast<logicalaccess::BinaryDataField>(field);
+            auto data = bdf->getValue();
+            writer.key(field->getName());
+            writer.startObject();
+            writer.key("type");
+            writer.value("BINARY");
+            writer.key("value");
+            writer.value(BufferHelper::toBase64(data));
+            writer.key("isIdentifier");
+            writer.value(bdf->getIsIdentifier());
+            writer.endObject();
         }
     }
-
-    return json_result;
+    writer.endObject();
 }
 
 void JsonDumpCardService::configure(const std::string &json_template)
@@ -193,72 +211,261 @@ void JsonDumpCardService::configure(const std::string &json_template)
     configured_ = true;
 }
 
-std::string JsonDumpCardService::dump()
+bool JsonDumpCardService::get_file_location(const std::shared_ptr<Location> &,
+                                            std::shared_ptr<Location> &, size_t &)
 {
-    if (!configured_)
-        throw LibLogicalAccessException("Please configure() the service first.");
+    return false;
+}
 
-    // Now we rely on AccessControl service to read each format.
-    nlohmann::json json_result = {};
-    auto acs                   = getChip()->getService<AccessControlCardService>();
+size_t JsonDumpCardService::get_file_size(const std::shared_ptr<Location> &,
+                                          const std::shared_ptr<AccessInfo> &)
+{
+    return 0;
+}
 
-    // Extract CSN.
-    json_result["ADDITIONAL_DATA"]                = {};
-    json_result["ADDITIONAL_DATA"]["CSN"]["type"] = "STRING";
-    json_result["ADDITIONAL_DATA"]["CSN"]["value"] =
-        logicalaccess::BufferHelper::getHex(getChip()->getChipIdentifier());
+bool JsonDumpCardService::reads_to_end(const std::shared_ptr<Location> &)
+{
+    return false;
+}
+
+namespace
+{
+bool same_access_info(const std::shared_ptr<AccessInfo> &a,
+                      const std::shared_ptr<AccessInfo> &b)
+{
+    if (!a || !b)
+        return a == b;
+    return *a == *b;
+}
+
+size_t get_format_size(const std::shared_ptr<Format> &format)
+{
+    return (format->getDataLength() + 7) / 8;
+}
+
+// Same copy as AccessControlCardService::readFormat(), so that the configured
+// format is left untouched.
+std::shared_ptr<Format> decode_format(const std::shared_ptr<Format> &format,
+                                      const ByteVector &data, size_t offset)
+{
+    std::shared_ptr<Format> result = Format::getByFormatType(format->getType());
+    result->unSerialize(format->serialize(), "");
+    const unsigned char *begin = data.data() + offset;
+    result->setLinearData(ByteVector(begin, begin + get_format_size(format)));
+    return result;
+}
+}
 
+std::vector<JsonDumpCardService::PlannedRead> JsonDumpCardService::plan_reads()
+{
+    std::vector<PlannedRead> reads;
     for (const auto &format_info : format_infos_)
     {
-        if (!format_info.second->getFormat()->isRepeatable())
+        PlannedFormat planned;
+        planned.name        = format_info.first;
+        planned.format_info = format_info.second;
+        planned.offset      = 0;
+
+        std::shared_ptr<Location> file_location;
+        if (get_format_size(format_info.second->getFormat()) == 0 ||
+            !get_file_location(format_info.second->getLocation(), file_location,
+                               planned.offset))
         {
-            auto result = acs->readFormat(format_info.second->getFormat(),
-                                          format_info.second->getLocation(),
-                                          format_info.second->getAiToUse());
+            file_location.reset();
+        }
 
-            json_result[format_info.first] = result_to_json(result);
+        auto read = reads.end();
+        if (file_location)
+        {
+            read = std::find_if(reads.begin(), reads.end(), [&](const PlannedRead &r) {
+                return r.location && *r.location == *file_location &&
+                       same_access_info(r.ai, format_info.second->getAiToUse());
+            });
+        }
+        if (read == reads.end())
+        {
+            PlannedRead new_read;
+            new_read.location = file_location;
+            new_read.ai       = format_info.second->getAiToUse();
+            reads.push_back(new_read);
+            read = reads.end() - 1;
+        }
+        read->formats.push_back(planned);
+    }
+    return reads;
+}
+
+bool JsonDumpCardService::read_file(const PlannedRead &read, JsonWriter &writer)
+{
+    auto storage = getChip()->getService<StorageCardService>();
+    if (!read.location || !storage)
+        return false;
+
+    size_t length = 0;
+    bool repeated = false;
+    for (const auto &planned : read.formats)
+    {
+        auto format = planned.format_info->getFormat();
+        if (format->isRepeatable())
+            repeated = true;
+        length = std::max(length, planned.offset + get_format_size(format));
+    }
+    // The length to read, 0 for the whole file.
+    size_t read_length = length;
+    if (repeated)
+    {
+        if (reads_to_end(read.location))
+        {
+            read_length = 0;
         }
         else
         {
-            json_result[format_info.first] = nlohmann::json::array();
-            while (true)
+            size_t file_size = get_file_size(read.location, read.ai);
+            if (file_size == 0)
+                return false;
+            length      = std::max(length, file_size);
+            read_length = length;
+        }
+    }
+
+    ByteVector data;
+    try
+    {
+        data = storage->readData(read.location, read.ai, read_length, CB_AUTOSWITCHAREA);
+    }
+    catch (const std::exception &e)
+    {
+        LOG(LogLevel::WARNINGS) << "Cannot read the file at once, reading its formats "
+                                   "one by one: "
+                                << e.what();
+        return false;
+    }
+    if (data.size() < length || (read_length == 0 && data.empty()))
+        return false;
+
+    for (const auto &planned : read.formats)
+    {
+        auto format = planned.format_info->getFormat();
+        if (!format->isRepeatable())
+        {
+            writer.key(planned.name);
+            write_format(writer, decode_format(format, data, planned.offset));
+            continue;
+        }
+
+        writer.key(planned.name);
+        writer.startArray();
+        size_t record_size = get_format_size(format);
+        for (size_t offset = planned.offset; offset + record_size <= data.size();
+             offset += record_size)
+        {
+            auto result = decode_format(format, data, offset);
+            // We read only zeroes. We can assume that we read everything
+            // that was available.
+            if (BufferHelper::allZeroes(result->getLinearData()))
+                break;
+            write_format(writer, result);
+        }
+        writer.endArray();
+    }
+    return true;
+}
+
+void JsonDumpCardService::read_format(const std::string &name,
+                                      const std::shared_ptr<FormatInfos> &format_info,
+                                      JsonWriter &writer)
+{
+    auto acs = getChip()->getService<AccessControlCardService>();
+    if (!format_info->getFormat()->isRepeatable())
+    {
+        auto result =
+            acs->readFormat(format_info->getFormat(), format_info->getLocation(),
+                            format_info->getAiToUse());
+
+        writer.key(name);
+        write_format(writer, result);
+        return;
+    }
+
+    // Records are read at increasing offsets of a copy: the configured location
+    // is kept for the next dumps.
+    std::shared_ptr<Location> location = format_info->getLocation()->clone();
+    writer.key(name);
+    writer.startArray();
+    while (true)
+    {
+        try
+        {
+            auto result = acs->readFormat(format_info->getFormat(), location,
+                                          format_info->getAiToUse());
+            if (BufferHelper::allZeroes(result->getLinearData()))
             {
-                try
-                {
-                    auto result      = acs->readFormat(format_info.second->getFormat(),
-                                                  format_info.second->getLocation(),
-                                                  format_info.second->getAiToUse());
-                    bool full_zeroes = true;
-                    for (const auto &b : result->getLinearData())
-                    {
-                        if (b != 0x00)
-                        {
-                            full_zeroes = false;
-                            break;
-                        }
-                    }
-                    if (full_zeroes)
-                    {
-                        // We read only zeroes. We can assume that we read everything
-                        // that was available.
-                        break;
-                    }
-
-                    json_result[format_info.first].push_back(result_to_json(result));
-                    // Now increment location, and try again.
-                    assert(format_info.second->getFormat()->getDataLength() % 8 == 0);
-                    format_info.second->getLocation()->incrementOffset(
-                        format_info.second->getFormat()->getDataLength() / 8);
-                }
-                catch (const std::exception&)
-                {
-                    // todo: handle this better.
-                    // For now we assume failure means we are done reading.
-                    break;
-                }
+                // We read only zeroes. We can assume that we read everything
+                // that was available.
+                break;
             }
+
+            write_format(writer, result);
+            // Now increment location, and try again.
+            assert(format_info->getFormat()->getDataLength() % 8 == 0);
+            location->incrementOffset(
+                static_cast<int>(format_info->getFormat()->getDataLength() / 8));
+        }
+        catch (const std::exception &)
+        {
+            // todo: handle this better.
+            // For now we assume failure means we are done reading.
+            break;
         }
     }
-    return json_result.dump(4);
+    writer.endArray();
+}
+
+std::string JsonDumpCardService::dump()
+{
+    std::ostringstream out;
+    dump(out);
+    // Keep the indented output, with sorted keys, of the previous versions.
+    return nlohmann::json::parse(out.str()).dump(4);
+}
+
+void JsonDumpCardService::dump(std::ostream &out)
+{
+    JsonWriter writer(out);
+    dump(writer);
+}
+
+void JsonDumpCardService::dump(JsonWriter &writer)
+{
+    if (!configured_)
+        throw LibLogicalAccessException("Please configure() the service first.");
+
+    writer.startObject();
+
+    // Extract CSN.
+    writer.key("ADDITIONAL_DATA");
+    writer.startObject();
+    writer.key("CSN");
+    writer.startObject();
+    writer.key("type");
+    writer.value("STRING");
+    writer.key("value");
+    writer.value(logicalaccess::BufferHelper::getHex(getChip()->getChipIdentifier()));
+    writer.endObject();
+    writer.endObject();
+
+    // Read each file once, with a single authentication, and decode all its
+    // formats from the data. Fall back to the AccessControl service to read
+    // formats one by one when a file cannot be read at once.
+    for (const auto &read : plan_reads())
+    {
+        if (read_file(read, writer))
+            continue;
+
+        for (const auto &planned : read.formats)
+            read_format(planned.name, planned.format_info, writer);
+    }
+
+    writer.endObject();
 }
 }
@@ -0,0 +1,180 @@
+#include <logicalaccess/services/json/json_writer.hpp>
+
+namespace logicalaccess
+{
+namespace
+{
+/**
+ * Length of the valid UTF-8 sequence starting with a non-ASCII byte, 0 if it is
+ * invalid (truncated, overlong, surrogate or above U+10FFFF).
+ */
+size_t utf8SequenceLength(const std::string &str, size_t pos)
+{
+    unsigned char c      = static_cast<unsigned char>(str[pos]);
+    unsigned char second = 0x80, secondMax = 0xbf;
+    size_t length;
+    if (c >= 0xc2 && c <= 0xdf)
+    {
+        length = 2;
+    }
+    else if (c >= 0xe0 && c <= 0xef)
+    {
+        length = 3;
+        if (c == 0xe0)
+            second = 0xa0;
+        else if (c == 0xed)
+            secondMax = 0x9f;
+    }
+    else if (c >= 0xf0 && c <= 0xf4)
+    {
+        length = 4;
+        if (c == 0xf0)
+            second = 0x90;
+        else if (c == 0xf4)
+            secondMax = 0x8f;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (pos + length > str.size())
+        return 0;
+    for (size_t i = 1; i < length; ++i)
+    {
+        unsigned char next = static_cast<unsigned char>(str[pos + i]);
+        if (next < (i == 1 ? second : 0x80) || next > (i == 1 ? secondMax : 0xbf))
+            return 0;
+    }
+    return length;
+}
+}
+
+JsonWriter::JsonWriter(std::ostream &out)
+    : d_out(out)
+    , d_afterKey(false)
+{
+}
+
+void JsonWriter::startObject()
+{
+    separate();
+    d_out.put('{');
+    d_empty.push_back(true);
+}
+
+void JsonWriter::endObject()
+{
+    d_out.put('}');
+    d_empty.pop_back();
+}
+
+void JsonWriter::startArray()
+{
+    separate();
+    d_out.put('[');
+    d_empty.push_back(true);
+}
+
+void JsonWriter::endArray()
+{
+    d_out.put(']');
+    d_empty.pop_back();
+}
+
+void JsonWriter::key(const std::string &name)
+{
+    separate();
+    writeString(name);
+    d_out.put(':');
+    d_afterKey = true;
+}
+
+void JsonWriter::value(const std::string &str)
+{
+    separate();
+    writeString(str);
+}
+
+void JsonWriter::value(const char *str)
+{
+    value(std::string(str));
+}
+
+void JsonWriter::value(uint64_t number)
+{
+    separate();
+    d_out << number;
+}
+
+void JsonWriter::value(bool boolean)
+{
+    separate();
+    d_out << (boolean ? "true" : "false");
+}
+
+void JsonWriter::separate()
+{
+    if (d_afterKey)
+    {
+        d_afterKey = false;
+        return;
+    }
+    if (d_empty.empty())
+        return;
+
+    if (!d_empty.back())
+        d_out.put(',');
+    d_empty.back() = false;
+}
+
+void JsonWriter::writeString(const std::string &str)
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    d_out.put('"');
+    size_t start = 0;
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        if (c >= 0x80)
+        {
+            size_t length = utf8SequenceLength(str, i);
+            if (length > 0)
+            {
+                i += length - 1;
+                continue;
+            }
+
+            // Invalid UTF-8 is replaced by U+FFFD, byte per byte, so that the
+            // output stays valid JSON.
+            d_out.write(str.data() + start, static_cast<std::streamsize>(i - start));
+            start = i + 1;
+            d_out << "\xef\xbf\xbd";
+            continue;
+        }
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        // Write the plain characters at once, then the escaped one.
+        d_out.write(str.data() + start, static_cast<std::streamsize>(i - start));
+        start = i + 1;
+        d_out.put('\\');
+        switch (c)
+        {
+        case '"': d_out.put('"'); break;
+        case '\\': d_out.put('\\'); break;
+        case '\b': d_out.put('b'); break;
+        case '\f': d_out.put('f'); break;
+        case '\n': d_out.put('n'); break;
+        case '\r': d_out.put('r'); break;
+        case '\t': d_out.put('t'); break;
+        default:
+            d_out << "u00" << HEX_DIGITS[c >> 4] << HEX_DIGITS[c & 0x0f];
+            break;
+        }
+    }
+    d_out.write(str.data() + start, static_cast<std::streamsize>(str.size() - start));
+    d_out.put('"');
+}
+}
@@ -4,6 +4,8 @@
  * \brief Xml Serializable.
  */
 
+#include <algorithm>
+#include <cctype>
 #include <string>
 #include <vector>
 #include <boost/property_tree/ptree.hpp>
@@ -11,6 +13,8 @@
 #include <logicalaccess/plugins/llacommon/logs.hpp>
 #include <logicalaccess/myexception.hpp>
 #include <logicalaccess/xmlserializable.hpp>
+#include <logicalaccess/compiledconfiguration.hpp>
+#include <logicalaccess/bufferhelper.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
 namespace logicalaccess
@@ -41,13 +45,19 @@ unsigned long long XmlSerializable::atoull(const std::string &str)
 ByteVector XmlSerializable::formatHexString(std::string hexstr)
 {
     size_t buflen = hexstr.size() / 2;
-    if (hexstr.size() % 2 == 0 && hexstr.size() > 2)
+    if (hexstr.size() % 2 == 0)
     {
-        for (unsigned int i = 2; i <= hexstr.size() - 2; i += 2)
+        // Digit pairs: a string with any other character is not decoded.
+        if (std::find_if(hexstr.begin(), hexstr.end(), [](char c) {
+                return !std::isxdigit(static_cast<unsigned char>(c));
+            }) != hexstr.end())
         {
-            hexstr.insert(i, " ");
-            i++;
+            return ByteVector();
         }
+
+        ByteVector buf(buflen);
+        BufferHelper::hexDecode(hexstr.data(), hexstr.size(), buf.data());
+        return buf;
     }
 
     ByteVector buf;
@@ -93,6 +103,29 @@ void XmlSerializable::unSerializeFromFile(const std::string &filename)
     unSerialize(ifs, "");
 }
 
+void XmlSerializable::serializeToCompiledFile(const std::string &filename)
+{
+    boost::property_tree::ptree pt;
+    serialize(pt);
+    CompiledConfiguration::compileToFile(pt, filename);
+}
+
+void XmlSerializable::unSerialize(const CompiledConfiguration &config,
+                                  const std::string &rootNode)
+{
+    // Only the object sub tree is rebuilt from the node table.
+    boost::property_tree::ptree node;
+    EXCEPTION_ASSERT_WITH_LOG(config.toPtree(rootNode + getDefaultXmlNodeName(), node),
+                              LibLogicalAccessException,
+                              "Node not found in the compiled configuration.");
+    unSerialize(node);
+}
+
+void XmlSerializable::unSerializeFromCompiledFile(const std::string &filename)
+{
+    unSerialize(*CompiledConfiguration::fromFile(filename), "");
+}
+
 std::string XmlSerializable::removeXmlDeclaration(const std::string &xmlstring)
 {
     std::istringstream iss(xmlstring);
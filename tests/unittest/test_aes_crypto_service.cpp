@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/cards/aes128key.hpp>
+#include <logicalaccess/plugins/crypto/aes_helper.hpp>
+#include <logicalaccess/services/aes_crypto_service.hpp>
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * A backend that only implements the single operations, and counts the
+ * batches it receives.
+ */
+class CountingAESCryptoService : public IAESCryptoService
+{
+  public:
+    using IAESCryptoService::aes_encrypt;
+    using IAESCryptoService::aes_decrypt;
+
+    ByteVector aes_encrypt(const ByteVector &data, const ByteVector &iv,
+                           std::shared_ptr<Key> key) override
+    {
+        return AESHelper::AESEncrypt(data, key->getData(), iv);
+    }
+
+    ByteVector aes_decrypt(const ByteVector &data, const ByteVector &iv,
+                           std::shared_ptr<Key> key) override
+    {
+        return AESHelper::AESDecrypt(data, key->getData(), iv);
+    }
+
+    std::vector<ByteVector> aes_encrypt(const std::vector<AESOperation> &ops) override
+    {
+        ++batches;
+        return IAESCryptoService::aes_encrypt(ops);
+    }
+
+    int batches = 0;
+};
+}
+
+// RFC 4493 test vectors.
+TEST(test_aes_crypto_service, cmac)
+{
+    auto key = std::make_shared<AES128Key>(
+        BufferHelper::fromHexString("2b7e151628aed2a6abf7158809cf4f3c"));
+    AESCryptoService service;
+
+    ASSERT_EQ(BufferHelper::fromHexString("bb1d6929e95937287fa37d129b756746"),
+              service.aes_cmac({}, key));
+    ASSERT_EQ(BufferHelper::fromHexString("070a16b46b4d4144f79bdd9dd04a287c"),
+              service.aes_cmac(
+                  BufferHelper::fromHexString("6bc1bee22e409f96e93d7e117393172a"), key));
+}
+
+TEST(test_aes_crypto_service, generic_cmac_batch)
+{
+    auto key1 = std::make_shared<AES128Key>(
+        BufferHelper::fromHexString("2b7e151628aed2a6abf7158809cf4f3c"));
+    auto key2 = std::make_shared<AES128Key>(
+        BufferHelper::fromHexString("00112233445566778899aabbccddeeff"));
+    std::vector<AESOperation> operations = {
+        {BufferHelper::fromHexString("01"), {}, key1},
+        {BufferHelper::fromHexString("0102030405060708090a0b0c0d0e0f10"), {}, key2},
+        {BufferHelper::fromHexString("0102030405060708090a0b0c0d0e0f10"
+                                     "0102030405060708090a0b0c0d0e0f10"),
+         {},
+         key1}};
+
+    AESCryptoService service;
+    for (unsigned int padding_size : {0u, 32u})
+    {
+        for (bool forceK2Use : {false, true})
+        {
+            CountingAESCryptoService backend;
+            auto macs = backend.aes_cmac(operations, padding_size, forceK2Use);
+            ASSERT_EQ(2, backend.batches);
+            ASSERT_EQ(operations.size(), macs.size());
+            for (size_t i = 0; i < operations.size(); ++i)
+            {
+                ASSERT_EQ(service.aes_cmac(operations[i].data, operations[i].key, {},
+                                           padding_size, forceK2Use),
+                          macs[i]);
+            }
+        }
+    }
+}
+
+TEST(test_aes_crypto_service, batch)
+{
+    auto key = std::make_shared<AES128Key>(
+        BufferHelper::fromHexString("2b7e151628aed2a6abf7158809cf4f3c"));
+    ByteVector data = BufferHelper::fromHexString("6bc1bee22e409f96e93d7e117393172a");
+
+    AESCryptoService service;
+    auto encrypted = service.aes_encrypt({{data, {}, key}, {data, data, key}});
+    ASSERT_EQ(2u, encrypted.size());
+    ASSERT_EQ(service.aes_encrypt(data, {}, key), encrypted[0]);
+    ASSERT_EQ(service.aes_encrypt(data, data, key), encrypted[1]);
+
+    auto decrypted =
+        service.aes_decrypt({{encrypted[0], {}, key}, {encrypted[1], data, key}});
+    ASSERT_EQ(data, decrypted[0]);
+    ASSERT_EQ(data, decrypted[1]);
+}
@@ -293,3 +293,98 @@ TEST(bitset_tests, append_x_bits)
     bs.append(0b11111110, 0, 7);
     ASSERT_EQ(0b11111111, bs.getData().at(0));
 }
+
+TEST(bitset_tests, append_value)
+{
+    BitsetStream bs;
+
+    bs.appendValue(0x5, 3);
+    bs.appendValue(0x123456789ABCDEF0ULL, 64);
+    ASSERT_EQ(67, bs.getBitSize());
+    ASSERT_EQ(9, bs.getByteSize());
+    ASSERT_EQ(0x5, bs.extractValue(0, 3));
+    ASSERT_EQ(0x123456789ABCDEF0ULL, bs.extractValue(3, 64));
+    ASSERT_EQ(0x1234, bs.extractValue(3, 16));
+    ASSERT_THROW(bs.appendValue(0, 65), std::out_of_range);
+    ASSERT_THROW(bs.extractValue(4, 64), std::out_of_range);
+    ASSERT_THROW(bs.extractValue(0, 65), std::out_of_range);
+}
+
+TEST(bitset_tests, concat_across_words)
+{
+    std::vector<uint8_t> data;
+    for (unsigned int i = 0; i < 40; ++i)
+        data.push_back(static_cast<uint8_t>(i * 37 + 11));
+
+    BitsetStream reference;
+    for (unsigned int i = 3; i < 3 + 301; ++i)
+        reference.append(data[i / 8], i % 8, 1);
+
+    BitsetStream bs;
+    bs.concat(data, 3, 301);
+    ASSERT_EQ(reference.getData(), bs.getData());
+    ASSERT_EQ(reference.toString(), bs.toString());
+
+    BitsetStream raw;
+    raw.concat(data.data(), data.size(), 3, 301);
+    ASSERT_EQ(reference.getData(), raw.getData());
+
+    BitsetStream fromStream;
+    fromStream.append(0x01, 7, 1);
+    fromStream.concat(bs, 62, 130);
+    ASSERT_EQ(131, fromStream.getBitSize());
+    ASSERT_EQ("1" + reference.toString(62, 191), fromStream.toString());
+
+    ASSERT_EQ(bs.extract(62, 130).toString(), reference.toString(62, 191));
+    ASSERT_THROW(bs.extract(200, 102), std::out_of_range);
+    ASSERT_THROW(bs.concat(data.data(), data.size(), 300, 21), std::out_of_range);
+    ASSERT_THROW(bs.concat(nullptr, 0, 0, 1), std::invalid_argument);
+
+    uint8_t out[38];
+    ASSERT_EQ(38, bs.getData(out, sizeof(out)));
+    ASSERT_EQ(bs.getData(), std::vector<uint8_t>(out, out + sizeof(out)));
+    ASSERT_THROW(bs.getData(out, 37), std::out_of_range);
+}
+
+TEST(bitset_tests, write_and_insert_across_words)
+{
+    BitsetStream bs(0xAA, 20);
+    ASSERT_EQ(160, bs.getBitSize());
+
+    std::vector<uint8_t> data = {0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF};
+    bs.writeAt(60, data, 4, 68);
+    ASSERT_EQ("1010", bs.toString(56, 59));
+    ASSERT_EQ("1111000000001111", bs.toString(60, 75));
+    ASSERT_EQ("1010", bs.toString(128, 131));
+    ASSERT_THROW(bs.writeAt(150, data, 0, 16), std::out_of_range);
+
+    BitsetStream field;
+    field.appendValue(0x3FF, 10);
+    bs.writeAt(0, field, 2, 8);
+    ASSERT_EQ("11111111", bs.toString(0, 7));
+
+    std::string tail = bs.toString(63, bs.getBitSize() - 1);
+    bs.insert(63, data, 0, 12);
+    ASSERT_EQ(172, bs.getBitSize());
+    ASSERT_EQ("111111110000", bs.toString(63, 74));
+    ASSERT_EQ(tail, bs.toString(75, bs.getBitSize() - 1));
+
+    bs.insert(1, field, 0, 3);
+    ASSERT_EQ(175, bs.getBitSize());
+    ASSERT_EQ("1111", bs.toString(0, 3));
+    ASSERT_EQ(0xA, bs.extractValue(171, 4));
+}
+
+TEST(bitset_tests, all_bits)
+{
+    BitsetStream bs;
+    ASSERT_TRUE(bs.all());
+    bs.append(0xFF, 0, 5);
+    ASSERT_TRUE(bs.all());
+    bs.appendValue(~0ULL, 64);
+    ASSERT_TRUE(bs.all());
+    bs.append(0x00, 0, 1);
+    ASSERT_FALSE(bs.all());
+    ASSERT_TRUE(bs.any());
+    ASSERT_FALSE(bs.none());
+}
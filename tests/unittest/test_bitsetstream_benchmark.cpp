@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <stdint.h>
+#include <logicalaccess/utils.hpp>
+#include <logicalaccess/services/accesscontrol/formats/BitsetStream.hpp>
+
+using namespace logicalaccess;
+
+// Microbenchmarks comparing the bit range operations of BitsetStream with
+// the byte / bit at a time loops that formats used to rely on.
+// They only print timings and are built by the benchmarks target, not run by
+// ctest: correctness is covered by test_bitsetstream.
+
+namespace
+{
+const unsigned int ITERATIONS = 20000;
+
+std::vector<uint8_t> makeData(size_t size)
+{
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < size; ++i)
+        data.push_back(static_cast<uint8_t>(i * 37 + 11));
+    return data;
+}
+
+void report(const char *name, size_t legacy, size_t bulk)
+{
+    std::cout << name << ": bit by bit " << legacy << " us, range " << bulk << " us"
+              << std::endl;
+}
+}
+
+TEST(bitset_benchmark, concat)
+{
+    auto data = makeData(25);
+    BitsetStream legacy, bulk;
+
+    ElapsedTimeCounter legacyCounter;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+    {
+        legacy.clear();
+        for (unsigned int i = 3; i < 3 + 197; ++i)
+            legacy.append(data[i / 8], i % 8, 1);
+    }
+    size_t legacyTime = legacyCounter.elapsed_micro();
+
+    ElapsedTimeCounter bulkCounter;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+    {
+        bulk.clear();
+        bulk.concat(data, 3, 197);
+    }
+    size_t bulkTime = bulkCounter.elapsed_micro();
+
+    ASSERT_EQ(legacy.getData(), bulk.getData());
+    report("concat 197 bits", legacyTime, bulkTime);
+}
+
+TEST(bitset_benchmark, extract)
+{
+    BitsetStream stream;
+    stream.concat(makeData(25), 0, 200);
+    unsigned long long legacyValue = 0, bulkValue = 0;
+
+    ElapsedTimeCounter legacyCounter;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+    {
+        legacyValue = 0;
+        for (unsigned int i = 17; i < 17 + 48; ++i)
+            legacyValue = (legacyValue << 1) | (stream.test(i) ? 1 : 0);
+    }
+    size_t legacyTime = legacyCounter.elapsed_micro();
+
+    ElapsedTimeCounter bulkCounter;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+    {
+        bulkValue = stream.extractValue(17, 48);
+    }
+    size_t bulkTime = bulkCounter.elapsed_micro();
+
+    ASSERT_EQ(legacyValue, bulkValue);
+    report("extract 48 bits", legacyTime, bulkTime);
+}
+
+TEST(bitset_benchmark, write_at)
+{
+    auto data = makeData(16);
+    BitsetStream legacy(0x00, 32), bulk(0x00, 32);
+
+    ElapsedTimeCounter legacyCounter;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+    {
+        for (unsigned int i = 0; i < 125; ++i)
+            legacy.writeAt(5 + i, data[(i + 2) / 8], (i + 2) % 8, 1);
+    }
+    size_t legacyTime = legacyCounter.elapsed_micro();
+
+    ElapsedTimeCounter bulkCounter;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+    {
+        bulk.writeAt(5, data, 2, 125);
+    }
+    size_t bulkTime = bulkCounter.elapsed_micro();
+
+    ASSERT_EQ(legacy.getData(), bulk.getData());
+    report("writeAt 125 bits", legacyTime, bulkTime);
+}
+
+TEST(bitset_benchmark, insert)
+{
+    auto data = makeData(8);
+    BitsetStream base;
+    base.concat(makeData(32), 0, 250);
+    BitsetStream legacy, bulk;
+
+    ElapsedTimeCounter legacyCounter;
+    for (unsigned int it = 0; it < ITERATIONS / 10; ++it)
+    {
+        legacy = base;
+        for (unsigned int i = 0; i < 60; ++i)
+            legacy.insert(100 + i, data[(i + 1) / 8], (i + 1) % 8, 1);
+    }
+    size_t legacyTime = legacyCounter.elapsed_micro();
+
+    ElapsedTimeCounter bulkCounter;
+    for (unsigned int it = 0; it < ITERATIONS / 10; ++it)
+    {
+        bulk = base;
+        bulk.insert(100, data, 1, 60);
+    }
+    size_t bulkTime = bulkCounter.elapsed_micro();
+
+    ASSERT_EQ(legacy.getData(), bulk.getData());
+    report("insert 60 bits", legacyTime, bulkTime);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/bufferhelper.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/xmlserializable.hpp>
+
+using namespace logicalaccess;
+
+TEST(test_bufferhelper, test_hex)
+{
+    ASSERT_EQ("", BufferHelper::getHex(ByteVector()));
+    ASSERT_EQ("00017FA0FF",
+              BufferHelper::getHex(ByteVector({0x00, 0x01, 0x7f, 0xa0, 0xff})));
+    ASSERT_EQ("4142", BufferHelper::getHex(std::string("AB")));
+
+    ASSERT_EQ(ByteVector({0x00, 0x01, 0x7f, 0xa0, 0xff}),
+              BufferHelper::fromHexString("00017fA0FF"));
+    ASSERT_EQ(ByteVector({0x01, 0x02, 0x03}), BufferHelper::fromHexString("01 02 03"));
+    // An odd last digit is a byte on its own.
+    ASSERT_EQ(ByteVector({0x12, 0x03}), BufferHelper::fromHexString("123"));
+    ASSERT_EQ(ByteVector(), BufferHelper::fromHexString(""));
+
+    ByteVector all;
+    for (int i = 0; i < 256; ++i)
+        all.push_back(static_cast<uint8_t>(i));
+    ASSERT_EQ(all, BufferHelper::fromHexString(BufferHelper::getHex(all)));
+}
+
+TEST(test_bufferhelper, test_base64)
+{
+    // RFC 4648 test vectors.
+    const char *vectors[][2] = {{"", ""},
+                                {"f", "Zg=="},
+                                {"fo", "Zm8="},
+                                {"foo", "Zm9v"},
+                                {"foob", "Zm9vYg=="},
+                                {"fooba", "Zm9vYmE="},
+                                {"foobar", "Zm9vYmFy"}};
+    for (const auto &vector : vectors)
+    {
+        std::string plain(vector[0]);
+        ByteVector data(plain.begin(), plain.end());
+        ASSERT_EQ(vector[1], BufferHelper::toBase64(data));
+        ASSERT_EQ(data, BufferHelper::fromBase64(vector[1]));
+    }
+
+    ByteVector all;
+    for (int i = 0; i < 256; ++i)
+        all.push_back(static_cast<uint8_t>(255 - i));
+    ASSERT_EQ(all, BufferHelper::fromBase64(BufferHelper::toBase64(all)));
+
+    ASSERT_THROW(BufferHelper::fromBase64("Zm9"), std::invalid_argument);
+    ASSERT_THROW(BufferHelper::fromBase64("Zm9*"), LibLogicalAccessException);
+    ASSERT_THROW(BufferHelper::fromBase64("Zm=v"), LibLogicalAccessException);
+}
+
+TEST(test_bufferhelper, test_span_codecs)
+{
+    const uint8_t data[] = {0xde, 0xad, 0xbe, 0xef};
+    char hex[8];
+    ASSERT_EQ(8u, BufferHelper::hexEncode(data, sizeof(data), hex));
+    ASSERT_EQ("DEADBEEF", std::string(hex, 8));
+
+    uint8_t decoded[4];
+    ASSERT_EQ(4u, BufferHelper::hexDecode(hex, sizeof(hex), decoded));
+    ASSERT_EQ(0, memcmp(data, decoded, sizeof(data)));
+
+    char b64[8];
+    ASSERT_EQ(BufferHelper::getBase64EncodedSize(sizeof(data)),
+              BufferHelper::base64Encode(data, sizeof(data), b64));
+    ASSERT_EQ("3q2+7w==", std::string(b64, 8));
+    uint8_t b64decoded[6];
+    ASSERT_EQ(4u, BufferHelper::base64Decode(b64, sizeof(b64), b64decoded));
+    ASSERT_EQ(0, memcmp(data, b64decoded, sizeof(data)));
+}
+
+TEST(test_bufferhelper, test_format_hex_string)
+{
+    ASSERT_EQ(ByteVector({0x01, 0xab, 0xff}), XmlSerializable::formatHexString("01abFF"));
+    ASSERT_EQ(ByteVector({0x01}), XmlSerializable::formatHexString("01"));
+    ASSERT_EQ(ByteVector(), XmlSerializable::formatHexString("01xy"));
+    ASSERT_EQ(ByteVector(), XmlSerializable::formatHexString(""));
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/utils.hpp>
+#include <logicalaccess/bufferhelper.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace logicalaccess;
+
+// Microbenchmarks comparing the table driven hex and base 64 codecs of
+// BufferHelper with the stream based code they replaced.
+// They only print timings and are built by the benchmarks target, not run by
+// ctest: correctness is covered by test_bufferhelper.
+
+namespace
+{
+const unsigned int ITERATIONS = 20000;
+
+ByteVector makeData(size_t size)
+{
+    ByteVector data;
+    for (size_t i = 0; i < size; ++i)
+        data.push_back(static_cast<uint8_t>(i * 37 + 11));
+    return data;
+}
+
+void report(const char *name, size_t legacy, size_t table)
+{
+    std::cout << name << ": stream " << legacy << " us, table " << table << " us"
+              << std::endl;
+}
+
+std::string legacyGetHex(const ByteVector &buffer)
+{
+    std::ostringstream ss;
+    ss << std::hex << std::uppercase << std::setfill('0');
+    std::for_each(buffer.cbegin(), buffer.cend(),
+                  [&](int c) { ss << std::setw(2) << c; });
+    return ss.str();
+}
+
+ByteVector legacyFromHexString(const std::string &hexString)
+{
+    ByteVector data;
+    std::stringstream convertStream;
+    size_t offset = 0;
+    while (offset < hexString.length())
+    {
+        unsigned int buffer;
+        convertStream << std::hex << hexString.substr(offset, 2);
+        convertStream >> std::hex >> buffer;
+        data.push_back(static_cast<unsigned char>(buffer));
+        offset += 2;
+        convertStream.str(std::string());
+        convertStream.clear();
+    }
+    return data;
+}
+}
+
+TEST(bufferhelper_benchmark, hex)
+{
+    // A short APDU, as logged for every command.
+    ByteVector apdu = makeData(64);
+
+    std::string legacyHex, tableHex;
+    ElapsedTimeCounter legacyEncode;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+        legacyHex = legacyGetHex(apdu);
+    size_t legacyEncodeTime = legacyEncode.elapsed_micro();
+
+    ElapsedTimeCounter tableEncode;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+        tableHex = BufferHelper::getHex(apdu);
+    size_t tableEncodeTime = tableEncode.elapsed_micro();
+
+    ASSERT_EQ(legacyHex, tableHex);
+    report("getHex 64 bytes", legacyEncodeTime, tableEncodeTime);
+
+    ByteVector legacyData, tableData;
+    ElapsedTimeCounter legacyDecode;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+        legacyData = legacyFromHexString(tableHex);
+    size_t legacyDecodeTime = legacyDecode.elapsed_micro();
+
+    ElapsedTimeCounter tableDecode;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+        tableData = BufferHelper::fromHexString(tableHex);
+    size_t tableDecodeTime = tableDecode.elapsed_micro();
+
+    ASSERT_EQ(legacyData, tableData);
+    report("fromHexString 64 bytes", legacyDecodeTime, tableDecodeTime);
+}
+
+TEST(bufferhelper_benchmark, base64)
+{
+    ByteVector data = makeData(1024);
+
+    std::string encoded;
+    ElapsedTimeCounter encodeCounter;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+        encoded = BufferHelper::toBase64(data);
+    size_t encodeTime = encodeCounter.elapsed_micro();
+
+    ByteVector decoded;
+    ElapsedTimeCounter decodeCounter;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+        decoded = BufferHelper::fromBase64(encoded);
+    size_t decodeTime = decodeCounter.elapsed_micro();
+
+    ASSERT_EQ(data, decoded);
+    std::cout << "base64 1024 bytes: encode " << encodeTime << " us, decode "
+              << decodeTime << " us" << std::endl;
+}
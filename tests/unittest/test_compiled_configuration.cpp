@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/compiledconfiguration.hpp>
+#include <logicalaccess/myexception.hpp>
+#include <logicalaccess/cards/aes128key.hpp>
+#include <logicalaccess/services/accesscontrol/cardsformatcomposite.hpp>
+#include <logicalaccess/services/accesscontrol/formats/wiegand26format.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+using namespace logicalaccess;
+
+namespace
+{
+boost::property_tree::ptree makeTree()
+{
+    boost::property_tree::ptree pt;
+    pt.put("config.cardType", "DESFireEV1");
+    pt.put("config.<xmlattr>.version", "2");
+    pt.add("config.reader", "first");
+    pt.add("config.reader", "second");
+    pt.put("config.empty", "");
+    pt.put("other.value", "42");
+    return pt;
+}
+}
+
+TEST(test_compiled_configuration, test_round_trip)
+{
+    boost::property_tree::ptree pt = makeTree();
+    CompiledConfiguration config(CompiledConfiguration::compile(pt));
+
+    boost::property_tree::ptree loaded;
+    config.toPtree(loaded);
+    ASSERT_TRUE(pt == loaded);
+    ASSERT_EQ(10u, config.getNodeCount());
+}
+
+TEST(test_compiled_configuration, test_find_value)
+{
+    CompiledConfiguration config(CompiledConfiguration::compile(makeTree()));
+
+    std::string value;
+    ASSERT_TRUE(config.findValue("config.cardType", value));
+    ASSERT_EQ("DESFireEV1", value);
+    ASSERT_TRUE(config.findValue("config.<xmlattr>.version", value));
+    ASSERT_EQ("2", value);
+    // Like property trees, the first node of a name is found.
+    ASSERT_TRUE(config.findValue("config.reader", value));
+    ASSERT_EQ("first", value);
+    ASSERT_TRUE(config.findValue("other.value", value));
+    ASSERT_EQ("42", value);
+    ASSERT_FALSE(config.findValue("config.missing", value));
+    ASSERT_FALSE(config.findValue("config.cardType.child", value));
+}
+
+TEST(test_compiled_configuration, test_sub_tree)
+{
+    boost::property_tree::ptree pt = makeTree();
+    CompiledConfiguration config(CompiledConfiguration::compile(pt));
+
+    boost::property_tree::ptree loaded;
+    ASSERT_TRUE(config.toPtree("config", loaded));
+    ASSERT_TRUE(pt.get_child("config") == loaded);
+    ASSERT_TRUE(config.toPtree("other.value", loaded));
+    ASSERT_EQ("42", loaded.data());
+    ASSERT_TRUE(loaded.empty());
+    ASSERT_FALSE(config.toPtree("config.missing", loaded));
+}
+
+TEST(test_compiled_configuration, test_depth_limit)
+{
+    boost::property_tree::ptree pt;
+    std::string path = "node";
+    for (size_t depth = 1; depth < CompiledConfiguration::MAX_DEPTH; ++depth)
+        path += ".node";
+    pt.put(path, "leaf");
+    CompiledConfiguration config(CompiledConfiguration::compile(pt));
+    std::string value;
+    ASSERT_TRUE(config.findValue(path, value));
+    ASSERT_EQ("leaf", value);
+
+    pt.put(path + ".node", "leaf");
+    ASSERT_THROW(CompiledConfiguration deep(CompiledConfiguration::compile(pt)),
+                 LibLogicalAccessException);
+}
+
+TEST(test_compiled_configuration, test_corrupted_image)
+{
+    ByteVector image = CompiledConfiguration::compile(makeTree());
+
+    ByteVector truncated(image.begin(), image.end() - 1);
+    ASSERT_THROW(CompiledConfiguration config(truncated), LibLogicalAccessException);
+
+    ByteVector badMagic = image;
+    badMagic[0]         = 'X';
+    ASSERT_THROW(CompiledConfiguration config(badMagic), LibLogicalAccessException);
+
+    // Child count of the root node, which no longer matches its descendants.
+    ByteVector badTree = image;
+    size_t strings     = image[12];
+    badTree[20 + strings * 8 + 8] = 3;
+    ASSERT_THROW(CompiledConfiguration config(badTree), LibLogicalAccessException);
+
+    ByteVector empty;
+    ASSERT_THROW(CompiledConfiguration config(empty), LibLogicalAccessException);
+}
+
+TEST(test_compiled_configuration, test_format_and_key_files)
+{
+    boost::filesystem::path dir  = boost::filesystem::temp_directory_path();
+    std::string formatFile = (dir / boost::filesystem::unique_path()).string();
+    std::string keyFile    = (dir / boost::filesystem::unique_path()).string();
+
+    Wiegand26Format format;
+    format.setUid(1000);
+    format.setFacilityCode(67);
+    format.serializeToCompiledFile(formatFile);
+
+    CardsFormatComposite composite;
+    auto loadedFormat = std::dynamic_pointer_cast<Wiegand26Format>(
+        composite.createFormatFromCompiled(*CompiledConfiguration::fromFile(formatFile),
+                                           ""));
+    ASSERT_TRUE(loadedFormat != nullptr);
+    ASSERT_EQ(1000u, loadedFormat->getUid());
+    ASSERT_EQ(67, loadedFormat->getFacilityCode());
+
+    loadedFormat = std::dynamic_pointer_cast<Wiegand26Format>(
+        composite.createFormatFromCompiled(*CompiledConfiguration::fromFile(formatFile),
+                                           format.getDefaultXmlNodeName()));
+    ASSERT_TRUE(loadedFormat != nullptr);
+    ASSERT_EQ(1000u, loadedFormat->getUid());
+
+    AES128Key key("00 11 22 33 44 55 66 77 88 99 aa bb cc dd ee ff");
+    key.serializeToCompiledFile(keyFile);
+    AES128Key loadedKey;
+    loadedKey.unSerializeFromCompiledFile(keyFile);
+    ASSERT_EQ(key, loadedKey);
+
+    boost::filesystem::remove(formatFile);
+    boost::filesystem::remove(keyFile);
+}
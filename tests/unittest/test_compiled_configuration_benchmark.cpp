@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/utils.hpp>
+#include <logicalaccess/compiledconfiguration.hpp>
+#include <logicalaccess/cards/aes128key.hpp>
+#include <logicalaccess/services/accesscontrol/formats/wiegand26format.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+using namespace logicalaccess;
+
+// Benchmark comparing the load of a door configuration from XML and from its
+// compiled form. It only prints timings and is built by the benchmarks target,
+// not run by ctest: correctness is covered by test_compiled_configuration.
+
+namespace
+{
+const unsigned int DOORS      = 200;
+const unsigned int ITERATIONS = 20;
+
+/**
+ * A configuration of doors, each with a format and a key.
+ */
+boost::property_tree::ptree makeConfiguration()
+{
+    boost::property_tree::ptree pt;
+    for (unsigned int i = 0; i < DOORS; ++i)
+    {
+        boost::property_tree::ptree door;
+        Wiegand26Format format;
+        format.setUid(i);
+        format.setFacilityCode(static_cast<unsigned char>(i));
+        format.serialize(door);
+
+        AES128Key key;
+        key.setData(ByteVector(16, static_cast<uint8_t>(i)));
+        key.serialize(door);
+        pt.add_child("Configuration.Door", door);
+    }
+    return pt;
+}
+
+/**
+ * Load the formats and keys of every door, returning a checksum.
+ */
+unsigned long long loadDoors(boost::property_tree::ptree &pt)
+{
+    unsigned long long checksum = 0;
+    for (auto &door : pt.get_child("Configuration"))
+    {
+        Wiegand26Format format;
+        format.unSerialize(door.second.get_child(format.getDefaultXmlNodeName()));
+        AES128Key key;
+        key.unSerialize(door.second.get_child(key.getDefaultXmlNodeName()));
+        checksum += format.getUid() + key.getData()[0];
+    }
+    return checksum;
+}
+}
+
+TEST(compiled_configuration_benchmark, load)
+{
+    boost::property_tree::ptree pt = makeConfiguration();
+    std::ostringstream oss;
+    write_xml(oss, pt);
+    std::string xml  = oss.str();
+    ByteVector image = CompiledConfiguration::compile(pt);
+
+    size_t xmlParseTime = 0, xmlTime = 0;
+    unsigned long long xmlChecksum = 0;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+    {
+        ElapsedTimeCounter counter;
+        std::istringstream iss(xml);
+        boost::property_tree::ptree loaded;
+        read_xml(iss, loaded);
+        xmlParseTime += counter.elapsed_micro();
+        xmlChecksum = loadDoors(loaded);
+        xmlTime += counter.elapsed_micro();
+    }
+
+    size_t compiledParseTime = 0, compiledTime = 0;
+    unsigned long long compiledChecksum = 0;
+    for (unsigned int it = 0; it < ITERATIONS; ++it)
+    {
+        ElapsedTimeCounter counter;
+        CompiledConfiguration config(image);
+        boost::property_tree::ptree loaded;
+        config.toPtree(loaded);
+        compiledParseTime += counter.elapsed_micro();
+        compiledChecksum = loadDoors(loaded);
+        compiledTime += counter.elapsed_micro();
+    }
+
+    ASSERT_EQ(xmlChecksum, compiledChecksum);
+    std::cout << DOORS << " doors, XML (" << xml.size() << " bytes): tree "
+              << xmlParseTime / ITERATIONS << " us, load " << xmlTime / ITERATIONS
+              << " us" << std::endl;
+    std::cout << DOORS << " doors, compiled (" << image.size() << " bytes): tree "
+              << compiledParseTime / ITERATIONS << " us, load "
+              << compiledTime / ITERATIONS << " us" << std::endl;
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/readers/iso7816/commands/desfireev2iso7816commands.hpp>
+#include <logicalaccess/plugins/cards/desfire/desfirechip.hpp>
+#include <logicalaccess/plugins/cards/iso7816/readercardadapters/iso7816readercardadapter.hpp>
+#include <logicalaccess/plugins/crypto/des_cipher.hpp>
+#include <logicalaccess/plugins/crypto/des_initialization_vector.hpp>
+#include <logicalaccess/plugins/crypto/des_symmetric_key.hpp>
+#include <logicalaccess/plugins/llacommon/settings.hpp>
+
+using namespace logicalaccess;
+
+namespace
+{
+const ByteVector KEY = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                        0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+
+const ByteVector RND_B = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17};
+
+ByteVector encrypt(const ByteVector &block)
+{
+    openssl::DESCipher cipher(openssl::OpenSSLSymmetricCipher::ENC_MODE_ECB);
+    ByteVector result;
+    cipher.cipher(block, result, openssl::DESSymmetricKey::createFromData(KEY),
+                  openssl::DESInitializationVector::createNull(), false);
+    return result;
+}
+
+ByteVector rotate(const ByteVector &rnd)
+{
+    ByteVector rotated(rnd.begin() + 1, rnd.end());
+    rotated.push_back(rnd[0]);
+    return rotated;
+}
+
+/**
+ * Simulates a DESFire card wrapped in ISO 7816, accepting the legacy 3DES
+ * authentication with KEY, and records the commands it receives.
+ */
+class SimulatedCardAdapter : public ISO7816ReaderCardAdapter
+{
+  public:
+    using ISO7816ReaderCardAdapter::sendAPDUCommand;
+
+    ISO7816Response sendAPDUCommand(const ByteVector &command) override
+    {
+        commands.push_back(command[1]);
+        if (command[1] == DF_INS_AUTHENTICATE)
+            return ISO7816Response(encrypt(RND_B), 0x91, DF_INS_ADDITIONAL_FRAME);
+
+        if (command[1] == DF_INS_ADDITIONAL_FRAME && command.size() > 20)
+        {
+            // The PCD deciphers in send mode: rndA, then rndB' chained.
+            ByteVector block1(command.begin() + 5, command.begin() + 13);
+            ByteVector block2(command.begin() + 13, command.begin() + 21);
+            ByteVector rndA  = encrypt(block1);
+            ByteVector rndB1 = encrypt(block2);
+            for (size_t i = 0; i < rndB1.size(); ++i)
+                rndB1[i] ^= block1[i];
+            if (rndB1 != rotate(RND_B))
+                return ISO7816Response(ByteVector(), 0x91, 0xae);
+            return ISO7816Response(encrypt(rotate(rndA)), 0x91, 0x00);
+        }
+        return ISO7816Response(ByteVector(), 0x91, 0x00);
+    }
+
+    std::vector<unsigned char> commands;
+};
+
+/**
+ * Restores the authentication cache setting.
+ */
+class AuthenticationCacheSetting
+{
+  public:
+    explicit AuthenticationCacheSetting(bool enabled)
+        : enabled_(Settings::getInstance()->IsDESFireAuthenticationCacheEnabled)
+    {
+        Settings::getInstance()->IsDESFireAuthenticationCacheEnabled = enabled;
+    }
+
+    ~AuthenticationCacheSetting()
+    {
+        Settings::getInstance()->IsDESFireAuthenticationCacheEnabled = enabled_;
+    }
+
+  private:
+    bool enabled_;
+};
+
+template <typename T>
+std::shared_ptr<T> makeCommands(std::shared_ptr<DESFireChip> chip,
+                                std::shared_ptr<SimulatedCardAdapter> adapter)
+{
+    auto cmd = std::make_shared<T>();
+    cmd->setReaderCardAdapter(adapter);
+    cmd->setChip(chip);
+    return cmd;
+}
+
+std::shared_ptr<DESFireKey> makeKey()
+{
+    auto key = std::make_shared<DESFireKey>(KEY);
+    key->setKeyType(DF_KEY_DES);
+    return key;
+}
+}
+
+TEST(test_desfire_authentication_cache, second_authentication_is_skipped)
+{
+    AuthenticationCacheSetting setting(true);
+    auto adapter = std::make_shared<SimulatedCardAdapter>();
+    auto chip    = std::make_shared<DESFireChip>();
+    chip->setChipIdentifier({0x04, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06});
+    auto cmd = makeCommands<DESFireISO7816Commands>(chip, adapter);
+
+    cmd->selectApplication(0x123456);
+    cmd->authenticate(0, makeKey());
+    ASSERT_EQ((std::vector<unsigned char>{DF_INS_SELECT_APPLICATION, DF_INS_AUTHENTICATE,
+                                          DF_INS_ADDITIONAL_FRAME}),
+              adapter->commands);
+    ASSERT_FALSE(chip->getCrypto()->d_sessionKey.empty());
+
+    adapter->commands.clear();
+    cmd->selectApplication(0x123456);
+    cmd->authenticate(0, makeKey());
+    ASSERT_TRUE(adapter->commands.empty());
+
+    // The EV1 and EV2 commands share the chip state.
+    makeCommands<DESFireEV1ISO7816Commands>(chip, adapter)->authenticate(0, makeKey());
+    makeCommands<DESFireEV2ISO7816Commands>(chip, adapter)->authenticate(0, makeKey());
+    ASSERT_TRUE(adapter->commands.empty());
+
+    // Another key number authenticates again.
+    cmd->authenticate(1, makeKey());
+    ASSERT_EQ((std::vector<unsigned char>{DF_INS_AUTHENTICATE, DF_INS_ADDITIONAL_FRAME}),
+              adapter->commands);
+}
+
+TEST(test_desfire_authentication_cache, disabled)
+{
+    AuthenticationCacheSetting setting(false);
+    auto adapter = std::make_shared<SimulatedCardAdapter>();
+    auto chip    = std::make_shared<DESFireChip>();
+    chip->setChipIdentifier({0x04, 0x01, 0x02, 0x03, 0x04, 0x05, 0x07});
+    auto cmd = makeCommands<DESFireISO7816Commands>(chip, adapter);
+
+    cmd->selectApplication(0x123456);
+    cmd->authenticate(0, makeKey());
+    cmd->authenticate(0, makeKey());
+    ASSERT_EQ((std::vector<unsigned char>{DF_INS_SELECT_APPLICATION, DF_INS_AUTHENTICATE,
+                                          DF_INS_ADDITIONAL_FRAME, DF_INS_AUTHENTICATE,
+                                          DF_INS_ADDITIONAL_FRAME}),
+              adapter->commands);
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/cards/desfire/desfiremetadatacache.hpp>
+#include <logicalaccess/plugins/cards/desfire/desfireev1commands.hpp>
+
+using namespace logicalaccess;
+
+TEST(test_desfire_metadata_cache, selection)
+{
+    DESFireMetadataCache cache;
+    cache.bind({0x04, 0x01, 0x02});
+    ASSERT_FALSE(cache.isSelected(0));
+
+    cache.setSelected(0x123456);
+    ASSERT_TRUE(cache.isSelected(0x123456));
+    ASSERT_FALSE(cache.isSelected(0));
+
+    // A new selection is sent to the card.
+    cache.invalidate(DF_INS_SELECT_APPLICATION, {0x56, 0x34, 0x12});
+    ASSERT_FALSE(cache.isSelected(0x123456));
+
+    cache.setSelected(0x123456);
+    cache.invalidate(DF_INS_DELETE_APPLICATION, {0x56, 0x34, 0x12});
+    ASSERT_FALSE(cache.isSelected(0x123456));
+
+    // The card drops the authentication when the authenticated key changes.
+    cache.setSelected(0x123456);
+    cache.invalidate(DF_INS_CHANGE_KEY_SETTINGS, {0x0f});
+    ASSERT_TRUE(cache.isSelected(0x123456));
+    cache.invalidate(DF_INS_CHANGE_KEY, {0x00});
+    ASSERT_FALSE(cache.isSelected(0x123456));
+
+    cache.setSelected(0x123456);
+    cache.bind({0x04, 0x01, 0x03});
+    ASSERT_FALSE(cache.isSelected(0x123456));
+}
+
+TEST(test_desfire_metadata_cache, application_ids)
+{
+    DESFireMetadataCache cache;
+    std::vector<unsigned int> aids;
+    ASSERT_FALSE(cache.getApplicationIDs(aids));
+
+    cache.setApplicationIDs({0x000521, 0x123456});
+    ASSERT_TRUE(cache.getApplicationIDs(aids));
+    ASSERT_EQ(2u, aids.size());
+
+    cache.invalidate(DF_INS_GET_APPLICATION_IDS, {});
+    ASSERT_TRUE(cache.getApplicationIDs(aids));
+
+    cache.invalidate(DF_INS_CREATE_APPLICATION, {0x01, 0x00, 0x00, 0x0b, 0x81});
+    ASSERT_FALSE(cache.getApplicationIDs(aids));
+}
+
+TEST(test_desfire_metadata_cache, files_and_keys)
+{
+    DESFireMetadataCache cache;
+    ByteVector files;
+    DESFireCommands::FileSetting settings;
+    memset(&settings, 0x00, sizeof(settings));
+
+    // Nothing is cached while the selected application is unknown.
+    cache.setFileIDs({0x00, 0x01});
+    ASSERT_FALSE(cache.getFileIDs(files));
+
+    cache.setSelected(0x000521);
+    cache.setFileIDs({0x00, 0x01});
+    settings.fileType = 0;
+    cache.setFileSettings(0x01, settings);
+    cache.setKeySettings(KS_DEFAULT, 3, DF_KEY_AES);
+    ASSERT_TRUE(cache.getFileIDs(files));
+    ASSERT_EQ(ByteVector({0x00, 0x01}), files);
+    ASSERT_TRUE(cache.getFileSettings(0x01, settings));
+    ASSERT_FALSE(cache.getFileSettings(0x00, settings));
+
+    // Other applications have their own metadata.
+    cache.setSelected(0x000522);
+    ASSERT_FALSE(cache.getFileIDs(files));
+    cache.setSelected(0x000521);
+    ASSERT_TRUE(cache.getFileIDs(files));
+
+    cache.invalidate(DF_INS_CHANGE_FILE_SETTINGS, {0x01, 0x00});
+    ASSERT_FALSE(cache.getFileSettings(0x01, settings));
+    ASSERT_TRUE(cache.getFileIDs(files));
+
+    cache.invalidate(DF_INS_CREATE_STD_DATA_FILE, {0x02, 0x00});
+    ASSERT_FALSE(cache.getFileIDs(files));
+
+    DESFireKeySettings keySettings;
+    unsigned char maxNbKeys;
+    DESFireKeyType keyType;
+    ASSERT_TRUE(cache.getKeySettings(keySettings, maxNbKeys, keyType));
+    ASSERT_EQ(3, maxNbKeys);
+    ASSERT_EQ(DF_KEY_AES, keyType);
+    cache.invalidate(DF_INS_CHANGE_KEY, {0x00});
+    ASSERT_FALSE(cache.getKeySettings(keySettings, maxNbKeys, keyType));
+}
+
+TEST(test_desfire_metadata_cache, record_and_value_files)
+{
+    DESFireMetadataCache cache;
+    DESFireCommands::FileSetting settings;
+    memset(&settings, 0x00, sizeof(settings));
+    cache.setSelected(0x000521);
+
+    // Writing a record changes the number of records of its file only.
+    settings.fileType = 4;
+    cache.setFileSettings(0x01, settings);
+    cache.setFileSettings(0x02, settings);
+    cache.invalidate(DF_INS_WRITE_RECORD, {0x01, 0x00, 0x00, 0x00});
+    ASSERT_FALSE(cache.getFileSettings(0x01, settings));
+    ASSERT_TRUE(cache.getFileSettings(0x02, settings));
+    cache.invalidate(DF_INS_CLEAR_RECORD_FILE, {0x02});
+    ASSERT_FALSE(cache.getFileSettings(0x02, settings));
+
+    // Credits change the limited credit value.
+    settings.fileType = 2;
+    cache.setFileSettings(0x03, settings);
+    cache.invalidate(DF_INS_LIMITED_CREDIT, {0x03, 0x01, 0x00, 0x00, 0x00});
+    ASSERT_FALSE(cache.getFileSettings(0x03, settings));
+    cache.setFileSettings(0x03, settings);
+    cache.invalidate(DF_INS_CREDIT, {0x03, 0x01, 0x00, 0x00, 0x00});
+    ASSERT_FALSE(cache.getFileSettings(0x03, settings));
+
+    // The transaction end applies the changes of every file.
+    cache.setFileSettings(0x01, settings);
+    cache.setFileSettings(0x03, settings);
+    cache.invalidate(DF_COMMIT_TRANSACTION, {});
+    ASSERT_FALSE(cache.getFileSettings(0x01, settings));
+    ASSERT_FALSE(cache.getFileSettings(0x03, settings));
+}
+
+TEST(test_desfire_metadata_cache, authentication)
+{
+    DESFireMetadataCache cache;
+    auto key =
+        std::make_shared<DESFireKey>("00 11 22 33 44 55 66 77 88 99 aa bb cc dd ee ff");
+    key->setKeyType(DF_KEY_AES);
+
+    // Authentications are only known within a selection.
+    cache.setAuthenticated(1, key);
+    ASSERT_FALSE(cache.isAuthenticated(1, key));
+
+    cache.setSelected(0x000521);
+    cache.setAuthenticated(1, key);
+    ASSERT_TRUE(cache.isAuthenticated(1, key));
+    ASSERT_TRUE(cache.isAuthenticated(1, std::make_shared<DESFireKey>(*key)));
+    ASSERT_FALSE(cache.isAuthenticated(2, key));
+
+    // The key is copied: changing it afterwards needs a new authentication.
+    key->setKeyVersion(1);
+    ASSERT_FALSE(cache.isAuthenticated(1, key));
+    key->setKeyVersion(0);
+
+    cache.invalidate(DF_INS_READ_DATA, {0x01});
+    ASSERT_TRUE(cache.isAuthenticated(1, key));
+
+    cache.invalidate(DF_INS_CHANGE_KEY, {0x02});
+    ASSERT_FALSE(cache.isAuthenticated(1, key));
+
+    cache.setSelected(0x000521);
+    cache.setAuthenticated(1, key);
+    cache.invalidate(DFEV1_INS_AUTHENTICATE_AES, {0x01});
+    ASSERT_FALSE(cache.isAuthenticated(1, key));
+
+    cache.setAuthenticated(1, key);
+    cache.invalidateSelection();
+    ASSERT_FALSE(cache.isAuthenticated(1, key));
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/services/accesscontrol/encodingpipeline.hpp>
+#include <logicalaccess/readerproviders/dummyreaderunit.hpp>
+#include <logicalaccess/cards/chip.hpp>
+#include <logicalaccess/cards/aes128key.hpp>
+#include <logicalaccess/cards/keydiversification.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * A reader unit presenting a list of cards, one after the other.
+ */
+class FakeReaderUnit : public DummyReaderUnit
+{
+  public:
+    explicit FakeReaderUnit(std::string name)
+        : DummyReaderUnit(name)
+        , name_(name)
+    {
+    }
+
+    void present(const ByteVector &identifier)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cards_.push_back(identifier);
+    }
+
+    bool waitInsertion(unsigned int) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cards_.empty())
+            return false;
+        chip_ = std::make_shared<Chip>("GenericTag");
+        chip_->setChipIdentifier(cards_.front());
+        return true;
+    }
+
+    bool waitRemoval(unsigned int) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!cards_.empty())
+            cards_.pop_front();
+        chip_ = nullptr;
+        return true;
+    }
+
+    std::shared_ptr<Chip> getSingleChip() override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return chip_;
+    }
+
+    bool connect() override
+    {
+        return true;
+    }
+
+    void disconnect() override
+    {
+    }
+
+    std::string getName() const override
+    {
+        return name_;
+    }
+
+  private:
+    std::string name_;
+
+    std::mutex mutex_;
+
+    std::deque<ByteVector> cards_;
+
+    std::shared_ptr<Chip> chip_;
+};
+
+/**
+ * Diversify a key by xoring the card identifier.
+ */
+class XorKeyDiversification : public KeyDiversification
+{
+  public:
+    void initDiversification(ByteVector identifier, unsigned int, std::shared_ptr<Key>,
+                             unsigned char, ByteVector &diversify) override
+    {
+        diversify = identifier;
+    }
+
+    ByteVector getDiversifiedKey(std::shared_ptr<Key> key, ByteVector diversify) override
+    {
+        ByteVector data = key->getData();
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] ^= diversify[i % diversify.size()];
+        }
+        return data;
+    }
+
+    std::string getKeyDiversificationType() override
+    {
+        return "Xor";
+    }
+
+    void serialize(boost::property_tree::ptree &) override
+    {
+    }
+
+    void unSerialize(boost::property_tree::ptree &) override
+    {
+    }
+
+    std::string getDefaultXmlNodeName() const override
+    {
+        return "XorKeyDiversification";
+    }
+};
+}
+
+TEST(test_encoding_pipeline, encode_on_all_readers)
+{
+    auto reader1 = std::make_shared<FakeReaderUnit>("reader1");
+    auto reader2 = std::make_shared<FakeReaderUnit>("reader2");
+    EncodingPipeline pipeline({reader1, reader2}, 2);
+    pipeline.setPollingPeriod(10);
+
+    std::mutex mutex;
+    std::vector<ByteVector> encoded;
+    std::vector<std::future<EncodingResult>> results;
+    for (int i = 0; i < 4; ++i)
+    {
+        EncodingJob job;
+        job.operations = [&mutex, &encoded](std::shared_ptr<Chip> chip,
+                                            const std::vector<std::shared_ptr<Key>> &) {
+            std::lock_guard<std::mutex> lock(mutex);
+            encoded.push_back(chip->getChipIdentifier());
+        };
+        results.push_back(pipeline.submit(job));
+    }
+
+    pipeline.start();
+    reader1->present({0x01});
+    reader2->present({0x02});
+    reader1->present({0x03});
+    reader2->present({0x04});
+
+    std::vector<std::string> readers;
+    for (auto &result : results)
+    {
+        EncodingResult r = result.get();
+        ASSERT_TRUE(r.success) << r.error;
+        readers.push_back(r.readerName);
+    }
+    pipeline.stop();
+
+    ASSERT_EQ(4u, encoded.size());
+    ASSERT_EQ(2, std::count(readers.begin(), readers.end(), "reader1"));
+    ASSERT_EQ(2, std::count(readers.begin(), readers.end(), "reader2"));
+
+    EncodingPipelineMetrics metrics = pipeline.getMetrics();
+    ASSERT_EQ(4u, metrics.succeeded);
+    ASSERT_EQ(0u, metrics.failed);
+}
+
+TEST(test_encoding_pipeline, diversify_for_known_card)
+{
+    auto reader = std::make_shared<FakeReaderUnit>("reader");
+    EncodingPipeline pipeline({reader});
+    pipeline.setPollingPeriod(10);
+
+    auto key = std::make_shared<AES128Key>();
+    key->fromString("00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00");
+    key->setKeyDiversification(std::make_shared<XorKeyDiversification>());
+
+    EncodingJob other;
+    other.identifier = {0xAA};
+    EncodingJob job;
+    job.identifier = {0x42};
+    job.keys.push_back({key, 0, 0});
+    ByteVector keyData;
+    job.operations = [&keyData](std::shared_ptr<Chip>,
+                                const std::vector<std::shared_ptr<Key>> &keys) {
+        keyData = keys.at(0)->getData();
+    };
+
+    std::future<EncodingResult> otherResult = pipeline.submit(other);
+    std::future<EncodingResult> result      = pipeline.submit(job);
+    pipeline.start();
+    reader->present({0x42});
+
+    EncodingResult r = result.get();
+    ASSERT_TRUE(r.success) << r.error;
+    ASSERT_EQ(ByteVector({0x42}), r.chipIdentifier);
+    ASSERT_EQ(ByteVector(16, 0x42), keyData);
+    // The master key is shared by the jobs and left unchanged.
+    ASSERT_EQ(ByteVector(16, 0x00), key->getData());
+    ASSERT_NE(nullptr, key->getKeyDiversification());
+
+    pipeline.stop();
+    EncodingResult o = otherResult.get();
+    ASSERT_FALSE(o.success);
+}
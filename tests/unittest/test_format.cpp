@@ -19,6 +19,8 @@
 #include "logicalaccess/services/accesscontrol/formats/getronik40bitformat.hpp"
 #include "logicalaccess/services/accesscontrol/formats/hidhoneywell40bitformat.hpp"
 #include "logicalaccess/services/accesscontrol/formats/rawformat.hpp"
+#include "logicalaccess/services/accesscontrol/formats/formatbatchdecoder.hpp"
+#include "logicalaccess/services/accesscontrol/formats/formatdetector.hpp"
 #include "logicalaccess/services/accesscontrol/formats/customformat/customformat.hpp"
 #include "logicalaccess/services/accesscontrol/formats/customformat/binarydatafield.hpp"
 #include "logicalaccess/services/accesscontrol/formats/customformat/paritydatafield.hpp"
@@ -475,3 +477,141 @@ TEST(test_format_utils, test_format_CustomFormat_bcdnibble_little_endian_bits)
     auto expected  = ByteVector{0b11000100};
     ASSERT_EQ(expected, formatBuf);
 }
+
+TEST(test_format_utils, test_format_batch_decode_wiegand26)
+{
+    ByteVector credentials;
+    for (unsigned long long uid = 0; uid < 1000; ++uid)
+    {
+        auto format = std::make_shared<Wiegand26Format>();
+        format->setUid(uid * 61);
+        format->setFacilityCode(static_cast<unsigned char>(uid % 256));
+        auto buf = format->getLinearData();
+        credentials.insert(credentials.end(), buf.begin(), buf.end());
+    }
+    // Flip the right parity bit of the credential #7.
+    credentials[7 * 4 + 3] ^= 0x40;
+
+    FormatBatchDecoder decoder(std::make_shared<Wiegand26Format>());
+    for (unsigned int threads : {1u, 4u})
+    {
+        auto result = decoder.decode(credentials, 4, threads);
+        ASSERT_EQ(1000, result.size());
+        auto &uids       = result.getColumn("Uid");
+        auto &facilities = result.getColumn("FacilityCode");
+        for (unsigned long long i = 0; i < 1000; ++i)
+        {
+            ASSERT_EQ(i * 61, uids[i]);
+            ASSERT_EQ(i % 256, facilities[i]);
+            ASSERT_EQ(i == 7 ? 0 : 1, result.valid[i]);
+        }
+    }
+    ASSERT_THROW(decoder.decode(credentials, 3), std::invalid_argument);
+    ASSERT_THROW(decoder.decode(credentials.data(), 1, 3), std::invalid_argument);
+}
+
+TEST(test_format_utils, test_format_batch_decode_wiegand37_with_facility)
+{
+    auto format = std::make_shared<Wiegand37WithFacilityFormat>();
+    format->setUid(123456);
+    format->setFacilityCode(4321);
+    auto credentials = format->getLinearData();
+    auto buf         = credentials;
+    buf.push_back(0x00);
+    credentials = buf;
+    credentials.insert(credentials.end(), buf.begin(), buf.end());
+
+    FormatBatchDecoder decoder(std::make_shared<Wiegand37WithFacilityFormat>());
+    auto result = decoder.decode(credentials, buf.size(), 0);
+    ASSERT_EQ(2, result.size());
+    ASSERT_EQ(123456, result.getColumn("Uid")[1]);
+    ASSERT_EQ(4321, result.getColumn("FacilityCode")[1]);
+    ASSERT_EQ(1, result.valid[0]);
+    ASSERT_THROW(result.getColumn("Unknown"), std::invalid_argument);
+}
+
+TEST(test_format_utils, test_format_detector_builtins)
+{
+    FormatDetector detector;
+
+    auto candidates = detector.detect(ByteVector({0xa1, 0x81, 0xf4, 0x40}), 26);
+    ASSERT_FALSE(candidates.empty());
+    ASSERT_EQ(FT_WIEGAND26, candidates[0].format->getType());
+    ASSERT_TRUE(candidates[0].valid);
+    auto wiegand26 = std::dynamic_pointer_cast<Wiegand26Format>(candidates[0].format);
+    ASSERT_EQ(1000, wiegand26->getUid());
+    ASSERT_EQ(67, wiegand26->getFacilityCode());
+
+    candidates = detector.detect(ByteVector({0xf3, 0x7f, 0x45, 0xca, 0x03}), 40);
+    ASSERT_FALSE(candidates.empty());
+    ASSERT_EQ(FT_HIDHONEYWELL, candidates[0].format->getType());
+    ASSERT_TRUE(candidates[0].valid);
+    ASSERT_GT(candidates[0].fixedBits, 0);
+
+    candidates = detector.detect(ByteVector({0x2e, 0x16, 0x27, 0x58, 0x9f}), 40);
+    ASSERT_FALSE(candidates.empty());
+    ASSERT_EQ(FT_GETRONIK40BIT, candidates[0].format->getType());
+    ASSERT_TRUE(candidates[0].valid);
+
+    candidates = detector.detect(ByteVector({0x00, 0x97, 0x46, 0x41, 0xd0}), 36);
+    ASSERT_FALSE(candidates.empty());
+    ASSERT_EQ(FT_DATACLOCK, candidates[0].format->getType());
+
+    auto fascn = ByteVector({0xD0, 0x43, 0x94, 0x58, 0x21, 0x0C, 0x2C, 0x19, 0xA0,
+                             0x84, 0x6D, 0x83, 0x68, 0x5A, 0x10, 0x82, 0x10, 0x8C,
+                             0xE7, 0x39, 0x84, 0x10, 0x8C, 0xA3, 0xF5});
+    candidates = detector.detect(fascn, 200);
+    ASSERT_FALSE(candidates.empty());
+    ASSERT_EQ(FT_FASCN200BIT, candidates[0].format->getType());
+    ASSERT_TRUE(candidates[0].valid);
+
+    auto wiegand37 = std::make_shared<Wiegand37WithFacilityFormat>();
+    wiegand37->setUid(123456);
+    wiegand37->setFacilityCode(4321);
+    // Same length and parity layout: both Wiegand 37 formats are valid candidates.
+    candidates = detector.detect(wiegand37->getLinearData(), 37);
+    auto facility = std::find_if(candidates.begin(), candidates.end(),
+                                 [](const FormatCandidate &candidate) {
+                                     return candidate.format->getType() ==
+                                            FT_WIEGAND37FACILITY;
+                                 });
+    ASSERT_NE(candidates.end(), facility);
+    ASSERT_TRUE(facility->valid);
+    ASSERT_EQ(4321, std::dynamic_pointer_cast<Wiegand37WithFacilityFormat>(facility->format)
+                        ->getFacilityCode());
+
+    ASSERT_TRUE(detector.detect(ByteVector({0x00, 0x00}), 13).empty());
+    ASSERT_THROW(detector.detect(ByteVector({0x00}), 9), std::invalid_argument);
+}
+
+TEST(test_format_utils, test_format_detector_custom)
+{
+    FormatDetector detector(false);
+    ASSERT_EQ(0, detector.size());
+
+    auto custom = std::make_shared<CustomFormat>();
+    auto header = std::make_shared<NumberDataField>();
+    header->setName("Header");
+    header->setPosition(0);
+    header->setDataLength(8);
+    header->setValue(0xA5);
+    header->setIsFixedField(true);
+    auto uid = std::make_shared<NumberDataField>();
+    uid->setName("Uid");
+    uid->setPosition(8);
+    uid->setDataLength(24);
+    custom->setFieldList({header, uid});
+    detector.registerFormat(custom);
+    ASSERT_EQ(1, detector.size());
+
+    uid->setValue(0x123456);
+    auto candidates = detector.detect(custom->getLinearData(), 32);
+    ASSERT_EQ(1, candidates.size());
+    ASSERT_EQ(8, candidates[0].fixedBits);
+    ASSERT_EQ(FT_CUSTOM, candidates[0].format->getType());
+    auto decodedUid = std::dynamic_pointer_cast<NumberDataField>(
+        candidates[0].format->getFieldFromName("Uid"));
+    ASSERT_EQ(0x123456, decodedUid->getValue());
+
+    ASSERT_TRUE(detector.detect(ByteVector({0xA4, 0x12, 0x34, 0x56}), 32).empty());
+}
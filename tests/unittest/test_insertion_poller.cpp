@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/readerproviders/insertionpoller.hpp>
+#include <logicalaccess/cards/chip.hpp>
+#include <logicalaccess/utils.hpp>
+
+#include <atomic>
+#include <future>
+
+using namespace logicalaccess;
+
+namespace
+{
+std::shared_ptr<Chip> makeChip(unsigned char id)
+{
+    auto chip = std::make_shared<Chip>("GenericTag");
+    chip->setChipIdentifier({id});
+    return chip;
+}
+}
+
+TEST(test_insertion_poller, backoff_when_idle)
+{
+    std::atomic<int> scans(0);
+    auto poller = std::make_shared<InsertionPoller>([&scans]() {
+        ++scans;
+        return std::shared_ptr<Chip>();
+    });
+    poller->setIntervals(10, 80);
+
+    ElapsedTimeCounter counter;
+    ASSERT_EQ(nullptr, poller->waitInsertion(400));
+    ASSERT_GE(counter.elapsed(), 400u);
+    // 10, 20, 40, 80, 80... instead of 40 scans at the minimum interval.
+    ASSERT_LE(scans, 10);
+
+    // A single scan without wait.
+    scans = 0;
+    ASSERT_EQ(nullptr, poller->waitInsertion(0));
+    ASSERT_EQ(1, scans);
+}
+
+TEST(test_insertion_poller, wake_up)
+{
+    std::atomic<bool> present(false);
+    auto poller = std::make_shared<InsertionPoller>([&present]() {
+        return present ? makeChip(0x01) : std::shared_ptr<Chip>();
+    });
+    poller->setIntervals(1000, 1000);
+
+    std::future<std::shared_ptr<Chip>> chip = std::async(
+        std::launch::async, [poller]() { return poller->waitInsertion(5000); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    ElapsedTimeCounter counter;
+    present = true;
+    poller->wakeUp();
+    ASSERT_NE(nullptr, chip.get());
+    ASSERT_LT(counter.elapsed(), 500u);
+}
+
+TEST(test_insertion_poller, removal_and_replacement)
+{
+    std::atomic<int> card(1);
+    auto poller = std::make_shared<InsertionPoller>([&card]() {
+        return card ? makeChip(static_cast<unsigned char>(card)) : std::shared_ptr<Chip>();
+    });
+    poller->setRemovalInterval(10);
+
+    ASSERT_FALSE(poller->waitRemoval({0x01}, 50));
+
+    card = 2;
+    std::shared_ptr<Chip> replacement;
+    ASSERT_TRUE(poller->waitRemoval({0x01}, 50, &replacement));
+    ASSERT_NE(nullptr, replacement);
+    ASSERT_EQ(ByteVector({0x02}), replacement->getChipIdentifier());
+
+    card = 0;
+    ASSERT_TRUE(poller->waitRemoval({0x02}, 50, &replacement));
+    ASSERT_EQ(nullptr, replacement);
+}
+
+TEST(test_insertion_poller, background_callbacks)
+{
+    std::atomic<int> card(0);
+    auto poller = std::make_shared<InsertionPoller>([&card]() {
+        return card ? makeChip(static_cast<unsigned char>(card)) : std::shared_ptr<Chip>();
+    });
+    poller->setIntervals(5, 5);
+    poller->setRemovalInterval(5);
+
+    std::promise<ByteVector> inserted;
+    std::promise<ByteVector> removed;
+    poller->start(
+        [&inserted](std::shared_ptr<Chip> chip) {
+            inserted.set_value(chip->getChipIdentifier());
+        },
+        [&removed](std::shared_ptr<Chip> chip) {
+            removed.set_value(chip->getChipIdentifier());
+        });
+    ASSERT_TRUE(poller->isStarted());
+
+    card = 7;
+    ASSERT_EQ(ByteVector({0x07}), inserted.get_future().get());
+    card = 0;
+    ASSERT_EQ(ByteVector({0x07}), removed.get_future().get());
+
+    poller->stop();
+    ASSERT_FALSE(poller->isStarted());
+}
+
+TEST(test_insertion_poller, stop_ends_blocking_wait)
+{
+    std::promise<void> scanned;
+    std::atomic<bool> first(true);
+    auto poller = std::make_shared<InsertionPoller>([&]() {
+        if (first.exchange(false))
+            scanned.set_value();
+        return std::shared_ptr<Chip>();
+    });
+    poller->setIntervals(1000, 1000);
+
+    // No background thread runs: the blocking wait ends anyway.
+    std::future<std::shared_ptr<Chip>> wait = std::async(
+        std::launch::async, [poller]() { return poller->waitInsertion(10000); });
+    scanned.get_future().wait();
+    ElapsedTimeCounter counter;
+    poller->stop();
+    ASSERT_EQ(std::future_status::ready, wait.wait_for(std::chrono::seconds(2)));
+    ASSERT_FALSE(wait.get());
+    ASSERT_LT(counter.elapsed(), 1000u);
+
+    // The next waits aren't affected.
+    counter = ElapsedTimeCounter();
+    ASSERT_FALSE(poller->waitInsertion(30));
+    ASSERT_GE(counter.elapsed(), 30u);
+}
+
+TEST(test_insertion_poller, stop_from_callback)
+{
+    auto poller = std::make_shared<InsertionPoller>([]() { return makeChip(0x01); });
+    poller->setIntervals(5, 5);
+
+    std::promise<void> stopped;
+    poller->start(
+        [&](std::shared_ptr<Chip>) {
+            poller->stop();
+            stopped.set_value();
+        },
+        nullptr);
+    stopped.get_future().wait();
+    ASSERT_FALSE(poller->isStarted());
+
+    // The stopped thread is joined, and the poller can be started again.
+    std::promise<void> inserted;
+    poller->start([&](std::shared_ptr<Chip>) { inserted.set_value(); }, nullptr);
+    inserted.get_future().wait();
+    poller->stop();
+    ASSERT_FALSE(poller->isStarted());
+}
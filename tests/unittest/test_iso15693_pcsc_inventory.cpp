@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/readers/pcsc/commands/iso15693pcsccommands.hpp>
+#include <logicalaccess/myexception.hpp>
+
+#include <algorithm>
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * Answers transparent exchanges with a fixed response, and the session
+ * management commands with a success.
+ */
+class TransparentExchangeAdapter : public PCSCReaderCardAdapter
+{
+  public:
+    using ISO7816ReaderCardAdapter::sendAPDUCommand;
+
+    ISO7816Response sendAPDUCommand(const ByteVector &command) override
+    {
+        // FF C2 00 01: transparent exchange.
+        if (command.size() > 3 && command[1] == 0xc2 && command[3] == 0x01)
+        {
+            ++exchanges;
+            return ISO7816Response(answer, 0x90, 0x00);
+        }
+        return ISO7816Response(ByteVector(), 0x90, 0x00);
+    }
+
+    ByteVector answer;
+
+    unsigned int exchanges = 0;
+};
+
+/**
+ * Simulates the VICC in the field: the ones matching the mask answer.
+ */
+class SimulatedFieldCommands : public ISO15693PCSCCommands
+{
+  public:
+    std::vector<ByteVector> tags;
+
+    unsigned int requests = 0;
+
+  protected:
+    InventoryStatus inventoryRequest(unsigned char /*afi*/, const ByteVector &mask,
+                                     unsigned char maskLength, ByteVector &uid) override
+    {
+        ++requests;
+        std::vector<ByteVector> matching;
+        for (const auto &tag : tags)
+        {
+            bool match = true;
+            for (unsigned int i = 0; i < maskLength && match; ++i)
+            {
+                match = ((tag[i / 8] ^ mask[i / 8]) & (1 << (i % 8))) == 0;
+            }
+            if (match)
+                matching.push_back(tag);
+        }
+
+        if (matching.empty())
+            return IS_NO_RESPONSE;
+        if (matching.size() > 1)
+            return IS_COLLISION;
+        uid = matching[0];
+        return IS_RESPONSE;
+    }
+};
+
+template <typename T>
+std::shared_ptr<T> makeCommands(std::shared_ptr<TransparentExchangeAdapter> adapter)
+{
+    auto cmd = std::make_shared<T>();
+    cmd->setReaderCardAdapter(adapter);
+    return cmd;
+}
+}
+
+TEST(test_iso15693_pcsc_inventory, simulated_field)
+{
+    auto adapter = std::make_shared<TransparentExchangeAdapter>();
+    auto cmd     = makeCommands<SimulatedFieldCommands>(adapter);
+
+    // No tag.
+    ASSERT_TRUE(cmd->inventory().empty());
+    ASSERT_EQ(1u, cmd->requests);
+
+    // One tag answers the first request.
+    const ByteVector first = {0x15, 0x1a, 0x2b, 0x3c, 0x4d, 0x01, 0x04, 0xe0};
+    cmd->tags.push_back(first);
+    cmd->requests = 0;
+    ASSERT_EQ(std::vector<ByteVector>{first}, cmd->inventory());
+    ASSERT_EQ(1u, cmd->requests);
+
+    // Several tags, two of them sharing their 20 first bits.
+    cmd->tags.push_back({0x25, 0x1a, 0x2b, 0x3c, 0x4d, 0x01, 0x04, 0xe0});
+    cmd->tags.push_back({0x15, 0x1a, 0x0b, 0x3c, 0x4d, 0x01, 0x04, 0xe0});
+    cmd->tags.push_back({0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x04, 0xe0});
+    cmd->requests                 = 0;
+    std::vector<ByteVector> found = cmd->inventory();
+    std::sort(found.begin(), found.end());
+    std::vector<ByteVector> expected = cmd->tags;
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(expected, found);
+    // Each collision splits on one bit. The deepest one is on bit 21: the first
+    // request and 2 requests per bit down to it.
+    ASSERT_LE(cmd->requests, 1u + 2u * 22u);
+}
+
+TEST(test_iso15693_pcsc_inventory, transparent_exchange_answers)
+{
+    auto adapter = std::make_shared<TransparentExchangeAdapter>();
+    auto cmd     = makeCommands<ISO15693PCSCCommands>(adapter);
+
+    // 64 01: no VICC answered.
+    adapter->answer = {0xc0, 0x03, 0x01, 0x64, 0x01};
+    ASSERT_TRUE(cmd->inventory().empty());
+    ASSERT_EQ(1u, adapter->exchanges);
+
+    // A single VICC: flags, DSFID and UID.
+    adapter->answer    = {0x97, 0x0a, 0x00, 0x00, 0x15, 0x1a, 0x2b,
+                       0x3c, 0x4d, 0x01, 0x04, 0xe0};
+    adapter->exchanges = 0;
+    ASSERT_EQ(std::vector<ByteVector>{ByteVector(adapter->answer.begin() + 4,
+                                                 adapter->answer.end())},
+              cmd->inventory());
+    ASSERT_EQ(1u, adapter->exchanges);
+}
+
+TEST(test_iso15693_pcsc_inventory, persistent_error)
+{
+    auto adapter = std::make_shared<TransparentExchangeAdapter>();
+    auto cmd     = makeCommands<ISO15693PCSCCommands>(adapter);
+
+    // 6A 81: function not supported. It isn't taken for a collision, which
+    // would split the mask on every bit of the UID.
+    adapter->answer = {0xc0, 0x03, 0x01, 0x6a, 0x81};
+    ASSERT_THROW(cmd->inventory(), CardException);
+    ASSERT_EQ(1u, adapter->exchanges);
+
+    // Unknown response status.
+    adapter->answer    = {0x96, 0x02, 0x80, 0x00};
+    adapter->exchanges = 0;
+    ASSERT_THROW(cmd->inventory(), CardException);
+    ASSERT_EQ(1u, adapter->exchanges);
+}
@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/cards/chip.hpp>
+#include <logicalaccess/cards/location.hpp>
+#include <logicalaccess/services/accesscontrol/accesscontrolcardservice.hpp>
+#include <logicalaccess/services/json/json_dump_card_service.hpp>
+#include <logicalaccess/services/storage/storagecardservice.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <nlohmann/json.hpp>
+
+using namespace logicalaccess;
+
+namespace
+{
+class FileLocation : public Location
+{
+  public:
+    FileLocation(int file, unsigned int byte)
+        : file(file)
+        , byte_(byte)
+    {
+    }
+
+    std::string getCardType() override
+    {
+        return "Test";
+    }
+
+    void incrementOffset(int increment) override
+    {
+        byte_ += increment;
+    }
+
+    std::shared_ptr<Location> clone() const override
+    {
+        return std::make_shared<FileLocation>(*this);
+    }
+
+    bool operator==(const Location &location) const override
+    {
+        auto other = dynamic_cast<const FileLocation *>(&location);
+        return other && other->file == file && other->byte_ == byte_;
+    }
+
+    void serialize(boost::property_tree::ptree &) override
+    {
+    }
+
+    void unSerialize(boost::property_tree::ptree &) override
+    {
+    }
+
+    std::string getDefaultXmlNodeName() const override
+    {
+        return "FileLocation";
+    }
+
+    int file;
+
+    unsigned int byte_;
+};
+
+class FileStorageCardService : public StorageCardService
+{
+  public:
+    explicit FileStorageCardService(std::shared_ptr<Chip> chip)
+        : StorageCardService(chip)
+        , reads(0)
+    {
+    }
+
+    std::string getCSType() override
+    {
+        return "Test";
+    }
+
+    void erase(std::shared_ptr<Location>, std::shared_ptr<AccessInfo>) override
+    {
+    }
+
+    void writeData(std::shared_ptr<Location>, std::shared_ptr<AccessInfo>,
+                   std::shared_ptr<AccessInfo>, const ByteVector &, CardBehavior) override
+    {
+    }
+
+    ByteVector readData(std::shared_ptr<Location> location, std::shared_ptr<AccessInfo>,
+                        size_t length, CardBehavior) override
+    {
+        ++reads;
+        auto fileLocation = std::dynamic_pointer_cast<FileLocation>(location);
+        const ByteVector &file = files.at(fileLocation->file);
+        // Like DESFire, a length of 0 reads up to the end of the file.
+        if (length == 0 && fileLocation->byte_ <= file.size())
+            length = file.size() - fileLocation->byte_;
+        if (fileLocation->byte_ + length > file.size())
+            throw std::runtime_error("Out of file.");
+        return ByteVector(file.begin() + fileLocation->byte_,
+                          file.begin() + fileLocation->byte_ + length);
+    }
+
+    ByteVector readDataHeader(std::shared_ptr<Location>,
+                              std::shared_ptr<AccessInfo>) override
+    {
+        return {};
+    }
+
+    std::map<int, ByteVector> files;
+
+    size_t reads;
+};
+
+class FileChip : public Chip
+{
+  public:
+    FileChip()
+        : Chip("Test")
+    {
+    }
+
+    std::shared_ptr<CardService> getService(CardServiceType serviceType) override
+    {
+        if (serviceType == CST_STORAGE)
+        {
+            if (!storage)
+                storage = std::make_shared<FileStorageCardService>(shared_from_this());
+            return storage;
+        }
+        if (serviceType == CST_ACCESS_CONTROL)
+            return std::make_shared<AccessControlCardService>(shared_from_this());
+        return Chip::getService(serviceType);
+    }
+
+    std::shared_ptr<FileStorageCardService> storage;
+};
+
+class FileJsonDumpCardService : public JsonDumpCardService
+{
+  public:
+    explicit FileJsonDumpCardService(const std::shared_ptr<Chip> &chip, bool plan,
+                                     bool readsToEnd = false)
+        : JsonDumpCardService(chip)
+        , sizeRequests(0)
+        , plan_(plan)
+        , readsToEnd_(readsToEnd)
+    {
+    }
+
+    size_t sizeRequests;
+
+  protected:
+    bool get_file_location(const std::shared_ptr<Location> &location,
+                           std::shared_ptr<Location> &file_location,
+                           size_t &offset) override
+    {
+        auto fileLocation = std::dynamic_pointer_cast<FileLocation>(location);
+        if (!plan_ || !fileLocation)
+            return false;
+        file_location = std::make_shared<FileLocation>(fileLocation->file, 0);
+        offset        = fileLocation->byte_;
+        return true;
+    }
+
+    size_t get_file_size(const std::shared_ptr<Location> &file_location,
+                         const std::shared_ptr<AccessInfo> &) override
+    {
+        ++sizeRequests;
+        auto chip = std::dynamic_pointer_cast<FileChip>(getChip());
+        return chip->storage->files.at(
+            std::dynamic_pointer_cast<FileLocation>(file_location)->file).size();
+    }
+
+    bool reads_to_end(const std::shared_ptr<Location> &) override
+    {
+        return readsToEnd_;
+    }
+
+  private:
+    std::shared_ptr<Key> create_key(const nlohmann::json &) override
+    {
+        return nullptr;
+    }
+
+    void configure_format_infos(const nlohmann::json &json) override
+    {
+        for (const auto &file : json.at("files"))
+        {
+            auto fi = std::make_shared<FormatInfos>();
+            fi->setLocation(std::make_shared<FileLocation>(
+                file.at("file").get<int>(), file.at("offset").get<unsigned int>()));
+            fi->setFormat(formats_.at(file.at("format")));
+            format_infos_[file.at("name")] = fi;
+        }
+    }
+
+    bool plan_;
+
+    bool readsToEnd_;
+};
+
+const char *TEMPLATE = R"({
+    "formats": {
+        "number": {
+            "name": "number",
+            "fields": [{"name": "value", "len": 16, "type": "FIELD_TYPE_NUMBER",
+                        "default_value": "0", "is_identifier": true}]
+        },
+        "records": {
+            "name": "records",
+            "is_repeated": true,
+            "fields": [{"name": "value", "len": 16, "type": "FIELD_TYPE_NUMBER",
+                        "default_value": "0", "is_identifier": false}]
+        }
+    },
+    "keyValues": {},
+    "files": [
+        {"name": "APP.id", "file": 1, "offset": 0, "format": "number"},
+        {"name": "APP.pin", "file": 1, "offset": 2, "format": "number"},
+        {"name": "APP.log", "file": 2, "offset": 0, "format": "records"}
+    ]
+})";
+
+std::shared_ptr<FileChip> create_chip()
+{
+    auto chip = std::make_shared<FileChip>();
+    chip->getService(CST_STORAGE);
+    chip->storage->files[1] = {0x12, 0x34, 0x00, 0x2a};
+    chip->storage->files[2] = {0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00};
+    return chip;
+}
+
+nlohmann::json dump(bool plan, size_t &reads)
+{
+    auto chip = create_chip();
+    FileJsonDumpCardService service(chip, plan);
+    service.configure(TEMPLATE);
+    auto result = nlohmann::json::parse(service.dump());
+    reads       = chip->storage->reads;
+    return result;
+}
+}
+
+TEST(json_dump_read_plan, one_read_per_file)
+{
+    size_t reads;
+    auto result = dump(true, reads);
+
+    ASSERT_EQ(2u, reads);
+    ASSERT_EQ(0x1234, result["APP.id"]["value"]["value"].get<int>());
+    ASSERT_EQ(42, result["APP.pin"]["value"]["value"].get<int>());
+    ASSERT_EQ(2u, result["APP.log"].size());
+    ASSERT_EQ(1, result["APP.log"][0]["value"]["value"].get<int>());
+    ASSERT_EQ(2, result["APP.log"][1]["value"]["value"].get<int>());
+}
+
+TEST(json_dump_read_plan, same_result_as_format_reads)
+{
+    size_t plannedReads, formatReads;
+    auto planned = dump(true, plannedReads);
+    auto formats = dump(false, formatReads);
+
+    ASSERT_EQ(formats, planned);
+    ASSERT_LT(plannedReads, formatReads);
+}
+
+TEST(json_dump_read_plan, streamed_output)
+{
+    FileJsonDumpCardService service(create_chip(), true);
+    service.configure(TEMPLATE);
+
+    std::ostringstream out;
+    service.dump(out);
+
+    ASSERT_EQ(std::string::npos, out.str().find('\n'));
+    ASSERT_EQ(nlohmann::json::parse(service.dump()), nlohmann::json::parse(out.str()));
+}
+
+TEST(json_dump_read_plan, read_to_end_of_file)
+{
+    auto chip = create_chip();
+    FileJsonDumpCardService service(chip, true, true);
+    service.configure(TEMPLATE);
+    auto result = nlohmann::json::parse(service.dump());
+
+    ASSERT_EQ(0u, service.sizeRequests);
+    ASSERT_EQ(2u, chip->storage->reads);
+    size_t reads;
+    ASSERT_EQ(dump(true, reads), result);
+}
+
+TEST(json_dump_read_plan, format_reads_keep_locations)
+{
+    FileJsonDumpCardService service(create_chip(), false);
+    service.configure(TEMPLATE);
+
+    // The records are read from a copy of the configured location.
+    auto first = nlohmann::json::parse(service.dump());
+    ASSERT_EQ(2u, first["APP.log"].size());
+    ASSERT_EQ(first, nlohmann::json::parse(service.dump()));
+}
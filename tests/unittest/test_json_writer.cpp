@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/services/json/json_writer.hpp>
+#include <nlohmann/json.hpp>
+
+#include <sstream>
+
+using namespace logicalaccess;
+
+TEST(test_json_writer, compact_output)
+{
+    std::ostringstream out;
+    JsonWriter writer(out);
+    writer.startObject();
+    writer.key("a");
+    writer.value(uint64_t(1));
+    writer.key("b");
+    writer.startArray();
+    writer.value(true);
+    writer.startObject();
+    writer.endObject();
+    writer.startArray();
+    writer.endArray();
+    writer.value("x");
+    writer.endArray();
+    writer.endObject();
+
+    ASSERT_EQ(R"({"a":1,"b":[true,{},[],"x"]})", out.str());
+}
+
+TEST(test_json_writer, string_escaping)
+{
+    std::string str("quote \" backslash \\ tab \t newline \n nul ");
+    str.push_back('\0');
+    str += " \x1f \xc3\xa9";
+
+    std::ostringstream out;
+    JsonWriter writer(out);
+    writer.value(str);
+
+    ASSERT_EQ(str, nlohmann::json::parse(out.str()).get<std::string>());
+    ASSERT_EQ(nlohmann::json(str).dump(), out.str());
+}
+
+TEST(test_json_writer, invalid_utf8)
+{
+    // Truncated, lone continuation, overlong, surrogate and above U+10FFFF.
+    const std::string invalid[] = {"\xc3", "\x80", "\xc0\xaf", "\xed\xa0\x80",
+                                   "\xf4\x90\x80\x80"};
+    for (const std::string &sequence : invalid)
+    {
+        std::ostringstream out;
+        JsonWriter writer(out);
+        writer.value("a" + sequence + "b");
+
+        std::string parsed = nlohmann::json::parse(out.str()).get<std::string>();
+        ASSERT_EQ('a', parsed.front());
+        ASSERT_EQ('b', parsed.back());
+        ASSERT_NE(std::string::npos, parsed.find("\xef\xbf\xbd"));
+    }
+
+    std::ostringstream out;
+    JsonWriter writer(out);
+    writer.value("\xf0\x9f\x94\x91 \xe2\x82\xac");
+    ASSERT_EQ("\"\xf0\x9f\x94\x91 \xe2\x82\xac\"", out.str());
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/cards/aes128key.hpp>
+#include <logicalaccess/securememory.hpp>
+
+#include <openssl/crypto.h>
+
+#include <boost/property_tree/ptree.hpp>
+
+using namespace logicalaccess;
+
+TEST(test_key, test_cipher_round_trip)
+{
+    AES128Key key("00 11 22 33 44 55 66 77 88 99 aa bb cc dd ee ff");
+    key.setCipherKey("passphrase");
+
+    boost::property_tree::ptree parentNode;
+    key.serialize(parentNode);
+    boost::property_tree::ptree &node = parentNode.get_child(key.getDefaultXmlNodeName());
+    ASSERT_TRUE(node.get<bool>("IsCiphered"));
+    ASSERT_NE(key.getString(), node.get<std::string>("Data"));
+
+    // Twice, the second time with the derived key from the cache.
+    for (int i = 0; i < 2; ++i)
+    {
+        AES128Key loaded;
+        loaded.setCipherKey("passphrase");
+        loaded.unSerialize(node);
+        ASSERT_EQ(key, loaded);
+    }
+
+    // Another passphrase derives another key.
+    boost::property_tree::ptree otherNode;
+    key.setCipherKey("another passphrase");
+    key.serialize(otherNode);
+    ASSERT_NE(node.get<std::string>("Data"),
+              otherNode.get_child(key.getDefaultXmlNodeName()).get<std::string>("Data"));
+}
+
+TEST(test_key, test_data_view)
+{
+    AES128Key key("00 11 22 33 44 55 66 77 88 99 aa bb cc dd ee ff");
+    KeyDataView view = key.getDataView();
+    ByteVector data  = key.getData();
+    ASSERT_EQ(16u, view.size());
+    ASSERT_EQ(data, ByteVector(view.begin(), view.end()));
+
+    // Shorter data are padded, like getData().
+    AES128Key empty;
+    KeyDataView padded = empty.getDataView();
+    ASSERT_EQ(ByteVector(16, 0x00), ByteVector(padded.begin(), padded.end()));
+}
+
+TEST(test_key, test_is_equal)
+{
+    AES128Key a("00 11 22 33 44 55 66 77 88 99 aa bb cc dd ee ff");
+    AES128Key b("00 11 22 33 44 55 66 77 88 99 aa bb cc dd ee ff");
+    AES128Key c("00 11 22 33 44 55 66 77 88 99 aa bb cc dd ee 00");
+    ASSERT_TRUE(a.isEqual(b));
+    ASSERT_FALSE(a.isEqual(c));
+}
+
+TEST(test_key, test_secure_byte_vector)
+{
+    SecureByteVector buffer(64, 0xAA);
+    buffer.resize(4096, 0x55);
+    ASSERT_EQ(0xAA, buffer[0]);
+    ASSERT_EQ(0x55, buffer[4095]);
+
+    // The secure heap is set up by the first allocation. Without it, the memory
+    // is allocated outside of it.
+    const bool secureHeap = CRYPTO_secure_malloc_initialized() != 0;
+#ifdef __linux__
+    // Available on Linux even when the memory can't be locked.
+    ASSERT_TRUE(secureHeap);
+#endif
+    ASSERT_EQ(secureHeap, CRYPTO_secure_allocated(buffer.data()) != 0);
+
+    // Larger than the secure heap: still allocated, outside of it.
+    SecureByteVector large(1024 * 1024, 0x11);
+    ASSERT_EQ(0x11, large.back());
+    ASSERT_EQ(0xAA, buffer[0]);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/llacommon/logs.hpp>
+#include <logicalaccess/plugins/llacommon/settings.hpp>
+
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <thread>
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * Log to a temporary file for the test duration.
+ */
+class LogCapture
+{
+  public:
+    LogCapture()
+        : path_((boost::filesystem::temp_directory_path() /
+                 boost::filesystem::unique_path())
+                    .string())
+        , enabled_(Settings::getInstance()->IsLogEnabled)
+    {
+        Settings::getInstance()->IsLogEnabled = true;
+        Logs::logfile.open(path_);
+    }
+
+    ~LogCapture()
+    {
+        Logs::logfile.close();
+        Settings::getInstance()->IsLogEnabled = enabled_;
+        std::remove(path_.c_str());
+    }
+
+    std::string content()
+    {
+        Logs::logfile.flush();
+        std::ifstream file(path_);
+        return std::string(std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>());
+    }
+
+  private:
+    std::string path_;
+
+    bool enabled_;
+};
+
+bool contains(const std::string &str, const std::string &part)
+{
+    return str.find(part) != std::string::npos;
+}
+}
+
+TEST(test_log_filter, context_mask)
+{
+    LogCapture capture;
+    ASSERT_EQ(LOG_ALL_LEVELS, LogContext::getThreadLogMask());
+    {
+        LogContext filter("", logLevelBit(ERRORS));
+        LOG(INFOS) << "filtered info";
+        LOG(ERRORS) << "kept error";
+        {
+            // Nested masks can only restrict the enabled levels.
+            LogContext nested("", LOG_ALL_LEVELS);
+            LOG(INFOS) << "nested info";
+        }
+    }
+    LOG(INFOS) << "restored info";
+    ASSERT_EQ(LOG_ALL_LEVELS, LogContext::getThreadLogMask());
+
+    std::string logs = capture.content();
+    ASSERT_FALSE(contains(logs, "filtered info"));
+    ASSERT_TRUE(contains(logs, "kept error"));
+    ASSERT_FALSE(contains(logs, "nested info"));
+    ASSERT_TRUE(contains(logs, "restored info"));
+}
+
+TEST(test_log_filter, disabler_is_per_thread)
+{
+    LogCapture capture;
+    {
+        LogDisabler disabler;
+        LOG(INFOS) << "disabled thread";
+
+        std::thread other([]() { LOG(INFOS) << "other thread"; });
+        other.join();
+    }
+    ASSERT_TRUE(Settings::getInstance()->IsLogEnabled);
+
+    std::string logs = capture.content();
+    ASSERT_FALSE(contains(logs, "disabled thread"));
+    ASSERT_TRUE(contains(logs, "other thread"));
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/metrics.hpp>
+
+#include <stdexcept>
+
+using namespace logicalaccess;
+
+TEST(test_metrics, histogram_quantiles)
+{
+    MetricHistogram histogram;
+    ASSERT_EQ(0, histogram.getQuantile(0.5));
+
+    // 100 values in the (1000, 2500] us bucket, 1 in the (50, 100] ms one.
+    for (int i = 0; i < 100; ++i)
+        histogram.observe(2000);
+    histogram.observe(80000);
+
+    ASSERT_EQ(101u, histogram.getCount());
+    ASSERT_EQ(280000u, histogram.getSum());
+    ASSERT_GT(histogram.getQuantile(0.5), 1000);
+    ASSERT_LE(histogram.getQuantile(0.5), 2500);
+    ASSERT_GT(histogram.getQuantile(1), 50000);
+    ASSERT_LE(histogram.getQuantile(1), 100000);
+}
+
+TEST(test_metrics, prometheus_format)
+{
+    MetricsRegistry &registry = MetricsRegistry::getInstance();
+    registry.reset();
+    registry.getHistogram("test_latency_seconds", {{"reader", "Reader \"1\""}})
+        .observe(300);
+    registry.getCounter("test_events_total", {{"result", "ok"}}).increment(2);
+
+    const std::string text = registry.toPrometheus();
+    ASSERT_NE(std::string::npos, text.find("# TYPE test_events_total counter\n"
+                                           "test_events_total{result=\"ok\"} 2\n"));
+    ASSERT_NE(std::string::npos, text.find("# TYPE test_latency_seconds histogram\n"));
+    ASSERT_NE(std::string::npos,
+              text.find("test_latency_seconds_bucket{reader=\"Reader \\\"1\\\"\","
+                        "le=\"0.00025\"} 0\n"));
+    ASSERT_NE(std::string::npos,
+              text.find("test_latency_seconds_bucket{reader=\"Reader \\\"1\\\"\","
+                        "le=\"0.0005\"} 1\n"));
+    ASSERT_NE(std::string::npos,
+              text.find("test_latency_seconds_bucket{reader=\"Reader \\\"1\\\"\","
+                        "le=\"+Inf\"} 1\n"));
+    ASSERT_NE(std::string::npos,
+              text.find("test_latency_seconds_count{reader=\"Reader \\\"1\\\"\"} 1\n"));
+}
+
+TEST(test_metrics, recorder_result)
+{
+    MetricsRegistry &registry = MetricsRegistry::getInstance();
+    registry.reset();
+    {
+        LatencyRecorder recorder("test_operation", {{"reader", "r"}});
+        recorder.succeed();
+    }
+    try
+    {
+        LatencyRecorder recorder("test_operation", {{"reader", "r"}});
+        throw std::runtime_error("failure");
+    }
+    catch (const std::runtime_error &)
+    {
+    }
+
+    ASSERT_EQ(2u, registry.getHistogram("test_operation_seconds", {{"reader", "r"}})
+                      .getCount());
+    ASSERT_EQ(1u, registry
+                      .getCounter("test_operation_total",
+                                  {{"reader", "r"}, {"result", "ok"}})
+                      .getValue());
+    ASSERT_EQ(1u, registry
+                      .getCounter("test_operation_total",
+                                  {{"reader", "r"}, {"result", "error"}})
+                      .getValue());
+
+    registry.setEnabled(false);
+    {
+        LatencyRecorder recorder("test_operation", {{"reader", "r"}});
+        recorder.succeed();
+    }
+    registry.setEnabled(true);
+    ASSERT_EQ(2u, registry.getHistogram("test_operation_seconds", {{"reader", "r"}})
+                      .getCount());
+}
+
+TEST(test_metrics, resolved_metrics)
+{
+    MetricsRegistry &registry = MetricsRegistry::getInstance();
+    registry.reset();
+    auto metrics =
+        std::make_shared<LatencyMetrics>("test_resolved", MetricLabels{{"reader", "r"}});
+    ASSERT_EQ("r", metrics->getLabel("reader"));
+    ASSERT_EQ("", metrics->getLabel("card"));
+    {
+        LatencyRecorder recorder(metrics);
+        recorder.succeed();
+    }
+    {
+        LatencyRecorder recorder(metrics);
+        recorder.setResult("timeout");
+    }
+    {
+        LatencyRecorder recorder(nullptr);
+        recorder.succeed();
+    }
+
+    ASSERT_EQ(2u, registry.getHistogram("test_resolved_seconds", {{"reader", "r"}})
+                      .getCount());
+    ASSERT_EQ(1u, registry
+                      .getCounter("test_resolved_total",
+                                  {{"reader", "r"}, {"result", "ok"}})
+                      .getValue());
+    ASSERT_EQ(1u, registry
+                      .getCounter("test_resolved_total",
+                                  {{"reader", "r"}, {"result", "timeout"}})
+                      .getValue());
+}
+
+TEST(test_metrics, prometheus_precision)
+{
+    MetricsRegistry &registry = MetricsRegistry::getInstance();
+    registry.reset();
+    registry.getHistogram("test_precision_seconds", {}).observe(123456789);
+    registry.getHistogram("test_precision_seconds", {}).observe(9007199254740000ULL);
+
+    // The sum is exported without losing microseconds.
+    const std::string text = registry.toPrometheus();
+    size_t begin = text.find("test_precision_seconds_sum ");
+    ASSERT_NE(std::string::npos, begin);
+    begin += std::string("test_precision_seconds_sum ").size();
+    ASSERT_EQ(static_cast<double>(9007199254740000ULL + 123456789) / 1000000.0,
+              std::stod(text.substr(begin, text.find('\n', begin) - begin)));
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/pkcs/pkcssessionpool.hpp>
+#include "cppkcs11/cppkcs11.hpp"
+
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace logicalaccess;
+
+// Built with the LLA_TESTS_SOFTHSM option. LLA_PKCS_MODULE is the SoftHSM
+// library, LLA_PKCS_SLOT and LLA_PKCS_PIN the slot and user PIN of an
+// initialized token.
+
+namespace
+{
+std::string getEnv(const char *name, const std::string &defaultValue)
+{
+    const char *value = std::getenv(name);
+    return value ? value : defaultValue;
+}
+
+class test_pkcs_session_pool : public ::testing::Test
+{
+  protected:
+    static void SetUpTestCase()
+    {
+        cppkcs::load_pkcs(getEnv("LLA_PKCS_MODULE", "/usr/lib/softhsm/libsofthsm2.so"));
+        cppkcs::initialize();
+    }
+
+    test_pkcs_session_pool()
+        : slot(std::stoul(getEnv("LLA_PKCS_SLOT", "0")))
+        , pin(getEnv("LLA_PKCS_PIN", "1234"))
+    {
+    }
+
+    /**
+     * Run an empty operation, returning the session it was given.
+     */
+    cppkcs::Session *lease(PKCSSessionPool &pool)
+    {
+        cppkcs::Session *leased = nullptr;
+        pool.run(slot, pin, {},
+                 [&](cppkcs::Session &session, const std::vector<cppkcs::Object *> &) {
+                     leased = &session;
+                     return std::vector<ByteVector>();
+                 });
+        return leased;
+    }
+
+    CK_SLOT_ID slot;
+
+    std::string pin;
+};
+}
+
+// First, while the token isn't logged in by another pool of the process.
+TEST_F(test_pkcs_session_pool, wrong_pin)
+{
+    PKCSSessionPool pool;
+    bool called = false;
+    ASSERT_ANY_THROW(pool.run(
+        slot, pin + "0", {},
+        [&](cppkcs::Session &, const std::vector<cppkcs::Object *> &) {
+            called = true;
+            return std::vector<ByteVector>();
+        }));
+    ASSERT_FALSE(called);
+
+    // The failed session isn't counted: the next one logs in.
+    ASSERT_NE(nullptr, lease(pool));
+}
+
+TEST_F(test_pkcs_session_pool, sessions_are_reused)
+{
+    PKCSSessionPool pool;
+    cppkcs::Session *first = lease(pool);
+    ASSERT_NE(nullptr, first);
+    ASSERT_EQ(first, lease(pool));
+}
+
+TEST_F(test_pkcs_session_pool, concurrent_leases)
+{
+    PKCSSessionPool pool;
+    cppkcs::Session *outer = nullptr, *inner = nullptr;
+    pool.run(slot, pin, {},
+             [&](cppkcs::Session &session, const std::vector<cppkcs::Object *> &) {
+                 outer = &session;
+                 // The lent session isn't shared: a second one is opened, on the
+                 // same login.
+                 inner = lease(pool);
+                 return std::vector<ByteVector>();
+             });
+    ASSERT_NE(nullptr, inner);
+    ASSERT_NE(outer, inner);
+
+    // Both are idle now.
+    cppkcs::Session *next = lease(pool);
+    ASSERT_TRUE(next == outer || next == inner);
+}
+
+TEST_F(test_pkcs_session_pool, failed_operation_discards_session)
+{
+    PKCSSessionPool pool;
+    ASSERT_NE(nullptr, lease(pool));
+    ASSERT_THROW(pool.run(slot, pin, {},
+                          [](cppkcs::Session &, const std::vector<cppkcs::Object *> &)
+                              -> std::vector<ByteVector> {
+                              throw std::runtime_error("operation failed");
+                          }),
+                 std::runtime_error);
+
+    // Closing the last session logged the token out: the next one logs in again.
+    ASSERT_NE(nullptr, lease(pool));
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/readerproviders/readermonitor.hpp>
+#include <logicalaccess/readerproviders/dummyreaderunit.hpp>
+#include <logicalaccess/utils.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+
+using namespace logicalaccess;
+
+namespace
+{
+class NamedReaderUnit : public DummyReaderUnit
+{
+  public:
+    explicit NamedReaderUnit(std::string name)
+        : DummyReaderUnit(name)
+        , name_(name)
+    {
+    }
+
+    std::string getName() const override
+    {
+        return name_;
+    }
+
+  private:
+    std::string name_;
+};
+
+/**
+ * A reader provider notifying each change of its system reader list.
+ */
+class HotPlugReaderProvider : public ReaderProvider
+{
+  public:
+    void plug(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        system_.push_back(name);
+        changed_ = true;
+        condition_.notify_all();
+    }
+
+    void unplug(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        system_.erase(std::find(system_.begin(), system_.end(), name));
+        changed_ = true;
+        condition_.notify_all();
+    }
+
+    void release() override
+    {
+    }
+
+    bool refreshReaderList() override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        readers_.clear();
+        for (const auto &name : system_)
+            readers_.push_back(std::make_shared<NamedReaderUnit>(name));
+        return true;
+    }
+
+    const ReaderList &getReaderList() override
+    {
+        return readers_;
+    }
+
+    bool waitReaderListChange(unsigned int maxwait) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool changed = condition_.wait_for(lock, std::chrono::milliseconds(maxwait),
+                                           [this]() { return changed_; });
+        changed_ = false;
+        return changed;
+    }
+
+    std::string getRPType() const override
+    {
+        return "HotPlug";
+    }
+
+    std::string getRPName() const override
+    {
+        return "HotPlug";
+    }
+
+    std::shared_ptr<ReaderUnit> createReaderUnit() override
+    {
+        return std::make_shared<NamedReaderUnit>("");
+    }
+
+  private:
+    std::mutex mutex_;
+
+    std::condition_variable condition_;
+
+    bool changed_ = false;
+
+    std::vector<std::string> system_;
+
+    ReaderList readers_;
+};
+}
+
+TEST(test_reader_monitor, added_and_removed)
+{
+    auto provider = std::make_shared<HotPlugReaderProvider>();
+    provider->plug("reader1");
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::string> events;
+    auto record = [&](const std::string &prefix) {
+        return [&, prefix](std::shared_ptr<ReaderUnit> reader) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.push_back(prefix + reader->getName());
+            condition.notify_all();
+        };
+    };
+    auto waitEvents = [&](size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return condition.wait_for(lock, std::chrono::seconds(2),
+                                  [&]() { return events.size() >= count; });
+    };
+
+    ReaderMonitor monitor(provider);
+    monitor.setStopLatency(1000);
+    monitor.start(record("+"), record("-"));
+    ASSERT_TRUE(monitor.isStarted());
+    ASSERT_TRUE(waitEvents(1));
+
+    ElapsedTimeCounter counter;
+    provider->plug("reader2");
+    ASSERT_TRUE(waitEvents(2));
+    provider->unplug("reader1");
+    ASSERT_TRUE(waitEvents(3));
+    // Notified changes don't wait for the stop latency.
+    ASSERT_LT(counter.elapsed(), 500u);
+
+    ASSERT_EQ(std::vector<std::string>({"+reader1", "+reader2", "-reader1"}), events);
+}
+
+TEST(test_reader_monitor, wait_for_readers)
+{
+    auto provider = std::make_shared<HotPlugReaderProvider>();
+
+    std::thread plug([provider]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        provider->plug("reader");
+    });
+
+    ElapsedTimeCounter counter;
+    ReaderList readers = provider->waitForReaders({"reader"}, 5, false);
+    plug.join();
+    ASSERT_EQ(1u, readers.size());
+    ASSERT_LT(counter.elapsed(), 500u);
+
+    ASSERT_TRUE(provider->waitForReaders({"other"}, 0.1, false).empty());
+}
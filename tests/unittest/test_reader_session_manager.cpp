@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/readerproviders/readersessionmanager.hpp>
+#include <logicalaccess/readerproviders/dummyreaderunit.hpp>
+
+#include <atomic>
+
+using namespace logicalaccess;
+
+namespace
+{
+/**
+ * A reader unit checking that its operations never overlap.
+ */
+class SerialReaderUnit : public DummyReaderUnit
+{
+  public:
+    SerialReaderUnit()
+        : DummyReaderUnit("serial")
+        , running_(false)
+        , overlapped_(false)
+    {
+    }
+
+    void operation(unsigned int duration)
+    {
+        if (running_.exchange(true))
+            overlapped_ = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(duration));
+        running_ = false;
+    }
+
+    bool overlapped() const
+    {
+        return overlapped_;
+    }
+
+  private:
+    std::atomic<bool> running_;
+
+    std::atomic<bool> overlapped_;
+};
+}
+
+TEST(test_reader_session_manager, per_reader_serialization)
+{
+    ReaderSessionManager manager(4);
+    std::vector<std::shared_ptr<SerialReaderUnit>> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.push_back(std::make_shared<SerialReaderUnit>());
+        manager.addReader(readers.back());
+    }
+
+    std::vector<std::future<int>> results;
+    ElapsedTimeCounter counter;
+    for (int i = 0; i < 5; ++i)
+    {
+        for (const auto &reader : readers)
+        {
+            results.push_back(manager.post(reader, [i](std::shared_ptr<ReaderUnit> unit) {
+                std::dynamic_pointer_cast<SerialReaderUnit>(unit)->operation(20);
+                return i;
+            }));
+        }
+    }
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        ASSERT_EQ(static_cast<int>(i / readers.size()), results[i].get());
+    }
+    // 5 operations of 20ms per reader, the readers in parallel.
+    ASSERT_LT(counter.elapsed(), 400u);
+
+    for (const auto &reader : readers)
+    {
+        ASSERT_FALSE(reader->overlapped());
+    }
+
+    // The statistics are updated before the results are available.
+    std::vector<ReaderSessionStatistics> statistics = manager.getStatistics();
+    ASSERT_EQ(4u, statistics.size());
+    for (const auto &s : statistics)
+    {
+        ASSERT_EQ(5u, s.completed);
+        ASSERT_EQ(0u, s.failed);
+        ASSERT_EQ(0u, s.queueDepth);
+        ASSERT_GE(s.totalRunTime, 100000u);
+        ASSERT_GE(s.maxLatency, 20000u);
+    }
+}
+
+TEST(test_reader_session_manager, exceptions_and_removal)
+{
+    ReaderSessionManager manager(1);
+    auto reader = std::make_shared<SerialReaderUnit>();
+    manager.addReader(reader);
+
+    // DummyReaderUnit throws on every call.
+    std::future<bool> removal = manager.waitRemoval(reader, 0);
+    ASSERT_THROW(removal.get(), std::exception);
+
+    std::future<void> slow = manager.post(reader, [](std::shared_ptr<ReaderUnit> unit) {
+        std::dynamic_pointer_cast<SerialReaderUnit>(unit)->operation(50);
+    });
+    std::future<void> dropped = manager.post(reader, [](std::shared_ptr<ReaderUnit>) {});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    manager.removeReader(reader);
+
+    slow.get();
+    ASSERT_THROW(dropped.get(), std::future_error);
+    ASSERT_TRUE(manager.getReaders().empty());
+    ASSERT_THROW(manager.post(reader, [](std::shared_ptr<ReaderUnit>) {}),
+                 std::invalid_argument);
+}
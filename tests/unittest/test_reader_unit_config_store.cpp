@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/readerproviders/readerunitconfigstore.hpp>
+#include <logicalaccess/cards/chip.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+using namespace logicalaccess;
+
+namespace
+{
+void writeConfig(const std::string &filename, const std::string &cardType)
+{
+    std::ofstream ofs(filename.c_str(), std::ios_base::trunc);
+    ofs << "<config><cardType>" << cardType << "</cardType></config>";
+}
+}
+
+TEST(test_reader_unit_config_store, test_refresh)
+{
+    std::string filename =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+            .string();
+    ReaderUnitConfigStore &store = ReaderUnitConfigStore::getInstance("test.config");
+    store.setWatchInterval(0);
+
+    store.setFilename(filename);
+    ASSERT_EQ(CHIP_UNKNOWN, store.getConfig()->cardType);
+    ASSERT_FALSE(store.refresh());
+
+    std::vector<std::string> notified;
+    size_t id = store.addListener([&notified](
+        std::shared_ptr<const ReaderUnitConfigStore::Config> config) {
+        notified.push_back(config->cardType);
+    });
+
+    writeConfig(filename, "Mifare1K");
+    ASSERT_TRUE(store.refresh());
+    ASSERT_EQ("Mifare1K", store.getConfig()->cardType);
+    ASSERT_FALSE(store.refresh());
+
+    // The same size, within the same second.
+    writeConfig(filename, "Mifare4K");
+    ASSERT_TRUE(store.refresh());
+    ASSERT_EQ("Mifare4K", store.getConfig()->cardType);
+
+    writeConfig(filename, "DESFireEV1");
+    ASSERT_TRUE(store.refresh());
+    ASSERT_EQ("DESFireEV1", store.getConfig()->cardType);
+
+    store.removeListener(id);
+    boost::filesystem::remove(filename);
+    ASSERT_TRUE(store.refresh());
+    ASSERT_EQ(CHIP_UNKNOWN, store.getConfig()->cardType);
+
+    ASSERT_EQ((std::vector<std::string>{"Mifare1K", "Mifare4K", "DESFireEV1"}), notified);
+    store.setFilename("");
+}
+
+TEST(test_reader_unit_config_store, test_watch)
+{
+    std::string filename =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+            .string();
+    ReaderUnitConfigStore &store = ReaderUnitConfigStore::getInstance("test.config");
+    store.setFilename(filename);
+    store.setWatchInterval(10);
+
+    writeConfig(filename, "Mifare4K");
+    for (int i = 0; i < 200 && store.getConfig()->cardType != "Mifare4K"; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ("Mifare4K", store.getConfig()->cardType);
+
+    store.setWatchInterval(ReaderUnitConfigStore::DEFAULT_WATCH_INTERVAL);
+    boost::filesystem::remove(filename);
+    store.setFilename("");
+}
+
+TEST(test_reader_unit_config_store, test_watch_several_stores)
+{
+    std::string first =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+            .string();
+    std::string second =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+            .string();
+    ReaderUnitConfigStore &firstStore = ReaderUnitConfigStore::getInstance("test.config");
+    ReaderUnitConfigStore &secondStore =
+        ReaderUnitConfigStore::getInstance("test2.config");
+    firstStore.setFilename(first);
+    secondStore.setFilename(second);
+    firstStore.setWatchInterval(10);
+    secondStore.setWatchInterval(20);
+
+    writeConfig(first, "Mifare1K");
+    writeConfig(second, "DESFire");
+    for (int i = 0; i < 200 && (firstStore.getConfig()->cardType != "Mifare1K" ||
+                                secondStore.getConfig()->cardType != "DESFire");
+         ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ("Mifare1K", firstStore.getConfig()->cardType);
+    ASSERT_EQ("DESFire", secondStore.getConfig()->cardType);
+
+    firstStore.setWatchInterval(ReaderUnitConfigStore::DEFAULT_WATCH_INTERVAL);
+    secondStore.setWatchInterval(ReaderUnitConfigStore::DEFAULT_WATCH_INTERVAL);
+    boost::filesystem::remove(first);
+    boost::filesystem::remove(second);
+    firstStore.setFilename("");
+    secondStore.setFilename("");
+}
+
+TEST(test_reader_unit_config_store, test_listener_refreshes)
+{
+    std::string filename =
+        (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+            .string();
+    ReaderUnitConfigStore &store = ReaderUnitConfigStore::getInstance("listener.config");
+    store.setWatchInterval(0);
+    store.setFilename(filename);
+
+    std::vector<std::string> notified;
+    size_t id = store.addListener(
+        [&store, &notified](std::shared_ptr<const ReaderUnitConfigStore::Config> config) {
+            notified.push_back(config->cardType);
+            store.refresh();
+        });
+
+    writeConfig(filename, "Mifare1K");
+    ASSERT_TRUE(store.refresh());
+    ASSERT_EQ((std::vector<std::string>{"Mifare1K"}), notified);
+
+    // Touched long ago, but not modified.
+    boost::filesystem::last_write_time(filename, std::time(nullptr) - 3600);
+    ASSERT_FALSE(store.refresh());
+    ASSERT_FALSE(store.refresh());
+    ASSERT_EQ((std::vector<std::string>{"Mifare1K"}), notified);
+
+    store.removeListener(id);
+    boost::filesystem::remove(filename);
+    store.setFilename("");
+}
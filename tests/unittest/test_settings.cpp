@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/plugins/llacommon/settings.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using namespace logicalaccess;
+
+TEST(test_settings, reload_publishes_new_settings)
+{
+    std::shared_ptr<Settings> settings = Settings::getInstance();
+    ASSERT_EQ(settings, Settings::getInstance());
+
+    settings->DataTransportTimeout = 1234;
+    Settings::reload();
+
+    std::shared_ptr<Settings> reloaded = Settings::getInstance();
+    ASSERT_NE(settings, reloaded);
+    ASSERT_NE(1234, reloaded->DataTransportTimeout);
+    // Readers of the previous settings are not disturbed.
+    ASSERT_EQ(1234, settings->DataTransportTimeout);
+}
+
+TEST(test_settings, reload_frees_previous_settings)
+{
+    std::weak_ptr<Settings> previous = Settings::getInstance();
+    Settings::reload();
+    ASSERT_TRUE(previous.expired());
+}
+
+TEST(test_settings, reload_while_reading)
+{
+    std::atomic<bool> stop(false);
+    std::atomic<unsigned int> reads(0);
+    std::atomic<unsigned int> failures(0);
+    std::thread reader([&]() {
+        while (!stop)
+        {
+            std::shared_ptr<const Settings> settings = Settings::getInstance();
+            if (settings->PluginFolders.empty())
+                ++failures;
+            ++reads;
+        }
+    });
+
+    // Keep reloading until the reader has run concurrently for a while.
+    for (int i = 0; i < 100 || reads < 100; ++i)
+    {
+        Settings::reload();
+    }
+    stop = true;
+    reader.join();
+
+    ASSERT_GT(reads.load(), 0u);
+    ASSERT_EQ(0u, failures.load());
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/dynlibrary/staticpluginregistry.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using namespace logicalaccess;
+
+namespace
+{
+void CDECL_WIN32_ getTestChip(std::shared_ptr<Chip> *chip)
+{
+    chip->reset();
+}
+
+bool CDECL_WIN32_ getTestChipInfoAt(unsigned int index, char *objectname,
+                                    size_t objectnamelen, void **getobjectptr)
+{
+    if (index != 0 || objectnamelen < 17)
+        return false;
+    strcpy(objectname, "StaticTestChip");
+    *getobjectptr = (void *)&getTestChip;
+    return true;
+}
+
+const StaticPluginEntry testEntries[] = {
+    {"getStaticTestChip", &getTestChip, nullptr, nullptr, nullptr}};
+
+const getobjectinfoat testChipInfos[] = {&getTestChipInfoAt, nullptr};
+}
+
+TEST(test_static_plugin_registry, register_and_resolve)
+{
+    ASSERT_EQ(nullptr, StaticPluginRegistry::getSymbol("getStaticTestChip"));
+
+    StaticPluginRegistry::registerPlugins(testEntries, 1, testChipInfos, nullptr);
+    void *fct = StaticPluginRegistry::getSymbol("getStaticTestChip");
+    ASSERT_NE(nullptr, fct);
+    ASSERT_EQ(&getTestChip, *(getcard *)(&fct));
+    ASSERT_EQ(nullptr, StaticPluginRegistry::getSymbol("getUnknownChip"));
+
+    // Registering the same table again does not duplicate it.
+    StaticPluginRegistry::registerPlugins(testEntries, 1, testChipInfos, nullptr);
+    std::vector<std::string> types = StaticPluginRegistry::getChipTypes();
+    ASSERT_EQ(1, std::count(types.begin(), types.end(), "StaticTestChip"));
+    ASSERT_EQ(fct, StaticPluginRegistry::getSymbol("getStaticTestChip"));
+}
+
+TEST(test_static_plugin_registry, resolve_while_registering)
+{
+    static const StaticPluginEntry otherEntries[] = {
+        {"getOtherStaticTestChip", &getTestChip, nullptr, nullptr, nullptr}};
+    StaticPluginRegistry::registerPlugins(testEntries, 1, testChipInfos, nullptr);
+
+    std::atomic<bool> stop(false);
+    std::atomic<unsigned int> failures(0);
+    std::thread reader([&]() {
+        while (!stop)
+        {
+            if (StaticPluginRegistry::getSymbol("getStaticTestChip") == nullptr)
+                ++failures;
+        }
+    });
+    StaticPluginRegistry::registerPlugins(otherEntries, 1, nullptr, nullptr);
+    stop = true;
+    reader.join();
+
+    ASSERT_EQ(0u, failures);
+    ASSERT_NE(nullptr, StaticPluginRegistry::getSymbol("getOtherStaticTestChip"));
+}
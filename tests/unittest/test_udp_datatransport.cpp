@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <logicalaccess/readerproviders/udpdatatransport.hpp>
+#include <logicalaccess/utils.hpp>
+
+using namespace logicalaccess;
+using boost::asio::ip::udp;
+
+TEST(test_udp_datatransport, receive_datagram)
+{
+    boost::asio::io_service ios;
+    udp::socket reader(ios, udp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+    UDPDataTransport transport;
+    transport.setIpAddress("127.0.0.1");
+    transport.setPort(reader.local_endpoint().port());
+    ASSERT_TRUE(transport.connect());
+
+    // Learn the transport endpoint, then answer with a datagram larger than
+    // the former 128 bytes receive buffer.
+    transport.send(ByteVector{0x01});
+    ByteVector request(16);
+    udp::endpoint client;
+    reader.receive_from(boost::asio::buffer(request), client);
+
+    ByteVector answer(512);
+    for (size_t i = 0; i < answer.size(); ++i)
+        answer[i] = static_cast<unsigned char>(i);
+    reader.send_to(boost::asio::buffer(answer), client);
+
+    ElapsedTimeCounter counter;
+    ASSERT_EQ(answer, transport.receive(1000));
+    ASSERT_LT(counter.elapsed(), 200u);
+
+    transport.disconnect();
+}
+
+TEST(test_udp_datatransport, receive_timeout)
+{
+    boost::asio::io_service ios;
+    udp::socket reader(ios, udp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+    UDPDataTransport transport;
+    transport.setIpAddress("127.0.0.1");
+    transport.setPort(reader.local_endpoint().port());
+    ASSERT_TRUE(transport.connect());
+
+    ElapsedTimeCounter counter;
+    ASSERT_TRUE(transport.receive(100).empty());
+    ASSERT_GE(counter.elapsed(), 100u);
+
+    transport.disconnect();
+}